@@ -0,0 +1,211 @@
+// =============================================================================
+// Firmware central — Phase 4 (arbitrage)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// RÔLE :
+//   1. Point d'accès WiFi des deux tireurs (LINK_SSID, 192.168.42.1)
+//   2. Reçoit DWELL / TOUCH (touch_wire.h) sur LINK_PORT_CENTRAL, acquitte
+//      chaque copie et écarte les doublons (TouchReceiver)
+//   3. Répond aux requêtes de synchro : les touches arrivent datées sur
+//      l'horloge de ce Pico (clock_sync.h)
+//   4. Arbitre (referee.h) : lampe dès la première touche de chaque tireur,
+//      verdict définitif à première touche + 300 ms + grâce
+//
+// JOURNAL : chaque événement unique (ligne EV, avec son instant d'arrivée)
+//   et chaque verdict (ligne VD) sont écrits sur Serial. Capturé tel quel,
+//   il se rejoue sur hôte avec les mêmes verdicts (host_tools refreplay).
+//
+// TEMPS DE DÉCISION : onEvent() et poll() sont chronométrés ; le pire cas
+//   est affiché dans STATUS. Les sorties sont mises de côté pendant l'appel,
+//   passées aux lampes, puis affichées : Serial ne compte ni dans la mesure
+//   ni dans la latence des lampes.
+//
+// LAMPES (lamp_panel.h) : bande NeoPixel de 16 pixels sur GP22 (PIO + DMA,
+//   A rouge à gauche, B vert à droite, blanc = non valable), buzzer piezo
+//   sur GP21 (slice PWM). Une trame est lancée dès la décision sans attendre
+//   la fin de l'envoi ; décision → premier photon mesurée à chaque trame,
+//   pire cas dans STATUS (borne LAMP_MAX_LATENCY_US + un tour de loop).
+//   Verdict affiché REFEREE_HOLD_US. LED intégrée : une lampe allumée.
+//   Vérifié sur hôte : host_tools lampsim.
+//
+// LATENCE (latency_probe.h) : les DWELL arrivent avec les étapes du tireur
+//   depuis le premier front de GP2 ; s'y ajoutent réception du datagramme,
+//   retour de l'arbitre et premier photon de la trame qui montre la lampe
+//   (ticket de LampPanel). Sur l'horloge du central, donc seulement pour un
+//   tireur synchronisé. p50 / p99 / max par étape : lignes [LATENCE] de
+//   STATUS. Chaîne complète sur hôte : host_tools e2e.
+//
+// BOUCLE (central_node.h) : lien, arbitre, lampes et latence sont dans
+//   CentralNode ; ce sketch n'ajoute que le point d'accès, Serial et la LED.
+//   host_tools boutsim fait tourner le même CentralNode sur la HAL simulée.
+// =============================================================================
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <buzzer.h>
+#include <central_node.h>
+#include <hal.h>
+#include <neopixel_strip.h>
+#include <referee.h>
+#include <udp_link.h>
+
+using namespace fencing;
+
+// =============================================================================
+// PINS
+// =============================================================================
+
+const int PIN_LIGHTS = 22;   // GP22 : données de la bande NeoPixel (via 330 Ω)
+const int PIN_BUZZER = 21;   // GP21 : buzzer piezo (slice PWM 2)
+
+// =============================================================================
+// PARAMÈTRES
+// =============================================================================
+
+const uint32_t STATUS_PERIOD_MS = 1000;
+
+// =============================================================================
+// ÉTAT
+// =============================================================================
+
+UdpLink        link;
+NeoPixelStrip  strip;
+PwmBuzzer      buzzer;
+bool           lightsUp     = false;
+unsigned long  lastStatusMs = 0;
+
+// Datagrammes, arbitre, lampes, latence : central_node.h (boutsim tourne
+// le même code sur hôte)
+CentralNode<UdpLink, NeoPixelStrip, PwmBuzzer> node(link, strip, buzzer);
+
+// Journal de l'arbitrage sur Serial, une fois les lampes lancées
+struct SerialLog {
+    void output(const RefereeOutput& o, uint32_t) {
+        if (o.kind == RefereeOutputKind::LIGHT) {
+            Serial.print("[LAMPE] ");
+            Serial.print(o.player == PLAYER_B ? 'B' : 'A');
+            Serial.print(' ');
+            Serial.println(lampText(o.lamp));
+            return;
+        }
+        char line[REFEREE_LOG_LINE];
+        Serial.println("-----------------------------------------------------");
+        Serial.print("[VERDICT] ");
+        Serial.print(verdictText(o));
+        if (o.lampA != Lamp::NONE && o.lampB != Lamp::NONE) {
+            Serial.print(" | ecart B-A ");
+            Serial.print(o.gapUs / 1000.0, 1);
+            Serial.print(" ms");
+        }
+        Serial.println();
+        if (formatVerdictLog(o, line, sizeof line))
+            Serial.print(line);
+        Serial.println("-----------------------------------------------------");
+    }
+
+    void event(const TouchEvent& ev, uint64_t rxUs) {
+        char line[REFEREE_LOG_LINE];
+        if (formatEventLog(ev, rxUs, line, sizeof line))
+            Serial.print(line);
+    }
+};
+
+SerialLog serialLog;
+
+void printStatus() {
+    const RefereeStats& st = node.referee().stats();
+    Serial.print("[STATUS] arbitrage max ");
+    Serial.print(node.refereeMaxUs());
+    Serial.print(" us | touches ");
+    Serial.print(st.hits);
+    Serial.print(" verdicts ");
+    Serial.print(st.verdicts);
+    Serial.print(" | verrouillees ");
+    Serial.print(st.locked);
+    Serial.print(" tardives ");
+    Serial.print(st.late);
+    Serial.print(" corrigees ");
+    Serial.print(st.corrections);
+    Serial.print(" non synchro ");
+    Serial.println(st.unsynced);
+    Serial.print("[LIEN] ");
+    Serial.print(node.linkUp() ? "a l'ecoute" : "hors service");
+    Serial.print(" | doublons ");
+    Serial.print(node.receiver().duplicates());
+    Serial.print(" | rejetes ");
+    Serial.print(link.rejected());
+    Serial.print(" | synchro ");
+    Serial.println(node.syncReplies());
+    const LampStats& ls = node.panel().stats();
+    Serial.print("[LAMPES] ");
+    Serial.print(lightsUp ? "trames " : "bande hors service | trames ");
+    Serial.print(ls.frames);
+    Serial.print(" | decision -> photon max ");
+    Serial.print(ls.maxLatencyUs);
+    Serial.print(" us (derniere ");
+    Serial.print(ls.lastLatencyUs);
+    Serial.print(", borne ");
+    Serial.print(LAMP_MAX_LATENCY_US);
+    Serial.print(") | fusionnees ");
+    Serial.println(ls.coalesced);
+    const LatencyProbe& latency = node.latency();
+    if (latency.events()) {
+        char line[96];
+        Serial.print("[LATENCE] premier front GP2 -> etape, ");
+        Serial.print(latency.events());
+        Serial.println(" dwell");
+        for (uint8_t i = 0; i < LATENCY_STAGES; i++)
+            if (formatLatencyLine(latency, (LatencyStage)i, line, sizeof line))
+                Serial.print(line);
+    }
+    node.resetPeaks();
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(3000);
+
+    pinMode(LED_BUILTIN, OUTPUT);
+    digitalWrite(LED_BUILTIN, LOW);
+    lightsUp = strip.begin(PIN_LIGHTS, LAMP_PIXELS);
+    buzzer.begin(PIN_BUZZER);
+
+    Serial.println("=====================================================");
+    Serial.println("  Firmware central — arbitrage fleuret");
+    Serial.println("=====================================================");
+    Serial.print("  WiFi : point d'acces ");
+    Serial.println(LINK_SSID);
+    WiFi.mode(WIFI_AP);
+    bool ap     = WiFi.softAP(LINK_SSID, LINK_PASS);
+    bool linkUp = ap && node.listen(LINK_PORT_CENTRAL);
+    Serial.print("  UDP ");
+    Serial.print(LINK_PORT_CENTRAL);
+    Serial.println(linkUp ? " : a l'ecoute" : " : ECHEC");
+    Serial.print("  Verrouillage ");
+    Serial.print(LOCKOUT_US / 1000);
+    Serial.print(" ms, grace ");
+    Serial.print(REFEREE_GRACE_US / 1000);
+    Serial.println(" ms");
+    Serial.print("  Lampes : ");
+    Serial.print(LAMP_PIXELS);
+    Serial.print(" pixels GP");
+    Serial.print(PIN_LIGHTS);
+    Serial.print(lightsUp ? ", buzzer GP" : " ECHEC, buzzer GP");
+    Serial.println(PIN_BUZZER);
+    Serial.println("  Journal : lignes EV / VD (host_tools refreplay)");
+    Serial.println("=====================================================");
+    Serial.println();
+}
+
+void loop() {
+    // Lien, échéances de l'arbitre, lampes ; le journal passe après les trames
+    node.loop(serialLog);
+
+    unsigned long now = millis();
+    if (now - lastStatusMs >= STATUS_PERIOD_MS) {
+        lastStatusMs = now;
+        printStatus();
+    }
+    digitalWrite(LED_BUILTIN, node.panel().lit() ? HIGH : LOW);
+}
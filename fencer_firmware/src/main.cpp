@@ -0,0 +1,627 @@
+// =============================================================================
+// Firmware tireur — Phase 2 (Mode Simple / Mode Time-Division)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// RÔLE :
+//   1. Émet Freq_VALID du tireur sur la cuirasse (GP14 → MOSFET → ligne A)
+//   2. Lit le bouton du fleuret (GP16, INPUT_PULLUP sur la ligne C)
+//   3. Pendant l'appui, chronomètre les périodes sur GP2 (PIO) et classe
+//      la fréquence vue par la pointe → touche valide / neutre / blanche
+//   4. Déclare le dwell FIE (DWELL) dès que 15 ms de contact à fréquence
+//      valide sont acquises, datées en µs, sans attendre le relâchement
+//
+// RÉPARTITION SUR LES DEUX CŒURS DU RP2040 :
+//
+//   Cœur 1 (setup1 / loop1) : détection uniquement. Boucle bornée, sans
+//     Serial ni attente : bascules de GP16, TouchDetector, événements
+//     poussés dans une SpscQueue en RAM partagée (jamais bloquant : file
+//     pleine → événement perdu, visible par son numéro de séquence).
+//     Durée max d'un tour de boucle publiée chaque seconde (STATUS).
+//     GP2 est lu à travers EdgeGovernor (edge_governor.h) : au-delà de
+//     GOVERNOR_STORM_HZ fronts/s (parasite, oscillation), les périodes sont
+//     jetées sans être lues et seul le compteur du DMA donne le débit ; le
+//     tour de boucle reste borné quel que soit le signal. Débit max publié
+//     dans STATUS, tempête → anomalie de trace.
+//
+//   Cœur 0 (setup / loop) : USB Serial (puis WiFi, Phase 3) et LED. Vide la
+//     file et formate les messages ; un Serial.print lent ne retarde plus
+//     la mesure (dans phase1_5, l'affichage toutes les 200 ms était dans la
+//     même boucle que la lecture du bouton).
+//
+// CÂBLAGE (cf. PROJECT_PLAN.md, "Correspondance Lignes / Pins") :
+//   GP14 → MOSFET A → ligne A (cuirasse)       Freq_VALID du tireur
+//   GP2  ← ligne B (pointe), pull-down 10kΩ    chronométrage PIO
+//   GP16 ← ligne C via 10kΩ série              bouton (HIGH = pressé)
+//   GP26 ← ligne B (relié à GP2)               amplitude ADC, -DFENCER_ADC
+//   GP15, GP17 : LOW (Mode Simple, MOSFETs de la coque bloqués)
+//
+// BOUTON (Mode Simple) : GP16 échantillonné à 4 kHz par une alarme matérielle
+//   (button_sampler.h), filtre à intégrateur de 2 ms au plus. Les bascules
+//   arrivent antidatées au premier échantillon stable : le dwell ne perd pas
+//   le temps d'anti-rebond (5 ms avec readButtonDebounced()).
+//
+// MODE TIME-DIVISION (-DFENCER_TIME_DIVISION, envs fencer_*_td) :
+//   GP17 émet Freq_NEUTRE sur la coque 9 ms sur 10, GP15 coupe la pull-up
+//   pendant le créneau DETECT de 1 ms où GP16 est échantillonné. Cadencé
+//   par une alarme matérielle sur le cœur 1 (time_division.h) ; loop1 lit
+//   l'état du bouton déjà filtré par le cycle.
+//
+// LIAISON CENTRAL (-DFENCER_LINK, envs fencer_*_link) :
+//   Le cœur 0 rejoint le point d'accès du central (LINK_SSID) et lui envoie
+//   DWELL et TOUCH en trames touch_wire.h par lwIP raw (udp_link.h), en
+//   copies redondantes acquittées (touch_link.h), datées sur l'horloge du
+//   central (clock_sync.h, échanges toutes les 250 ms). Résumé dans STATUS.
+//
+// AMPLITUDE (-DFENCER_ADC, envs fencer_*_adc, plan LOW) :
+//   GP26 relié à GP2 lit la tension de la ligne B. ADC en continu par DMA
+//   (adc_capture.h), crête à crête et RMS par fenêtre (amplitude_meter.h)
+//   pendant l'appui seulement ; hors appui l'anneau est vidé sans calcul.
+//   La note de contact multiplie la confiance du détecteur : une fuite
+//   capacitive qui fait basculer GP2 sans créneau franc ne décide pas.
+//   Vérifié sur la chaîne simulée : host_tools adcsim.
+//
+// LATENCE (latency_probe.h) : chaque événement de l'appui part avec ses
+//   estampilles depuis le premier front de GP2 (classification, dwell,
+//   file du cœur 1, première copie UDP) ; le central ajoute réception,
+//   décision et lampe. Les DWELL sont agrégés ici aussi (p50 / p99 / max
+//   par étape, lignes [LATENCE] de STATUS). Chaîne complète sur hôte :
+//   host_tools e2e.
+//
+// TRACE (trace_ring.h) : anneaux binaires toujours actifs, un par contexte
+//   d'écriture — cœur 1 (bascules du bouton, changements de classe des
+//   périodes de GP2, événements), interruption du Mode Time-Division
+//   (phases), cœur 0 (datagrammes, acquittements). Vidés sur Serial en
+//   binaire quand on envoie 'T', ou TRACE_POST_MS après une anomalie
+//   (période hors bandes pendant l'appui, file pleine, tour de boucle trop
+//   long, tempête de fronts sur GP2), au plus une fois par TRACE_COOLDOWN_MS.
+//   Décodage sur hôte : host_tools tracedump (CSV / VCD).
+//
+// CALIBRATION (carrier_calibration.h) : au branchement (association avec le
+//   central en -DFENCER_LINK, démarrage sinon) ou sur 'C' : pointe sur la
+//   cuirasse adverse, puis sur la coque / la piste, CAL_MIN_PRESSES appuis
+//   à des endroits différents. Le cœur 1 échantillonne au lieu de détecter
+//   (événements CALIBRATION, jamais envoyés au central), le cœur 0 écrit
+//   les lignes CAL sur Serial — journal rejouable par host_tools calib —,
+//   dérive les bandes du tireur, les enregistre en flash et les publie au
+//   cœur 1 (DoubleBuffer), qui les pose entre deux appuis. Étape sans assez
+//   d'appuis au bout de CAL_STEP_TIMEOUT_MS ou dérivation refusée : le plan
+//   en cours est gardé. Au démarrage, le plan enregistré est rechargé.
+//
+// BOUCLES (fencer_node.h) : le corps de loop1() et l'envoi des événements
+//   du cœur 0 sont dans FencerNode ; ce sketch garde les broches, Serial,
+//   la calibration, les traces et le WiFi. host_tools boutsim fait tourner
+//   deux FencerNode sur la HAL simulée.
+//
+// TIREUR : -DFENCER_SIDE_A ou -DFENCER_SIDE_B (platformio.ini)
+// =============================================================================
+
+#include <Arduino.h>
+
+#include <adc_capture.h>
+#include <amplitude_meter.h>
+#include <band_plan.h>
+#include <button_sampler.h>
+#include <carrier_calibration.h>
+#include <classifier.h>
+#include <edge_governor.h>
+#include <fencer_event.h>
+#include <fencer_node.h>
+#include <fie_timing.h>
+#include <freq_plan.h>
+#include <hal.h>
+#include <latency_probe.h>
+#include <pio_edge_timer.h>
+#include <time_division.h>
+#include <trace_ring.h>
+#include <udp_link.h>
+
+#if defined(FENCER_LINK)
+#include <WiFi.h>
+#endif
+
+using namespace fencing;
+
+#if defined(FENCER_SIDE_B)
+const uint32_t  FREQ_OWN       = FREQ_VALID_B;
+const char      SIDE_NAME      = 'B';
+const FreqClass CLASS_OPPONENT = FreqClass::VALID_A;
+#else
+const uint32_t  FREQ_OWN       = FREQ_VALID_A;
+const char      SIDE_NAME      = 'A';
+const FreqClass CLASS_OPPONENT = FreqClass::VALID_B;
+#endif
+
+// =============================================================================
+// PINS
+// =============================================================================
+
+const int PIN_PWM_VALID = 14;   // GP14 : Freq_VALID → MOSFET A → cuirasse
+const int PIN_FREQ_IN   = 2;    // GP2  : ligne B (chronométrage PIO)
+const int PIN_BUTTON    = 16;   // GP16 : ligne C (INPUT_PULLUP)
+const int PIN_MOSFET_C  = 15;   // GP15 : Mode Time-Division, LOW en Mode Simple
+const int PIN_PWM_C     = 17;   // GP17 : Mode Time-Division, LOW en Mode Simple
+const int PIN_ADC       = 26;   // GP26 : ligne B (relié à GP2), -DFENCER_ADC
+
+// =============================================================================
+// PARAMÈTRES
+// =============================================================================
+
+const uint32_t TRACE_CORE1_SIZE   = 1024;  // enregistrements de 8 octets
+const uint32_t TRACE_CORE0_SIZE   = 256;
+const uint32_t TRACE_TD_SIZE      = 256;   // 200 phases / s : ~1.3 s
+const uint32_t TRACE_POST_MS      = 50;    // contexte gardé après l'anomalie
+const uint32_t TRACE_COOLDOWN_MS  = 5000;  // entre deux vidages sur anomalie
+
+const uint32_t CAL_STEP_TIMEOUT_MS = 20000; // étape de calibration sans assez d'appuis
+
+const uint8_t PLAYER_ID = SIDE_NAME == 'B' ? PLAYER_B : PLAYER_A;
+
+#if defined(FENCER_LINK)
+const UdpPeer LINK_CENTRAL = { ipv4(192, 168, 42, 1), LINK_PORT_CENTRAL };  // softAP arduino-pico
+typedef UdpLink FencerLink;
+#else
+typedef NoLink  FencerLink;    // rien ne part
+#endif
+
+// =============================================================================
+// ÉTAT PARTAGÉ ENTRE LES CŒURS
+// =============================================================================
+
+// File d'événements, étape de calibration et plan : dans le nœud, écrits
+// par un cœur et lus par l'autre (fencer_node.h)
+EdgeTimer  edgeTimer;
+FencerLink link;
+FencerNode<EdgeTimer, FencerLink> node(edgeTimer, link, PLAYER_ID);
+
+// Un anneau par contexte d'écriture ; le cœur 0 les lit pour les vider
+TraceBuffer<TRACE_CORE1_SIZE> core1Trace(TraceSource::CORE1);
+TraceBuffer<TRACE_CORE0_SIZE> core0Trace(TraceSource::CORE0);
+TraceBuffer<TRACE_TD_SIZE>    tdTrace(TraceSource::TD_IRQ);
+
+// =============================================================================
+// CŒUR 1 — détection
+// =============================================================================
+
+#if defined(FENCER_TIME_DIVISION)
+TdAlarmDriver timeDivision;
+#else
+ButtonSampler buttonSampler;
+#endif
+
+#if defined(FENCER_ADC)
+AdcCapture     adcCapture;
+AmplitudeMeter amplitude(ADC_SAMPLE_HZ);
+#endif
+
+void setup1() {
+#if defined(FENCER_TIME_DIVISION)
+    // Alarme réclamée ici : son interruption tourne sur le cœur 1
+    timeDivision.setTrace(&tdTrace);
+    timeDivision.begin(PIN_MOSFET_C, PIN_PWM_C, PIN_BUTTON, FREQ_NEUTRE);
+#else
+    // Mode Simple : circuit d'émission de la coque inactif
+    hal::pinOutput(PIN_MOSFET_C, false);
+    hal::pinOutput(PIN_PWM_C, false);
+    buttonSampler.begin(PIN_BUTTON);    // alarme réclamée ici : interruption sur le cœur 1
+#endif
+
+    hal::pinInput(PIN_FREQ_IN, hal::Pull::NONE);
+    edgeTimer.begin(PIN_FREQ_IN);
+    node.setup1(&core1Trace);
+#if defined(FENCER_ADC)
+    // Sans ADC : décision sur la seule confiance
+    if (adcCapture.begin(PIN_ADC, ADC_SAMPLE_HZ)) {
+        amplitude = AmplitudeMeter(adcCapture.sampleHz());
+        node.setAmplitude(&adcCapture, &amplitude);
+    }
+#endif
+
+    hal::pwmStart(PIN_PWM_VALID, FREQ_OWN);
+}
+
+void loop1() {
+#if defined(FENCER_TIME_DIVISION)
+    node.loop1(timeDivision.state());
+#else
+    node.loop1(buttonSampler);
+#endif
+}
+
+// =============================================================================
+// CŒUR 0 — Serial USB, LED
+// =============================================================================
+
+unsigned long touchCount   = 0;
+uint64_t      buttonDownUs = 0;
+bool          buttonDown   = false;   // d'après les événements (rien d'autre n'est partagé)
+bool          dwellSeen    = false;   // DWELL reçu pendant l'appui en cours
+
+// -----------------------------------------------------------------------------
+// Calibration des bandes (cœur 0)
+// -----------------------------------------------------------------------------
+const FreqClass CAL_STEPS[] = { CLASS_OPPONENT, FreqClass::NEUTRE };
+const uint8_t   CAL_STEP_COUNT = sizeof(CAL_STEPS) / sizeof(CAL_STEPS[0]);
+
+PlanStore      planStore;
+CalibrationSet calSet;
+uint8_t        calStep   = CAL_STEP_COUNT;   // CAL_STEP_COUNT : pas de calibration
+uint32_t       calStepMs = 0;
+
+bool calibrationActive() { return calStep < CAL_STEP_COUNT; }
+
+void printPlan(const BandPlan& plan) {
+    for (uint8_t i = 0; i < plan.count; i++) {
+        Serial.print("[PLAN] ");
+        Serial.print(freqClassLabel(plan.bands[i].cls));
+        Serial.print(" : ");
+        Serial.print(plan.bands[i].loHz());
+        Serial.print(" .. ");
+        Serial.print(plan.bands[i].hiHz());
+        Serial.println(" Hz");
+    }
+}
+
+void announceStep() {
+    Serial.print("[CALIBRATION] etape ");
+    Serial.print(calStep + 1);
+    Serial.print("/");
+    Serial.print(CAL_STEP_COUNT);
+    Serial.print(" : pointe sur ");
+    Serial.print(CAL_STEPS[calStep] == FreqClass::NEUTRE ? "la coque / la piste"
+                                                         : "la cuirasse adverse");
+    Serial.print(", ");
+    Serial.print(CAL_MIN_PRESSES);
+    Serial.println(" appuis a des endroits differents");
+    node.setCalibrationTarget(CAL_STEPS[calStep]);
+    calStepMs = hal::nowMs();
+}
+
+void startCalibration() {
+    calSet.clear();
+    calStep = 0;
+    announceStep();
+}
+
+void stopCalibration() {
+    calStep = CAL_STEP_COUNT;
+    node.setCalibrationTarget(FreqClass::NONE);
+}
+
+void finishCalibration() {
+    stopCalibration();
+    BandPlan plan;
+    CalReport report;
+    CalStatus st = calSet.derive(plan, &report);
+    for (const CalCarrier& c : report.carriers) {
+        if (!c.calibrated)
+            continue;
+        Serial.print("[CALIBRATION] ");
+        Serial.print(freqClassLabel(c.cls));
+        Serial.print(" : ");
+        Serial.print(c.samples);
+        Serial.print(" echantillons (");
+        Serial.print(c.rejected);
+        Serial.print(" ecartes) | ");
+        Serial.print(c.loHz);
+        Serial.print(" / ");
+        Serial.print(c.medianHz);
+        Serial.print(" / ");
+        Serial.print(c.hiHz);
+        Serial.print(" Hz | ");
+        Serial.println(calStatusText(c.status));
+    }
+    if (st != CalStatus::OK) {
+        Serial.print("[CALIBRATION] refusee : ");
+        Serial.print(calStatusText(st));
+        Serial.println(" -> plan en cours conserve");
+        return;
+    }
+    // Le core arduino-pico met le cœur 1 en attente pendant l'écriture
+    Serial.println(planStore.save(plan) ? "[CALIBRATION] plan enregistre en flash"
+                                        : "[CALIBRATION] /!\\ echec d'ecriture en flash");
+    node.publishPlan(plan);
+    printPlan(plan);
+}
+
+// Étape complète → suivante ; délai dépassé → abandon
+void serviceCalibration() {
+    if (!calibrationActive())
+        return;
+    if (calSet.complete(CAL_STEPS[calStep])) {
+        if (++calStep < CAL_STEP_COUNT)
+            announceStep();
+        else
+            finishCalibration();
+    } else if (hal::nowMs() - calStepMs >= CAL_STEP_TIMEOUT_MS) {
+        Serial.print("[CALIBRATION] delai depasse (");
+        Serial.print(calSet.presses(CAL_STEPS[calStep]));
+        Serial.println(" appuis) -> plan en cours conserve");
+        stopCalibration();
+    }
+}
+
+// Plan enregistré au démarrage ; FREQ_PLAN sinon
+void loadPlan() {
+    BandPlan plan;
+    if (planStore.load(plan)) {
+        Serial.println("[PLAN] bandes calibrees (flash)");
+        node.publishPlan(plan);
+        printPlan(plan);
+    } else {
+        Serial.println("[PLAN] FREQ_PLAN compile (pas de calibration en flash)");
+    }
+}
+
+#if defined(FENCER_LINK)
+bool calibrated = false;   // calibration lancée à la première association
+
+// Association WiFi non bloquante : la socket s'ouvre dès que le lien est là
+void serviceLink() {
+    if (!node.linkUp() && WiFi.status() == WL_CONNECTED) {
+        node.connect(LINK_PORT_FENCER, LINK_CENTRAL);
+        // Branchement au central : calibration du matériel de l'assaut
+        if (node.linkUp() && !calibrated) {
+            calibrated = true;
+            startCalibration();
+        }
+    }
+    node.serviceLink();
+}
+
+void printLinkStatus() {
+    const LinkStats& st        = node.sender().stats();
+    const ClockSync& clockSync = node.clockSync();
+    Serial.print("[LIEN] ");
+    Serial.print(node.linkUp() ? "associe" : "hors ligne");
+    Serial.print(" | envoyes ");
+    Serial.print(st.queued);
+    Serial.print(" acquittes ");
+    Serial.print(st.acked);
+    Serial.print(" abandonnes ");
+    Serial.print(st.expired + st.overflow);
+    Serial.print(" | datagrammes ");
+    Serial.print(st.datagrams);
+    Serial.print(" | ack max ");
+    Serial.print(st.ackMaxUs);
+    Serial.print(" us | synchro ");
+    if (clockSync.synced()) {
+        Serial.print("±");
+        Serial.print(clockSync.uncertaintyUs(hal::nowUs()));
+        Serial.print(" us, derive ");
+        Serial.print(clockSync.skewPpb() / 1000.0, 1);
+        Serial.println(" ppm");
+    } else {
+        Serial.println("en attente");
+    }
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Vidage des traces (cœur 0)
+// -----------------------------------------------------------------------------
+uint64_t     traceWords[TRACE_CORE1_SIZE];
+uint8_t      traceOut[traceDumpSize(TRACE_CORE1_SIZE)];
+TraceAnomaly pendingAnomaly = TraceAnomaly::NONE;
+uint32_t     anomalyMs      = 0;
+uint32_t     lastDumpMs     = 0;
+bool         dumpedOnce     = false;
+
+void dumpRing(const TraceRing& ring, uint8_t reason, TraceAnomaly code) {
+    uint32_t written;
+    uint32_t n = ring.snapshot(traceWords, TRACE_CORE1_SIZE, written);
+    TraceDumpHeader h = { ring.source(), reason, code, (uint16_t)n, written, hal::nowUs() };
+    size_t size = encodeTraceDump(h, traceWords, traceOut, sizeof traceOut);
+    Serial.write(traceOut, size);
+}
+
+void dumpTraces(uint8_t reason, TraceAnomaly code) {
+    Serial.println();
+    Serial.println(reason ? "[TRACE] vidage sur anomalie" : "[TRACE] vidage");
+    dumpRing(core1Trace, reason, code);
+#if defined(FENCER_TIME_DIVISION)
+    dumpRing(tdTrace, reason, code);
+#endif
+#if defined(FENCER_LINK)
+    dumpRing(core0Trace, reason, code);
+#endif
+    Serial.println();
+    lastDumpMs = hal::nowMs();
+    dumpedOnce = true;
+}
+
+// 'T' sur Serial : vidage immédiat. Anomalie : vidage TRACE_POST_MS plus tard.
+void serviceTrace(bool requested) {
+    uint32_t now = hal::nowMs();
+    if (pendingAnomaly == TraceAnomaly::NONE) {
+        pendingAnomaly = core1Trace.anomaly();
+        anomalyMs      = now;
+    }
+    if (requested) {
+        dumpTraces(0, TraceAnomaly::NONE);
+    } else if (pendingAnomaly != TraceAnomaly::NONE && now - anomalyMs >= TRACE_POST_MS) {
+        if (!dumpedOnce || now - lastDumpMs >= TRACE_COOLDOWN_MS)
+            dumpTraces(1, pendingAnomaly);
+        core1Trace.clearAnomaly();
+        pendingAnomaly = TraceAnomaly::NONE;
+    }
+}
+
+// 'T' : vidage des traces, 'C' : calibration
+void serviceSerial() {
+    bool traceRequested = false;
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == 'T')
+            traceRequested = true;
+        else if (c == 'C' && !calibrationActive())
+            startCalibration();
+    }
+    serviceTrace(traceRequested);
+}
+
+void printLatency() {
+    const LatencyProbe& latency = node.latency();
+    if (!latency.events())
+        return;
+    char line[96];
+    Serial.print("[LATENCE] premier front GP2 -> etape, ");
+    Serial.print(latency.events());
+    Serial.println(" dwell");
+    for (uint8_t i = 0; i < LATENCY_FENCER_STAGES; i++)
+        if (formatLatencyLine(latency, (LatencyStage)i, line, sizeof line))
+            Serial.print(line);
+}
+
+void printEvent(const FencerEvent& ev) {
+    switch (ev.type) {
+        case FencerEventType::BUTTON_DOWN:
+            buttonDownUs = ev.tUs;
+            buttonDown   = true;
+            dwellSeen    = false;
+            Serial.println("[BOUTON] Presse ! Mesure en cours...");
+            break;
+
+        case FencerEventType::DECISION:
+            Serial.print("[DECISION] t+");
+            Serial.print((uint32_t)((ev.tUs - buttonDownUs) / 1000u));
+            Serial.print(" ms | Freq: ");
+            Serial.print(ev.freqHz);
+            Serial.print(" Hz | confiance ");
+            Serial.print(ev.value / 10.0, 1);
+            Serial.print(" % | ");
+            Serial.println(touchResultText(ev.cls));
+            break;
+
+        case FencerEventType::DWELL:
+            if (ev.cls == FreqClass::NONE) {
+                // Touche blanche, déclarée pendant l'appui comme le dwell
+                Serial.print("[BLANCHE] 15 ms d'appui sans porteuse | declare ");
+                Serial.print(ev.value);
+                Serial.println(" us apres");
+                break;
+            }
+            // Touche acquise : c'est cet événement qui partira vers le central
+            dwellSeen = true;
+            Serial.print("[DWELL] 15 ms de contact a t+");
+            Serial.print((uint32_t)((ev.tUs - buttonDownUs) / 1000u));
+            Serial.print(" ms | ");
+            Serial.print(freqClassLabel(ev.cls));
+            Serial.print(" | declare ");
+            Serial.print(ev.value);
+            Serial.println(" us apres");
+            break;
+
+        case FencerEventType::TOUCH:
+            buttonDown = false;
+            touchCount++;
+            Serial.println("-----------------------------------------------------");
+            Serial.print("[TOUCHE #");
+            Serial.print(touchCount);
+            Serial.print("]  Freq: ");
+            Serial.print(ev.freqHz);
+            Serial.print(" Hz | ");
+            Serial.print(freqClassLabel(ev.cls));
+            Serial.print(" | Appui: ");
+            Serial.print(ev.value / 1000.0, 2);
+            Serial.println(" ms");
+            Serial.print("  Resultat: ");
+            Serial.println(touchResultText(ev.cls));
+            if (!dwellSeen)
+                Serial.println("  /!\\ Pas 15 ms de contact valide continu (dwell FIE)");
+            Serial.println("-----------------------------------------------------");
+            break;
+
+        case FencerEventType::CALIBRATION: {
+            // Ligne du journal rejouable sur hôte (host_tools calib)
+            char line[48];
+            if (formatCalibrationLog(ev.cls, ev.value, ev.freqHz, line, sizeof line))
+                Serial.print(line);
+            if (calibrationActive() && ev.cls == CAL_STEPS[calStep])
+                calSet.add(ev.cls, ev.value, ev.freqHz);
+            break;
+        }
+
+        case FencerEventType::STATUS:
+            Serial.print("[STATUS] coeur 1 : boucle max ");
+            Serial.print(ev.value);
+            Serial.print(" us | file ");
+            Serial.print(node.events().size());
+            Serial.print("/");
+            Serial.print(node.events().capacity());
+            Serial.print(" | perdus ");
+            Serial.println(node.lostEvents());
+            Serial.print("[STATUS] GP2 : debit max ");
+            Serial.print(ev.freqHz);
+            Serial.print(" fronts/s");
+            Serial.println(ev.freqHz >= GOVERNOR_STORM_HZ ? " -> TEMPETE (periodes jetees)" : "");
+#if defined(FENCER_LINK)
+            printLinkStatus();
+#endif
+            printLatency();
+            break;
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(3000);
+
+    pinMode(LED_BUILTIN, OUTPUT);
+    digitalWrite(LED_BUILTIN, HIGH);
+
+    Serial.println("=====================================================");
+    Serial.print("  Firmware tireur ");
+    Serial.print(SIDE_NAME);
+#if defined(FENCER_TIME_DIVISION)
+    Serial.println(" — Mode Time-Division, double coeur");
+#else
+    Serial.println(" — Mode Simple, double coeur");
+#endif
+    Serial.println("=====================================================");
+    Serial.print("  GP14 : Freq_VALID ");
+    Serial.print(FREQ_OWN);
+    Serial.println(" Hz → cuirasse");
+    Serial.println("  GP2  : chronometrage PIO (ligne B)");
+    Serial.println("  GP16 : bouton (INPUT_PULLUP, ligne C)");
+#if defined(FENCER_TIME_DIVISION)
+    Serial.println("  GP17 : Freq_NEUTRE coque 9 ms / GP15 : DETECT 1 ms");
+#endif
+#if defined(FENCER_LINK)
+    Serial.print("  WiFi : ");
+    Serial.print(LINK_SSID);
+    Serial.println(" → central UDP (copies redondantes, acquittees)");
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(LINK_SSID, LINK_PASS);
+#endif
+    node.setup(&core0Trace, hal::bootNonce());   // seq repart de 0 : le central le saura
+    Serial.println("  Trace : 'T' pour vider (binaire, host_tools tracedump)");
+    Serial.println("  Calibration : 'C' (lignes CAL, host_tools calib)");
+    Serial.println("  Coeur 1 : detection | Coeur 0 : Serial");
+    Serial.println("=====================================================");
+    Serial.println();
+
+    loadPlan();
+#if !defined(FENCER_LINK)
+    startCalibration();     // sans central : le branchement, c'est le démarrage
+#endif
+}
+
+void loop() {
+    // Envoyé au central par pop(), avant l'affichage : Serial peut bloquer
+    FencerEvent ev;
+    while (node.pop(ev))
+        printEvent(ev);
+#if defined(FENCER_LINK)
+    serviceLink();
+#endif
+    serviceCalibration();
+    serviceSerial();
+
+    // LED : fixe au repos, clignote pendant un appui, vite pendant la calibration
+    unsigned long now = millis();
+    if (calibrationActive())
+        digitalWrite(LED_BUILTIN, (now / 50) % 2 ? LOW : HIGH);
+    else
+        digitalWrite(LED_BUILTIN, buttonDown && (now / 100) % 2 ? LOW : HIGH);
+}
@@ -0,0 +1,97 @@
+// =============================================================================
+// bench_core.cpp — Micro-benchmarks du chemin critique de fencing_core
+// =============================================================================
+//
+// Cout par appel (ns) sur l'hote de : classifyFrequency (table generee a la
+// compilation, comparee a l'ancienne chaine de if des sketches),
+// Debouncer::update, Lockout::accept. Les entrees sont precalculees pour ne
+// mesurer que l'appel ; le resultat est accumule pour que le compilateur ne
+// l'elimine pas.
+// =============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <classifier.h>
+#include <debounce.h>
+#include <fie_timing.h>
+
+using namespace fencing;
+
+namespace {
+
+const size_t ITERATIONS = 10000000;
+
+// Reference : classification des sketches avant la table (chaine de if)
+FreqClass classifyIfChain(uint32_t freq) {
+    if (freq < FREQ_MIN_DETECT)
+        return FreqClass::NONE;
+    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
+        return FreqClass::NEUTRE;
+    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
+        return FreqClass::VALID_A;
+    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
+        return FreqClass::VALID_B;
+    return FreqClass::UNKNOWN;
+}
+
+template <typename F>
+void measure(const char* name, F&& body) {
+    volatile uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; i++)
+        sink = sink + body(i);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ITERATIONS;
+    std::printf("  %-28s %6.2f ns/appel\n", name, ns);
+}
+
+}  // namespace
+
+int benchCore(int, char**) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> freqDist(0, 2 * FREQ_VALID_B);
+    std::bernoulli_distribution bounce(0.1);
+
+    const size_t MASK = 4095;
+    std::vector<uint32_t> freqs(MASK + 1);
+    std::vector<uint8_t>  raws(MASK + 1);
+    for (size_t i = 0; i <= MASK; i++) {
+        freqs[i] = freqDist(rng);
+        raws[i]  = bounce(rng);
+    }
+
+    std::printf("Micro-benchmarks fencing_core (%zu iterations)\n", ITERATIONS);
+    std::printf("  table : cases de %u Hz, %u octets\n",
+                1u << detail::LUT_SHIFT, (unsigned)detail::LUT_SIZE);
+
+    for (uint32_t f = 0; f <= 2 * FREQ_VALID_B; f++) {
+        if (classifyFrequency(f) != classifyIfChain(f)) {
+            std::printf("  ECART table / if a %u Hz\n", f);
+            return 1;
+        }
+    }
+
+    measure("classifyFrequency (table)", [&](size_t i) {
+        return (uint32_t)classifyFrequency(freqs[i & MASK]);
+    });
+
+    measure("classifyIfChain (reference)", [&](size_t i) {
+        return (uint32_t)classifyIfChain(freqs[i & MASK]);
+    });
+
+    Debouncer debouncer;
+    measure("Debouncer::update", [&](size_t i) {
+        return (uint32_t)debouncer.update(raws[i & MASK] != 0, (uint32_t)i);
+    });
+
+    Lockout lockout;
+    measure("Lockout::accept", [&](size_t i) {
+        if ((i & 1023) == 0) lockout.reset();
+        return (uint32_t)lockout.accept((uint32_t)i);
+    });
+
+    return 0;
+}
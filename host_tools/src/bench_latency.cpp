@@ -0,0 +1,140 @@
+// =============================================================================
+// bench_latency.cpp — Latence de decision : comptage 50 ms vs mesure reciproque
+// =============================================================================
+//
+// Traces synthetiques de fronts montants (horodatage en ns) :
+//   - porteuse f, phase aleatoire par rapport a l'appui du bouton (t = 0)
+//   - gigue gaussienne de JITTER_PERMILLE sur chaque front
+//   - etablissement du contact bruite pendant 0 a MAX_BOUNCE_US : fronts
+//     perdus et fronts parasites (cf. "mesures aberrantes" du plan)
+//
+// Comptage (phase1_5) : fenetres de MEASURE_WINDOW_MS depuis l'appui,
+//   decision a la premiere fenetre dont la frequence est dans la bande.
+// Reciproque : ReciprocalEstimator<N>, decision au premier front ou
+//   l'estimation est stable et dans la bande.
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <edge_counter.h>
+#include <pio_edge_timer.h>
+#include <reciprocal_meter.h>
+
+namespace {
+
+const uint32_t MEASURE_WINDOW_MS = 50;
+const uint32_t TRACE_MS          = 200;
+const uint32_t JITTER_PERMILLE   = 5;
+const uint32_t MAX_BOUNCE_US     = 2000;
+const uint32_t TOLERANCE_PERCENT = 10;
+const int      TRIALS            = 2000;
+const uint8_t  N_PERIODS         = 4;
+
+struct Stats {
+    std::vector<double> latencyMs;
+    int errors = 0;     // decisions hors bande
+    int misses = 0;     // aucune decision sur la trace
+
+    void report(const char* name) const {
+        std::vector<double> v = latencyMs;
+        std::sort(v.begin(), v.end());
+        double mean = 0;
+        for (double x : v) mean += x;
+        mean = v.empty() ? 0 : mean / v.size();
+        double p99 = v.empty() ? 0 : v[(size_t)(v.size() * 0.99)];
+        double mx  = v.empty() ? 0 : v.back();
+        std::printf("  %-12s moy %6.2f ms | p99 %6.2f ms | max %6.2f ms | erreurs %4d | sans decision %4d\n",
+                    name, mean, p99, mx, errors, misses);
+    }
+};
+
+bool inBand(uint32_t measured, uint32_t f) {
+    uint32_t tol = f * TOLERANCE_PERCENT / 100;
+    return measured + tol >= f && measured <= f + tol;
+}
+
+std::vector<uint64_t> makeTrace(uint32_t freqHz, std::mt19937& rng) {
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    double periodNs = 1e9 / freqHz;
+    double phaseNs  = uni(rng) * periodNs;
+    double bounceNs = uni(rng) * MAX_BOUNCE_US * 1000.0;
+
+    std::vector<uint64_t> edges;
+    for (double t = phaseNs; t < TRACE_MS * 1e6; t += periodNs) {
+        double jittered = t + gauss(rng) * periodNs * JITTER_PERMILLE / 1000.0;
+        if (jittered < 0) continue;
+        if (jittered < bounceNs) {
+            if (uni(rng) < 0.5) continue;                 // front perdu
+            if (uni(rng) < 0.5)                           // front parasite
+                edges.push_back((uint64_t)(jittered - uni(rng) * periodNs * 0.5));
+        }
+        edges.push_back((uint64_t)jittered);
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+void runCounting(const std::vector<uint64_t>& edges, uint32_t f, Stats& st) {
+    fencing::FakeEdgeCounter counter;
+    counter.clear();
+    size_t i = 0;
+    for (uint32_t end = MEASURE_WINDOW_MS; end <= TRACE_MS; end += MEASURE_WINDOW_MS) {
+        uint64_t endNs = (uint64_t)end * 1000000u;
+        while (i < edges.size() && edges[i] < endNs) {
+            counter.addEdges(1);
+            i++;
+        }
+        uint32_t freq = fencing::windowFreqHz(counter.takePulseCount(), MEASURE_WINDOW_MS);
+        if (inBand(freq, f)) {
+            st.latencyMs.push_back(end);
+            if (end != MEASURE_WINDOW_MS) st.errors++;   // 1ere fenetre fausse
+            return;
+        }
+    }
+    st.misses++;
+}
+
+void runReciprocal(const std::vector<uint64_t>& edges, uint32_t f, Stats& st) {
+    fencing::FakeEdgeTimer timer(1000000000u);
+    fencing::ReciprocalEstimator<N_PERIODS> est(timer.tickHz());
+    for (size_t i = 1; i < edges.size(); i++) {
+        timer.addPeriod((uint32_t)(edges[i] - edges[i - 1]));
+        timer.poll(est);
+        if (est.stable()) {
+            st.latencyMs.push_back(edges[i] / 1e6);
+            if (!inBand(est.freqHz(), f)) st.errors++;
+            return;
+        }
+    }
+    st.misses++;
+}
+
+}  // namespace
+
+int benchLatency(int, char**) {
+    const uint32_t freqs[] = { 1000, 1500, 2500 };
+    std::mt19937 rng(12345);
+
+    std::printf("Latence de decision depuis l'appui (%d essais par frequence)\n", TRIALS);
+    std::printf("  comptage : fenetre %u ms | reciproque : N = %u periodes, bande ±%u %%\n\n",
+                MEASURE_WINDOW_MS, N_PERIODS, TOLERANCE_PERCENT);
+
+    for (uint32_t f : freqs) {
+        Stats counting, reciprocal;
+        for (int t = 0; t < TRIALS; t++) {
+            std::vector<uint64_t> edges = makeTrace(f, rng);
+            runCounting(edges, f, counting);
+            runReciprocal(edges, f, reciprocal);
+        }
+        std::printf("%u Hz\n", f);
+        counting.report("comptage");
+        reciprocal.report("reciproque");
+    }
+    return 0;
+}
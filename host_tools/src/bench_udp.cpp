@@ -0,0 +1,290 @@
+// =============================================================================
+// bench_udp.cpp — Transport UDP tireur → central sur localhost
+// =============================================================================
+//
+// Deux PosixUdpLink sur 127.0.0.1 dans le meme processus (meme horloge) :
+// le tireur envoie par TouchSender, le central recoit par TouchReceiver et
+// acquitte. L'injecteur degrade les DEUX sens (evenements et acquittements)
+// avec la meme loi.
+//
+// Scenarios : sans perte, 5 %, 20 % de pertes independantes, rafales
+// (pertes 5 %, puis 60 % tant que la precedente est perdue), tous avec
+// 1 ms de latence + 0..2 ms de gigue. Evenements espaces de 2 a 6 ms,
+// bien plus serres qu'en assaut, pour charger la file d'envoi.
+//
+// Par scenario : livres (uniques) / envoyes, doublons ecartes par le
+// central, latence premiere reception p50 / p99 / max, copies par
+// evenement, pire acquittement, abandons ; et, pour comparaison, la
+// livraison d'un envoi unique sans acquittement sous la meme loi.
+//
+// Redemarrage du tireur : REBOOT_EVENTS evenements, silence, puis le
+// tireur repart (nouveau TouchSender, seq de nouveau a 0, donc dans les 64
+// derniers numeros vus par le central, nouvelle session dans la trame) pour
+// REBOOT_EVENTS autres.
+//
+// Verifie : tout est livre avant LINK_DEADLINE_US dans tous les scenarios,
+// aucun abandon, aucun doublon remonte par le central ; au redemarrage,
+// les evenements de la nouvelle session sont tous remontes, et le central
+// compte une seule nouvelle session. Les latences sont mesurees en temps
+// reel : sur un hote charge elles comprennent l'ordonnancement (quelques
+// ms), elles ne sont donc qu'affichees. Attendu :
+// p99 avant la premiere relance tant que la perte de toutes les copies est
+// rare (5 % : 0.05^3) ; a 20 % (0.2^3 = 0.8 %) le p99 tombe sur la relance.
+//
+// USAGE : program udpbench [evenements par scenario, defaut 500]
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <touch_link.h>
+#include <udp_link.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t DELAY_US  = 1000;
+const uint32_t JITTER_US = 2000;
+const uint32_t LOOP_SLEEP_US = 100;   // tour de boucle ; l'attente active se fait brider
+const int      REBOOT_EVENTS = 20;
+
+struct Scenario {
+    const char* name;
+    uint16_t    lossPermille;
+    uint16_t    burstPermille;
+};
+
+const Scenario SCENARIOS[] = {
+    { "sans perte",       0,   0   },
+    { "pertes 5 %",       50,  50  },
+    { "pertes 20 %",      200, 200 },
+    { "rafales 5 / 60 %", 50,  600 },
+};
+
+struct Result {
+    int      sent = 0, unique = 0, surfaced = 0, single = 0;
+    uint32_t duplicates = 0, losses = 0;
+    LinkStats stats;
+    std::vector<uint32_t> latencies;
+};
+
+bool openPair(PosixUdpLink& fencer, PosixUdpLink& central) {
+    if (!fencer.begin(0) || !central.begin(0)) {
+        std::printf("socket UDP localhost indisponible\n");
+        return false;
+    }
+    fencer.setPeer({ ipv4(127, 0, 0, 1), central.localPort() });
+    return true;
+}
+
+Result run(const Scenario& sc, int events, uint32_t seed) {
+    Result r;
+    PosixUdpLink fencer, central;
+    if (!openPair(fencer, central))
+        return r;
+
+    LinkImpairment imp;
+    imp.lossPermille  = sc.lossPermille;
+    imp.burstPermille = sc.burstPermille;
+    imp.delayUs       = DELAY_US;
+    imp.jitterUs      = JITTER_US;
+    fencer.setImpairment(imp, seed);
+    central.setImpairment(imp, seed * 7 + 1);
+
+    TouchSender<PosixUdpLink>   sender(fencer);
+    TouchReceiver<PosixUdpLink> receiver(central);
+
+    std::mt19937 rng(seed);
+    std::vector<bool> seen(events, false);
+    uint64_t next = PosixUdpLink::clockUs();
+    uint16_t seq  = 0;
+
+    for (;;) {
+        uint64_t now = PosixUdpLink::clockUs();
+        if (r.sent < events && now >= next) {
+            TouchEvent ev = {};
+            ev.type   = FencerEventType::TOUCH;
+            ev.player = PLAYER_A;
+            ev.cls    = FreqClass::VALID_B;
+            ev.seq    = seq++;
+            ev.tUs    = now;
+            if (sender.send(ev, now))
+                r.sent++;
+            next = now + std::uniform_int_distribution<uint32_t>(2000, 6000)(rng);
+        }
+        sender.poll(now);
+
+        LinkMessage msg;
+        while (central.poll(msg)) {
+            if (msg.kind != LinkKind::EVENT || !receiver.onEvent(msg.ev, msg.from))
+                continue;
+            r.surfaced++;
+            if (msg.ev.seq < events && !seen[msg.ev.seq]) {
+                seen[msg.ev.seq] = true;
+                r.unique++;
+                r.latencies.push_back((uint32_t)(PosixUdpLink::clockUs() - msg.ev.tUs));
+            }
+        }
+        while (fencer.poll(msg))
+            if (msg.kind == LinkKind::ACK)
+                sender.onAck(msg.player, msg.seq, PosixUdpLink::clockUs());
+
+        if (r.sent == events && sender.inFlight() == 0)
+            break;
+        std::this_thread::sleep_for(std::chrono::microseconds(LOOP_SLEEP_US));
+    }
+
+    // Les copies encore en route arrivent apres l'acquittement : les ecouler
+    uint64_t drain = PosixUdpLink::clockUs() + DELAY_US + JITTER_US + 1000;
+    while (PosixUdpLink::clockUs() < drain) {
+        LinkMessage msg;
+        while (central.poll(msg))
+            if (msg.kind == LinkKind::EVENT && receiver.onEvent(msg.ev, msg.from))
+                r.surfaced++;
+        fencer.poll(msg);
+    }
+
+    r.duplicates = receiver.duplicates();
+    r.losses     = fencer.injectedLosses() + central.injectedLosses();
+    r.stats      = sender.stats();
+    return r;
+}
+
+// Redemarrage : deux sessions successives du meme tireur, seq de 0 a
+// REBOOT_EVENTS - 1 dans chacune. Rend le nombre d'evenements remontes par
+// le central (value : numero global de l'evenement).
+struct RebootResult {
+    int      surfaced = 0;
+    uint32_t duplicates = 0, restarts = 0;
+};
+
+RebootResult runReboot(uint32_t before, uint32_t after) {
+    RebootResult r;
+    PosixUdpLink fencer, central;
+    if (!openPair(fencer, central))
+        return r;
+    TouchReceiver<PosixUdpLink> receiver(central);
+    std::vector<bool> seen(2 * REBOOT_EVENTS, false);
+
+    auto pump = [&](TouchSender<PosixUdpLink>& sender, uint64_t untilUs) {
+        while (PosixUdpLink::clockUs() < untilUs) {
+            sender.poll(PosixUdpLink::clockUs());
+            LinkMessage msg;
+            while (central.poll(msg))
+                if (msg.kind == LinkKind::EVENT && receiver.onEvent(msg.ev, msg.from) &&
+                    msg.ev.value < seen.size() && !seen[msg.ev.value]) {
+                    seen[msg.ev.value] = true;
+                    r.surfaced++;
+                }
+            while (fencer.poll(msg))
+                if (msg.kind == LinkKind::ACK)
+                    sender.onAck(msg.player, msg.seq, PosixUdpLink::clockUs());
+            std::this_thread::sleep_for(std::chrono::microseconds(LOOP_SLEEP_US));
+        }
+    };
+
+    const uint32_t sessions[2] = { before, after };
+    for (int boot = 0; boot < 2; boot++) {
+        TouchSender<PosixUdpLink> sender(fencer);     // demarrage : file vide
+        sender.setSession(sessions[boot]);
+        for (int i = 0; i < REBOOT_EVENTS; i++) {
+            TouchEvent ev = {};
+            ev.type   = FencerEventType::TOUCH;
+            ev.player = PLAYER_A;
+            ev.cls    = FreqClass::VALID_B;
+            ev.seq    = (uint16_t)i;
+            ev.value  = (uint32_t)(boot * REBOOT_EVENTS + i);
+            ev.tUs    = PosixUdpLink::clockUs();
+            sender.send(ev, ev.tUs);
+            pump(sender, PosixUdpLink::clockUs() + 2000);
+        }
+        // Dernieres copies et acquittements ecoules avant le redemarrage
+        pump(sender, PosixUdpLink::clockUs() + LINK_SPACING_US * LINK_COPIES + 5000);
+    }
+    r.duplicates = receiver.duplicates();
+    r.restarts   = receiver.restarts();
+    return r;
+}
+
+// Reference : un datagramme par evenement, ni copie ni acquittement
+int runSingle(const Scenario& sc, int events, uint32_t seed) {
+    PosixUdpLink fencer, central;
+    if (!openPair(fencer, central))
+        return 0;
+    LinkImpairment imp;
+    imp.lossPermille  = sc.lossPermille;
+    imp.burstPermille = sc.burstPermille;
+    fencer.setImpairment(imp, seed);
+
+    int received = 0;
+    TouchEvent ev = {};
+    ev.type   = FencerEventType::TOUCH;
+    ev.player = PLAYER_A;
+    LinkMessage msg;
+    for (int i = 0; i < events; i++) {
+        ev.seq = (uint16_t)i;
+        fencer.sendEvent(ev);
+        while (central.poll(msg)) received++;
+    }
+    uint64_t drain = PosixUdpLink::clockUs() + 2000;
+    while (PosixUdpLink::clockUs() < drain)
+        while (central.poll(msg)) received++;
+    return received;
+}
+
+uint32_t pct(const std::vector<uint32_t>& v, int p) {
+    return v.empty() ? 0 : v[std::min(v.size() - 1, v.size() * p / 100)];
+}
+
+}  // namespace
+
+int benchUdp(int argc, char** argv) {
+    int events = argc >= 1 ? std::atoi(argv[0]) : 500;
+    if (events <= 0) events = 500;
+    if (events > 60000) events = 60000;
+
+    std::printf("UDP localhost : %u copies a %u us, relance %u us, abandon a %u ms\n",
+                LINK_COPIES, LINK_SPACING_US, LINK_RETRY_US, LINK_DEADLINE_US / 1000);
+    std::printf("latence injectee %u us + 0..%u us, %d evenements par scenario\n\n",
+                DELAY_US, JITTER_US, events);
+    std::printf("  %-17s %9s %6s %6s %6s %6s %6s %7s %6s %8s\n", "scenario", "livres",
+                "doubl", "p50", "p99", "max", "copies", "ack max", "aband", "simple");
+
+    bool ok = true;
+    uint32_t seed = 1;
+    for (const Scenario& sc : SCENARIOS) {
+        Result r = run(sc, events, seed);
+        int single = runSingle(sc, events, seed);
+        seed++;
+
+        std::sort(r.latencies.begin(), r.latencies.end());
+        char delivered[16];
+        std::snprintf(delivered, sizeof delivered, "%d/%d", r.unique, r.sent);
+        std::printf("  %-17s %9s %6u %6u %6u %6u %6.2f %7u %6u %7.1f%%\n", sc.name, delivered,
+                    r.duplicates, pct(r.latencies, 50), pct(r.latencies, 99),
+                    r.latencies.empty() ? 0 : r.latencies.back(),
+                    r.sent ? (double)r.stats.datagrams / r.sent : 0.0, r.stats.ackMaxUs,
+                    r.stats.expired, 100.0 * single / events);
+
+        ok = ok && r.sent == events && r.unique == events && r.surfaced == r.unique &&
+             r.stats.expired == 0 && r.latencies.back() < LINK_DEADLINE_US;
+    }
+
+    RebootResult reboot = runReboot(0x1234ABCDu, 0x5678EF01u);
+    std::printf("\n  redemarrage du tireur apres %d evenements, seq de nouveau a 0 :\n",
+                REBOOT_EVENTS);
+    std::printf("    %2d/%d remontes | nouvelles sessions %u | doublons %u\n",
+                reboot.surfaced, 2 * REBOOT_EVENTS, reboot.restarts, reboot.duplicates);
+    ok = ok && reboot.surfaced == 2 * REBOOT_EVENTS && reboot.restarts == 1;
+
+    std::printf("\nlatence : envoi → premiere reception au central (us) | copies : datagrammes\n"
+                "par evenement | simple : livraison d'un envoi unique sans acquittement\n");
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
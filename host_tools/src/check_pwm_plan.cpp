@@ -0,0 +1,82 @@
+// =============================================================================
+// check_pwm_plan.cpp — Verification du planificateur PWM (pwm_planner.h)
+// =============================================================================
+//
+// Pour chaque frequence entiere de [min, max] (defaut 500 Hz - 50 kHz) a
+// clk (defaut 125 MHz, recherche en 32 bits ; au-dela de ~260 MHz, p. ex.
+// 300000000, c'est le repli 64 bits qui est verifie) : le plan doit exister, respecter les bornes materielles
+// (diviseur 8.4 dans [1, 256[, TOP dans [2, 65536]) et etre le meilleur
+// couple (aucun autre couple diviseur/TOP plus proche, recherche exhaustive
+// de controle). Affiche le nombre de frequences exactes et l'erreur max.
+// =============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <pwm_planner.h>
+
+using namespace fencing;
+
+namespace {
+
+// Recherche exhaustive de controle : meilleure erreur de periode possible
+uint64_t bruteForceBestErr(uint32_t clkHz, uint32_t freqHz) {
+    const uint64_t clk16 = (uint64_t)clkHz * 16u;
+    uint64_t best = ~(uint64_t)0;
+    for (uint32_t div16 = PWM_DIV16_MIN; div16 <= PWM_DIV16_MAX; div16++) {
+        uint64_t step = (uint64_t)div16 * freqHz;
+        uint64_t top = (clk16 + step / 2) / step;
+        for (uint64_t t = top ? top - 1 : 0; t <= top + 1; t++) {
+            if (t < PWM_TOP_MIN || t > PWM_TOP_MAX) continue;
+            uint64_t p = (uint64_t)div16 * t * freqHz;
+            uint64_t err = p > clk16 ? p - clk16 : clk16 - p;
+            if (err < best) best = err;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+int checkPwmPlan(int argc, char** argv) {
+    uint32_t fMin = argc > 0 ? (uint32_t)std::strtoul(argv[0], nullptr, 10) : 500;
+    uint32_t fMax = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : 50000;
+    const uint32_t clk = argc > 2 ? (uint32_t)std::strtoul(argv[2], nullptr, 10) : SYS_CLK_NOMINAL_HZ;
+    const uint64_t clk16 = (uint64_t)clk * 16u;
+
+    uint32_t exact = 0, failures = 0;
+    int32_t  worstErr = 0;
+    uint32_t worstFreq = 0;
+
+    for (uint32_t f = fMin; f <= fMax; f++) {
+        PwmPlan plan = planPwm(clk, f);
+        bool bounds = plan.ok &&
+                      plan.div16 >= PWM_DIV16_MIN && plan.div16 <= PWM_DIV16_MAX &&
+                      plan.top >= PWM_TOP_MIN && plan.top <= PWM_TOP_MAX;
+        if (!bounds) {
+            std::printf("  ECHEC %u Hz : pas de plan valide\n", f);
+            failures++;
+            continue;
+        }
+        uint64_t p = (uint64_t)plan.div16 * plan.top * f;
+        uint64_t err = p > clk16 ? p - clk16 : clk16 - p;
+        if (err != bruteForceBestErr(clk, f)) {
+            std::printf("  ECHEC %u Hz : div16=%u TOP=%u n'est pas optimal\n",
+                        f, plan.div16, plan.top);
+            failures++;
+        }
+        if (plan.exact()) exact++;
+        int32_t absErr = plan.errorMilliHz < 0 ? -plan.errorMilliHz : plan.errorMilliHz;
+        if (absErr > worstErr) {
+            worstErr = absErr;
+            worstFreq = f;
+        }
+    }
+
+    uint32_t total = fMax - fMin + 1;
+    std::printf("Planificateur PWM a %u Hz, %u a %u Hz (%u frequences)\n", clk, fMin, fMax, total);
+    std::printf("  exactes       : %u\n", exact);
+    std::printf("  erreur max    : %d.%03d Hz (a %u Hz)\n", worstErr / 1000, worstErr % 1000, worstFreq);
+    std::printf("  echecs        : %u\n", failures);
+    return failures ? 1 : 0;
+}
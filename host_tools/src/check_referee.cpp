@@ -0,0 +1,484 @@
+// =============================================================================
+// check_referee.cpp — Arbitrage du central : scenarios, rejeu, temps de decision
+// =============================================================================
+//
+// SCENARIOS : phrases d'armes ecrites a la main (touche seule, coup double,
+// touche hors verrouillage, blanche, blanche tenue 400 ms et 2 s, propre
+// cuirasse, NEUTRE, appui court, arrivees dans le desordre, touche tardive,
+// affichage, tireur non synchronise) avec le verdict attendu.
+//
+// DETERMINISME : un assaut aleatoire (phrases toutes les 2.5 a 5 s, touches
+// valides / blanches / propre cuirasse, appuis de 20 a 400 ms, ecarts A-B
+// de ±400 ms, transport de 1 a 5 ms avec 3 % de relances jusqu'a 120 ms,
+// 5 % d'evenements non synchronises) est arbitre :
+//   - sans poll() entre les evenements, puis avec poll() toutes les 1 ms et
+//     toutes les 137 µs : memes sorties, lampe par lampe
+//   - via son journal (formatEventLog / parseEventLog) : memes verdicts que
+//     les lignes VD du journal
+//
+// TEMPS DE DECISION : chaque onEvent() et chaque poll() qui rend un verdict
+// est chronometre sur l'hote (p50 / p99 / max). Sur le central, STATUS
+// affiche le pire cas mesure sur cible.
+//
+// USAGE : program referee [phrases, defaut 2000] [journal a ecrire]
+//         program refreplay <journal>   (lignes EV / VD, cf. referee.h)
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <referee.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t SYNC_UNCERTAINTY_US = 300;
+const uint32_t BENCH_ROUNDS        = 20;
+
+struct Arrival {
+    uint64_t   atUs;
+    TouchEvent ev;
+};
+
+// Sorties en texte, pour comparer deux arbitrages ligne a ligne
+struct TextSink {
+    std::vector<std::string> lines;
+    bool push(const RefereeOutput& o) {
+        char buf[REFEREE_LOG_LINE];
+        if (o.kind == RefereeOutputKind::VERDICT) {
+            formatVerdictLog(o, buf, sizeof buf);
+        } else {
+            std::snprintf(buf, sizeof buf, "LT,%llu,%u,%u,%llu\n", (unsigned long long)o.atUs,
+                          o.player, (unsigned)o.lamp, (unsigned long long)o.hitUs);
+        }
+        lines.push_back(buf);
+        return true;
+    }
+};
+
+struct VerdictSink {
+    std::vector<RefereeOutput> verdicts;
+    bool push(const RefereeOutput& o) {
+        if (o.kind == RefereeOutputKind::VERDICT) verdicts.push_back(o);
+        return true;
+    }
+};
+
+struct CountSink {
+    uint32_t lights = 0, verdicts = 0;
+    bool push(const RefereeOutput& o) {
+        if (o.kind == RefereeOutputKind::VERDICT) verdicts++;
+        else lights++;
+        return true;
+    }
+};
+
+TouchEvent makeEvent(uint8_t player, FencerEventType type, FreqClass cls, uint64_t tUs,
+                     uint32_t value, bool synced = true) {
+    TouchEvent ev = {};
+    ev.type   = type;
+    ev.player = player;
+    ev.cls    = cls;
+    ev.tUs    = tUs;
+    ev.value  = value;
+    ev.syncUs = synced ? SYNC_UNCERTAINTY_US : TOUCH_SYNC_NONE;
+    return ev;
+}
+
+FreqClass opponent(uint8_t player) {
+    return player == PLAYER_A ? FreqClass::VALID_B : FreqClass::VALID_A;
+}
+
+FreqClass own(uint8_t player) {
+    return player == PLAYER_A ? FreqClass::VALID_A : FreqClass::VALID_B;
+}
+
+// -----------------------------------------------------------------------------
+// Scenarios
+// -----------------------------------------------------------------------------
+struct Step {
+    uint32_t        arrivalMs;
+    uint8_t         player;
+    FencerEventType type;
+    char            target;     // 'o' adverse, 's' propre cuirasse, 'n' NONE, 'u' NEUTRE
+    uint32_t        tMs;        // DWELL : dwell acquis (blanche : appui + 15 ms) ;
+                                // TOUCH : relachement
+    uint32_t        pressMs;    // TOUCH : duree d'appui
+    bool            synced;
+};
+
+struct Scenario {
+    const char* name;
+    Step        steps[6];
+    size_t      count;
+    const char* expected;       // verdicts separes par '|'
+};
+
+const FencerEventType DW = FencerEventType::DWELL;
+const FencerEventType TO = FencerEventType::TOUCH;
+
+const Scenario SCENARIOS[] = {
+    { "touche A seule",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1102, PLAYER_A, TO, 'o', 1100, 115, true } },
+      2, "TOUCHE A" },
+    { "coup double a 200 ms",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1204, PLAYER_B, DW, 'o', 1200, 0, true } },
+      2, "COUP DOUBLE" },
+    { "B a 300 ms (limite)",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1302, PLAYER_B, DW, 'o', 1300, 0, true } },
+      2, "COUP DOUBLE" },
+    { "B a 301 ms (verrouille)",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1303, PLAYER_B, DW, 'o', 1301, 0, true } },
+      2, "TOUCHE A" },
+    { "blanche A (appui 40 ms)",
+      { { 1017, PLAYER_A, DW, 'n', 1015, 0, true }, { 1042, PLAYER_A, TO, 'n', 1040, 40, true } },
+      2, "BLANCHE A" },
+    { "blanche A (appui 400 ms)",
+      // relachement apres l'echeance de la phrase : la blanche est deja la
+      { { 1017, PLAYER_A, DW, 'n', 1015, 0, true }, { 1402, PLAYER_A, TO, 'n', 1400, 400, true } },
+      2, "BLANCHE A" },
+    { "blanche A (2 s) + touche B",
+      { { 1017, PLAYER_A, DW, 'n', 1015, 0, true }, { 1203, PLAYER_B, DW, 'o', 1200, 0, true },
+        { 3002, PLAYER_A, TO, 'n', 3000, 2000, true } },
+      3, "DEUX LAMPES" },
+    { "blanche A + touche B",
+      { { 1017, PLAYER_A, DW, 'n', 1015, 0, true }, { 1103, PLAYER_B, DW, 'o', 1100, 0, true } },
+      2, "DEUX LAMPES" },
+    { "relachement seul (sans DWELL)",
+      { { 1402, PLAYER_A, TO, 'n', 1400, 400, true } }, 1, "" },
+    { "propre cuirasse B",
+      { { 1003, PLAYER_B, DW, 's', 1000, 0, true } }, 1, "BLANCHE B" },
+    { "coque / piste, appui court",
+      { { 1052, PLAYER_A, TO, 'u', 1050, 50, true }, { 1202, PLAYER_B, TO, 'n', 1200, 10, true } },
+      2, "" },
+    { "B arrive avant A, plus ancien",
+      // B date 1420 recu d'abord ; A date 1100 recu en retard : B hors fenetre
+      { { 1425, PLAYER_B, DW, 'o', 1420, 0, true }, { 1440, PLAYER_A, DW, 'o', 1100, 0, true } },
+      2, "TOUCHE A" },
+    { "B tardif (apres l'echeance)",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1400, PLAYER_B, DW, 'o', 1250, 0, true } },
+      2, "TOUCHE A" },
+    { "2e touche de A ignoree",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 1153, PLAYER_A, DW, 's', 1150, 0, true } },
+      2, "TOUCHE A" },
+    { "affichage puis nouvelle phrase",
+      { { 1003, PLAYER_A, DW, 'o', 1000, 0, true }, { 2003, PLAYER_B, DW, 'o', 2000, 0, true },
+        { 4003, PLAYER_B, DW, 'o', 4000, 0, true } },
+      3, "TOUCHE A|TOUCHE B" },
+    { "tireurs non synchronises",
+      // dates a l'arrivee : B a 150 ms de A
+      { { 1003, PLAYER_A, DW, 'o', 77, 0, false }, { 1153, PLAYER_B, DW, 'o', 9999, 0, false } },
+      2, "COUP DOUBLE" },
+};
+
+std::string runScenario(const Scenario& sc) {
+    Referee referee;
+    VerdictSink sink;
+    uint64_t last = 0;
+    for (size_t i = 0; i < sc.count; i++) {
+        const Step& s = sc.steps[i];
+        FreqClass cls = s.target == 'o' ? opponent(s.player)
+                      : s.target == 's' ? own(s.player)
+                      : s.target == 'u' ? FreqClass::NEUTRE : FreqClass::NONE;
+        last = (uint64_t)s.arrivalMs * 1000u;
+        referee.onEvent(makeEvent(s.player, s.type, cls, (uint64_t)s.tMs * 1000u,
+                                  s.pressMs * 1000u, s.synced),
+                        last, sink);
+    }
+    referee.poll(last + 10000000u, sink);
+
+    std::string text;
+    for (const RefereeOutput& v : sink.verdicts) {
+        if (!text.empty()) text += "|";
+        text += verdictText(v);
+    }
+    return text;
+}
+
+// -----------------------------------------------------------------------------
+// Assaut aleatoire
+// -----------------------------------------------------------------------------
+std::vector<Arrival> randomBout(int phrases, uint32_t seed) {
+    std::mt19937 rng(seed);
+    auto uni = [&](int64_t lo, int64_t hi) {
+        return std::uniform_int_distribution<int64_t>(lo, hi)(rng);
+    };
+    auto chance = [&](int percent) { return uni(0, 99) < percent; };
+    auto transport = [&]() -> uint64_t {
+        return chance(3) ? (uint64_t)uni(8000, 120000) : (uint64_t)uni(1000, 5000);
+    };
+
+    std::vector<Arrival> out;
+    auto emit = [&](uint64_t atUs, TouchEvent ev) {
+        if (chance(5)) {
+            ev.tUs    = ev.tUs + 1000000000ull;     // horloge locale quelconque
+            ev.syncUs = TOUCH_SYNC_NONE;
+        }
+        out.push_back({ atUs, ev });
+    };
+
+    uint64_t t = 1000000;
+    uint16_t seq[2] = { 0, 0 };
+    for (int n = 0; n < phrases; n++) {
+        t += (uint64_t)uni(2500000, 5000000);
+        for (uint8_t player = PLAYER_A; player <= PLAYER_B; player++) {
+            if (!chance(70)) continue;
+            int64_t offset = player == PLAYER_A ? 0 : uni(-400000, 400000);
+            uint64_t contact = (uint64_t)((int64_t)t + offset);
+            uint32_t press   = (uint32_t)uni(20000, 400000);
+            uint64_t release = contact + press;
+            int kind = (int)uni(0, 9);
+            uint16_t& s = seq[player - 1];
+
+            if (kind <= 7) {
+                FreqClass cls = kind < 7 ? opponent(player) : own(player);
+                TouchEvent dwell = makeEvent(player, DW, cls, contact + DWELL_MIN_US, 0);
+                dwell.seq = s++;
+                emit(contact + DWELL_MIN_US + transport(), dwell);
+                TouchEvent touch = makeEvent(player, TO, cls, release, press);
+                touch.seq = s++;
+                emit(release + transport(), touch);
+            } else {
+                FreqClass cls = kind == 8 ? FreqClass::NONE : FreqClass::NEUTRE;
+                if (cls == FreqClass::NONE) {
+                    // Blanche : declaree par le tireur 15 ms apres l'appui
+                    TouchEvent blank = makeEvent(player, DW, cls, contact + DWELL_MIN_US, 0);
+                    blank.seq = s++;
+                    emit(contact + DWELL_MIN_US + transport(), blank);
+                }
+                TouchEvent touch = makeEvent(player, TO, cls, release, press);
+                touch.seq = s++;
+                emit(release + transport(), touch);
+            }
+        }
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const Arrival& a, const Arrival& b) { return a.atUs < b.atUs; });
+    return out;
+}
+
+// Arbitre la suite d'arrivees, poll() toutes les pollUs (0 : jamais entre
+// les evenements)
+std::vector<std::string> arbitrate(const std::vector<Arrival>& bout, uint64_t pollUs,
+                                   std::string* log = nullptr) {
+    Referee referee;
+    TextSink sink;
+    uint64_t now = 0;
+    size_t seen = 0;
+    char line[REFEREE_LOG_LINE];
+
+    auto flushLog = [&]() {
+        for (; log && seen < sink.lines.size(); seen++)
+            if (sink.lines[seen][0] == 'V') *log += sink.lines[seen];
+    };
+
+    for (const Arrival& a : bout) {
+        if (pollUs) {
+            for (now += pollUs; now < a.atUs; now += pollUs)
+                referee.poll(now, sink);
+            now = a.atUs;
+        }
+        // Le central journalise l'evenement, puis l'arbitre
+        if (log && formatEventLog(a.ev, a.atUs, line, sizeof line))
+            *log += line;
+        referee.onEvent(a.ev, a.atUs, sink);
+        flushLog();
+    }
+    referee.poll(bout.empty() ? 0 : bout.back().atUs + 10000000u, sink);
+    flushLog();
+    return sink.lines;
+}
+
+// Rejoue un journal ; compare aux lignes VD s'il y en a
+struct Replay {
+    size_t events = 0, recorded = 0, matched = 0;
+    std::vector<RefereeOutput> verdicts;
+    RefereeStats stats;
+};
+
+Replay replayLog(const std::vector<std::string>& lines) {
+    Replay r;
+    Referee referee;
+    VerdictSink sink;
+    std::vector<RefereeOutput> recorded;
+    uint64_t last = 0;
+    for (const std::string& l : lines) {
+        TouchEvent ev;
+        uint64_t arrival;
+        RefereeOutput v;
+        if (parseEventLog(l.c_str(), ev, arrival)) {
+            referee.onEvent(ev, arrival, sink);
+            last = arrival;
+            r.events++;
+        } else if (parseVerdictLog(l.c_str(), v)) {
+            recorded.push_back(v);
+        }
+    }
+    referee.poll(last + 10000000u, sink);
+    r.verdicts = sink.verdicts;
+    r.recorded = recorded.size();
+    for (size_t i = 0; i < recorded.size() && i < r.verdicts.size(); i++) {
+        const RefereeOutput& a = recorded[i];
+        const RefereeOutput& b = r.verdicts[i];
+        if (a.atUs == b.atUs && a.lampA == b.lampA && a.lampB == b.lampB && a.hitUs == b.hitUs &&
+            a.gapUs == b.gapUs)
+            r.matched++;
+    }
+    r.stats = referee.stats();
+    return r;
+}
+
+std::vector<std::string> splitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+uint32_t pct(std::vector<uint32_t>& v, int p) {
+    return v.empty() ? 0 : v[std::min(v.size() - 1, v.size() * p / 100)];
+}
+
+}  // namespace
+
+int checkReferee(int argc, char** argv) {
+    int phrases = argc >= 1 ? std::atoi(argv[0]) : 2000;
+    if (phrases <= 0) phrases = 2000;
+    bool ok = true;
+
+    std::printf("Arbitrage : verrouillage %u ms, grace %u ms, affichage %u ms\n\n",
+                LOCKOUT_US / 1000, REFEREE_GRACE_US / 1000, REFEREE_HOLD_US / 1000);
+
+    // Scenarios
+    std::printf("Scenarios\n");
+    for (const Scenario& sc : SCENARIOS) {
+        std::string got = runScenario(sc);
+        bool pass = got == sc.expected;
+        ok = ok && pass;
+        std::printf("  %-32s %-20s %s\n", sc.name, got.empty() ? "(aucun)" : got.c_str(),
+                    pass ? "ok" : "ECHEC");
+        if (!pass) std::printf("    attendu : %s\n", sc.expected);
+    }
+
+    // Determinisme
+    std::vector<Arrival> bout = randomBout(phrases, 14);
+    std::string log;
+    std::vector<std::string> ref = arbitrate(bout, 0, &log);
+    bool sameCadence = arbitrate(bout, 1000) == ref && arbitrate(bout, 137) == ref;
+    Replay replay = replayLog(splitLines(log));
+    bool sameReplay = replay.recorded > 0 && replay.matched == replay.recorded &&
+                      replay.verdicts.size() == replay.recorded;
+    ok = ok && sameCadence && sameReplay;
+
+    uint32_t doubles = 0, whites = 0;
+    for (const RefereeOutput& v : replay.verdicts) {
+        if (v.lampA == Lamp::VALID && v.lampB == Lamp::VALID) doubles++;
+        if (v.lampA == Lamp::OFF_TARGET || v.lampB == Lamp::OFF_TARGET) whites++;
+    }
+    const RefereeStats& st = replay.stats;
+    std::printf("\nAssaut aleatoire : %d phrases, %zu evenements\n", phrases, bout.size());
+    std::printf("  verdicts %u (coups doubles %u, avec blanche %u)\n", st.verdicts, doubles,
+                whites);
+    std::printf("  touches %u | ignores %u | verrouilles %u | repetees %u | tardives %u | "
+                "corrections %u | non synchro %u\n", st.hits, st.ignored, st.locked,
+                st.repeated, st.late, st.corrections, st.unsynced);
+    std::printf("  poll() a 1 ms / 137 us : %s\n", sameCadence ? "memes sorties" : "DIFFERENT");
+    std::printf("  rejeu du journal       : %zu / %zu verdicts identiques\n", replay.matched,
+                replay.recorded);
+
+    if (argc >= 2) {
+        FILE* out = std::fopen(argv[1], "w");
+        if (out) {
+            std::fputs(log.c_str(), out);
+            std::fclose(out);
+            std::printf("  journal ecrit : %s\n", argv[1]);
+        } else {
+            std::printf("  impossible d'ecrire %s\n", argv[1]);
+        }
+    }
+
+    // Temps de decision
+    std::vector<uint32_t> eventNs, verdictNs;
+    CountSink count;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        Referee referee;
+        for (const Arrival& a : bout) {
+            uint32_t before = count.verdicts;
+            auto t0 = std::chrono::steady_clock::now();
+            referee.poll(a.atUs, count);
+            auto t1 = std::chrono::steady_clock::now();
+            referee.onEvent(a.ev, a.atUs, count);
+            auto t2 = std::chrono::steady_clock::now();
+            if (count.verdicts != before)
+                verdictNs.push_back(
+                    (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            eventNs.push_back(
+                (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+        }
+    }
+    std::sort(eventNs.begin(), eventNs.end());
+    std::sort(verdictNs.begin(), verdictNs.end());
+    std::printf("\nTemps de decision (hote, horloge comprise, %u passes)\n", BENCH_ROUNDS);
+    std::printf("  onEvent()          p50 %5u ns | p99 %5u ns | max %7u ns\n", pct(eventNs, 50),
+                pct(eventNs, 99), eventNs.empty() ? 0 : eventNs.back());
+    std::printf("  poll() -> verdict  p50 %5u ns | p99 %5u ns | max %7u ns\n",
+                pct(verdictNs, 50), pct(verdictNs, 99), verdictNs.empty() ? 0 : verdictNs.back());
+    std::printf("  etat : %zu octets, aucune allocation\n", sizeof(Referee));
+
+    // p99 en µs ; le max depend de l'ordonnanceur de l'hote
+    ok = ok && pct(eventNs, 99) < 1000 && pct(verdictNs, 99) < 1000;
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
+
+int replayReferee(int argc, char** argv) {
+    if (argc < 1) {
+        std::printf("usage : program refreplay <journal>\n");
+        return 1;
+    }
+    FILE* in = std::fopen(argv[0], "r");
+    if (!in) {
+        std::printf("impossible d'ouvrir %s\n", argv[0]);
+        return 1;
+    }
+    std::vector<std::string> lines;
+    char line[256];
+    while (std::fgets(line, sizeof line, in)) {
+        // Journal capture sur Serial : la ligne peut etre prefixee
+        const char* p = std::strstr(line, "EV,");
+        if (!p) p = std::strstr(line, "VD,");
+        if (p) lines.push_back(p);
+    }
+    std::fclose(in);
+
+    Replay r = replayLog(lines);
+    for (const RefereeOutput& v : r.verdicts) {
+        std::printf("  %10.3f s  %-15s A %-7s B %-7s", v.atUs / 1e6, verdictText(v),
+                    lampText(v.lampA), lampText(v.lampB));
+        if (v.lampA != Lamp::NONE && v.lampB != Lamp::NONE)
+            std::printf("  ecart %+.1f ms", v.gapUs / 1000.0);
+        std::printf("\n");
+    }
+    std::printf("\n%zu evenements, %zu verdicts", r.events, r.verdicts.size());
+    if (r.recorded == 0) {
+        std::printf(" (journal sans verdicts)\n");
+        return 0;
+    }
+    bool ok = r.matched == r.recorded && r.verdicts.size() == r.recorded;
+    std::printf(", %zu / %zu identiques au journal\n\n%s\n", r.matched, r.recorded,
+                ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
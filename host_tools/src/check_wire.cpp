@@ -0,0 +1,304 @@
+// =============================================================================
+// check_wire.cpp — Trames TouchEvent : fuzz et debit
+// =============================================================================
+//
+// wirefuzz :
+//   1. aller-retour encode → decode sur des evenements aleatoires
+//   2. chaque erreur de 1 bit, et des erreurs aleatoires de 2 a 3 bits,
+//      sur chaque trame : jamais acceptees
+//   3. trames tronquees a toutes les longueurs : refusees
+//   4. octets aleatoires (magic et version forces une fois sur deux) dans
+//      un buffer de la taille exacte sur le tas : le decodeur ne lit jamais
+//      au-dela (a lancer avec -fsanitize=address) ; une trame aleatoire ne
+//      passe que si CRC (2^-16) et champs sont bons a la fois
+//   5. une seule longueur : trame annoncee plus longue ou plus courte
+//      (CRC recalcule a sa place), version differente, datagramme plus
+//      long que la trame, pbuf en deux maillons : refuses
+//   6. acquittements et synchro : aller-retour, erreurs de 1 bit refusees,
+//      une trame d'un autre type n'est pas acceptee
+//
+// wirebench : evenements/s en codage, decodage et aller-retour.
+//
+// USAGE : program wirefuzz [essais, defaut 200000]
+//         program wirebench
+// =============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <byte_order.h>
+#include <crc16.h>
+#include <touch_wire.h>
+
+using namespace fencing;
+
+namespace {
+
+TouchEvent randomEvent(std::mt19937_64& rng) {
+    TouchEvent ev = {};
+    ev.type   = (FencerEventType)(rng() % ((uint8_t)FencerEventType::DWELL + 1));
+    ev.player = rng() & 1 ? PLAYER_A : PLAYER_B;
+    ev.cls    = (FreqClass)(rng() % ((uint8_t)FreqClass::UNKNOWN + 1));
+    ev.seq    = (uint16_t)rng();
+    ev.tUs    = rng();
+    ev.freqHz = (uint32_t)rng();
+    ev.value  = (uint32_t)rng();
+    ev.syncUs = (uint16_t)rng();
+    ev.session = (uint32_t)rng();
+    // Estampilles du tireur : une fois sur quatre aucune, sinon etapes au hasard
+    if (rng() % 4) {
+        latencyAnchor(ev.lat, 0, rng() % LATENCY_NONE);
+        for (uint8_t i = 0; i < LATENCY_FENCER_STAGES; i++)
+            if (rng() & 1) latencySet(ev.lat, (LatencyStage)i, (uint32_t)(rng() % LATENCY_NONE));
+    }
+    return ev;
+}
+
+bool sameStamps(const LatencyStamps& a, const LatencyStamps& b) {
+    if (latencyAnchored(a) != latencyAnchored(b))
+        return false;
+    if (!latencyAnchored(a))
+        return true;
+    if (a.leadUs != b.leadUs)
+        return false;
+    for (uint8_t i = 0; i < LATENCY_FENCER_STAGES; i++)
+        if (latencyAt(a, (LatencyStage)i) != latencyAt(b, (LatencyStage)i))
+            return false;
+    return true;
+}
+
+bool sameEvent(const TouchEvent& a, const TouchEvent& b) {
+    return a.type == b.type && a.player == b.player && a.cls == b.cls && a.seq == b.seq &&
+           a.tUs == b.tUs && a.freqHz == b.freqHz && a.value == b.value && a.syncUs == b.syncUs &&
+           a.session == b.session && sameStamps(a.lat, b.lat);
+}
+
+// Maillon de pbuf lwIP, sans lwIP
+struct FakePbuf {
+    void*    payload;
+    uint16_t len;
+    uint16_t tot_len;
+};
+
+bool check(const char* what, bool ok) {
+    std::printf("  %-46s %s\n", what, ok ? "OK" : "ECHEC");
+    return ok;
+}
+
+}  // namespace
+
+int fuzzWire(int argc, char** argv) {
+    long trials = argc >= 1 ? std::atol(argv[0]) : 200000;
+    if (trials <= 0) trials = 200000;
+
+    std::mt19937_64 rng(11);
+    uint8_t frame[TOUCH_WIRE_SIZE];
+    bool ok = true;
+
+    std::printf("Trame TouchEvent v%u : %zu octets, %ld essais\n\n", TOUCH_WIRE_VERSION,
+                TOUCH_WIRE_SIZE, trials);
+
+    // 1-3. Aller-retour, erreurs de bits, troncatures
+    long roundTrip = 0, flips1 = 0, flipsN = 0, truncated = 0;
+    long acceptedFlips = 0, acceptedTrunc = 0;
+    for (long n = 0; n < trials; n++) {
+        TouchEvent ev = randomEvent(rng), back = {};
+        if (encodeTouchEvent(ev, frame, sizeof frame) != TOUCH_WIRE_SIZE ||
+            decodeTouchEvent(frame, sizeof frame, back) != WireStatus::OK || !sameEvent(ev, back))
+            roundTrip++;
+
+        if (n < trials / 20) {
+            for (size_t bit = 0; bit < TOUCH_WIRE_SIZE * 8; bit++) {
+                frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+                if (decodeTouchEvent(frame, sizeof frame, back) == WireStatus::OK) acceptedFlips++;
+                frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+                flips1++;
+            }
+            for (size_t len = 0; len < TOUCH_WIRE_SIZE; len++) {
+                if (decodeTouchEvent(frame, len, back) == WireStatus::OK) acceptedTrunc++;
+                truncated++;
+            }
+        }
+
+        uint8_t bad[TOUCH_WIRE_SIZE];
+        std::memcpy(bad, frame, sizeof bad);
+        int bits = 2 + (int)(rng() % 2);
+        size_t pos[3];
+        for (int b = 0; b < bits; b++) {
+            bool dup;
+            do {
+                pos[b] = rng() % (TOUCH_WIRE_SIZE * 8);
+                dup = false;
+                for (int k = 0; k < b; k++) dup = dup || pos[k] == pos[b];
+            } while (dup);
+            bad[pos[b] / 8] ^= (uint8_t)(1u << (pos[b] % 8));
+        }
+        if (decodeTouchEvent(bad, sizeof bad, back) == WireStatus::OK) acceptedFlips++;
+        flipsN++;
+    }
+    char what[80];
+    std::snprintf(what, sizeof what, "aller-retour (%ld)", trials);
+    ok = check(what, roundTrip == 0) && ok;
+    std::snprintf(what, sizeof what, "erreurs 1 bit (%ld) / 2-3 bits (%ld)", flips1, flipsN);
+    ok = check(what, acceptedFlips == 0) && ok;
+    std::snprintf(what, sizeof what, "troncatures (%ld)", truncated);
+    ok = check(what, acceptedTrunc == 0) && ok;
+
+    // 4. Octets aleatoires, buffer exact sur le tas
+    long accepted = 0, forced = 0;
+    for (long n = 0; n < trials * 5; n++) {
+        size_t len = rng() % 64;
+        uint8_t* buf = new uint8_t[len ? len : 1];
+        for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)rng();
+        if (len >= 3 && (n & 1)) {
+            buf[0] = TOUCH_WIRE_MAGIC;
+            buf[1] = TOUCH_WIRE_VERSION;
+            buf[2] = (uint8_t)(TOUCH_WIRE_SIZE + rng() % 8);
+            forced++;
+        }
+        TouchEvent out;
+        if (decodeTouchEvent(buf, len, out) == WireStatus::OK) accepted++;
+        delete[] buf;
+    }
+    std::printf("  %-46s %ld (dont %ld en-tetes valides)\n", "octets aleatoires acceptes",
+                accepted, forced);
+
+    // 5. Longueur exacte, version et pbuf
+    TouchEvent ev = randomEvent(rng), back = {};
+    uint8_t longer[TOUCH_WIRE_SIZE + 4];
+    encodeTouchEvent(ev, longer, sizeof longer);
+    std::memmove(longer + TOUCH_WIRE_SIZE + 2, longer + TOUCH_WIRE_SIZE - 2, 2);
+    longer[TOUCH_WIRE_SIZE - 2] = 0xAB;              // 4 octets de plus
+    longer[TOUCH_WIRE_SIZE - 1] = 0xCD;
+    longer[TOUCH_WIRE_SIZE]     = 0xEF;
+    longer[TOUCH_WIRE_SIZE + 1] = 0x01;
+    longer[2] = (uint8_t)sizeof longer;
+    put16(longer + sizeof longer - 2, crc16(longer, sizeof longer - 2));
+    ok = check("trame plus longue, CRC juste : refusee",
+               decodeTouchEvent(longer, sizeof longer, back) == WireStatus::BAD_LENGTH) && ok;
+
+    // Longueur annoncee plus courte, CRC recalcule a sa place
+    const size_t shorter[] = { 26, 28, 48 };
+    bool shortOk = true;
+    for (size_t size : shorter) {
+        encodeTouchEvent(ev, frame, sizeof frame);
+        frame[2] = (uint8_t)size;
+        put16(frame + size - 2, crc16(frame, size - 2));
+        shortOk = shortOk && decodeTouchEvent(frame, size, back) == WireStatus::BAD_LENGTH &&
+                  decodeTouchEvent(frame, sizeof frame, back) == WireStatus::BAD_LENGTH;
+    }
+    ok = check("trames de 26, 28 et 48 octets refusees", shortOk) && ok;
+
+    encodeTouchEvent(ev, frame, sizeof frame);
+    frame[1] = TOUCH_WIRE_VERSION + 1;
+    ok = check("version suivante refusee",
+               decodeTouchEvent(frame, sizeof frame, back) == WireStatus::BAD_VERSION) && ok;
+
+    encodeTouchEvent(ev, longer, sizeof longer);
+    ok = check("octets en trop apres la trame refuses",
+               decodeTouchEvent(longer, TOUCH_WIRE_SIZE + 1, back) == WireStatus::BAD_LENGTH) && ok;
+
+    FakePbuf p = { frame, (uint16_t)TOUCH_WIRE_SIZE, (uint16_t)TOUCH_WIRE_SIZE };
+    bool pbufOk = encodeTouchEvent(ev, &p) == TOUCH_WIRE_SIZE &&
+                  decodeTouchEvent(&p, back) == WireStatus::OK && sameEvent(ev, back);
+    p.len = 10;
+    pbufOk = pbufOk && decodeTouchEvent(&p, back) == WireStatus::TOO_SHORT;
+    ok = check("pbuf : un maillon accepte, deux refuses", pbufOk) && ok;
+
+    // 6. Acquittements
+    uint8_t ack[TOUCH_ACK_SIZE];
+    long ackBad = 0;
+    for (long n = 0; n < trials / 20; n++) {
+        uint8_t player = rng() & 1 ? PLAYER_A : PLAYER_B, gotPlayer = 0;
+        uint16_t seq = (uint16_t)rng(), gotSeq = 0;
+        if (encodeTouchAck(player, seq, ack, sizeof ack) != TOUCH_ACK_SIZE ||
+            decodeTouchAck(ack, sizeof ack, gotPlayer, gotSeq) != WireStatus::OK ||
+            gotPlayer != player || gotSeq != seq)
+            ackBad++;
+        for (size_t bit = 0; bit < TOUCH_ACK_SIZE * 8; bit++) {
+            ack[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            if (decodeTouchAck(ack, sizeof ack, gotPlayer, gotSeq) == WireStatus::OK) ackBad++;
+            ack[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        }
+    }
+    uint8_t p0; uint16_t s0;
+    ok = check("acquittements : aller-retour, erreurs 1 bit",
+               ackBad == 0 && decodeTouchAck(frame, sizeof frame, p0, s0) == WireStatus::BAD_MAGIC) && ok;
+
+    // Synchro : requete et reponse
+    uint8_t sync[SYNC_REPLY_SIZE];
+    long syncBad = 0;
+    for (long n = 0; n < trials / 20; n++) {
+        SyncExchange ex = { (uint8_t)(rng() & 1 ? PLAYER_A : PLAYER_B), (uint16_t)rng(), rng(),
+                            rng(), rng() }, got = {};
+        bool reply = n & 1;
+        size_t size = reply ? encodeSyncReply(ex, sync, sizeof sync)
+                            : encodeSyncRequest(ex, sync, sizeof sync);
+        auto decode = [&]() {
+            return reply ? decodeSyncReply(sync, size, got) : decodeSyncRequest(sync, size, got);
+        };
+        if (size != (reply ? SYNC_REPLY_SIZE : SYNC_REQUEST_SIZE) || decode() != WireStatus::OK ||
+            got.player != ex.player || got.seq != ex.seq || got.t1Us != ex.t1Us ||
+            (reply && (got.t2Us != ex.t2Us || got.t3Us != ex.t3Us)))
+            syncBad++;
+        for (size_t bit = 0; bit < size * 8; bit++) {
+            sync[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            if (decode() == WireStatus::OK) syncBad++;
+            sync[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        }
+        SyncExchange other;
+        if ((reply ? decodeSyncRequest(sync, size, other) : decodeSyncReply(sync, size, other)) ==
+            WireStatus::OK)
+            syncBad++;
+    }
+    ok = check("synchro : aller-retour, erreurs 1 bit, types", syncBad == 0) && ok;
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
+
+int benchWire(int, char**) {
+    const size_t COUNT = 1024;
+    const long   ROUNDS = 5000;
+
+    std::mt19937_64 rng(7);
+    std::vector<TouchEvent> events(COUNT);
+    for (TouchEvent& ev : events) ev = randomEvent(rng);
+    std::vector<uint8_t> frames(COUNT * TOUCH_WIRE_SIZE);
+
+    auto rate = [&](const char* name, auto&& body) {
+        uint64_t sink = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (long r = 0; r < ROUNDS; r++)
+            for (size_t i = 0; i < COUNT; i++)
+                sink += body(i);
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        double n = (double)ROUNDS * COUNT;
+        std::printf("  %-22s %8.2f M evt/s  %6.1f ns/evt  (%llu)\n", name, n / s / 1e6,
+                    s * 1e9 / n, (unsigned long long)(sink & 0xFF));
+    };
+
+    std::printf("Trame TouchEvent v%u (%zu octets), %zu evenements x %ld\n\n", TOUCH_WIRE_VERSION,
+                TOUCH_WIRE_SIZE, COUNT, ROUNDS);
+
+    rate("encode", [&](size_t i) {
+        return encodeTouchEvent(events[i], &frames[i * TOUCH_WIRE_SIZE], TOUCH_WIRE_SIZE);
+    });
+    rate("decode", [&](size_t i) {
+        TouchEvent out;
+        decodeTouchEvent(&frames[i * TOUCH_WIRE_SIZE], TOUCH_WIRE_SIZE, out);
+        return (size_t)out.seq;
+    });
+    rate("encode + decode", [&](size_t i) {
+        uint8_t buf[TOUCH_WIRE_SIZE];
+        TouchEvent out;
+        encodeTouchEvent(events[i], buf, sizeof buf);
+        decodeTouchEvent(buf, sizeof buf, out);
+        return (size_t)out.value;
+    });
+    return 0;
+}
@@ -0,0 +1,401 @@
+// =============================================================================
+// dump_trace.cpp — Decodage des traces binaires du tireur (CSV / VCD)
+// =============================================================================
+//
+// CAPTURE : tout ce que le tireur ecrit sur Serial apres un 'T' (ou une
+// anomalie), enregistre tel quel, par exemple :
+//   stty -F /dev/ttyACM0 raw 115200 && cat /dev/ttyACM0 > capture.bin
+// Les blocs "FTRC" (trace_ring.h) sont retrouves au milieu du texte ; les
+// blocs au CRC faux sont ignores et comptes.
+//
+//   program tracedump capture.bin        CSV sur la sortie standard
+//   program tracedump capture.bin vcd    VCD (GTKWave, PulseView) : bouton,
+//                                        classe et frequence des periodes,
+//                                        phase Time-Division, evenements,
+//                                        datagrammes, anomalies
+//
+// Les enregistrements de plusieurs vidages sont fusionnes (doublons
+// retires) et dates en µs complets d'apres l'instant de chaque vidage.
+//
+// SANS ARGUMENT, verification sur hote :
+//   - TouchDetector trace un appui avec des periodes aberrantes (12 et
+//     32 kHz) a l'etablissement et a la rupture du contact : bascules,
+//     changements de classe, anomalie et evenements presents, vidage
+//     decode a l'identique, CRC qui rejette un octet modifie
+//   - un thread ecrit sans arret dans un petit anneau pendant que
+//     snapshot() le copie : aucune copie ne contient d'enregistrement
+//     dechire ou hors sequence (sur un hote a un seul coeur, seules les
+//     preemptions au milieu d'une copie exercent l'ecart)
+//   - cout de record()
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <classifier.h>
+#include <fencer_event.h>
+#include <pio_edge_timer.h>
+#include <touch_detector.h>
+#include <trace_ring.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t ABERRANT_MAKE_HZ  = 12000;
+const uint32_t ABERRANT_BREAK_HZ = 32000;
+static_assert(classifyFrequency(ABERRANT_MAKE_HZ) == FreqClass::UNKNOWN, "12 kHz hors bandes");
+static_assert(classifyFrequency(ABERRANT_BREAK_HZ) == FreqClass::UNKNOWN, "32 kHz hors bandes");
+
+const uint32_t STRESS_RING      = 64;
+const uint32_t STRESS_PACE      = 200;      // attente entre deux ecritures (iterations)
+const uint32_t STRESS_MS        = 300;
+
+struct Entry {
+    uint64_t    tUs;
+    TraceSource source;
+    TraceRecord r;
+    uint64_t    word;
+};
+
+const char* sourceText(TraceSource s) {
+    switch (s) {
+        case TraceSource::CORE1:  return "coeur1";
+        case TraceSource::CORE0:  return "coeur0";
+        case TraceSource::TD_IRQ: return "td_irq";
+        default:                  return "?";
+    }
+}
+
+const char* eventText(uint8_t type) {
+    static const char* const NAMES[] = { "BUTTON_DOWN", "DECISION", "TOUCH", "STATUS", "DWELL" };
+    return type < sizeof NAMES / sizeof NAMES[0] ? NAMES[type] : "?";
+}
+
+const char* anomalyText(uint8_t code) {
+    static const char* const NAMES[] = { "-", "ABERRANT", "QUEUE_FULL", "OVERRUN", "EDGE_STORM" };
+    return code < sizeof NAMES / sizeof NAMES[0] ? NAMES[code] : "?";
+}
+
+const char* phaseText(uint8_t phase) {
+    static const char* const NAMES[] = { "IDLE", "EMIT", "DETECT", "FULL_DETECT" };
+    return phase < sizeof NAMES / sizeof NAMES[0] ? NAMES[phase] : "?";
+}
+
+void detail(const TraceRecord& r, char* buf, size_t cap) {
+    switch (r.tag) {
+        case TraceTag::BUTTON:
+            std::snprintf(buf, cap, "%s", r.a ? "appui" : "relachement");
+            break;
+        case TraceTag::PERIOD:
+            std::snprintf(buf, cap, "%s %u Hz", freqClassLabel((FreqClass)r.a), r.b);
+            break;
+        case TraceTag::EVENT:
+            std::snprintf(buf, cap, "%s seq %u", eventText(r.a), r.b);
+            break;
+        case TraceTag::TD_PHASE:
+            std::snprintf(buf, cap, "%s", phaseText(r.a));
+            break;
+        case TraceTag::PACKET:
+            std::snprintf(buf, cap, "seq %u copie %u", r.b, r.a);
+            break;
+        case TraceTag::ACK:
+            std::snprintf(buf, cap, "seq %u", r.b);
+            break;
+        case TraceTag::LOOP:
+            std::snprintf(buf, cap, "boucle max %u us", r.b);
+            break;
+        case TraceTag::ANOMALY:
+            std::snprintf(buf, cap, "%s %u", anomalyText(r.a), r.b);
+            break;
+        default:
+            buf[0] = 0;
+    }
+}
+
+// Tous les blocs valides de la capture ; corrupt = blocs "FTRC" rejetes
+std::vector<Entry> decodeCapture(const std::vector<uint8_t>& data, int& dumps, int& corrupt) {
+    std::vector<Entry> out;
+    dumps = corrupt = 0;
+    for (size_t i = 0; i + 4 <= data.size();) {
+        if (std::memcmp(&data[i], "FTRC", 4) != 0) {
+            i++;
+            continue;
+        }
+        TraceDumpHeader h;
+        const uint8_t* rec;
+        size_t used = decodeTraceDump(&data[i], data.size() - i, h, rec);
+        if (!used) {
+            corrupt++;
+            i++;
+            continue;
+        }
+        dumps++;
+        for (uint16_t k = 0; k < h.count; k++) {
+            uint64_t w = traceWord(rec + 8u * k);
+            TraceRecord r = unpackTrace(w);
+            out.push_back({ traceTimeUs(r.tUs, h.nowUs), h.source, r, w });
+        }
+        i += used;
+    }
+    // Ordre d'ecriture conserve a instant egal ; un enregistrement deja vu
+    // dans un vidage precedent (meme instant, meme anneau, meme mot) est retire
+    std::stable_sort(out.begin(), out.end(), [](const Entry& a, const Entry& b) {
+        if (a.tUs != b.tUs) return a.tUs < b.tUs;
+        return a.source < b.source;
+    });
+    std::vector<Entry> merged;
+    size_t group = 0;
+    for (const Entry& e : out) {
+        if (!merged.empty() &&
+            (merged.back().tUs != e.tUs || merged.back().source != e.source))
+            group = merged.size();
+        bool seen = false;
+        for (size_t k = group; k < merged.size() && !seen; k++)
+            seen = merged[k].word == e.word;
+        if (!seen) merged.push_back(e);
+    }
+    return merged;
+}
+
+void writeCsv(FILE* f, const std::vector<Entry>& entries) {
+    std::fprintf(f, "t_us,source,tag,a,b,detail\n");
+    char text[64];
+    for (const Entry& e : entries) {
+        detail(e.r, text, sizeof text);
+        std::fprintf(f, "%llu,%s,%s,%u,%u,%s\n", (unsigned long long)e.tUs,
+                     sourceText(e.source), traceTagText(e.r.tag), e.r.a, e.r.b, text);
+    }
+}
+
+void vcdBits(FILE* f, uint32_t v, char id) {
+    char bits[33];
+    int n = 0;
+    for (int b = 31; b >= 0; b--)
+        if (n || (v >> b) & 1 || b == 0) bits[n++] = (char)('0' + ((v >> b) & 1));
+    bits[n] = 0;
+    std::fprintf(f, "b%s %c\n", bits, id);
+}
+
+void writeVcd(FILE* f, const std::vector<Entry>& entries) {
+    std::fprintf(f, "$timescale 1us $end\n$scope module tireur $end\n");
+    std::fprintf(f, "$var wire 1 ! bouton $end\n");
+    std::fprintf(f, "$var reg 8 \" classe $end\n");
+    std::fprintf(f, "$var reg 16 # freq_hz $end\n");
+    std::fprintf(f, "$var reg 8 $ td_phase $end\n");
+    std::fprintf(f, "$var reg 8 %% evenement $end\n");
+    std::fprintf(f, "$var reg 16 & datagramme_seq $end\n");
+    std::fprintf(f, "$var reg 16 ' ack_seq $end\n");
+    std::fprintf(f, "$var reg 8 ( anomalie $end\n");
+    std::fprintf(f, "$upscope $end\n$enddefinitions $end\n");
+    if (entries.empty())
+        return;
+
+    uint64_t origin = entries.front().tUs;
+    uint64_t last   = ~0ull;
+    std::fprintf(f, "#0\n0!\nb0 \"\nb0 #\nb0 $\nb0 %%\nb0 &\nb0 '\nb0 (\n");
+    for (const Entry& e : entries) {
+        uint64_t t = e.tUs - origin;
+        if (t != last) {
+            std::fprintf(f, "#%llu\n", (unsigned long long)t);
+            last = t;
+        }
+        const TraceRecord& r = e.r;
+        switch (r.tag) {
+            case TraceTag::BUTTON:   std::fprintf(f, "%c!\n", r.a ? '1' : '0'); break;
+            case TraceTag::PERIOD:   vcdBits(f, r.a, '"'); vcdBits(f, r.b, '#'); break;
+            case TraceTag::TD_PHASE: vcdBits(f, r.a, '$'); break;
+            case TraceTag::EVENT:    vcdBits(f, r.a, '%'); break;
+            case TraceTag::PACKET:   vcdBits(f, r.b, '&'); break;
+            case TraceTag::ACK:      vcdBits(f, r.b, '\''); break;
+            case TraceTag::ANOMALY:  vcdBits(f, r.a, '('); break;
+            default: break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Verification sur hote
+// -----------------------------------------------------------------------------
+struct TracingSink {
+    TraceRing& ring;
+    uint16_t   seq = 0;
+    std::vector<FencerEvent> events;
+
+    bool push(FencerEvent ev) {
+        ev.seq = seq++;
+        ring.record(ev.tUs, TraceTag::EVENT, (uint8_t)ev.type, ev.seq);
+        events.push_back(ev);
+        return true;
+    }
+};
+
+// Appui de 5 a 45 ms, contact sur VALID_B de 6 a 30 ms, encadre de
+// periodes aberrantes ; boucle de 20 µs comme loop1
+bool checkDetectorTrace(TraceRing& ring) {
+    FakeEdgeTimer timer(1000000000u);
+    TouchDetector detector(timer.tickHz(), 0);
+    detector.setTrace(&ring);
+    TracingSink sink = { ring, 0, {} };
+
+    struct Burst { uint64_t fromUs, toUs; uint32_t hz; };
+    const Burst bursts[] = {
+        { 6000,  6250,  ABERRANT_MAKE_HZ },
+        { 6250,  30000, FREQ_VALID_B },
+        { 30000, 30150, ABERRANT_BREAK_HZ },
+    };
+    const uint64_t pressUs = 5000, releaseUs = 45000;
+
+    uint64_t nextEdgeNs = bursts[0].fromUs * 1000u;
+    size_t burst = 0;
+    for (uint64_t t = 0; t < 50000; t += 20) {
+        while (burst < 3 && nextEdgeNs <= t * 1000u) {
+            uint64_t periodNs = 1000000000ull / bursts[burst].hz;
+            timer.addPeriod((uint32_t)periodNs);
+            nextEdgeNs += periodNs;
+            if (nextEdgeNs >= bursts[burst].toUs * 1000u) burst++;
+        }
+        bool down = t >= pressUs && t < releaseUs;
+        detector.stepFiltered(t, down, down ? pressUs : releaseUs, timer, sink);
+    }
+
+    uint32_t written;
+    std::vector<uint64_t> words(ring.capacity());
+    uint32_t n = ring.snapshot(words.data(), (uint32_t)words.size(), written);
+    TraceDumpHeader h = { ring.source(), 1, ring.anomaly(), (uint16_t)n, written, 50000 };
+    std::vector<uint8_t> buf(traceDumpSize(n) + 16, 0x55);
+    size_t size = encodeTraceDump(h, words.data(), buf.data() + 8, buf.size() - 8);
+
+    int dumps, corrupt;
+    std::vector<Entry> entries = decodeCapture(buf, dumps, corrupt);
+
+    bool same = dumps == 1 && corrupt == 0 && entries.size() == n;
+    for (size_t i = 0; same && i < n; i++)
+        same = entries[i].word == words[i];
+
+    auto count = [&](TraceTag tag, int a) {
+        int c = 0;
+        for (const Entry& e : entries)
+            c += e.r.tag == tag && (a < 0 || e.r.a == a);
+        return c;
+    };
+    int unknown = count(TraceTag::PERIOD, (int)FreqClass::UNKNOWN);
+    bool content = count(TraceTag::BUTTON, 1) == 1 && count(TraceTag::BUTTON, 0) == 1 &&
+                   unknown == 2 && count(TraceTag::PERIOD, (int)FreqClass::VALID_B) == 1 &&
+                   count(TraceTag::ANOMALY, (int)TraceAnomaly::ABERRANT) == 2 &&
+                   count(TraceTag::EVENT, (int)FencerEventType::DWELL) == 1 &&
+                   count(TraceTag::EVENT, (int)FencerEventType::TOUCH) == 1 &&
+                   ring.anomaly() == TraceAnomaly::ABERRANT;
+
+    // Un octet modifie : le bloc est rejete
+    buf[8 + TRACE_DUMP_HEADER + 3] ^= 0x10;
+    std::vector<Entry> bad = decodeCapture(buf, dumps, corrupt);
+    bool crc = bad.empty() && corrupt == 1;
+
+    std::printf("Appui trace (contact VALID_B, 12 kHz a l'etablissement, 32 kHz a la rupture)\n");
+    std::printf("  %u enregistrements, vidage de %zu octets\n\n", n, size);
+    writeCsv(stdout, entries);
+    std::printf("\n  contenu attendu       %s\n", content ? "ok" : "ECHEC");
+    std::printf("  decodage identique    %s\n", same ? "ok" : "ECHEC");
+    std::printf("  CRC (octet modifie)   %s\n", crc ? "rejete" : "ECHEC");
+    return content && same && crc;
+}
+
+// L'ecrivain enregistre i = 0, 1, 2, ... ; chaque copie doit etre une suite
+// continue et croissante, sans mot dechire
+bool stressSnapshot() {
+    TraceBuffer<STRESS_RING> ring(TraceSource::CORE1);
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (uint32_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+            ring.record(i, TraceTag::LOOP, (uint8_t)(i >> 16), (uint16_t)i);
+            for (volatile uint32_t k = 0; k < STRESS_PACE; k = k + 1) {}
+        }
+    });
+
+    while (ring.written() < 4 * STRESS_RING)
+        std::this_thread::yield();
+
+    uint64_t words[STRESS_RING];
+    uint32_t bad = 0, empty = 0, snapshots = 0;
+    uint64_t copied = 0, dropped = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(STRESS_MS);
+    for (; std::chrono::steady_clock::now() < end; snapshots++) {
+        uint32_t written;
+        uint32_t n = ring.snapshot(words, STRESS_RING, written);
+        copied  += n;
+        dropped += std::min(written, STRESS_RING) - n;
+        if (n == 0) empty++;
+        for (uint32_t i = 0; i < n; i++) {
+            TraceRecord r = unpackTrace(words[i]);
+            bool torn = (uint16_t)r.tUs != r.b || (uint8_t)(r.tUs >> 16) != r.a ||
+                        r.tag != TraceTag::LOOP;
+            TraceRecord prev = i ? unpackTrace(words[i - 1]) : r;
+            if (torn || (i && r.tUs != prev.tUs + 1)) bad++;
+        }
+    }
+    stop.store(true);
+    writer.join();
+
+    std::printf("\nCopie pendant l'ecriture (anneau de %u, %u copies en %u ms)\n", STRESS_RING,
+                snapshots, STRESS_MS);
+    std::printf("  enregistrements copies %llu | ecartes (reecrits pendant la copie) %llu | "
+                "copies vides %u\n", (unsigned long long)copied, (unsigned long long)dropped,
+                empty);
+    std::printf("  dechires / hors sequence : %u\n", bad);
+    return bad == 0 && copied > 0;
+}
+
+double recordCostNs() {
+    TraceBuffer<1024> ring(TraceSource::CORE1);
+    const uint32_t n = 20000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; i++)
+        ring.record(i, TraceTag::PERIOD, (uint8_t)i, (uint16_t)i);
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return s * 1e9 / n + (ring.written() == n ? 0 : 1e9);
+}
+
+}  // namespace
+
+int dumpTrace(int argc, char** argv) {
+    if (argc >= 1) {
+        FILE* in = std::fopen(argv[0], "rb");
+        if (!in) {
+            std::printf("impossible d'ouvrir %s\n", argv[0]);
+            return 1;
+        }
+        std::vector<uint8_t> data;
+        uint8_t chunk[4096];
+        size_t got;
+        while ((got = std::fread(chunk, 1, sizeof chunk, in)) > 0)
+            data.insert(data.end(), chunk, chunk + got);
+        std::fclose(in);
+
+        int dumps, corrupt;
+        std::vector<Entry> entries = decodeCapture(data, dumps, corrupt);
+        if (argc >= 2 && std::strcmp(argv[1], "vcd") == 0)
+            writeVcd(stdout, entries);
+        else
+            writeCsv(stdout, entries);
+        std::fprintf(stderr, "%d blocs, %zu enregistrements, %d blocs rejetes (CRC)\n", dumps,
+                     entries.size(), corrupt);
+        return dumps > 0 ? 0 : 1;
+    }
+
+    TraceBuffer<1024> ring(TraceSource::CORE1);
+    bool ok = checkDetectorTrace(ring);
+    ok = stressSnapshot() && ok;
+
+    double ns = recordCostNs();
+    std::printf("\nrecord() : %.2f ns (hote) | enregistrement %zu octets | anneau coeur 1 de "
+                "1024 : %zu octets\n", ns, sizeof(uint64_t), sizeof(TraceBuffer<1024>));
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// =============================================================================
+// Outils hote — Escrime sans fil
+// =============================================================================
+//
+// USAGE : program <commande> [arguments]
+//
+//   bench     micro-benchmarks du chemin critique (classification, ...)
+//   latency   latence de decision : comptage 50 ms vs mesure reciproque
+//   pwmplan   verifie le planificateur PWM de 500 Hz a 50 kHz [min max clk]
+//   sweeprank classe les plans de porteuses d'apres un log de balayage [fichier]
+//   sweepsim  simule un balayage a travers le fleuret (CSV) [R_ohm] [liste]
+//   chainsim  chaine analogique simulee → detection : banc, plan, candidates [essais [liste]]
+//   calib     calibration des bandes au branchement : derivation, touches, flash [essais | journal]
+//   spsc      stress de la file inter-coeurs avec deux threads [millions]
+//   window    fenetres a cadence fixe vs millis() sous blocages de la boucle [secondes]
+//   edgestorm tempetes de fronts sur GP2 : limiteur vs lecture directe [cycles]
+//   tdsim     simule le cycle EMIT / DETECT et la latence bouton [essais]
+//   debounce  rejoue des traces de rebonds du bouton [fichier de trace]
+//   dwell     dwell FIE en µs, declare pendant le contact [essais]
+//   contactsim classe aux bords du contact : fenetre, reciproque, contact [essais]
+//   goertzel  banc de raies sur train de bits vs comptage : melanges, cout [essais]
+//   adcsim    amplitude de GP2 par l'ADC : calcul, contact vs fuite, cout [essais]
+//   wirefuzz  fuzz des trames TouchEvent (CRC, troncatures, versions) [essais]
+//   wirebench debit codage / decodage des trames TouchEvent
+//   udpbench  transport UDP redondant sur localhost avec pertes [evenements]
+//   syncsim   synchro d'horloge tireur → central [derive_ppm gigue_us [duree_s [redemarrage_s]]]
+//   e2e       latence de bout en bout : premier front de GP2 → lampe [touches]
+//   boutsim   assauts simules : deux tireurs + central, arbitrage et latence [phrases [mode [journal]]]
+//   lampsim   lampes et buzzer du central : trames, son, latence [phrases]
+//   referee   arbitrage du central : scenarios, determinisme, temps [phrases [journal]]
+//   refreplay rejoue un journal du central (lignes EV / VD) <journal>
+//   tracedump decode une capture de traces binaires en CSV / VCD [capture [vcd]]
+// =============================================================================
+
+#include <cstdio>
+#include <cstring>
+
+int benchCore(int argc, char** argv);
+int benchLatency(int argc, char** argv);
+int checkPwmPlan(int argc, char** argv);
+int sweepRank(int argc, char** argv);
+int sweepSim(int argc, char** argv);
+int simChain(int argc, char** argv);
+int simCalibration(int argc, char** argv);
+int stressSpsc(int argc, char** argv);
+int simWindow(int argc, char** argv);
+int stressEdges(int argc, char** argv);
+int simTimeDivision(int argc, char** argv);
+int replayDebounce(int argc, char** argv);
+int simDwell(int argc, char** argv);
+int simContact(int argc, char** argv);
+int simGoertzel(int argc, char** argv);
+int simAdc(int argc, char** argv);
+int fuzzWire(int argc, char** argv);
+int benchWire(int argc, char** argv);
+int benchUdp(int argc, char** argv);
+int simClockSync(int argc, char** argv);
+int checkReferee(int argc, char** argv);
+int simLamps(int argc, char** argv);
+int simEndToEnd(int argc, char** argv);
+int simBout(int argc, char** argv);
+int replayReferee(int argc, char** argv);
+int dumpTrace(int argc, char** argv);
+
+namespace {
+
+struct Command {
+    const char* name;
+    int (*run)(int argc, char** argv);   // arguments apres la commande
+    const char* help;
+};
+
+const Command COMMANDS[] = {
+    { "bench",     benchCore,    "micro-benchmarks du chemin critique (classification, ...)" },
+    { "latency",   benchLatency, "latence de decision : comptage 50 ms vs mesure reciproque" },
+    { "pwmplan",   checkPwmPlan, "verifie le planificateur PWM de 500 Hz a 50 kHz [min max clk]" },
+    { "sweeprank", sweepRank,    "classe les plans de porteuses d'apres un log de balayage [fichier]" },
+    { "sweepsim",  sweepSim,     "simule un balayage a travers le fleuret (CSV) [R_ohm] [liste]" },
+    { "chainsim",  simChain,     "chaine analogique simulee → detection : banc, plan, candidates [essais [liste]]" },
+    { "calib",     simCalibration, "calibration des bandes au branchement : derivation, touches, flash [essais | journal]" },
+    { "spsc",      stressSpsc,   "stress de la file inter-coeurs avec deux threads [millions]" },
+    { "window",    simWindow,    "fenetres a cadence fixe vs millis() sous blocages de la boucle [secondes]" },
+    { "edgestorm", stressEdges,  "tempetes de fronts sur GP2 : limiteur vs lecture directe [cycles]" },
+    { "tdsim",     simTimeDivision, "simule le cycle EMIT / DETECT et la latence bouton [essais]" },
+    { "debounce",  replayDebounce,  "rejoue des traces de rebonds du bouton [fichier de trace]" },
+    { "dwell",     simDwell,        "dwell FIE en µs, declare pendant le contact [essais]" },
+    { "contactsim", simContact,     "classe aux bords du contact : fenetre, reciproque, contact [essais]" },
+    { "goertzel",  simGoertzel,     "banc de raies sur train de bits vs comptage : melanges, cout [essais]" },
+    { "adcsim",    simAdc,          "amplitude de GP2 par l'ADC : calcul, contact vs fuite, cout [essais]" },
+    { "wirefuzz",  fuzzWire,        "fuzz des trames TouchEvent (CRC, troncatures, versions) [essais]" },
+    { "wirebench", benchWire,       "debit codage / decodage des trames TouchEvent" },
+    { "udpbench",  benchUdp,        "transport UDP redondant sur localhost avec pertes [evenements]" },
+    { "syncsim",   simClockSync,    "synchro d'horloge tireur → central [derive_ppm gigue_us [duree_s [redemarrage_s]]]" },
+    { "e2e",       simEndToEnd,     "latence de bout en bout : premier front de GP2 → lampe [touches]" },
+    { "boutsim",   simBout,         "assauts simules : deux tireurs + central, arbitrage et latence [phrases [mode [journal]]]" },
+    { "lampsim",   simLamps,        "lampes et buzzer du central : trames, son, latence [phrases]" },
+    { "referee",   checkReferee,    "arbitrage du central : scenarios, determinisme, temps [phrases [journal]]" },
+    { "refreplay", replayReferee,   "rejoue un journal du central (lignes EV / VD) <journal>" },
+    { "tracedump", dumpTrace,       "decode une capture de traces binaires en CSV / VCD [capture [vcd]]" },
+};
+
+void usage() {
+    std::printf("usage : program <commande> [arguments]\n\n");
+    for (const Command& c : COMMANDS)
+        std::printf("  %-10s %s\n", c.name, c.help);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    for (const Command& c : COMMANDS) {
+        if (std::strcmp(argv[1], c.name) == 0)
+            return c.run(argc - 2, argv + 2);
+    }
+    usage();
+    return 1;
+}
@@ -0,0 +1,308 @@
+// =============================================================================
+// replay_debounce.cpp — Rejeu de traces de rebonds du bouton (GP16)
+// =============================================================================
+//
+// Compare l'ancien Debouncer (regle des 5 ms stables, appele en boucle avec
+// millis()) a l'IntegratorDebouncer echantillonne a DEBOUNCE_SAMPLE_US pour
+// plusieurs budgets de latence.
+//
+// Trace synthetique : appuis de 15 a 60 ms, rebonds a l'appui et au
+// relachement (rafales jusqu'a BOUNCE_MAX_US), parasites isoles au repos
+// (HIGH) et pendant l'appui (LOW, lame qui flechit). La verite terrain est
+// le premier front de l'appui et le premier front du relachement.
+//
+// Par filtre : appuis manques / fantomes, latence de decision (bascule vue
+// par la boucle − debut reel), erreur de l'instant d'appui publie et du
+// dwell mesure.
+//
+// Trace enregistree (analyseur logique) : une transition par ligne,
+// "t_us niveau" ou "t_us,niveau", lignes # ignorees ; les appuis vus par
+// chaque filtre sont listes.
+//
+// USAGE : program debounce [fichier de trace]
+// =============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <debounce.h>
+#include <fie_timing.h>
+
+using namespace fencing;
+
+namespace {
+
+const int      SYNTH_PRESSES   = 2000;
+const uint32_t BOUNCE_MAX_US   = 1500;
+const uint32_t GLITCH_MAX_US   = 200;
+const uint32_t LEGACY_LOOP_US  = 100;   // tour de boucle des sketches
+
+struct Edge {
+    uint64_t tUs;
+    bool     level;
+};
+
+// Niveau de GP16 en fonction du temps, lu en avancant
+struct Trace {
+    std::vector<Edge> edges;
+    uint64_t          endUs = 0;
+
+    void set(uint64_t tUs, bool level) {
+        bool current = edges.empty() ? false : edges.back().level;
+        if (level != current)
+            edges.push_back({ tUs, level });
+    }
+};
+
+struct Cursor {
+    const Trace& trace;
+    size_t       next  = 0;
+    bool         level = false;
+
+    explicit Cursor(const Trace& t) : trace(t) {}
+
+    bool at(uint64_t tUs) {
+        while (next < trace.edges.size() && trace.edges[next].tUs <= tUs)
+            level = trace.edges[next++].level;
+        return level;
+    }
+};
+
+struct Press {
+    uint64_t startUs, endUs;      // publies par le filtre (ou verite terrain)
+    uint64_t seenUs;              // bascule vue par la boucle
+};
+
+// -----------------------------------------------------------------------------
+// Generation
+// -----------------------------------------------------------------------------
+Trace synthetic(std::vector<Press>& truth) {
+    std::mt19937 rng(16);
+    auto uni = [&](uint32_t lo, uint32_t hi) {
+        return std::uniform_int_distribution<uint32_t>(lo, hi)(rng);
+    };
+
+    Trace trace;
+    uint64_t t = 10000;
+
+    // Rafale de rebonds commencant a t, finissant au niveau final
+    auto bounce = [&](bool finalLevel) {
+        uint64_t end = t + uni(0, BOUNCE_MAX_US);
+        bool level = finalLevel;
+        while (t < end) {
+            trace.set(t, level);
+            t += uni(20, 250);
+            level = !level;
+        }
+        trace.set(t, finalLevel);
+    };
+
+    // Parasites isoles de niveau !level entre t et t + durationUs
+    auto steady = [&](bool level, uint32_t durationUs) {
+        uint64_t end = t + durationUs;
+        for (;;) {
+            uint64_t glitch = t + uni(2000, 40000);
+            uint32_t width  = uni(10, GLITCH_MAX_US);
+            if (glitch + width + 1000 >= end) break;
+            trace.set(glitch, !level);
+            trace.set(glitch + width, level);
+            t = glitch + width;
+        }
+        t = end;
+    };
+
+    for (int i = 0; i < SYNTH_PRESSES; i++) {
+        steady(false, uni(50000, 200000));
+
+        Press p = {};
+        p.startUs = t;
+        bounce(true);
+        steady(true, uni(DWELL_MIN_MS * 1000, 60000) - (uint32_t)(t - p.startUs));
+        p.endUs = t;
+        bounce(false);
+        truth.push_back(p);
+    }
+    steady(false, 100000);
+    trace.endUs = t;
+    return trace;
+}
+
+bool loadTrace(const char* path, Trace& trace) {
+    FILE* in = std::fopen(path, "r");
+    if (!in) {
+        std::printf("impossible d'ouvrir %s\n", path);
+        return false;
+    }
+    char line[128];
+    while (std::fgets(line, sizeof line, in)) {
+        unsigned long long t;
+        int level;
+        if (line[0] == '#') continue;
+        if (std::sscanf(line, "%llu%*[ ,;\t]%d", &t, &level) != 2) continue;
+        if (!trace.edges.empty() && t < trace.edges.back().tUs) continue;
+        trace.set(t, level != 0);
+        trace.endUs = t;
+    }
+    std::fclose(in);
+    trace.endUs += 100000;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Filtres
+// -----------------------------------------------------------------------------
+
+// Sketches : Debouncer(5 ms) a chaque tour de boucle, appui date a la bascule
+std::vector<Press> runLegacy(const Trace& trace) {
+    std::vector<Press> out;
+    Cursor cur(trace);
+    Debouncer button(DEBOUNCE_MS);
+    bool state = false;
+    for (uint64_t t = 0; t < trace.endUs; t += LEGACY_LOOP_US) {
+        uint32_t ms = (uint32_t)(t / 1000u);
+        bool s = button.update(cur.at(t), ms);
+        if (s && !state)
+            out.push_back({ (uint64_t)ms * 1000u, 0, t });
+        if (!s && state)
+            out.back().endUs = (uint64_t)ms * 1000u;
+        state = s;
+    }
+    return out;
+}
+
+// Echantillons a cadence fixe, bascule datee par edgeTime()
+std::vector<Press> runIntegrator(const Trace& trace, uint8_t threshold) {
+    std::vector<Press> out;
+    Cursor cur(trace);
+    IntegratorDebouncer filter(threshold);
+    uint32_t tick = 0;
+    for (uint64_t t = 0; t < trace.endUs; t += DEBOUNCE_SAMPLE_US, tick++) {
+        if (!filter.sample(cur.at(t), tick))
+            continue;
+        uint64_t edgeUs = (uint64_t)filter.edgeTime() * DEBOUNCE_SAMPLE_US;
+        if (filter.state())
+            out.push_back({ edgeUs, 0, t });
+        else
+            out.back().endUs = edgeUs;
+    }
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Bilan
+// -----------------------------------------------------------------------------
+struct Score {
+    int     missed = 0, phantom = 0, matched = 0;
+    int64_t latencyMax = 0, latencySum = 0;
+    int64_t startErrMin = 0, startErrMax = 0;
+    int64_t dwellErrMin = 0, dwellErrMax = 0;
+};
+
+Score score(const std::vector<Press>& truth, const std::vector<Press>& seen) {
+    Score s;
+    size_t j = 0;
+    for (size_t i = 0; i < truth.size(); i++) {
+        uint64_t windowEnd = i + 1 < truth.size() ? truth[i + 1].startUs : ~0ull;
+        while (j < seen.size() && seen[j].seenUs < truth[i].startUs) {
+            s.phantom++;
+            j++;
+        }
+        if (j >= seen.size() || seen[j].seenUs >= windowEnd) {
+            s.missed++;
+            continue;
+        }
+        const Press& p = seen[j++];
+        int64_t latency  = (int64_t)(p.seenUs - truth[i].startUs);
+        int64_t startErr = (int64_t)p.startUs - (int64_t)truth[i].startUs;
+        int64_t dwellErr = ((int64_t)p.endUs - (int64_t)p.startUs) -
+                           ((int64_t)truth[i].endUs - (int64_t)truth[i].startUs);
+        if (s.matched == 0) {
+            s.startErrMin = s.startErrMax = startErr;
+            s.dwellErrMin = s.dwellErrMax = dwellErr;
+        }
+        s.matched++;
+        s.latencySum += latency;
+        s.latencyMax  = std::max(s.latencyMax, latency);
+        s.startErrMin = std::min(s.startErrMin, startErr);
+        s.startErrMax = std::max(s.startErrMax, startErr);
+        s.dwellErrMin = std::min(s.dwellErrMin, dwellErr);
+        s.dwellErrMax = std::max(s.dwellErrMax, dwellErr);
+        // Appuis fantomes dans le meme appui reel (relachement mal filtre)
+        while (j < seen.size() && seen[j].seenUs < windowEnd) {
+            s.phantom++;
+            j++;
+        }
+    }
+    s.phantom += (int)(seen.size() - j);
+    return s;
+}
+
+void printScore(const char* name, const Score& s) {
+    std::printf("  %-22s %5d %6d %6lld %6lld %6lld..%-6lld %6lld..%-6lld\n", name, s.missed,
+                s.phantom, s.matched ? (long long)(s.latencySum / s.matched) : 0LL,
+                (long long)s.latencyMax, (long long)s.startErrMin, (long long)s.startErrMax,
+                (long long)s.dwellErrMin, (long long)s.dwellErrMax);
+}
+
+void printPresses(const char* name, const std::vector<Press>& seen) {
+    std::printf("%s : %zu appuis\n", name, seen.size());
+    for (const Press& p : seen)
+        std::printf("  t=%10llu us  dwell %6lld us%s\n", (unsigned long long)p.startUs,
+                    p.endUs ? (long long)(p.endUs - p.startUs) : -1LL,
+                    p.endUs && !dwellSatisfied((uint32_t)((p.endUs - p.startUs) / 1000u))
+                        ? "  < dwell FIE" : "");
+}
+
+const uint32_t BUDGETS_US[] = { 500, 1000, DEBOUNCE_BUDGET_US, 3000 };
+
+}  // namespace
+
+int replayDebounce(int argc, char** argv) {
+    if (argc >= 1) {
+        Trace trace;
+        if (!loadTrace(argv[0], trace))
+            return 1;
+        std::printf("%zu transitions, %.1f ms\n\n", trace.edges.size(), trace.endUs / 1000.0);
+        printPresses("Debouncer 5 ms", runLegacy(trace));
+        for (uint32_t budget : BUDGETS_US) {
+            char name[48];
+            std::snprintf(name, sizeof name, "\nIntegrateur %u us", budget);
+            printPresses(name, runIntegrator(trace, debounceThreshold(budget, DEBOUNCE_SAMPLE_US)));
+        }
+        return 0;
+    }
+
+    std::vector<Press> truth;
+    Trace trace = synthetic(truth);
+    std::printf("Trace synthetique : %d appuis, %zu transitions, rebonds <= %u us, "
+                "parasites <= %u us\n\n", SYNTH_PRESSES, trace.edges.size(), BOUNCE_MAX_US,
+                GLITCH_MAX_US);
+    std::printf("  %-22s %5s %6s %6s %6s %14s %14s\n", "filtre (us)", "manq", "fant",
+                "lat", "latmax", "err appui", "err dwell");
+
+    printScore("Debouncer 5 ms", score(truth, runLegacy(trace)));
+
+    bool ok = true;
+    for (uint32_t budget : BUDGETS_US) {
+        uint8_t threshold = debounceThreshold(budget, DEBOUNCE_SAMPLE_US);
+        char name[48];
+        std::snprintf(name, sizeof name, "Integrateur %u x %u", threshold, DEBOUNCE_SAMPLE_US);
+        Score s = score(truth, runIntegrator(trace, threshold));
+        printScore(name, s);
+
+        // Budget par defaut : aucun appui manque ni fantome, latence bornee
+        // par rebonds + budget, dwell juste a la duree des rebonds pres
+        if (budget == DEBOUNCE_BUDGET_US)
+            ok = s.missed == 0 && s.phantom == 0 &&
+                 s.latencyMax <= (int64_t)(2 * BOUNCE_MAX_US + budget + DEBOUNCE_SAMPLE_US) &&
+                 s.dwellErrMin >= -(int64_t)(BOUNCE_MAX_US + DEBOUNCE_SAMPLE_US) &&
+                 s.dwellErrMax <= (int64_t)(BOUNCE_MAX_US + DEBOUNCE_SAMPLE_US);
+    }
+
+    std::printf("\nlat : bascule vue − debut reel | err : publie − reel (rebonds compris)\n");
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+// =============================================================================
+// sim_adc.cpp — Amplitude de GP2 par l'ADC : calcul, contact vs fuite, cout
+// =============================================================================
+//
+// 1. CALCUL : formes connues (creneau, sinus, pointes exponentielles, continu,
+//    bruit) en echantillons 12 bits, passees par FakeAdcCapture (retour au
+//    debut de l'anneau, blocs de taille aleatoire) puis AmplitudeMeter.
+//    Min / max / moyenne / RMS compares a un calcul en double, note de
+//    contact comparee a l'attendu (creneau plein → 1000, continu et
+//    pointes → 0).
+//
+// 2. CONTACT vs FUITE sur la chaine simulee (signal_chain.h) : pour chaque
+//    porteuse du plan, `essais` jeux de materiel tires au hasard.
+//      contact  pointe sur la cuirasse emettrice (ChainPath::CONTACT)
+//      fuite    emission sur sa propre ligne C, couplage faible B↔C
+//               (C_lame 0.3 a 3 nF, ChainPath::COUPLING) : GP2 bascule sans
+//               que rien ne touche
+//    La tension de B est convertie a ADC_SAMPLE_HZ (bruit de 2 LSB), les
+//    fronts passent par FakeEdgeTimer. Deux TouchDetector cote a cote, sans
+//    et avec la note (protocole du firmware, updateContactQuality : mesure
+//    pendant l'appui seulement, note nulle hors appui et jusqu'a la
+//    premiere fenetre).
+//
+// 3. COUT : ns par echantillon sur l'hote, puis part d'un coeur Cortex-M0+ a
+//    133 MHz pendant l'appui d'apres un modele en cycles ; hors appui le
+//    firmware vide l'anneau sans calcul (flush).
+//
+// Verifie : (1) ; (2) sur les porteuses que la chaine passe (90 % de
+// decisions justes sans la note) : aucune fuite ne decide avec la note, et
+// la note garde au moins 95 % des decisions justes. Les autres (plan par
+// defaut et fil du fleuret de ~10 nF : le contact arrive ecrase, la fuite
+// a 20-40 kHz passe mieux que lui) sont mesurees, la note n'y tranche pas.
+//
+// USAGE : program adcsim [essais, defaut 100]
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <adc_capture.h>
+#include <amplitude_meter.h>
+#include <classifier.h>
+#include <fencer_event.h>
+#include <pio_edge_timer.h>
+#include <signal_chain.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const double   CORE_HZ         = 133e6;
+const uint32_t M0_CYCLES_PER_SAMPLE = 12;    // LDRH, 2 CMP + branches, ADD,
+                                             // MULS, ADDS/ADCS, compteur
+const double   ADC_NOISE_LSB   = 2.0;
+const uint32_t LOOP_US         = 50;
+const uint32_t PRESS_US        = 3000;       // la chaine s'etablit avant l'appui
+const uint32_t CONTACT_MS      = 30;
+const uint32_t RETAIN_PERMILLE = 950;
+const uint32_t PASSING_PERMILLE = 900;
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+    const FencerEvent* decision() const {
+        for (const FencerEvent& ev : events)
+            if (ev.type == FencerEventType::DECISION) return &ev;
+        return nullptr;
+    }
+};
+
+uint16_t toCounts(double v) {
+    double c = std::lround(v / 3.3 * ADC_MAX_COUNT);
+    return (uint16_t)(c < 0 ? 0 : c > ADC_MAX_COUNT ? ADC_MAX_COUNT : c);
+}
+
+// --- 1. Calcul ---------------------------------------------------------------
+
+struct Shape {
+    const char* name;
+    int         expectQuality;     // -1 : pas de verification
+    double (*volts)(uint32_t i, uint32_t period);
+};
+
+double squareV(uint32_t i, uint32_t period) { return (i % period) < period / 2 ? 3.3 : 0.0; }
+double sineV(uint32_t i, uint32_t period) {
+    return 1.65 + 1.5 * std::sin(6.283185307179586 * i / period);
+}
+double spikeV(uint32_t i, uint32_t period) {
+    return 3.3 * std::exp(-(double)(i % period) / (period / 16.0));
+}
+double dcV(uint32_t, uint32_t) { return 1.9; }
+double lowSquareV(uint32_t i, uint32_t period) { return (i % period) < period / 2 ? 1.5 : 1.2; }
+
+const Shape SHAPES[] = {
+    { "creneau 0 - 3.3 V",   1000, squareV },
+    { "sinus 0.15 - 3.15 V", -1,   sineV },
+    { "pointes",             0,    spikeV },
+    { "continu 1.9 V",       0,    dcV },
+    { "creneau 1.2 - 1.5 V", 0,    lowSquareV },
+};
+
+struct Reference {
+    double minMv = 1e9, maxMv = -1e9, sum = 0, sumSq = 0;
+    uint32_t n = 0;
+};
+
+bool checkMath(std::mt19937& rng) {
+    AmplitudeMeter meter;
+    FakeAdcCapture adc;
+    adc.begin(26, ADC_SAMPLE_HZ);
+    std::normal_distribution<double> noise(0.0, ADC_NOISE_LSB);
+    std::uniform_int_distribution<uint32_t> chunk(1, FakeAdcCapture::RING_SIZE - 1);
+    uint32_t period = ADC_SAMPLE_HZ / detail::minCenterHz();
+    bool ok = true;
+
+    std::printf("1. Calcul : fenetre %u echantillons a %u ech/s (%u µs)\n",
+                meter.windowSamples(), ADC_SAMPLE_HZ, AMPLITUDE_WINDOW_US);
+    for (const Shape& shape : SHAPES) {
+        meter.reset();
+        Reference ref;
+        uint32_t windows = 0, bad = 0, badQuality = 0;
+        uint32_t quality = 0;
+        uint32_t total   = meter.windowSamples() * 40 + 7;
+        uint32_t i = 0;
+        while (i < total) {
+            uint32_t n = chunk(rng);
+            for (uint32_t k = 0; k < n && i < total; k++, i++) {
+                double c = std::lround(shape.volts(i, period) / 3.3 * ADC_MAX_COUNT
+                                       + (shape.volts == dcV ? 0.0 : noise(rng)));
+                uint16_t counts = (uint16_t)(c < 0 ? 0 : c > ADC_MAX_COUNT ? ADC_MAX_COUNT : c);
+                adc.addSample(counts);
+                double mv = counts * 3300.0 / ADC_MAX_COUNT;
+                if (mv < ref.minMv) ref.minMv = mv;
+                if (mv > ref.maxMv) ref.maxMv = mv;
+                ref.sum += counts;
+                ref.sumSq += (double)counts * counts;
+                if (++ref.n == meter.windowSamples()) {
+                    // Fenetre de reference fermee : comparer a celle du compteur
+                    adc.poll(meter);
+                    AmplitudeStats a;
+                    if (!meter.takeWindow(a)) {
+                        bad++;
+                    } else {
+                        double mean = ref.sum / ref.n;
+                        double rms  = std::sqrt(std::max(0.0, ref.sumSq / ref.n - mean * mean))
+                                    * 3300.0 / ADC_MAX_COUNT;
+                        mean *= 3300.0 / ADC_MAX_COUNT;
+                        if (std::fabs(a.minMv - ref.minMv) > 1 || std::fabs(a.maxMv - ref.maxMv) > 1 ||
+                            std::fabs(a.meanMv - mean) > 1 || std::fabs(a.rmsMv - rms) > 2 ||
+                            a.samples != ref.n)
+                            bad++;
+                        uint16_t q = contactQuality(a);
+                        quality += q;
+                        if (shape.expectQuality >= 0 && q != shape.expectQuality)
+                            badQuality++;
+                    }
+                    windows++;
+                    ref = Reference();
+                }
+            }
+            // Blocs de taille aleatoire : le compteur voit des coupures
+            // quelconques, y compris au retour de l'anneau
+            adc.poll(meter);
+        }
+        const AmplitudeStats& a = meter.last();
+        std::printf("  %-22s cc %4u mV  moy %4u mV  rms %4u mV  note moy %4u  "
+                    "fenetres %3u  ecarts %u/%u %s\n",
+                    shape.name, a.p2pMv, a.meanMv, a.rmsMv, windows ? quality / windows : 0,
+                    windows, bad, badQuality, bad || badQuality ? "ECHEC" : "ok");
+        ok &= bad == 0 && badQuality == 0 && windows == total / meter.windowSamples();
+    }
+    return ok;
+}
+
+// --- 2. Contact vs fuite ----------------------------------------------------
+
+struct Outcome {
+    int      plain = 0;         // DECISION sans la note (juste pour un contact)
+    int      gated = 0;         // avec la note
+    uint64_t quality = 0;       // somme des notes de la premiere fenetre
+};
+
+void runPress(const ChainParams& p, ChainPath path, uint32_t freqHz, FreqClass truth,
+              uint32_t seed, Outcome& r) {
+    SignalChain chain(p, path, seed);
+    // Un chronometre par detecteur : pollEdges consomme les fronts
+    FakeEdgeTimer plainTimer(1000000000u), gatedTimer(1000000000u);
+    EdgeTimerFeed<FakeEdgeTimer> plainFeed(plainTimer), gatedFeed(gatedTimer);
+    TouchDetector plain(plainTimer.tickHz(), 0), gated(gatedTimer.tickHz(), 0);
+    FakeAdcCapture adc;
+    adc.begin(26, ADC_SAMPLE_HZ);
+    AmplitudeMeter meter;
+    Collect plainOut, gatedOut;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, ADC_NOISE_LSB * 3.3 / ADC_MAX_COUNT);
+    std::vector<uint64_t> rising;
+
+    const uint64_t releaseUs = PRESS_US + (uint64_t)CONTACT_MS * 1000u;
+    const double   stepNs    = 1e9 / ADC_SAMPLE_HZ;
+    double   sampleNs = 0;
+    bool     first    = true;
+    for (uint64_t t = LOOP_US; t <= releaseUs + 2 * LOOP_US; t += LOOP_US) {
+        // Conversions de l'ADC jusqu'a t, fronts de GP2 au passage
+        while (sampleNs < (double)t * 1000.0) {
+            rising.clear();
+            chain.run((uint64_t)sampleNs, freqHz, rising);
+            for (uint64_t e : rising) {
+                plainFeed.onRisingEdge(e);
+                gatedFeed.onRisingEdge(e);
+            }
+            adc.addSample(toCounts(chain.voltageB() + noise(rng)));
+            sampleNs += stepNs;
+        }
+        rising.clear();
+        chain.run(t * 1000u, freqHz, rising);
+        for (uint64_t e : rising) {
+            plainFeed.onRisingEdge(e);
+            gatedFeed.onRisingEdge(e);
+        }
+
+        // Protocole du firmware (fencer_firmware, updateContactQuality)
+        if (!gated.pressed()) {
+            adc.flush();
+            meter.reset();
+            gated.setContactQuality(0);
+        } else {
+            adc.poll(meter);
+            AmplitudeStats a;
+            if (meter.takeWindow(a)) {
+                uint16_t q = contactQuality(a);
+                gated.setContactQuality(q);
+                if (first) r.quality += q;
+                first = false;
+            }
+        }
+
+        bool down = t >= PRESS_US && t < releaseUs;
+
+        plain.stepFiltered(t, down, down ? PRESS_US : releaseUs, plainTimer, plainOut);
+        gated.stepFiltered(t, down, down ? PRESS_US : releaseUs, gatedTimer, gatedOut);
+    }
+
+    const FencerEvent* p1 = plainOut.decision();
+    const FencerEvent* p2 = gatedOut.decision();
+    bool contact = path == ChainPath::CONTACT;
+    if (p1 && (!contact || p1->cls == truth)) r.plain++;
+    if (p2 && (!contact || p2->cls == truth)) r.gated++;
+}
+
+double logUniform(std::mt19937& rng, double lo, double hi) {
+    return std::exp(std::uniform_real_distribution<double>(std::log(lo), std::log(hi))(rng));
+}
+
+}  // namespace
+
+int simAdc(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 100;
+    if (trials <= 0) trials = 100;
+    auto start = std::chrono::steady_clock::now();
+    std::mt19937 rng(29);
+
+    bool ok = checkMath(rng);
+
+    std::printf("\n2. Contact vs fuite, %d jeux de materiel par porteuse "
+                "(decisions sans / avec la note, note moyenne)\n", trials);
+    std::vector<ChainParams> contactSets, leakSets;
+    for (int i = 0; i < trials; i++) {
+        contactSets.push_back(randomChainParams(rng));
+        ChainParams leak = randomChainParams(rng);
+        leak.bladeF = logUniform(rng, 0.3e-9, 3e-9);
+        leakSets.push_back(leak);
+    }
+    for (const CarrierBand& band : FREQ_PLAN) {
+        Outcome contact, leak;
+        for (int i = 0; i < trials; i++) {
+            runPress(contactSets[i], ChainPath::CONTACT, band.centerHz, band.cls, (uint32_t)i + 1, contact);
+            runPress(leakSets[i], ChainPath::COUPLING, band.centerHz, band.cls, (uint32_t)i + 1, leak);
+        }
+        bool passing = (uint32_t)contact.plain * 1000u >= (uint32_t)trials * PASSING_PERMILLE;
+        bool leakOk  = !passing || leak.gated == 0;
+        bool keepOk  = !passing || (uint32_t)contact.gated * 1000u >=
+                                   (uint32_t)contact.plain * RETAIN_PERMILLE;
+        std::printf("  %-20s contact juste %5.1f / %5.1f %% note %4u | fuite %5.1f / %5.1f %% note %4u  %s\n",
+                    band.label, 100.0 * contact.plain / trials, 100.0 * contact.gated / trials,
+                    (unsigned)(contact.quality / trials), 100.0 * leak.plain / trials,
+                    100.0 * leak.gated / trials, (unsigned)(leak.quality / trials),
+                    leakOk && keepOk ? (passing ? "ok" : "mesure (porteuse perdue par la chaine)") : "ECHEC");
+        ok &= leakOk && keepOk;
+    }
+
+    // --- 3. Cout ----------------------------------------------------------------
+    std::vector<uint16_t> samples(1u << 16);
+    for (size_t i = 0; i < samples.size(); i++)
+        samples[i] = toCounts(squareV((uint32_t)i, 25) + 0.01 * (double)(i % 7));
+    AmplitudeMeter meter;
+    const int rounds = 200;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < rounds; k++)
+        meter.pushSamples(samples.data(), (uint32_t)samples.size());
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count()
+              / ((double)rounds * samples.size());
+    double m0 = (double)ADC_SAMPLE_HZ * M0_CYCLES_PER_SAMPLE / CORE_HZ;
+    std::printf("\n3. Cout : hote %.2f ns/echantillon (fenetres %u) | M0+ (modele, 133 MHz) "
+                "%u cycles/echantillon a %u ech/s -> %.1f %% d'un coeur pendant l'appui, "
+                "0 hors appui\n",
+                ns, meter.windows(), M0_CYCLES_PER_SAMPLE, ADC_SAMPLE_HZ, 100 * m0);
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\n  duree %.1f s\n", secs);
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,844 @@
+// =============================================================================
+// sim_bout.cpp — Assauts simules : deux tireurs et le central, temps simule
+// =============================================================================
+//
+// Tout le systeme sans trois Pico ni tireur : chaque carte a sa HAL simulee
+// (hal::sim::selectBoard, horloge decalee et derivante pour les tireurs) et
+// tourne les boucles de ses firmwares, tour de boucle par tour de boucle :
+//
+//   tireur A / B : FencerNode (fencer_node.h), celui de fencer_firmware
+//     setup1   : hal::pwmStart(GP14, Freq_VALID) ; Mode Time-Division :
+//                FakeTdDriver, cycle EMIT / DETECT sur GP15 / GP17
+//     bouton   : GP16 via la HAL, rebonds ; Mode Simple : FakeButtonSampler,
+//                la simulation joue ses echeances a 4 kHz
+//     loop1    : FencerNode::loop1
+//     loop     : FencerNode::pop, FencerNode::serviceLink (lien associe)
+//   lame : la pointe voit la porteuse de la surface touchee, lue dans la HAL
+//     de la carte adverse (hal::sim::pwmFreq / pwmActive) : cuirasse GP14,
+//     coque GP17 (portee par le cycle EMIT / DETECT), rien hors surface ;
+//     fronts ideaux (la chaine analogique est evaluee par chainsim)
+//   air : trames touch_wire.h, 1 a 5 ms, 5 % de pertes, rafales
+//   central : CentralNode (central_node.h) sur FakeNeoPixel / FakeBuzzer,
+//     celui de central_firmware ; son journal note verdicts et photons
+//
+// Les sketches (globales, Serial, WiFi) ne s'instancient pas deux fois dans
+// un processus ; leurs boucles, si : ne restent ici que les alarmes, la
+// lame, l'air et l'ordonnancement des tours.
+//
+// Evenements discrets : une carte inactive ne fait un tour que toutes les
+// ms (coeur 1 : aussi entre le dwell et le relachement) ; une arrivee de
+// datagramme ou un evenement en file la reveille dans une periode de
+// boucle. Pres d'un millier de phrases d'armes par seconde.
+//
+// SCENARIOS (une phrase d'armes, tireur attaquant tire au hasard) :
+//   touche simple, double (ecart < verrouillage), doubles limites juste
+//   avant et juste apres le verrouillage de 300 ms, coque adverse, coque
+//   puis riposte sur la cuirasse, hors surface (touche blanche), appui
+//   court (< 15 ms), rafale de pertes de 10 a 30 ms pendant la touche.
+//   Coque et hors surface : un appui sur trois est tenu de 335 ms a 2 s,
+//   au-dela du verrouillage et de la grace ; la blanche s'allume quand meme
+//   a appui + 15 ms.
+//
+// Verifie, par phrase : verdict attendu (lampes A / B, aucun verdict
+// quand rien ne s'allume), ecart B − A a la tolerance du bouton pres,
+// contact → photon dans le budget (hors rafales), aucune touche tardive
+// ou non synchronisee.
+//
+// USAGE : program boutsim [phrases, defaut 2000] [simple | td, defaut les deux]
+//         [journal : lignes EV / VD du central, host_tools refreplay]
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <button_sampler.h>
+#include <buzzer.h>
+#include <central_node.h>
+#include <clock_sync.h>
+#include <fencer_event.h>
+#include <fencer_node.h>
+#include <freq_plan.h>
+#include <hal.h>
+#include <lamp_panel.h>
+#include <latency_probe.h>
+#include <neopixel_strip.h>
+#include <pio_edge_timer.h>
+#include <referee.h>
+#include <signal_chain.h>
+#include <time_division.h>
+#include <touch_link.h>
+#include <touch_wire.h>
+#include <udp_link.h>
+
+using namespace fencing;
+
+namespace {
+
+// Cartes (hal::sim::selectBoard)
+const uint8_t BOARD_CENTRAL = 0, BOARD_A = 1, BOARD_B = 2, BOARDS = 3;
+
+// Broches des firmwares
+const uint8_t PIN_PWM_VALID = 14;
+const uint8_t PIN_BUTTON    = 16;
+const uint8_t PIN_MOSFET_C  = 15;
+const uint8_t PIN_PWM_C     = 17;
+const uint8_t PIN_LIGHTS    = 22;
+const uint8_t PIN_BUZZER    = 21;
+
+const uint32_t CORE1_MIN_US   = 3,  CORE1_MAX_US   = 15;
+const uint32_t CORE0_MIN_US   = 20, CORE0_MAX_US   = 300;
+const uint32_t CENTRAL_MIN_US = 20, CENTRAL_MAX_US = 500;
+const uint32_t CORE1_IDLE_US  = 1000;           // hors appui
+const uint32_t LOOP_IDLE_US   = 5000;           // coeur 0 / central sans rien en cours
+const uint32_t AIR_MIN_US     = 1000, AIR_MAX_US = 5000;
+const uint32_t AIR_LOSS_PERMILLE = 50;
+const uint32_t SYNC_WARMUP_US = 3000000;
+// Dernier appui d'une phrase → phrase suivante : bouton, dwell,
+// verrouillage, grace, affichage du verdict, repos
+const uint32_t PHRASE_SETTLE_US = TD_EMIT_US + TD_DETECT_US + DWELL_MIN_US + LOCKOUT_US +
+                                  REFEREE_GRACE_US + REFEREE_HOLD_US + 100000;
+const uint32_t BOUNCE_MAX_US  = 1000;
+const uint32_t SETTLE_MAX_US  = 300;            // contact franc apres l'appui
+
+// Ecart de touches mesure vs vrai : anti-rebond (Mode Simple), creneau
+// DETECT (Mode Time-Division)
+const uint32_t GAP_TOL_SIMPLE_US = 3000;
+const uint32_t GAP_TOL_TD_US     = TD_EMIT_US + TD_DETECT_US + 2000;
+
+// Contact → premier photon (blanche : appui + 15 ms → photon), hors rafales
+const uint32_t LIGHT_BUDGET_SIMPLE_US = 40000;
+const uint32_t LIGHT_BUDGET_TD_US     = 50000;
+
+// --- Horloges ---------------------------------------------------------------
+
+struct Clock {
+    uint64_t offsetUs;
+    int64_t  driftPpb;
+
+    uint64_t local(uint64_t tUs) const {
+        return tUs + offsetUs + (uint64_t)((int64_t)tUs * driftPpb / 1000000000);
+    }
+    uint64_t localNs(uint64_t tNs) const {
+        return tNs + offsetUs * 1000u + (uint64_t)((int64_t)tNs / 1000 * driftPpb / 1000000);
+    }
+    // Instant vrai d'une echeance locale (derive au premier ordre)
+    uint64_t trueUs(uint64_t localUs) const {
+        uint64_t t = localUs - offsetUs;
+        return t - (uint64_t)((int64_t)t * driftPpb / 1000000000);
+    }
+};
+
+const Clock CLOCKS[BOARDS] = {
+    { 0, 0 },                 // central : temps vrai
+    { 7300000, 25000 },       // A
+    { 2100000, -40000 },      // B
+};
+
+void enterBoard(uint8_t board, uint64_t nowUs) {
+    hal::sim::selectBoard(board);
+    hal::sim::setTimeUs(CLOCKS[board].local(nowUs));
+}
+
+// --- Scenarios --------------------------------------------------------------
+
+enum class Scenario : uint8_t {
+    SINGLE, DOUBLE, NEAR_DOUBLE, NEAR_LOCKED, COQUE, COQUE_RIPOSTE, OFF_TARGET, FLICK, BURST,
+};
+const uint8_t SCENARIOS = 9;
+
+const char* scenarioText(Scenario s) {
+    switch (s) {
+        case Scenario::SINGLE:        return "touche simple";
+        case Scenario::DOUBLE:        return "double";
+        case Scenario::NEAR_DOUBLE:   return "double limite";
+        case Scenario::NEAR_LOCKED:   return "verrouillee limite";
+        case Scenario::COQUE:         return "coque";
+        case Scenario::COQUE_RIPOSTE: return "coque puis riposte";
+        case Scenario::OFF_TARGET:    return "hors surface";
+        case Scenario::FLICK:         return "appui court";
+        case Scenario::BURST:         return "rafale de pertes";
+    }
+    return "?";
+}
+
+enum class Target : uint8_t { LAME, COQUE, NOTHING };
+
+// Un appui de la pointe (temps vrai)
+struct Press {
+    uint64_t pressUs, releaseUs;
+    Target   target;
+    uint32_t bounceUs;              // rebonds au debut et a la fin
+    uint32_t settleUs;              // porteuse franche apres l'appui
+    uint32_t seed;
+};
+
+struct Phrase {
+    Scenario kind;
+    uint64_t startUs;
+    Lamp     lamp[2];               // attendu
+    int      press[2] = { -1, -1 }; // appui de chaque tireur
+    int64_t  gapUs    = 0;          // contact B − contact A (deux appuis)
+    bool     burst    = false;
+
+    uint8_t  verdicts = 0;
+    Lamp     got[2]   = { Lamp::NONE, Lamp::NONE };
+    int32_t  gotGapUs = 0;
+    uint64_t photonUs[2] = { 0, 0 };  // premiere lampe de chaque tireur
+};
+
+// Niveau de GP16 a l'instant t (HIGH = presse) ; cursor avance avec t
+bool buttonLevel(const std::vector<Press>& presses, size_t& cursor, uint64_t t) {
+    while (cursor < presses.size() &&
+           t >= presses[cursor].releaseUs + presses[cursor].bounceUs)
+        cursor++;
+    if (cursor >= presses.size() || t < presses[cursor].pressUs)
+        return false;
+    const Press& p = presses[cursor];
+    bool held = t < p.releaseUs;
+    uint64_t since = held ? t - p.pressUs : t - p.releaseUs;
+    if (since < p.bounceUs && ((since / 100u + p.seed) % 3u) == 0)
+        return !held;
+    return held;
+}
+
+// --- Air ----------------------------------------------------------------------
+
+struct Air {
+    struct Flight {
+        uint64_t atUs;
+        uint8_t  from, to;
+        bool     woke;              // destinataire deja reveille
+        uint8_t  len;
+        uint8_t  data[WIRE_FRAME_MAX];
+    };
+
+    std::vector<Flight> flights;
+    std::mt19937        rng{ 23 };
+    uint32_t            sent = 0, lost = 0, blackedOut = 0;
+    uint64_t            blackoutFromUs = 0, blackoutToUs = 0;
+
+    void send(uint64_t nowUs, uint8_t from, uint8_t to, const uint8_t* data, size_t len) {
+        sent++;
+        if (nowUs >= blackoutFromUs && nowUs < blackoutToUs) {
+            blackedOut++;
+            return;
+        }
+        if (std::uniform_int_distribution<uint32_t>(0, 999)(rng) < AIR_LOSS_PERMILLE) {
+            lost++;
+            return;
+        }
+        Flight f;
+        f.atUs = nowUs + std::uniform_int_distribution<uint32_t>(AIR_MIN_US, AIR_MAX_US)(rng);
+        f.from = from;
+        f.to   = to;
+        f.woke = false;
+        f.len  = (uint8_t)len;
+        std::copy(data, data + len, f.data);
+        flights.push_back(f);
+    }
+
+    // Prochaine arrivee pas encore signalee a son destinataire
+    uint64_t nextWakeUs() const {
+        uint64_t t = ~0ull;
+        for (const Flight& f : flights)
+            if (!f.woke && f.atUs < t) t = f.atUs;
+        return t;
+    }
+};
+
+UdpPeer peerOf(uint8_t board) {
+    return board == BOARD_CENTRAL ? UdpPeer{ ipv4(192, 168, 42, 1), LINK_PORT_CENTRAL }
+                                  : UdpPeer{ ipv4(192, 168, 42, 10 + board), LINK_PORT_FENCER };
+}
+
+uint8_t boardOf(const UdpPeer& peer) {
+    return peer.port == LINK_PORT_CENTRAL ? BOARD_CENTRAL : (uint8_t)((peer.ip >> 24) - 10);
+}
+
+// Interface de UdpLink ; nowUs = temps vrai du tour en cours
+struct SimLink {
+    Air&     air;
+    uint8_t  board;
+    uint64_t nowUs = 0;
+
+    SimLink(Air& a, uint8_t b) : air(a), board(b) {}
+
+    bool begin(uint16_t) { return true; }      // associe d'emblee
+    void setPeer(const UdpPeer&) {}
+
+    bool sendEvent(const TouchEvent& ev) {
+        uint8_t buf[TOUCH_WIRE_SIZE];
+        size_t n = encodeTouchEvent(ev, buf, sizeof buf);
+        air.send(nowUs, board, BOARD_CENTRAL, buf, n);
+        return n > 0;
+    }
+    bool sendAck(const UdpPeer& to, uint8_t player, uint16_t seq) {
+        uint8_t buf[TOUCH_ACK_SIZE];
+        size_t n = encodeTouchAck(player, seq, buf, sizeof buf);
+        air.send(nowUs, board, boardOf(to), buf, n);
+        return n > 0;
+    }
+    bool sendSyncRequest(const SyncExchange& ex) {
+        uint8_t buf[SYNC_REQUEST_SIZE];
+        size_t n = encodeSyncRequest(ex, buf, sizeof buf);
+        air.send(nowUs, board, BOARD_CENTRAL, buf, n);
+        return n > 0;
+    }
+    bool sendSyncReply(const UdpPeer& to, SyncExchange ex) {
+        ex.t3Us = hal::nowUs();
+        uint8_t buf[SYNC_REPLY_SIZE];
+        size_t n = encodeSyncReply(ex, buf, sizeof buf);
+        air.send(nowUs, board, boardOf(to), buf, n);
+        return n > 0;
+    }
+
+    // Plus ancien datagramme arrive ; rxUs sur l'horloge de cette carte
+    bool poll(LinkMessage& msg) {
+        auto best = air.flights.end();
+        for (auto it = air.flights.begin(); it != air.flights.end(); ++it)
+            if (it->to == board && it->atUs <= nowUs &&
+                (best == air.flights.end() || it->atUs < best->atUs))
+                best = it;
+        if (best == air.flights.end())
+            return false;
+        bool ok  = decodeLinkFrame(best->data, best->len, msg);
+        msg.rxUs = CLOCKS[board].local(best->atUs);
+        msg.from = peerOf(best->from);
+        air.flights.erase(best);
+        return ok || poll(msg);
+    }
+};
+
+// --- Tireur -------------------------------------------------------------------
+
+struct Fencer {
+    uint8_t  board, opponent;
+    bool     td;
+    uint32_t freqOwn;
+
+    FakeEdgeTimer                      timer;
+    EdgeTimerFeed<FakeEdgeTimer>       feed;
+    SimLink                            link;
+    FencerNode<FakeEdgeTimer, SimLink> node;
+    // Alarmes du coeur 1 : leurs echeances sont jouees ici
+    FakeButtonSampler buttons;      // Mode Simple
+    FakeTdDriver      cycle;        // Mode Time-Division
+
+    std::vector<Press> presses;
+    size_t   buttonCursor = 0, bladeCursor = 0;
+    uint64_t bladeNs      = 0;      // fronts de la lame emis jusque-la (temps vrai)
+
+    uint64_t next1 = 0, next0 = 0, nextTd = ~0ull;
+
+    Fencer(Air& air, uint8_t b, bool timeDivision)
+        : board(b),
+          opponent(b == BOARD_A ? BOARD_B : BOARD_A),
+          td(timeDivision),
+          freqOwn(b == BOARD_A ? FREQ_VALID_A : FREQ_VALID_B),
+          feed(timer),
+          link(air, b),
+          node(timer, link, b == BOARD_A ? PLAYER_A : PLAYER_B) {}
+
+    // setup1() puis setup() de fencer_firmware (-DFENCER_LINK), lien associe
+    void setup(uint64_t nowUs) {
+        enterBoard(board, nowUs);
+        if (td) {
+            cycle.begin(PIN_MOSFET_C, PIN_PWM_C, PIN_BUTTON, FREQ_NEUTRE);
+            nextTd = CLOCKS[board].trueUs(cycle.dueUs());
+        } else {
+            hal::pinOutput(PIN_MOSFET_C, false);
+            hal::pinOutput(PIN_PWM_C, false);
+            buttons.begin(PIN_BUTTON);
+        }
+        feed.onRisingEdge(1);        // le chronometre a deja vu un front
+        node.setup1(nullptr);
+        hal::pwmStart(PIN_PWM_VALID, freqOwn);
+        node.setup(nullptr, hal::bootNonce());
+        node.connect(LINK_PORT_FENCER, peerOf(BOARD_CENTRAL));
+    }
+
+    // Porteuse que la pointe voit a travers la surface touchee : lue dans
+    // la HAL de la carte qui l'emet (0 : rien)
+    uint32_t carrierHz(Target target) const {
+        if (target == Target::NOTHING)
+            return 0;
+        uint8_t pin = target == Target::LAME ? PIN_PWM_VALID : PIN_PWM_C;
+        hal::sim::selectBoard(opponent);
+        return hal::sim::pwmActive(pin) ? hal::sim::pwmFreq(pin) : 0;
+    }
+
+    // Fronts montants de GP2 jusqu'a untilUs, porteuse dans son etat actuel :
+    // a appeler avant tout changement d'etat de l'emetteur adverse
+    void flushBlade(uint64_t untilUs) {
+        uint64_t untilNs = untilUs * 1000u;
+        while (bladeNs < untilNs) {
+            while (bladeCursor < presses.size() &&
+                   presses[bladeCursor].releaseUs * 1000u <= bladeNs)
+                bladeCursor++;
+            if (bladeCursor >= presses.size())
+                break;
+            const Press& p = presses[bladeCursor];
+            uint64_t fromNs = (p.pressUs + p.settleUs) * 1000u;
+            uint64_t toNs   = std::min(untilNs, p.releaseUs * 1000u);
+            if (bladeNs < fromNs) bladeNs = std::min(fromNs, untilNs);
+            if (bladeNs >= toNs) {
+                if (toNs == untilNs) break;
+                continue;
+            }
+            uint32_t hz = carrierHz(p.target);
+            if (hz) {
+                // PWM libre depuis t = 0 : la porte n'en decale pas la phase
+                uint64_t periodNs = 1000000000ull / hz;
+                uint64_t k        = (bladeNs + periodNs - 1) / periodNs;
+                for (uint64_t t = k * periodNs; t < toNs; t += periodNs)
+                    feed.onRisingEdge(CLOCKS[board].localNs(t));
+            }
+            bladeNs = toNs;
+        }
+        if (bladeNs < untilNs) bladeNs = untilNs;
+    }
+
+    // Alarme du cycle EMIT / DETECT (Mode Time-Division)
+    void onTdDeadline(uint64_t nowUs) {
+        enterBoard(board, nowUs);
+        hal::sim::setInput(PIN_BUTTON, buttonLevel(presses, buttonCursor, nowUs));
+        cycle.service();
+        nextTd = CLOCKS[board].trueUs(cycle.dueUs());
+        if (nextTd <= nowUs) nextTd = nowUs + 1;
+    }
+
+    // loop1(), apres les echeances du ButtonSampler jusqu'a ce tour
+    void core1(uint64_t nowUs) {
+        flushBlade(nowUs);
+        enterBoard(board, nowUs);
+        if (td) {
+            node.loop1(cycle.state());
+            return;
+        }
+        for (uint64_t due = buttons.dueUs(); due <= hal::nowUs(); due = buttons.dueUs()) {
+            uint64_t dueTrue = CLOCKS[board].trueUs(due);
+            hal::sim::setInput(PIN_BUTTON, buttonLevel(presses, buttonCursor, dueTrue));
+            buttons.service();
+        }
+        node.loop1(buttons);
+    }
+
+    // Tours serres de l'approche d'un appui jusqu'a son dwell ; ensuite rien
+    // d'observable avant le relachement, date par le filtre du bouton
+    bool contactNear(uint64_t nowUs) const {
+        const TouchDetector& d = node.detector();
+        if (d.pressed())
+            return !d.dwell().satisfied();
+        size_t i = buttonCursor;
+        return i < presses.size() && nowUs + CORE1_IDLE_US >= presses[i].pressUs;
+    }
+
+    // loop() : evenements de la file (envoyes au central), serviceLink()
+    void core0(uint64_t nowUs) {
+        enterBoard(board, nowUs);
+        link.nowUs = nowUs;
+        FencerEvent ev;
+        while (node.pop(ev)) {}
+        node.serviceLink();
+    }
+
+    // Copies et relances dues : tours serres tant qu'un evenement est en vol
+    bool core0Busy() const { return !node.events().empty() || node.sender().inFlight(); }
+};
+
+// --- Central ------------------------------------------------------------------
+
+struct Photon {
+    uint32_t ticket;
+    size_t   phrase;
+    uint8_t  player;                // 0 : A, 1 : B
+};
+
+typedef CentralNode<SimLink, FakeNeoPixel, FakeBuzzer> CentralLoop;
+
+struct Central {
+    // Journal de CentralNode : lignes EV / VD, verdicts et lampes des phrases
+    struct Log {
+        Central*             c;
+        std::vector<Phrase>* bout;
+        size_t               phrase;
+
+        void output(const RefereeOutput& o, uint32_t ticket) {
+            if (o.kind == RefereeOutputKind::LIGHT) {
+                if (o.lamp != Lamp::NONE)
+                    c->photons.push_back({ ticket, phrase, (uint8_t)(o.player == PLAYER_B) });
+                return;
+            }
+            char line[REFEREE_LOG_LINE];
+            if (c->journal && formatVerdictLog(o, line, sizeof line))
+                std::fputs(line, c->journal);
+            // Verdict : a la phrase de sa premiere touche
+            size_t k = phrase;
+            while (k > 0 && (*bout)[k].startUs > o.hitUs) k--;
+            Phrase& p = (*bout)[k];
+            p.verdicts++;
+            p.got[0]   = o.lampA;
+            p.got[1]   = o.lampB;
+            p.gotGapUs = o.gapUs;
+        }
+
+        void event(const TouchEvent& ev, uint64_t rxUs) {
+            char line[REFEREE_LOG_LINE];
+            if (c->journal && formatEventLog(ev, rxUs, line, sizeof line))
+                std::fputs(line, c->journal);
+        }
+    };
+
+    SimLink              link;
+    FakeNeoPixel         strip;
+    FakeBuzzer           buzzer;
+    CentralLoop          node;
+    std::vector<Photon>  photons;
+    FILE*                journal = nullptr;
+    uint64_t             next    = 0;
+
+    explicit Central(Air& air) : link(air, BOARD_CENTRAL), node(link, strip, buzzer) {}
+
+    // setup() de central_firmware, point d'acces leve
+    void setup() {
+        enterBoard(BOARD_CENTRAL, 0);
+        strip.begin(PIN_LIGHTS, LAMP_PIXELS);
+        buzzer.begin(PIN_BUZZER);
+        node.listen(LINK_PORT_CENTRAL);
+    }
+
+    // loop(), puis premier photon de chaque lampe (ticket encore connu du panneau)
+    void step(uint64_t nowUs, std::vector<Phrase>& bout, size_t phrase) {
+        enterBoard(BOARD_CENTRAL, nowUs);
+        link.nowUs = nowUs;
+        Log log = { this, &bout, phrase };
+        node.loop(log);
+
+        const CentralLoop::Panel& panel = node.panel();
+        for (size_t i = 0; i < photons.size();) {
+            const Photon& ph = photons[i];
+            if (!panel.shown(ph.ticket)) { i++; continue; }
+            uint64_t& first = bout[ph.phrase].photonUs[ph.player];
+            uint64_t  at    = panel.photonUs(ph.ticket);
+            if (at && (!first || at < first)) first = at;
+            photons.erase(photons.begin() + i);
+        }
+    }
+
+    // Trame en attente d'une bande occupee ; les datagrammes reveillent seuls
+    bool busy() const { return node.panel().pending(); }
+};
+
+// --- Assaut -------------------------------------------------------------------
+
+uint64_t uniform(std::mt19937& rng, uint64_t lo, uint64_t hi) {
+    return std::uniform_int_distribution<uint64_t>(lo, hi)(rng);
+}
+
+Press makePress(std::mt19937& rng, uint64_t atUs, uint32_t durationUs, Target target) {
+    Press p;
+    p.pressUs   = atUs;
+    p.releaseUs = atUs + durationUs;
+    p.target    = target;
+    p.bounceUs  = (uint32_t)uniform(rng, 0, BOUNCE_MAX_US);
+    p.settleUs  = (uint32_t)uniform(rng, 0, SETTLE_MAX_US);
+    p.seed      = (uint32_t)rng();
+    return p;
+}
+
+// Phrases et appuis des deux tireurs, lampes attendues ; rend la fin
+uint64_t scriptBout(std::mt19937& rng, int phrases, bool td, std::vector<Phrase>& bout,
+                std::vector<Press>* presses) {
+    uint32_t tol = td ? GAP_TOL_TD_US : GAP_TOL_SIMPLE_US;
+    uint64_t t   = SYNC_WARMUP_US;
+    for (int i = 0; i < phrases; i++) {
+        Phrase p;
+        p.kind    = (Scenario)uniform(rng, 0, SCENARIOS - 1);
+        p.startUs = t;
+        p.lamp[0] = p.lamp[1] = Lamp::NONE;
+        uint8_t first  = (uint8_t)uniform(rng, 0, 1);
+        uint8_t second = !first;
+        uint64_t lastUs = t;
+        auto hit = [&](uint8_t who, uint64_t atUs, uint32_t durUs, Target target) {
+            lastUs = std::max(lastUs, atUs + durUs);
+            p.press[who] = (int)presses[who].size();
+            presses[who].push_back(makePress(rng, atUs, durUs, target));
+        };
+        auto lame = [&]() { return (uint32_t)uniform(rng, 30000, 80000); };
+        // Blanche : un appui sur trois tenu au-dela de lockoutUs + graceUs
+        auto blank = [&]() {
+            return uniform(rng, 0, 2) ? lame() : (uint32_t)uniform(rng, 335000, 2000000);
+        };
+
+        int64_t gap = -1;
+        switch (p.kind) {
+            case Scenario::SINGLE:
+                hit(first, t, lame(), Target::LAME);
+                p.lamp[first] = Lamp::VALID;
+                break;
+            case Scenario::DOUBLE:
+            case Scenario::BURST:
+                gap = (int64_t)uniform(rng, 0, LOCKOUT_US - tol - 10000);
+                break;
+            case Scenario::NEAR_DOUBLE:
+                gap = LOCKOUT_US - tol - (int64_t)uniform(rng, 0, 10000);
+                break;
+            case Scenario::NEAR_LOCKED: {
+                int64_t late = LOCKOUT_US + tol + (int64_t)uniform(rng, 0, 10000);
+                hit(first, t, lame(), Target::LAME);
+                hit(second, t + late, lame(), Target::LAME);
+                p.lamp[first] = Lamp::VALID;
+                p.gapUs = first == 0 ? late : -late;
+                break;
+            }
+            case Scenario::COQUE:
+                // Mode Simple : coque muette, la pointe ne voit rien → blanche
+                hit(first, t, blank(), Target::COQUE);
+                p.lamp[first] = td ? Lamp::NONE : Lamp::OFF_TARGET;
+                break;
+            case Scenario::COQUE_RIPOSTE:
+                hit(first, t, lame(), Target::COQUE);
+                hit(second, t + uniform(rng, 100000, 200000), lame(), Target::LAME);
+                p.lamp[first]  = td ? Lamp::NONE : Lamp::OFF_TARGET;
+                p.lamp[second] = Lamp::VALID;
+                break;
+            case Scenario::OFF_TARGET:
+                hit(first, t, blank(), Target::NOTHING);
+                p.lamp[first] = Lamp::OFF_TARGET;
+                break;
+            case Scenario::FLICK:
+                hit(first, t, (uint32_t)uniform(rng, 3000, 9000), Target::LAME);
+                break;
+        }
+        if (gap >= 0) {
+            hit(first, t, lame(), Target::LAME);
+            hit(second, t + gap, lame(), Target::LAME);
+            p.lamp[0] = p.lamp[1] = Lamp::VALID;
+            p.gapUs = first == 0 ? gap : -gap;
+        }
+        p.burst = p.kind == Scenario::BURST;
+        bout.push_back(p);
+        t = lastUs + PHRASE_SETTLE_US + uniform(rng, 0, 500000);
+    }
+    return t;
+}
+
+uint32_t exactPercentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t rank = (size_t)(p * v.size() + 0.999999);
+    if (rank == 0) rank = 1;
+    return v[std::min(v.size(), rank) - 1];
+}
+
+// Un assaut complet dans un mode ; true si tout est conforme
+bool runBout(int phrases, bool td, FILE* journal) {
+    hal::sim::reset();
+    std::mt19937 rng(td ? 2324 : 2323);
+    auto loopUs = [&](uint32_t lo, uint32_t hi) { return uniform(rng, lo, hi); };
+
+    Air air;
+    std::unique_ptr<Fencer> fencers[2] = {
+        std::unique_ptr<Fencer>(new Fencer(air, BOARD_A, td)),
+        std::unique_ptr<Fencer>(new Fencer(air, BOARD_B, td)),
+    };
+    Central central(air);
+    central.journal = journal;
+
+    std::vector<Phrase> bout;
+    std::vector<Press>  presses[2];
+    uint64_t endUs = scriptBout(rng, phrases, td, bout, presses);
+    for (uint8_t i = 0; i < 2; i++) fencers[i]->presses = presses[i];
+
+    central.setup();
+    for (auto& f : fencers) f->setup(0);
+
+    size_t   phrase = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    while (true) {
+        uint64_t now = central.next;
+        for (auto& f : fencers)
+            now = std::min(now, std::min(f->next1, std::min(f->next0, f->nextTd)));
+        uint64_t wake = air.nextWakeUs();
+        if (wake <= now) {
+            // Datagramme arrive : son destinataire fait un tour dans la periode
+            now = wake;
+            for (Air::Flight& fl : air.flights) {
+                if (fl.woke || fl.atUs > now) continue;
+                fl.woke = true;
+                if (fl.to == BOARD_CENTRAL)
+                    central.next = std::min(central.next, now + loopUs(CENTRAL_MIN_US, CENTRAL_MAX_US));
+                else {
+                    Fencer& f = *fencers[fl.to - BOARD_A];
+                    f.next0 = std::min(f.next0, now + loopUs(CORE0_MIN_US, CORE0_MAX_US));
+                }
+            }
+            continue;
+        }
+        if (now > endUs) break;
+        while (phrase + 1 < bout.size() && bout[phrase + 1].startUs <= now) phrase++;
+
+        // Rafale de pertes : de la premiere touche + 15 ms, 10 a 30 ms
+        const Phrase& cur = bout[phrase];
+        if (cur.burst && air.blackoutFromUs < cur.startUs) {
+            air.blackoutFromUs = cur.startUs + DWELL_MIN_US;
+            air.blackoutToUs   = air.blackoutFromUs + uniform(rng, 10000, 30000);
+        }
+
+        for (auto& fp : fencers) {
+            Fencer& f = *fp;
+            if (now == f.nextTd) {
+                // La porte de GP17 va changer : la pointe adverse voit l'etat d'avant
+                fencers[f.board == BOARD_A]->flushBlade(now);
+                f.onTdDeadline(now);
+            }
+            if (now == f.next1) {
+                f.core1(now);
+                if (!f.node.events().empty())
+                    f.next0 = std::min(f.next0, now + loopUs(CORE0_MIN_US, CORE0_MAX_US));
+                f.next1 = now + (f.contactNear(now) ? loopUs(CORE1_MIN_US, CORE1_MAX_US) : CORE1_IDLE_US);
+            }
+            if (now == f.next0) {
+                f.core0(now);
+                f.next0 = now + (f.core0Busy() ? loopUs(CORE0_MIN_US, CORE0_MAX_US) : LOOP_IDLE_US);
+            }
+        }
+        if (now == central.next) {
+            central.step(now, bout, phrase);
+            central.next = now + (central.busy() ? loopUs(CENTRAL_MIN_US, CENTRAL_MAX_US) : LOOP_IDLE_US);
+        }
+    }
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // --- Verifications ----------------------------------------------------------
+    double simS = endUs / 1e6;
+    std::printf("\n=== Mode %s : %d phrases, %.0f s simulees en %.2f s "
+                "(%.0f x temps reel, %.0f phrases/s)\n",
+                td ? "Time-Division" : "Simple", phrases, simS, wallS,
+                wallS > 0 ? simS / wallS : 0.0, wallS > 0 ? phrases / wallS : 0.0);
+    uint32_t tol    = td ? GAP_TOL_TD_US : GAP_TOL_SIMPLE_US;
+    uint32_t budget = td ? LIGHT_BUDGET_TD_US : LIGHT_BUDGET_SIMPLE_US;
+    uint32_t count[SCENARIOS] = {}, wrong[SCENARIOS] = {};
+    uint32_t wrongTotal = 0, gapBad = 0, overBudget = 0, noPhoton = 0;
+    int64_t  gapErrMax = 0;
+    std::vector<uint32_t> lightUs, whiteUs;
+    for (const Phrase& p : bout) {
+        uint8_t s = (uint8_t)p.kind;
+        count[s]++;
+        bool expectVerdict = p.lamp[0] != Lamp::NONE || p.lamp[1] != Lamp::NONE;
+        bool ok = p.verdicts == (expectVerdict ? 1 : 0) &&
+                  (!expectVerdict || (p.got[0] == p.lamp[0] && p.got[1] == p.lamp[1]));
+        if (!ok) {
+            if (wrongTotal++ < 5)
+                std::printf("  /!\\ %s a %.3f s : attendu %s / %s, %u verdict(s) %s / %s, "
+                            "ecart vrai %.1f ms, mesure %.1f ms\n",
+                            scenarioText(p.kind), p.startUs / 1e6, lampText(p.lamp[0]),
+                            lampText(p.lamp[1]), p.verdicts, lampText(p.got[0]),
+                            lampText(p.got[1]), p.gapUs / 1000.0, p.gotGapUs / 1000.0);
+            wrong[s]++;
+            continue;
+        }
+        if (p.lamp[0] == Lamp::VALID && p.lamp[1] == Lamp::VALID) {
+            int64_t err = (int64_t)p.gotGapUs - p.gapUs;
+            if (err < 0) err = -err;
+            if (err > gapErrMax) gapErrMax = err;
+            if (err > tol) gapBad++;
+        }
+        for (uint8_t k = 0; k < 2; k++) {
+            if (p.lamp[k] == Lamp::NONE) continue;
+            if (!p.photonUs[k]) { noPhoton++; continue; }
+            if (p.burst) continue;
+            // Blanche : declaree a appui + 15 ms (DWELL classe NONE), comptee depuis
+            const Press& pr = presses[k][p.press[k]];
+            bool white  = p.lamp[k] == Lamp::OFF_TARGET;
+            uint32_t us = (uint32_t)(p.photonUs[k] - pr.pressUs - (white ? DWELL_MIN_US : 0));
+            (white ? whiteUs : lightUs).push_back(us);
+            if (us > budget) overBudget++;
+        }
+    }
+    const RefereeStats& rs = central.node.referee().stats();
+
+    // --- Rapport ----------------------------------------------------------------
+    std::printf("  %-20s %6s %8s\n", "scenario", "n", "faux");
+    for (uint8_t s = 0; s < SCENARIOS; s++)
+        std::printf("  %-20s %6u %8u\n", scenarioText((Scenario)s), count[s], wrong[s]);
+    std::printf("  ecart B-A des doubles : erreur max %.1f ms (tolerance %.1f) | hors tolerance %u\n",
+                gapErrMax / 1000.0, tol / 1000.0, gapBad);
+    std::printf("  contact -> photon : p50 %.1f | p99 %.1f | max %.1f ms (budget %.0f) | "
+                "hors budget %u | sans photon %u\n",
+                exactPercentile(lightUs, 0.5) / 1000.0, exactPercentile(lightUs, 0.99) / 1000.0,
+                lightUs.empty() ? 0.0 : *std::max_element(lightUs.begin(), lightUs.end()) / 1000.0,
+                budget / 1000.0, overBudget, noPhoton);
+    std::printf("  appui + 15 ms -> photon (blanches) : p50 %.1f | max %.1f ms\n",
+                exactPercentile(whiteUs, 0.5) / 1000.0,
+                whiteUs.empty() ? 0.0 : *std::max_element(whiteUs.begin(), whiteUs.end()) / 1000.0);
+    std::printf("  arbitrage : touches %u | verdicts %u | tardives %u | non synchro %u | "
+                "verrouillees %u | corrigees %u\n",
+                rs.hits, rs.verdicts, rs.late, rs.unsynced, rs.locked, rs.corrections);
+    std::printf("  air : datagrammes %u | perdus %u | en rafale %u | doublons %u | synchro %u\n",
+                air.sent, air.lost, air.blackedOut, central.node.receiver().duplicates(),
+                central.node.syncReplies());
+    for (auto& f : fencers)
+        std::printf("  tireur %c : envoyes %u acquittes %u abandonnes %u | file perdus %u | "
+                    "synchro ±%u µs\n",
+                    f->board == BOARD_A ? 'A' : 'B', f->node.sender().stats().queued,
+                    f->node.sender().stats().acked,
+                    f->node.sender().stats().expired + f->node.sender().stats().overflow,
+                    f->node.lostEvents(), f->node.clockSync().uncertaintyUs(CLOCKS[f->board].local(endUs)));
+    char line[96];
+    std::printf("  [LATENCE] premier front GP2 -> etape, %lu dwell (central)\n",
+                (unsigned long)central.node.latency().events());
+    for (uint8_t i = 0; i < LATENCY_STAGES; i++)
+        if (formatLatencyLine(central.node.latency(), (LatencyStage)i, line, sizeof line))
+            std::printf("  %s", line);
+
+    return wrongTotal == 0 && gapBad == 0 && overBudget == 0 && noPhoton == 0 && rs.late == 0 &&
+           rs.unsynced == 0;
+}
+
+}  // namespace
+
+int simBout(int argc, char** argv) {
+    int phrases = argc >= 1 ? std::atoi(argv[0]) : 2000;
+    if (phrases <= 0) phrases = 2000;
+    bool simple = true, td = true;
+    if (argc >= 2) {
+        simple = std::strcmp(argv[1], "simple") == 0;
+        td     = std::strcmp(argv[1], "td") == 0;
+        if (!simple && !td) {
+            std::fprintf(stderr, "mode inconnu : %s (simple | td)\n", argv[1]);
+            return 2;
+        }
+    }
+    FILE* journal = nullptr;
+    if (argc >= 3) {
+        journal = std::fopen(argv[2], "w");
+        if (!journal) {
+            std::fprintf(stderr, "impossible d'ecrire %s\n", argv[2]);
+            return 2;
+        }
+    }
+
+    std::printf("Assauts simules : tireurs A (%u Hz) et B (%u Hz), coque %u Hz, "
+                "verrouillage %u ms\n",
+                FREQ_VALID_A, FREQ_VALID_B, FREQ_NEUTRE, LOCKOUT_US / 1000);
+    std::printf("  air %u-%u ms, %u %% de pertes ; horloges A +%.1f s %+.0f ppm, B +%.1f s %+.0f ppm\n",
+                AIR_MIN_US / 1000, AIR_MAX_US / 1000, AIR_LOSS_PERMILLE / 10,
+                CLOCKS[BOARD_A].offsetUs / 1e6, CLOCKS[BOARD_A].driftPpb / 1000.0,
+                CLOCKS[BOARD_B].offsetUs / 1e6, CLOCKS[BOARD_B].driftPpb / 1000.0);
+
+    bool ok = true;
+    if (simple) ok = runBout(phrases, false, journal) && ok;
+    if (td)     ok = runBout(phrases, true, journal) && ok;
+    if (journal) std::fclose(journal);
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,403 @@
+// =============================================================================
+// sim_calibration.cpp — Calibration des bandes au branchement, sur hote
+// =============================================================================
+//
+// 1. CALIBRATION SIMULEE : `essais` tireurs (porteuse VALID_A), materiel
+//    tire au hasard (randomChainParams). Chaque etape du firmware est
+//    rejouee : jusqu'a CAL_PRESSES appuis de CAL_PRESS_MS a des endroits
+//    differents (resistance du contact et capacite de la cuirasse retirees
+//    a chaque appui), chaine analogique → FakeEdgeTimer →
+//    CalibrationSampler. Les evenements CALIBRATION passent par le journal
+//    Serial (lignes CAL, formatees puis relues) avant
+//    CalibrationSet::derive().
+//
+//    Deux materiels : nominal (la pointe voit les centres de FREQ_PLAN) et
+//    decale (chaque porteuse adverse vue a ±SHIFT_MIN..SHIFT_MAX pour mille
+//    de son centre, tire par tireur) : la chaine simulee ne deplace pas la
+//    frequence, le decalage tient lieu des 16 / 20 kHz du plan.
+//
+// 2. TOUCHES : pour chaque tireur calibre, TOUCHES appuis de 30 ms sur
+//    chaque porteuse, a de nouveaux endroits, juges par deux TouchDetector :
+//    FREQ_PLAN compile et plan calibre (setPlan). Juste / fausse / aucune,
+//    confiance et delai de decision.
+//
+// 3. STOCKAGE : aller-retour FakePlanStore, CRC corrompu, flash effacee,
+//    empreinte d'un autre plan compile, enregistrement tronque, bande de
+//    largeur nulle.
+//
+// Verifie : le plan calibre decide juste au moins aussi souvent que
+// FREQ_PLAN sur le materiel nominal, plus souvent sur le materiel decale,
+// jamais avec plus de decisions fausses ; (3) sans ecart.
+//
+// Journal enregistre (capture Serial du fencer_firmware, lignes CAL) :
+// les echantillons sont relus, le plan derive et affiche ; OK si la
+// derivation aboutit.
+//
+// USAGE : program calib [essais, defaut 20 | journal]
+// =============================================================================
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <band_plan.h>
+#include <byte_order.h>
+#include <carrier_calibration.h>
+#include <crc16.h>
+#include <fencer_event.h>
+#include <hal.h>
+#include <pio_edge_timer.h>
+#include <signal_chain.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint8_t  PIN_EMIT      = 14;
+const uint32_t LOOP_US       = 50;
+const uint32_t CAL_PRESSES   = 12;      // appuis au plus par etape (delai du firmware)
+const uint32_t CAL_PRESS_MS  = 150;
+const uint32_t TOUCH_MS      = 30;
+const uint32_t TOUCHES       = 8;       // par porteuse et par tireur
+const FreqClass OWN_CLASS    = FreqClass::VALID_A;
+const uint32_t SHIFT_MIN     = 40;      // pour mille
+const uint32_t SHIFT_MAX     = 90;
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+};
+
+// Frequence vue par la pointe du tireur, par porteuse
+struct Seen {
+    uint32_t hz[FREQ_PLAN_SIZE];
+
+    uint32_t of(FreqClass cls) const {
+        for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+            if (FREQ_PLAN[i].cls == cls) return hz[i];
+        return 0;
+    }
+};
+
+Seen seenCarriers(bool shifted, std::mt19937& rng) {
+    Seen s;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+        s.hz[i] = FREQ_PLAN[i].centerHz;
+        if (!shifted || FREQ_PLAN[i].cls == OWN_CLASS)
+            continue;
+        uint32_t permille = SHIFT_MIN + rng() % (SHIFT_MAX - SHIFT_MIN + 1);
+        uint32_t delta    = s.hz[i] * permille / 1000u;
+        s.hz[i] = rng() & 1 ? s.hz[i] + delta : s.hz[i] - delta;
+    }
+    return s;
+}
+
+// Un autre endroit de la cuirasse : contact et capacite differents
+ChainParams atSpot(const ChainParams& p, std::mt19937& rng) {
+    ChainParams q = p;
+    q.pathOhm   *= std::uniform_real_distribution<double>(0.6, 1.6)(rng);
+    q.cuirasseF *= std::uniform_real_distribution<double>(0.5, 2.0)(rng);
+    return q;
+}
+
+// Un appui avec contact sur la porteuse `freqHz` ; `step(t, down, edgeUs,
+// timer)` est appele a chaque tour de boucle
+template <typename Step>
+void runPress(const ChainParams& p, uint32_t freqHz, uint32_t seed, uint32_t contactMs,
+              Step step) {
+    hal::sim::reset();
+    hal::pwmStart(PIN_EMIT, freqHz);
+
+    SignalChain chain(p, ChainPath::CONTACT, seed);
+    FakeEdgeTimer timer(1000000000u);
+    EdgeTimerFeed<FakeEdgeTimer> feed(timer);
+    std::vector<uint64_t> rising;
+
+    const uint64_t pressUs   = 1000;
+    const uint64_t releaseUs = pressUs + (uint64_t)contactMs * 1000u;
+    for (uint64_t t = LOOP_US; t <= releaseUs + 2 * LOOP_US; t += LOOP_US) {
+        rising.clear();
+        chain.runHal(t * 1000u, PIN_EMIT, rising);
+        for (uint64_t e : rising) feed.onRisingEdge(e);
+        bool down = t >= pressUs && t < releaseUs;
+        step(t, down, down ? pressUs : releaseUs, timer);
+    }
+}
+
+// Etape de calibration : evenements → journal → CalibrationSet
+void calibrateStep(const ChainParams& p, const Seen& seen, FreqClass cls, std::mt19937& rng,
+                   CalibrationSet& set, uint32_t& lines) {
+    for (uint32_t k = 0; k < CAL_PRESSES && !set.complete(cls); k++) {
+        Collect sink;
+        // Un sampler par appui : l'horloge simulee repart de zero ; le
+        // numero d'appui est celui du firmware
+        CalibrationSampler s(1000000000u);
+        s.setTarget(cls);
+        runPress(atSpot(p, rng), seen.of(cls), rng(), CAL_PRESS_MS,
+                 [&](uint64_t t, bool down, uint64_t edgeUs, FakeEdgeTimer& timer) {
+                     s.step(t, down, edgeUs, timer, sink);
+                 });
+        for (const FencerEvent& ev : sink.events) {
+            char line[48];
+            if (formatCalibrationLog(ev.cls, k + 1, ev.freqHz, line, sizeof line) == 0)
+                continue;
+            FreqClass c;
+            uint32_t press, hz;
+            if (parseCalibrationLog(line, c, press, hz) && set.add(c, press, hz))
+                lines++;
+        }
+    }
+}
+
+struct Score {
+    uint32_t right = 0, wrong = 0, none = 0;
+    uint64_t latencyUs = 0;
+    uint64_t confidence = 0;
+};
+
+void runTouch(const ChainParams& p, uint32_t freqHz, FreqClass truth, const BandPlan* plan,
+              uint32_t seed, Score& s) {
+    TouchDetector detector(1000000000u, 0);
+    if (plan) detector.setPlan(plan);
+    Collect sink;
+    runPress(p, freqHz, seed, TOUCH_MS,
+             [&](uint64_t t, bool down, uint64_t edgeUs, FakeEdgeTimer& timer) {
+                 detector.stepFiltered(t, down, edgeUs, timer, sink);
+             });
+    const FencerEvent* decision = nullptr;
+    uint64_t pressUs = 0;
+    for (const FencerEvent& ev : sink.events) {
+        if (ev.type == FencerEventType::BUTTON_DOWN) pressUs = ev.tUs;
+        if (ev.type == FencerEventType::DECISION) decision = &ev;
+    }
+    if (!decision) {
+        s.none++;
+        return;
+    }
+    decision->cls == truth ? s.right++ : s.wrong++;
+    s.latencyUs  += decision->tUs - pressUs;
+    s.confidence += decision->value;
+}
+
+void printPlan(const char* title, const BandPlan& plan) {
+    std::printf("  %s :", title);
+    for (uint8_t i = 0; i < plan.count; i++)
+        std::printf("  %s %lu..%lu Hz", freqClassLabel(plan.bands[i].cls),
+                    (unsigned long)plan.bands[i].loHz(), (unsigned long)plan.bands[i].hiHz());
+    std::printf("\n");
+}
+
+void printReport(const CalReport& rep) {
+    for (const CalCarrier& c : rep.carriers) {
+        if (!c.calibrated) {
+            std::printf("  %-20s non calibree (FREQ_PLAN)\n", freqClassLabel(c.cls));
+            continue;
+        }
+        std::printf("  %-20s %3u echantillons (%u ecartes), %2u appuis | %lu / %lu / %lu Hz | %s\n",
+                    freqClassLabel(c.cls), c.samples, c.rejected, c.presses, (unsigned long)c.loHz,
+                    (unsigned long)c.medianHz, (unsigned long)c.hiHz, calStatusText(c.status));
+    }
+}
+
+bool samePlan(const BandPlan& a, const BandPlan& b) {
+    if (a.count != b.count) return false;
+    for (uint8_t i = 0; i < a.count; i++)
+        if (a.bands[i].cls != b.bands[i].cls || a.bands[i].centerHz != b.bands[i].centerHz ||
+            a.bands[i].toleranceHz != b.bands[i].toleranceHz)
+            return false;
+    return true;
+}
+
+bool checkStore(const BandPlan& plan) {
+    FakePlanStore store;
+    BandPlan got = {};
+    bool erased = !store.load(got);
+    bool saved  = store.save(plan) && store.load(got) && samePlan(plan, got);
+
+    uint8_t* raw = store.raw();
+    raw[CAL_RECORD_HEADER + 3] ^= 0x10;
+    bool crcRejected = !store.load(got);
+    raw[CAL_RECORD_HEADER + 3] ^= 0x10;
+
+    // Enregistrement d'un autre plan compile : empreinte differente, CRC juste
+    uint8_t buf[CAL_RECORD_MAX];
+    size_t n = encodeBandPlan(plan, buf, sizeof buf);
+    buf[6] ^= 0xFF;
+    put16(buf + n - 2, crc16(buf, n - 2));
+    bool tagRejected = !decodeBandPlan(buf, n, got);
+    buf[6] ^= 0xFF;
+
+    bool truncated = !decodeBandPlan(buf, n - 1, got);
+    BandPlan zero = plan;
+    zero.bands[0].toleranceHz = 0;
+    bool invalid   = encodeBandPlan(BandPlan{ 2, { FREQ_PLAN[0], FREQ_PLAN[0] } }, buf, sizeof buf) == 0 &&
+                     encodeBandPlan(zero, buf, sizeof buf) == 0;
+
+    bool ok = erased && saved && crcRejected && tagRejected && truncated && invalid;
+    std::printf("  effacee %s | aller-retour %s | CRC %s | autre plan %s | tronque %s | "
+                "plan invalide %s → %s\n",
+                erased ? "refusee" : "LUE", saved ? "ok" : "ECART",
+                crcRejected ? "refuse" : "ACCEPTE", tagRejected ? "refuse" : "ACCEPTE",
+                truncated ? "refuse" : "ACCEPTE", invalid ? "refuse" : "ACCEPTE",
+                ok ? "OK" : "ECART");
+    return ok;
+}
+
+int replayLog(const char* path) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) {
+        std::printf("impossible d'ouvrir %s\n", path);
+        return 1;
+    }
+    CalibrationSet set;
+    set.clear();
+    char line[256];
+    uint32_t lines = 0, kept = 0;
+    while (std::fgets(line, sizeof line, f)) {
+        FreqClass cls;
+        uint32_t press, hz;
+        if (!parseCalibrationLog(line, cls, press, hz))
+            continue;
+        lines++;
+        if (set.add(cls, press, hz)) kept++;
+    }
+    std::fclose(f);
+
+    std::printf("Journal %s : %u lignes CAL, %u echantillons retenus\n\n", path, lines, kept);
+    BandPlan plan = defaultBandPlan();
+    CalReport rep;
+    CalStatus st = set.derive(plan, &rep);
+    printReport(rep);
+    std::printf("\n");
+    printPlan("FREQ_PLAN", defaultBandPlan());
+    if (st == CalStatus::OK)
+        printPlan("calibre  ", plan);
+    std::printf("\n  derivation : %s\n", calStatusText(st));
+
+    bool ok = st == CalStatus::OK;
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
+
+struct Scenario {
+    const char* name;
+    bool        shifted;
+    uint32_t    derived = 0, lines = 0;
+    uint32_t    status[6] = {};
+    Score       def, cal;
+    bool        shown = false;
+    BandPlan    sample = {};
+};
+
+void runScenario(Scenario& sc, int trials, std::mt19937& rng) {
+    const FreqClass steps[] = {
+        OWN_CLASS == FreqClass::VALID_A ? FreqClass::VALID_B : FreqClass::VALID_A,
+        FreqClass::NEUTRE,
+    };
+
+    for (int i = 0; i < trials; i++) {
+        ChainParams p = randomChainParams(rng);
+        Seen seen = seenCarriers(sc.shifted, rng);
+
+        // --- 1. Calibration
+        CalibrationSet set;
+        set.clear();
+        bool complete = true;
+        for (FreqClass cls : steps) {
+            calibrateStep(p, seen, cls, rng, set, sc.lines);
+            complete = complete && set.complete(cls);
+        }
+        // Etape inachevee au bout du delai : le firmware garde son plan
+        BandPlan plan = {};
+        CalReport rep;
+        CalStatus st = complete ? set.derive(plan, &rep) : CalStatus::TOO_FEW;
+        sc.status[(uint8_t)st]++;
+        if (st != CalStatus::OK)
+            continue;
+        sc.derived++;
+        if (!sc.shown) {
+            std::printf("Premier tireur calibre, materiel %s :\n", sc.name);
+            printReport(rep);
+            printPlan("FREQ_PLAN", defaultBandPlan());
+            printPlan("calibre  ", plan);
+            std::printf("\n");
+            sc.sample = plan;
+            sc.shown  = true;
+        }
+
+        // --- 2. Touches, memes endroits pour les deux plans
+        for (const CarrierBand& band : FREQ_PLAN) {
+            for (uint32_t k = 0; k < TOUCHES; k++) {
+                ChainParams q = atSpot(p, rng);
+                uint32_t seed = rng();
+                runTouch(q, seen.of(band.cls), band.cls, nullptr, seed, sc.def);
+                runTouch(q, seen.of(band.cls), band.cls, &plan, seed, sc.cal);
+            }
+        }
+    }
+}
+
+void printScenario(const Scenario& sc, int trials) {
+    std::printf("  materiel %s : %u / %d plans derives, %u lignes CAL", sc.name, sc.derived,
+                trials, sc.lines);
+    for (uint8_t s = 1; s < 6; s++)
+        if (sc.status[s])
+            std::printf(" | %s %u", calStatusText((CalStatus)s), sc.status[s]);
+    std::printf("\n");
+
+    uint32_t touches = sc.def.right + sc.def.wrong + sc.def.none;
+    const Score* scores[] = { &sc.def, &sc.cal };
+    const char*  names[]  = { "FREQ_PLAN", "calibre" };
+    for (int k = 0; k < 2; k++) {
+        const Score& s = *scores[k];
+        uint32_t decided = s.right + s.wrong;
+        std::printf("    %-10s | %4u touches | juste %5.1f %% | fausse %5.1f %% | aucune %5.1f %% | "
+                    "confiance %4.0f | decision %5.0f us\n",
+                    names[k], touches, touches ? 100.0 * s.right / touches : 0.0,
+                    touches ? 100.0 * s.wrong / touches : 0.0,
+                    touches ? 100.0 * s.none / touches : 0.0,
+                    decided ? (double)s.confidence / decided : 0.0,
+                    decided ? (double)s.latencyUs / decided : 0.0);
+    }
+}
+
+}  // namespace
+
+int simCalibration(int argc, char** argv) {
+    if (argc >= 1 && !std::isdigit((unsigned char)argv[0][0]))
+        return replayLog(argv[0]);
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 20;
+    if (trials <= 0) trials = 20;
+
+    std::printf("Tireur %s : %u appuis de %u ms au plus par etape, %d jeux de materiel\n\n",
+                freqClassLabel(OWN_CLASS), CAL_PRESSES, CAL_PRESS_MS, trials);
+
+    std::mt19937 rng(25);
+    Scenario nominal, shifted;
+    nominal.name    = "nominal";
+    nominal.shifted = false;
+    shifted.name    = "decale";
+    shifted.shifted = true;
+    runScenario(nominal, trials, rng);
+    runScenario(shifted, trials, rng);
+
+    std::printf("1-2. Calibration et touches\n");
+    printScenario(nominal, trials);
+    printScenario(shifted, trials);
+
+    std::printf("\n3. Stockage\n");
+    bool ok = checkStore(nominal.shown ? nominal.sample : defaultBandPlan());
+
+    ok = ok && nominal.derived > 0 && shifted.derived > 0 &&
+         nominal.cal.right >= nominal.def.right && nominal.cal.wrong <= nominal.def.wrong &&
+         shifted.cal.right > shifted.def.right && shifted.cal.wrong <= shifted.def.wrong;
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+// =============================================================================
+// sim_chain.cpp — Chaine analogique simulee → vrai code de detection
+// =============================================================================
+//
+// 1. RESULTATS DU BANC (signal_chain.h, valeurs nominales) : le modele doit
+//    retrouver ce que le plan a mesure, frequence comptee sur une fenetre de
+//    50 ms comme phase1_5 :
+//      Phase 1    pull-up 10 kΩ : 20 kHz perdu ; 100 Ω : 20 kHz exact
+//      Phase 1.7  fil du fleuret 10 nF : 20 kHz perdu, 1 kHz exact
+//      Phase 1.5  emission sur sa ligne C : 20 kHz present sur B
+//
+// 2. PLAN COMPILE : pour chaque porteuse de FREQ_PLAN, `essais` jeux de
+//    materiel tires au hasard (randomChainParams). Le generateur passe par
+//    hal::pwmStart (frequence reellement produite), la chaine par runHal,
+//    les fronts par FakeEdgeTimer dans TouchDetector (boucle de 50 µs).
+//    Resultat : DECISION juste / fausse / absente, fronts perdus.
+//
+// 3. CANDIDATES (liste de sweep.h, 1 a 3 kHz par defaut) : part des jeux de
+//    materiel ou la porteuse passe (moins de 5 % de fronts perdus, frequence
+//    a ±1 %). Meme question que sweeprank, sans banc.
+//
+// Verifie les resultats du banc (1) ; (2) et (3) sont des mesures.
+//
+// USAGE : program chainsim [essais, defaut 300] [liste de frequences]
+// =============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <classifier.h>
+#include <edge_counter.h>
+#include <fencer_event.h>
+#include <hal.h>
+#include <pio_edge_timer.h>
+#include <signal_chain.h>
+#include <sweep.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint8_t  PIN_EMIT       = 14;     // GP14 : MOSFET d'emission (Mode Simple)
+const uint32_t SETTLE_MS      = 5;
+const uint32_t WINDOW_MS      = 50;     // MEASURE_PERIOD de phase1_5
+const uint32_t CONTACT_MS     = 30;
+const uint32_t LOOP_US        = 50;
+const uint32_t PASS_LOSS_PERMILLE = 50;
+const uint32_t PASS_ERR_PERMILLE  = 10;
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+};
+
+// Frequence comptee sur WINDOW_MS apres SETTLE_MS d'emission
+uint32_t countedHz(const ChainParams& p, ChainPath path, uint32_t freqHz) {
+    SignalChain chain(p, path);
+    std::vector<uint64_t> rising;
+    chain.run((uint64_t)SETTLE_MS * 1000000u, freqHz, rising);
+    rising.clear();
+    chain.run((uint64_t)(SETTLE_MS + WINDOW_MS) * 1000000u, freqHz, rising);
+    return windowFreqHz((uint32_t)rising.size(), WINDOW_MS);
+}
+
+bool checkBench(const char* name, uint32_t emitted, uint32_t measured, bool shouldPass) {
+    bool passes = measured * 1000u >= emitted * (1000u - PASS_ERR_PERMILLE) &&
+                  measured * 1000u <= emitted * (1000u + PASS_ERR_PERMILLE);
+    bool ok = passes == shouldPass;
+    std::printf("  %-40s %6u Hz → %6u Hz  attendu %-6s %s\n", name, emitted, measured,
+                shouldPass ? "passe" : "perdu", ok ? "ok" : "ECHEC");
+    return ok;
+}
+
+struct CarrierResult {
+    int      right = 0, wrong = 0, none = 0;
+    uint64_t expected = 0, received = 0;
+};
+
+// Un appui avec contact sur la cuirasse emettrice, detection complete
+void runContact(const ChainParams& p, uint32_t freqHz, FreqClass truth, uint32_t seed,
+                CarrierResult& r) {
+    hal::sim::reset();
+    uint32_t emitted = hal::pwmStart(PIN_EMIT, freqHz);
+
+    SignalChain chain(p, ChainPath::CONTACT, seed);
+    FakeEdgeTimer timer(1000000000u);
+    EdgeTimerFeed<FakeEdgeTimer> feed(timer);
+    TouchDetector detector(timer.tickHz(), 0);
+    Collect sink;
+    std::vector<uint64_t> rising;
+
+    const uint64_t pressUs   = 1000;
+    const uint64_t releaseUs = pressUs + (uint64_t)CONTACT_MS * 1000u;
+    uint64_t edgesInContact = 0;
+    for (uint64_t t = LOOP_US; t <= releaseUs + 2 * LOOP_US; t += LOOP_US) {
+        rising.clear();
+        chain.runHal(t * 1000u, PIN_EMIT, rising);
+        for (uint64_t e : rising) {
+            feed.onRisingEdge(e);
+            if (e >= pressUs * 1000u && e < releaseUs * 1000u) edgesInContact++;
+        }
+        bool down = t >= pressUs && t < releaseUs;
+        detector.stepFiltered(t, down, down ? pressUs : releaseUs, timer, sink);
+    }
+
+    r.expected += (uint64_t)emitted * CONTACT_MS / 1000u;
+    r.received += edgesInContact;
+    const FencerEvent* decision = nullptr;
+    for (const FencerEvent& ev : sink.events)
+        if (ev.type == FencerEventType::DECISION) decision = &ev;
+    if (!decision)              r.none++;
+    else if (decision->cls == truth) r.right++;
+    else                        r.wrong++;
+}
+
+}  // namespace
+
+int simChain(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 300;
+    if (trials <= 0) trials = 300;
+    SweepList list = defaultSweepList();
+    if (argc >= 2 && !parseSweepList(argv[1], list)) {
+        std::printf("liste invalide : %s\n", argv[1]);
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // --- 1. Resultats du banc -------------------------------------------------
+    std::printf("1. Resultats du banc (materiel nominal, fenetre %u ms)\n", WINDOW_MS);
+    bool ok = true;
+    ChainParams bare;                  // cuirasse seule, sans fleuret
+    bare.bladeF = 0;
+    ChainParams weak = bare;
+    weak.pullUpOhm = 10000;
+    ChainParams nominal;
+    ok &= checkBench("Phase 1   pull-up 10 kOhm, sans fleuret", 20000,
+                     countedHz(weak, ChainPath::CONTACT, 20000), false);
+    ok &= checkBench("Phase 1   pull-up 100 Ohm, sans fleuret", 20000,
+                     countedHz(bare, ChainPath::CONTACT, 20000), true);
+    ok &= checkBench("Phase 1.7 fil du fleuret 10 nF", 20000,
+                     countedHz(nominal, ChainPath::CONTACT, 20000), false);
+    ok &= checkBench("Phase 1.7 fil du fleuret 10 nF", 1000,
+                     countedHz(nominal, ChainPath::CONTACT, 1000), true);
+    ok &= checkBench("Phase 1.5 emission sur C, lue sur B", 20000,
+                     countedHz(nominal, ChainPath::COUPLING, 20000), true);
+
+    // --- 2. Plan compile ------------------------------------------------------
+    std::printf("\n2. Plan compile, %d jeux de materiel par porteuse (TouchDetector)\n", trials);
+    std::mt19937 rng(17);
+    std::vector<ChainParams> sets;
+    for (int i = 0; i < trials; i++)
+        sets.push_back(randomChainParams(rng));
+
+    for (const CarrierBand& band : FREQ_PLAN) {
+        CarrierResult r;
+        for (int i = 0; i < trials; i++)
+            runContact(sets[i], band.centerHz, band.cls, (uint32_t)i + 1, r);
+        double loss = r.expected ? 100.0 * (1.0 - (double)r.received / r.expected) : 0;
+        std::printf("  %-20s juste %5.1f %% | fausse %5.1f %% | aucune %5.1f %% | fronts perdus %5.1f %%\n",
+                    band.label, 100.0 * r.right / trials, 100.0 * r.wrong / trials,
+                    100.0 * r.none / trials, loss < 0 ? 0 : loss);
+    }
+
+    // --- 3. Porteuses candidates ----------------------------------------------
+    std::printf("\n3. Porteuses candidates : part des jeux de materiel ou elles passent\n");
+    for (uint8_t s = 0; s < list.size; s++) {
+        uint32_t f = list.freqHz[s];
+        int pass = 0;
+        for (int i = 0; i < trials; i++) {
+            SignalChain chain(sets[i], ChainPath::CONTACT, (uint32_t)i + 1);
+            std::vector<uint64_t> rising;
+            chain.run((uint64_t)SETTLE_MS * 1000000u, f, rising);
+            rising.clear();
+            chain.run((uint64_t)(SETTLE_MS + WINDOW_MS) * 1000000u, f, rising);
+            uint32_t expected = f * WINDOW_MS / 1000u;
+            uint32_t got      = (uint32_t)rising.size();
+            uint32_t lost     = got < expected ? expected - got : 0;
+            uint32_t meanHz   = rising.size() >= 2
+                ? (uint32_t)((rising.size() - 1) * 1e9 / (double)(rising.back() - rising.front()) + 0.5)
+                : 0;
+            uint32_t err = meanHz > f ? meanHz - f : f - meanHz;
+            if (lost * 1000u <= expected * PASS_LOSS_PERMILLE && err * 1000u <= f * PASS_ERR_PERMILLE)
+                pass++;
+        }
+        std::printf("  %6u Hz  %5.1f %%\n", f, 100.0 * pass / trials);
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\n  duree %.1f s\n", secs);
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
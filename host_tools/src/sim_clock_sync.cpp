@@ -0,0 +1,234 @@
+// =============================================================================
+// sim_clock_sync.cpp — Synchronisation d'horloge tireur → central simulee
+// =============================================================================
+//
+// Temps reel simule T (µs) = horloge du central. Le tireur compte
+//   L(T) = L0 + T . (1 + derive) + variation thermique (sinus de ±2 ppm,
+//   periode 120 s)
+// et fait tourner ClockSync comme loop() : poll() tous les LOOP_US, reponse
+// traitee a son arrivee (t4 = L a l'arrivee).
+//
+// Reseau, chaque sens independamment : BASE_US + exponentielle de moyenne
+// "gigue", et SPIKE_PROB de retransmission WiFi (+5 a 30 ms) ; LOSS_PROB de
+// pertes. Le central repond apres 50 a 300 µs.
+//
+// Redemarrage du central (colonne redem.) : a restartS, le central se tait
+// BOOT_US puis repart avec une horloge C(T) = T − instant du redemarrage
+// (time_us_64() de nouveau a zero) ; avant, C(T) = T.
+//
+// Apres WARMUP_US, toutes les 10 ms : erreur = toCentral(L(T)) − C(T), et
+// l'incertitude annoncee (syncUs) doit la couvrir. Comparaisons :
+//   arrivee  ordonner a la reception au central (avant ce module) : erreur
+//            = temps de vol d'un evenement
+//   naif     offset du dernier echange seul, sans filtre ni derive
+//
+// Verifie, par scenario : |erreur| p99 < 1 ms et max < 2 ms (la tolerance
+// FIE du verrouillage est de ±25 ms), erreur couverte par l'incertitude
+// annoncee dans 99.9 % des cas au moins ; un saut d'offset detecte par
+// redemarrage du central et aucun sinon, mesures reprises RESYNC_US apres
+// la premiere reponse du central redemarre. Colonne pente : derive estimee de
+// l'offset central − tireur (≈ −derive du tireur, ±2 ppm thermiques).
+//
+// USAGE : program syncsim [derive_ppm gigue_us [duree_s [redemarrage_s]]]
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <clock_sync.h>
+
+using namespace fencing;
+
+namespace {
+
+const double   PI           = 3.14159265358979323846;
+const uint32_t LOOP_US      = 200;
+const double   BASE_US      = 800;
+const double   SPIKE_PROB   = 0.05;
+const double   LOSS_PROB    = 0.02;
+const uint64_t WARMUP_US    = 3000000;
+const uint64_t MEASURE_US   = 10000;
+const double   THERMAL_PPM  = 2.0;
+const double   THERMAL_S    = 120.0;
+const uint64_t BOOT_US      = 2000000;
+const uint64_t RESYNC_US    = 1000000;
+
+struct Scenario {
+    double   driftPpm;
+    double   jitterUs;
+    uint32_t seconds;
+    uint32_t restartS;      // redemarrage du central, 0 : aucun
+};
+
+const Scenario SCENARIOS[] = {
+    {   0.0,  300, 300,  0 },
+    {  20.0,  500, 300,  0 },
+    {  60.0, 2000, 300,  0 },
+    { -60.0, 2000, 300,  0 },
+    { 100.0, 5000, 300,  0 },
+    {  20.0,  500, 120, 60 },
+    { -60.0, 2000, 120, 60 },
+};
+
+struct Stats {
+    std::vector<double> abs;
+    void add(double e) { abs.push_back(std::fabs(e)); }
+    double pct(int p) {
+        if (abs.empty()) return 0;
+        std::sort(abs.begin(), abs.end());
+        return abs[std::min(abs.size() - 1, abs.size() * p / 100)];
+    }
+    double max() { return abs.empty() ? 0 : *std::max_element(abs.begin(), abs.end()); }
+};
+
+struct Result {
+    Stats    sync, arrival, naive;
+    long     covered = 0, measured = 0;
+    uint32_t accepted = 0, ignored = 0, steps = 0;
+    int32_t  skewPpb = 0;
+};
+
+Result run(const Scenario& sc, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::exponential_distribution<double> jitter(1.0 / sc.jitterUs);
+
+    auto flight = [&]() -> double {
+        double d = BASE_US + jitter(rng);
+        if (uni(rng) < SPIKE_PROB) d += 5000 + uni(rng) * 25000;
+        return d;
+    };
+
+    // Horloge du tireur (origine arbitraire)
+    const double L0 = 1234567.0 + uni(rng) * 1e9;
+    auto local = [&](double T) -> uint64_t {
+        double thermal = THERMAL_PPM * 1e-6 * (THERMAL_S * 1e6 / (2 * PI)) *
+                         (1 - std::cos(2 * PI * T / (THERMAL_S * 1e6)));
+        return (uint64_t)(L0 + T * (1 + sc.driftPpm * 1e-6) + thermal);
+    };
+
+    // Horloge du central, repartie de zero au redemarrage
+    const uint64_t restartT = (uint64_t)sc.restartS * 1000000u;
+    auto central = [&](double T) -> uint64_t {
+        return restartT && T >= (double)restartT ? (uint64_t)(T - (double)restartT) : (uint64_t)T;
+    };
+    auto down = [&](double T) {
+        return restartT && T >= (double)restartT && T < (double)(restartT + BOOT_US);
+    };
+
+    ClockSync clock;
+    Result r;
+    uint64_t resumeT = ~(uint64_t)0;    // mesures suspendues jusqu'a resumeT
+
+    struct Pending {
+        double       arriveT;     // arrivee de la reponse chez le tireur
+        SyncExchange rep;
+    };
+    std::vector<Pending> inFlight;
+    bool   haveNaive = false;
+    double naiveOffset = 0;
+
+    const uint64_t endUs = (uint64_t)sc.seconds * 1000000u;
+    uint64_t nextMeasure = WARMUP_US;
+
+    for (uint64_t T = 0; T < endUs; T += LOOP_US) {
+        // Reponses arrivees
+        for (size_t i = 0; i < inFlight.size();) {
+            if (inFlight[i].arriveT > (double)T) { i++; continue; }
+            const Pending p = inFlight[i];
+            inFlight.erase(inFlight.begin() + i);
+            uint64_t t4 = local(p.arriveT);
+            clock.onReply(p.rep, t4);
+            haveNaive   = true;
+            naiveOffset = ((double)(int64_t)(p.rep.t2Us - p.rep.t1Us) +
+                           (double)(int64_t)(p.rep.t3Us - t4)) / 2;
+        }
+
+        SyncExchange req;
+        if (clock.poll(local((double)T), PLAYER_A, req) && uni(rng) >= LOSS_PROB) {
+            double atCentral = (double)T + flight();
+            double replyAt   = atCentral + 50 + uni(rng) * 250;
+            Pending p;
+            p.rep      = req;
+            p.rep.t2Us = central(atCentral);
+            p.rep.t3Us = central(replyAt);
+            p.arriveT  = replyAt + flight();
+            if (down(atCentral)) {
+                // central en cours de demarrage : requete perdue
+            } else if (uni(rng) >= LOSS_PROB) {
+                inFlight.push_back(p);
+                if (restartT && atCentral >= (double)restartT && resumeT == ~(uint64_t)0)
+                    resumeT = (uint64_t)p.arriveT + RESYNC_US;
+            }
+        }
+
+        // Du redemarrage a RESYNC_US apres la premiere reponse du nouveau
+        // central : rien a mesurer, l'horloge de reference a disparu
+        bool resyncing = restartT && T >= restartT && T < resumeT;
+        if (T >= nextMeasure && resyncing)
+            nextMeasure += MEASURE_US;
+        else if (T >= nextMeasure) {
+            nextMeasure += MEASURE_US;
+            uint64_t L = local((double)T);
+            uint64_t C = central((double)T);
+            double err = (double)(int64_t)(clock.toCentral(L) - C);
+            r.sync.add(err);
+            r.arrival.add(flight());
+            if (haveNaive) r.naive.add((double)L + naiveOffset - (double)C);
+            r.measured++;
+            if (std::fabs(err) <= clock.uncertaintyUs(L)) r.covered++;
+        }
+    }
+    r.accepted = clock.accepted();
+    r.ignored  = clock.ignored();
+    r.steps    = clock.steps();
+    r.skewPpb  = clock.skewPpb();
+    return r;
+}
+
+}  // namespace
+
+int simClockSync(int argc, char** argv) {
+    std::vector<Scenario> scenarios(SCENARIOS, SCENARIOS + sizeof SCENARIOS / sizeof SCENARIOS[0]);
+    if (argc >= 2) {
+        Scenario sc = { std::atof(argv[0]), std::atof(argv[1]), 300, 0 };
+        if (argc >= 3 && std::atoi(argv[2]) > 0) sc.seconds = (uint32_t)std::atoi(argv[2]);
+        if (argc >= 4 && std::atoi(argv[3]) > 0) sc.restartS = (uint32_t)std::atoi(argv[3]);
+        if (sc.jitterUs <= 0) sc.jitterUs = 1;
+        scenarios.assign(1, sc);
+    }
+
+    std::printf("Synchro : %u echanges a %u ms puis toutes les %u ms, %u echantillons\n",
+                SYNC_FAST_COUNT, SYNC_FAST_PERIOD_US / 1000, SYNC_PERIOD_US / 1000, SYNC_HISTORY);
+    std::printf("reseau : %.0f us + expo(gigue), %.0f %% de retransmissions +5..30 ms, "
+                "%.0f %% de pertes ; ±%.0f ppm thermique\n\n",
+                BASE_US, SPIKE_PROB * 100, LOSS_PROB * 100, THERMAL_PPM);
+    std::printf("  %-6s %-6s %-5s %-6s | %-22s | %-15s | %-15s | %6s %6s %5s\n", "derive", "gigue",
+                "duree", "redem.", "synchro p50/p99/max", "arrivee p99/max", "naif p99/max", "couv.",
+                "pente", "sauts");
+    std::printf("  %-6s %-6s %-5s %-6s | %-22s | %-15s | %-15s | %6s %6s %5s\n", "ppm", "us", "s",
+                "s", "(us)", "(us)", "(us)", "%", "ppm", "");
+
+    bool ok = true;
+    uint32_t seed = 13;
+    for (const Scenario& sc : scenarios) {
+        Result r = run(sc, seed++);
+        double cover = r.measured ? 100.0 * r.covered / r.measured : 0;
+        std::printf("  %6.0f %6.0f %5u %6u | %6.0f %6.0f %8.0f | %6.0f %8.0f | %6.0f %8.0f | %6.2f "
+                    "%6.1f %5u\n",
+                    sc.driftPpm, sc.jitterUs, sc.seconds, sc.restartS, r.sync.pct(50),
+                    r.sync.pct(99), r.sync.max(), r.arrival.pct(99), r.arrival.max(),
+                    r.naive.pct(99), r.naive.max(), cover, r.skewPpb / 1000.0, r.steps);
+        ok = ok && r.sync.pct(99) < 1000 && r.sync.max() < 2000 && cover >= 99.9 &&
+             r.steps == (sc.restartS ? 1u : 0u);
+    }
+
+    std::printf("\nerreur : instant converti − instant reel (central) | couv. : erreur <= "
+                "incertitude annoncee\n");
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
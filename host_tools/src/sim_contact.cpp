@@ -0,0 +1,285 @@
+// =============================================================================
+// sim_contact.cpp — Classification aux bords du contact (etablissement,
+//                   rupture) : fenetre 50 ms, reciproque, contact continu
+// =============================================================================
+//
+// Chaque essai : bouton appuye un peu avant le contact, pointe sur une
+// surface du plan (porteuse ± tolerance / 2, gigue gaussienne). Le contact
+// rebondit a l'etablissement et a la rupture : 0 a 3 salves de 1 a 6
+// periodes separees de coupures de 2 a 30 periodes. Entre les deux, contact
+// continu de CONTACT_MIN_MS a CONTACT_MAX_MS. Sur tout le contact, 2 % de
+// fronts manques et 3 % de fronts parasites.
+//
+// Trois decisions sur les memes fronts :
+//   fenetre     comptage sur MEASURE_WINDOW_MS depuis l'appui (phase1_5),
+//               premiere fenetre classee dans une bande
+//   reciproque  ReciprocalEstimator<4>, premier stable() (ancien
+//               TouchDetector : la classe, meme UNKNOWN, etait figee)
+//   contact     ContactEstimator<4>, N periodes du segment continu et
+//               confiance >= CONTACT_MIN_CONFIDENCE
+// puis TouchDetector complet (FakeEdgeTimer, boucle de 20 a 60 µs) :
+// DECISION doit porter la bonne classe et sa confiance.
+//
+// Verifie : aucune mauvaise decision pour l'estimateur de contact et pour
+// TouchDetector, pas plus de contacts sans decision qu'avec la mesure
+// reciproque (contact trop court ou trop hache pour N periodes coherentes).
+// La fenetre est mesuree pour comparaison.
+//
+// USAGE : program contactsim [essais, defaut 20000]
+// =============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <classifier.h>
+#include <contact_estimator.h>
+#include <fencer_event.h>
+#include <pio_edge_timer.h>
+#include <reciprocal_meter.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t MEASURE_WINDOW_MS = 50;
+const uint32_t CONTACT_MIN_MS    = 10;
+const uint32_t CONTACT_MAX_MS    = 40;
+const uint32_t JITTER_PERMILLE   = 3;
+const uint32_t MISS_PERCENT      = 2;
+const uint32_t GLITCH_PERCENT    = 3;
+const uint32_t LOOP_US           = 20;
+const uint32_t PRESS_LEAD_US     = 2000;   // appui avant le contact, au plus
+
+struct Trace {
+    FreqClass             cls;
+    uint64_t              pressNs;
+    uint64_t              makeNs;     // premier front du contact
+    uint64_t              endNs;      // dernier front
+    std::vector<uint64_t> edges;
+};
+
+struct Method {
+    const char*           name;
+    std::vector<uint32_t> latencyUs;  // depuis le premier front du contact
+    int wrong   = 0;                  // classe decidee fausse
+    int missed  = 0;                  // aucune decision
+
+    void decide(FreqClass c, FreqClass truth, uint64_t atNs, uint64_t makeNs) {
+        if (c != truth) wrong++;
+        latencyUs.push_back((uint32_t)((atNs > makeNs ? atNs - makeNs : 0) / 1000u));
+    }
+
+    void report() {
+        std::sort(latencyUs.begin(), latencyUs.end());
+        auto pct = [&](int p) -> double {
+            return latencyUs.empty()
+                 ? 0 : latencyUs[std::min(latencyUs.size() - 1, latencyUs.size() * p / 100)] / 1000.0;
+        };
+        std::printf("  %-12s fausses %5d | sans decision %5d | latence p50 %6.2f ms | p99 %6.2f ms\n",
+                    name, wrong, missed, pct(50), pct(99));
+    }
+};
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+};
+
+class TraceMaker {
+public:
+    explicit TraceMaker(uint32_t seed) : rng_(seed) {}
+
+    Trace make(uint64_t startNs, int n) {
+        const CarrierBand& band = FREQ_PLAN[n % FREQ_PLAN_SIZE];
+        Trace tr = {};
+        tr.cls = band.cls;
+        double freq = band.centerHz + uni(-0.5, 0.5) * band.toleranceHz;
+        period_ = 1e9 / freq;
+
+        tr.makeNs  = startNs + (uint64_t)uni(PRESS_LEAD_US * 1000.0, 2 * PRESS_LEAD_US * 1000.0);
+        tr.pressNs = tr.makeNs - (uint64_t)uni(0, PRESS_LEAD_US * 1000.0);
+        t_ = (double)tr.makeNs;
+        edges_ = &tr.edges;
+
+        bounces();
+        burst((uint32_t)(uni(CONTACT_MIN_MS, CONTACT_MAX_MS) * 1e6 / period_));
+        bounces();
+        std::sort(tr.edges.begin(), tr.edges.end());
+        tr.endNs = tr.edges.empty() ? tr.makeNs : tr.edges.back();
+        return tr;
+    }
+
+private:
+    double uni(double lo, double hi) {
+        return std::uniform_real_distribution<double>(lo, hi)(rng_);
+    }
+
+    void bounces() {
+        int n = (int)uni(0, 4);
+        for (int b = 0; b < n; b++) {
+            burst((uint32_t)uni(1, 7));
+            t_ += period_ * uni(2, 30);
+        }
+    }
+
+    // Salve de fronts a la porteuse, avec fronts manques / parasites
+    void burst(uint32_t periods) {
+        for (uint32_t i = 0; i <= periods; i++) {
+            double jitter = gauss_(rng_) * period_ * JITTER_PERMILLE / 1000.0;
+            double at = t_ + jitter;
+            if (uni(0, 100) < GLITCH_PERCENT && i > 0)
+                edges_->push_back((uint64_t)(at - period_ * uni(0.15, 0.85)));
+            if (uni(0, 100) >= MISS_PERCENT || i == 0)
+                edges_->push_back((uint64_t)at);
+            if (i < periods) t_ += period_;
+        }
+    }
+
+    std::mt19937                     rng_;
+    std::normal_distribution<double> gauss_{ 0.0, 1.0 };
+    double                           period_ = 0;
+    double                           t_      = 0;
+    std::vector<uint64_t>*           edges_  = nullptr;
+};
+
+bool inBand(FreqClass c) {
+    return c == FreqClass::NEUTRE || c == FreqClass::VALID_A || c == FreqClass::VALID_B;
+}
+
+uint32_t periodTicks(uint64_t a, uint64_t b) {
+    return (uint32_t)std::min<uint64_t>(b - a, 0xFFFFFFFFu);
+}
+
+void runWindow(const Trace& tr, Method& m) {
+    uint64_t windowNs = (uint64_t)MEASURE_WINDOW_MS * 1000000u;
+    size_t i = 0;
+    for (uint64_t end = tr.pressNs + windowNs; end < tr.endNs + 2 * windowNs; end += windowNs) {
+        uint32_t count = 0;
+        while (i < tr.edges.size() && tr.edges[i] < end) {
+            if (tr.edges[i] >= end - windowNs) count++;
+            i++;
+        }
+        FreqClass c = classifyCount(count, MEASURE_WINDOW_MS);
+        if (inBand(c)) {
+            m.decide(c, tr.cls, end, tr.makeNs);
+            return;
+        }
+    }
+    m.missed++;
+}
+
+void runReciprocal(const Trace& tr, uint64_t lastEdgeNs, Method& m) {
+    ReciprocalEstimator<DETECT_PERIODS> est(1000000000u);
+    for (uint64_t e : tr.edges) {
+        est.pushPeriod(periodTicks(lastEdgeNs, e));
+        lastEdgeNs = e;
+        if (est.stable()) {
+            m.decide(classifyFrequency(est.freqHz()), tr.cls, e, tr.makeNs);
+            return;
+        }
+    }
+    m.missed++;
+}
+
+void runContact(const Trace& tr, uint64_t lastEdgeNs, Method& m, uint32_t& minConfidence) {
+    ContactEstimator<DETECT_PERIODS> est(1000000000u);
+    for (uint64_t e : tr.edges) {
+        est.pushPeriod(periodTicks(lastEdgeNs, e));
+        lastEdgeNs = e;
+        if (!est.ready()) continue;
+        ContactEstimate ce = est.estimate();
+        if (ce.confidence >= CONTACT_MIN_CONFIDENCE) {
+            minConfidence = std::min<uint32_t>(minConfidence, ce.confidence);
+            m.decide(ce.cls, tr.cls, e, tr.makeNs);
+            return;
+        }
+    }
+    m.missed++;
+}
+
+}  // namespace
+
+int simContact(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 20000;
+    if (trials <= 0) trials = 20000;
+
+    TraceMaker maker(16);
+    std::mt19937 rng(17);
+
+    Method window     = { "fenetre", {} };
+    Method reciprocal = { "reciproque", {} };
+    Method contact    = { "contact", {} };
+    Method detector   = { "detecteur", {} };
+    uint32_t minConfidence = 1000;
+    int badConfidence = 0;
+
+    FakeEdgeTimer timer(1000000000u);
+    TouchDetector det(timer.tickHz(), 0);
+    Collect sink;
+
+    uint64_t startNs = 0;
+    uint64_t lastEdgeNs = 0;
+    uint64_t tUs = 0;
+
+    for (int n = 0; n < trials; n++) {
+        Trace tr = maker.make(startNs, n);
+
+        runWindow(tr, window);
+        runReciprocal(tr, lastEdgeNs, reciprocal);
+        runContact(tr, lastEdgeNs, contact, minConfidence);
+
+        // TouchDetector : fronts de l'essai livres au rythme de loop1
+        uint64_t releaseUs = tr.endNs / 1000u + 1000;
+        size_t   next = 0;
+        size_t   firstEvent = sink.events.size();
+        tUs = std::max<uint64_t>(tUs, tr.pressNs / 1000u - 100);
+        while (tUs < releaseUs + 200) {
+            tUs += LOOP_US + std::uniform_int_distribution<uint32_t>(0, 2 * LOOP_US)(rng);
+            while (next < tr.edges.size() && tr.edges[next] <= tUs * 1000u) {
+                timer.addPeriod(periodTicks(lastEdgeNs, tr.edges[next]));
+                lastEdgeNs = tr.edges[next++];
+            }
+            bool down = tUs * 1000u >= tr.pressNs && tUs < releaseUs;
+            det.stepFiltered(tUs, down, down ? tr.pressNs / 1000u : releaseUs, timer, sink);
+        }
+        const FencerEvent* decision = nullptr;
+        for (size_t i = firstEvent; i < sink.events.size(); i++)
+            if (sink.events[i].type == FencerEventType::DECISION) decision = &sink.events[i];
+        if (decision) {
+            detector.decide(decision->cls, tr.cls, decision->tUs * 1000u, tr.makeNs);
+            if (decision->value < CONTACT_MIN_CONFIDENCE || decision->value > 1000)
+                badConfidence++;
+        } else {
+            detector.missed++;
+        }
+        sink.events.clear();
+
+        startNs = tr.endNs + 200000000ull;
+    }
+
+    std::printf("Classification aux bords du contact | %d essais | plan :", trials);
+    for (const CarrierBand& b : FREQ_PLAN)
+        std::printf(" %u", b.centerHz);
+    std::printf(" Hz\n");
+    std::printf("  rebonds 0..3 salves, contact continu %u..%u ms, fronts manques %u %%, "
+                "parasites %u %%, gigue %u permille\n\n",
+                CONTACT_MIN_MS, CONTACT_MAX_MS, MISS_PERCENT, GLITCH_PERCENT, JITTER_PERMILLE);
+    window.report();
+    reciprocal.report();
+    contact.report();
+    detector.report();
+    std::printf("\n  confiance a la decision : min %u permille (seuil %u) | hors bornes %d\n",
+                minConfidence, CONTACT_MIN_CONFIDENCE, badConfidence);
+
+    bool ok = contact.wrong == 0 && detector.wrong == 0 && badConfidence == 0 &&
+              contact.missed <= reciprocal.missed && detector.missed <= reciprocal.missed;
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+// =============================================================================
+// sim_dwell.cpp — Dwell FIE en µs : declaration pendant le contact
+// =============================================================================
+//
+// Rejoue TouchDetector (donc DwellTracker) avec un FakeEdgeTimer comme le
+// ferait loop1 : la boucle tourne toutes les LOOP_US (+ gigue), lit les
+// fronts de GP2 recus depuis le tour precedent (pollEdges, date le dernier
+// a l'instant du poll) et la bascule antidatee du bouton.
+//
+// Deux plans de frequences, passes au detecteur en BandPlan (setPlan) quel
+// que soit le plan compile : 20/25/40 kHz et 1/1.5/2.5 kHz (plan LOW, ou une
+// periode de 400 µs depasse deja la moitie de la tolerance FIE). Porteuse :
+// VALID_B du plan ; a 1.5 kHz (VALID_A du plan LOW) la periode de 667 µs
+// depasse a elle seule la tolerance, aucun comptage de fronts ne la tient.
+//
+// Chaque essai : contact de duree choisie sur la cuirasse adverse
+// (VALID_B ±0.2 %), bouton bascule a ±BUTTON_SKEW_US du debut du
+// contact, appui tenu HOLD_MS puis relache. Les contacts courts encadrent
+// le seuil de 15 ms a la tolerance FIE pres ; un essai sur quatre a une
+// coupure de GAP_US au milieu (lame qui decolle) : seul un contact continu
+// compte.
+//
+// Verifie, pour chaque plan : aucun dwell declare sous 15 ms − tolerance,
+// aucun manque au-dessus de 15 ms + tolerance, instant declare a la
+// tolerance pres.
+// Mesure l'avance de DWELL sur le relachement (ancien dwell de phase1_5).
+//
+// USAGE : program dwell [essais, defaut 20000]
+// =============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <band_plan.h>
+#include <dwell_tracker.h>
+#include <fencer_event.h>
+#include <pio_edge_timer.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t LOOP_US        = 20;     // tour de loop1 (+ gigue jusqu'a x3)
+const uint32_t BUTTON_SKEW_US = 300;
+const uint32_t HOLD_MS        = 300;    // appui tenu apres le contact
+const uint32_t GAP_US         = 2000;
+const uint32_t CONTACTS_US[]  = { 14000, 14400, 14800, 15200, 15600, 16000, 20000, 120000 };
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+};
+
+struct Trial {
+    uint64_t contactUs;     // debut du contact (verite terrain)
+    uint32_t lengthUs;      // plus long contact continu
+    bool     split;
+};
+
+struct Plan {
+    const char* name;
+    BandPlan    bands;
+};
+
+const Plan PLANS[] = {
+    { "20/25/40 kHz", { 3, { { FreqClass::NEUTRE,  20000, 2000, "NEUTRE" },
+                             { FreqClass::VALID_A, 25000, 2000, "VALID_A" },
+                             { FreqClass::VALID_B, 40000, 2000, "VALID_B" } } } },
+    { "1/1.5/2.5 kHz (LOW)", { 3, { { FreqClass::NEUTRE,  1000, 200, "NEUTRE" },
+                                    { FreqClass::VALID_A, 1500, 200, "VALID_A" },
+                                    { FreqClass::VALID_B, 2500, 200, "VALID_B" } } } },
+};
+
+bool runPlan(const Plan& plan, int trials) {
+    std::mt19937 rng(15);
+    auto uni = [&](int32_t lo, int32_t hi) {
+        return std::uniform_int_distribution<int32_t>(lo, hi)(rng);
+    };
+
+    FakeEdgeTimer timer(1000000000u);          // ticks = ns
+    TouchDetector detector(timer.tickHz(), 0);
+    detector.setPlan(&plan.bands);
+    Collect sink;
+
+    const uint32_t carrierHz = plan.bands.band(FreqClass::VALID_B)->centerHz;
+    const uint64_t periodNs  = 1000000000ull / carrierHz;
+
+    int falseDwell = 0, missed = 0, declared = 0;
+    int64_t errMin = 0, errMax = 0;
+    std::vector<uint32_t> delays, advances;
+
+    uint64_t t = 0;                 // µs
+    uint64_t lastEdgeNs = 0;
+
+    for (int n = 0; n < trials; n++) {
+        uint32_t length = CONTACTS_US[n % (sizeof CONTACTS_US / sizeof CONTACTS_US[0])];
+        bool     split  = n % 4 == 3;
+
+        Trial tr = {};
+        tr.contactUs = t + 50000 + (uint64_t)uni(0, 10000);
+        tr.split     = split;
+        // Coupure au milieu : deux morceaux de length / 2
+        uint64_t gapStart = split ? tr.contactUs + length / 2 : ~0ull;
+        uint64_t contactEnd = tr.contactUs + length + (split ? GAP_US : 0);
+        tr.lengthUs = split ? length / 2 : length;
+
+        uint64_t pressUs   = tr.contactUs + uni(-(int32_t)BUTTON_SKEW_US, BUTTON_SKEW_US);
+        uint64_t releaseUs = contactEnd + (uint64_t)HOLD_MS * 1000u;
+
+        uint64_t nextEdgeNs = tr.contactUs * 1000u + (uint64_t)uni(0, (int32_t)periodNs);
+        size_t firstEvent = sink.events.size();
+
+        while (t < releaseUs + 5000) {
+            t += LOOP_US + (uint64_t)uni(0, 2 * LOOP_US);
+
+            // Fronts de GP2 jusqu'a t : signal present pendant le contact
+            while (nextEdgeNs <= t * 1000u) {
+                uint64_t edgeUs = nextEdgeNs / 1000u;
+                bool inGap = edgeUs >= gapStart && edgeUs < gapStart + GAP_US;
+                if (edgeUs < contactEnd && !inGap) {
+                    if (lastEdgeNs)
+                        timer.addPeriod((uint32_t)std::min<uint64_t>(nextEdgeNs - lastEdgeNs,
+                                                                      0xFFFFFFFFu));
+                    lastEdgeNs = nextEdgeNs;
+                }
+                int32_t jitter = uni(-(int32_t)periodNs / 500, (int32_t)periodNs / 500);
+                nextEdgeNs += periodNs + jitter;
+                if (edgeUs >= contactEnd) nextEdgeNs = ~0ull;
+            }
+
+            bool down = t >= pressUs && t < releaseUs;
+            detector.stepFiltered(t, down, down ? pressUs : releaseUs, timer, sink);
+        }
+
+        // Bilan de l'essai
+        const FencerEvent* dwellEv = nullptr;
+        for (size_t i = firstEvent; i < sink.events.size(); i++)
+            if (sink.events[i].type == FencerEventType::DWELL && sink.events[i].cls != FreqClass::NONE)
+                dwellEv = &sink.events[i];
+
+        bool expected = tr.lengthUs >= DWELL_MIN_US + DWELL_TOLERANCE_US;
+        bool forbidden = tr.lengthUs + DWELL_TOLERANCE_US <= DWELL_MIN_US;
+        if (dwellEv) {
+            if (forbidden) falseDwell++;
+            declared++;
+            uint64_t truth = tr.contactUs + DWELL_MIN_US;   // 1er morceau si coupe
+            int64_t err = (int64_t)detector.dwell().satisfiedAtUs() - (int64_t)truth;
+            if (declared == 1) errMin = errMax = err;
+            errMin = std::min(errMin, err);
+            errMax = std::max(errMax, err);
+            delays.push_back(dwellEv->value);
+            advances.push_back((uint32_t)(releaseUs - detector.dwell().satisfiedAtUs()));
+        } else if (expected) {
+            missed++;
+        }
+    }
+
+    std::sort(delays.begin(), delays.end());
+    std::sort(advances.begin(), advances.end());
+    auto pct = [](const std::vector<uint32_t>& v, int p) -> uint32_t {
+        return v.empty() ? 0 : v[std::min(v.size() - 1, v.size() * p / 100)];
+    };
+
+    std::printf("Plan %s : signal %u Hz (periode %u us)\n", plan.name, carrierHz,
+                (uint32_t)(periodNs / 1000u));
+    std::printf("  dwell declares           %d\n", declared);
+    std::printf("  declares a tort (<%5u) %d\n", DWELL_MIN_US - DWELL_TOLERANCE_US, falseDwell);
+    std::printf("  manques         (>=%5u) %d\n", DWELL_MIN_US + DWELL_TOLERANCE_US, missed);
+    std::printf("  instant declare - reel   %lld .. %lld us\n", (long long)errMin, (long long)errMax);
+    std::printf("  retard de la declaration p50 %u us | p99 %u us | max %u us\n",
+                pct(delays, 50), pct(delays, 99), delays.empty() ? 0 : delays.back());
+    std::printf("  avance sur le relachement p50 %.1f ms | min %.1f ms\n",
+                pct(advances, 50) / 1000.0, advances.empty() ? 0 : advances.front() / 1000.0);
+
+    bool ok = falseDwell == 0 && missed == 0 && declared > 0 &&
+              errMin >= -(int64_t)DWELL_TOLERANCE_US && errMax <= (int64_t)DWELL_TOLERANCE_US;
+    std::printf("  → %s\n\n", ok ? "OK" : "ECHEC");
+    return ok;
+}
+
+}  // namespace
+
+int simDwell(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 20000;
+    if (trials <= 0) trials = 20000;
+
+    std::printf("Dwell FIE %u us ±%u us | boucle %u..%u us | bouton ±%u us\n", DWELL_MIN_US,
+                DWELL_TOLERANCE_US, LOOP_US, 3 * LOOP_US, BUTTON_SKEW_US);
+    std::printf("%d essais par plan, contacts de 14 a 120 ms, 1 sur 4 coupe %u us au milieu\n\n",
+                trials, GAP_US);
+
+    bool ok = true;
+    for (const Plan& plan : PLANS)
+        ok = runPlan(plan, trials) && ok;
+
+    std::printf("%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
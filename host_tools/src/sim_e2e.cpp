@@ -0,0 +1,486 @@
+// =============================================================================
+// sim_e2e.cpp — Latence de bout en bout : premier front de GP2 → lampe
+// =============================================================================
+//
+// Toute la chaine dans le meme processus, sur un temps simule :
+//
+//   tireur A (horloge decalee de 7.3 s, derive 25 ppm)
+//     coeur 1 : porteuse VALID_B sur GP2 (FakeEdgeTimer, EdgeTimerFeed),
+//               TouchDetector, file SpscQueue (tour de 3 a 15 µs)
+//     coeur 0 : file → TouchSender, ClockSync (tour de 20 a 300 µs, Serial)
+//   air : trames touch_wire.h codees / decodees, 1 a 5 ms, 5 % de pertes
+//         dans les deux sens (evenements, acquittements, synchro)
+//   central : TouchReceiver, Referee, LampPanel (FakeNeoPixel, FakeBuzzer),
+//             LatencyProbe (tour de 20 a 500 µs)
+//
+// Les estampilles et le code de marquage sont ceux des firmwares (puits et
+// envoi de FencerNode, serviceLink). Une touche valable toutes les 2 a 4 s :
+// chacune allume la lampe de A.
+//
+// Affiche le meme tableau que la ligne [LATENCE] de STATUS du central, les
+// segments entre etapes (p50 / p99) et la latence vraie contact → photon.
+//
+// Verifie :
+//   - chaque touche arrive au central avec toutes ses etapes, lampe comprise
+//   - ordre des etapes (a l'incertitude de synchro pres entre tireur et
+//     central)
+//   - premier front estime au central = premier front vrai, a syncUs + un
+//     tour du coeur 1 pres
+//   - LIGHT_ON = photon de la trame FakeNeoPixel qui suit la decision
+//   - histogrammes : p50 / p99 dans leur classe (+12.5 %), max exact ;
+//     etapes du tireur identiques de part et d'autre de la trame
+//
+// USAGE : program e2e [touches, defaut 200]
+// =============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <buzzer.h>
+#include <clock_sync.h>
+#include <fencer_event.h>
+#include <lamp_panel.h>
+#include <latency_probe.h>
+#include <neopixel_strip.h>
+#include <pio_edge_timer.h>
+#include <referee.h>
+#include <signal_chain.h>
+#include <spsc_queue.h>
+#include <touch_detector.h>
+#include <touch_link.h>
+#include <touch_wire.h>
+#include <udp_link.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint64_t FENCER_OFFSET_US = 7300000;
+const int64_t  FENCER_DRIFT_PPB = 25000;
+const uint32_t CORE1_MIN_US  = 3,  CORE1_MAX_US  = 15;
+const uint32_t CORE1_IDLE_US = 1000;          // hors appui
+const uint32_t CORE0_MIN_US  = 20, CORE0_MAX_US  = 300;
+const uint32_t CENTRAL_MIN_US = 20, CENTRAL_MAX_US = 500;
+const uint32_t AIR_MIN_US    = 1000, AIR_MAX_US = 5000;
+const uint32_t AIR_LOSS_PERMILLE = 50;
+const uint32_t SYNC_WARMUP_US = 3000000;
+const uint32_t PRESS_MIN_US  = 30000, PRESS_MAX_US = 80000;
+
+// Horloge du tireur en fonction du temps vrai (= horloge du central)
+uint64_t fencerUs(uint64_t tUs) {
+    return tUs + FENCER_OFFSET_US + (uint64_t)((int64_t)tUs * FENCER_DRIFT_PPB / 1000000000);
+}
+
+uint64_t fencerNs(uint64_t tNs) {
+    return tNs + FENCER_OFFSET_US * 1000u + (uint64_t)((int64_t)tNs / 1000 * FENCER_DRIFT_PPB / 1000000);
+}
+
+// --- Air : datagrammes codes, retard et pertes ------------------------------
+
+struct Air {
+    struct Flight {
+        uint64_t atUs;
+        bool     toCentral;
+        uint8_t  len;
+        uint8_t  data[WIRE_FRAME_MAX];
+    };
+
+    std::vector<Flight> flights;
+    std::mt19937        rng{ 22 };
+    uint32_t            sent = 0, lost = 0;
+
+    void send(uint64_t nowUs, bool toCentral, const uint8_t* data, size_t len) {
+        sent++;
+        if (std::uniform_int_distribution<uint32_t>(0, 999)(rng) < AIR_LOSS_PERMILLE) {
+            lost++;
+            return;
+        }
+        Flight f;
+        f.atUs      = nowUs + std::uniform_int_distribution<uint32_t>(AIR_MIN_US, AIR_MAX_US)(rng);
+        f.toCentral = toCentral;
+        f.len       = (uint8_t)len;
+        std::copy(data, data + len, f.data);
+        flights.push_back(f);
+    }
+};
+
+// Un bout du lien (interface de UdpLink) ; nowUs = temps vrai du tour en cours
+struct SimLink {
+    Air&     air;
+    bool     central;
+    uint64_t nowUs = 0;
+
+    bool sendEvent(const TouchEvent& ev) {
+        uint8_t buf[TOUCH_WIRE_SIZE];
+        size_t n = encodeTouchEvent(ev, buf, sizeof buf);
+        air.send(nowUs, true, buf, n);
+        return n > 0;
+    }
+    bool sendAck(const UdpPeer&, uint8_t player, uint16_t seq) {
+        uint8_t buf[TOUCH_ACK_SIZE];
+        size_t n = encodeTouchAck(player, seq, buf, sizeof buf);
+        air.send(nowUs, false, buf, n);
+        return n > 0;
+    }
+    bool sendSyncRequest(const SyncExchange& ex) {
+        uint8_t buf[SYNC_REQUEST_SIZE];
+        size_t n = encodeSyncRequest(ex, buf, sizeof buf);
+        air.send(nowUs, true, buf, n);
+        return n > 0;
+    }
+    bool sendSyncReply(const UdpPeer&, SyncExchange ex) {
+        ex.t3Us = nowUs;
+        uint8_t buf[SYNC_REPLY_SIZE];
+        size_t n = encodeSyncReply(ex, buf, sizeof buf);
+        air.send(nowUs, false, buf, n);
+        return n > 0;
+    }
+
+    // Plus ancien datagramme arrive ; rxUs sur l'horloge de ce bout
+    bool poll(LinkMessage& msg) {
+        auto best = air.flights.end();
+        for (auto it = air.flights.begin(); it != air.flights.end(); ++it)
+            if (it->toCentral == central && it->atUs <= nowUs &&
+                (best == air.flights.end() || it->atUs < best->atUs))
+                best = it;
+        if (best == air.flights.end())
+            return false;
+        bool ok   = decodeLinkFrame(best->data, best->len, msg);
+        msg.rxUs  = central ? best->atUs : fencerUs(best->atUs);
+        msg.from  = {};
+        air.flights.erase(best);
+        return ok || poll(msg);
+    }
+};
+
+// --- Tireur -----------------------------------------------------------------
+
+struct Touch {
+    uint64_t pressUs, releaseUs;    // temps vrai
+    uint64_t firstEdgeNs;           // premier front physique de la porteuse
+};
+
+SpscQueue<FencerEvent, 32> events;
+
+// Puits de FencerNode, sur l'horloge simulee
+struct Core1Sink {
+    uint16_t seq   = 0;
+    uint64_t nowUs = 0;             // horloge du tireur
+    int      touch = -1;
+    std::vector<int>* seqTouch = nullptr;
+
+    bool push(FencerEvent ev) {
+        ev.seq = seq++;
+        latencyMark(ev.lat, LatencyStage::ENQUEUED, nowUs, ev.tUs);
+        if (ev.type == FencerEventType::DWELL) {
+            if (seqTouch->size() <= ev.seq) seqTouch->resize(ev.seq + 1, -1);
+            (*seqTouch)[ev.seq] = touch;
+        }
+        return events.push(ev);
+    }
+};
+
+// --- Central ----------------------------------------------------------------
+
+struct OutputBuffer {
+    RefereeOutput items[4];
+    uint8_t       count = 0;
+    bool push(const RefereeOutput& o) {
+        if (count >= 4) return false;
+        items[count++] = o;
+        return true;
+    }
+};
+
+// Estampilles finales d'un DWELL, vues du central
+struct Record {
+    int           touch;
+    LatencyStamps lat;
+    uint64_t      eventUs;
+    uint64_t      applyUs;          // lampe passee au panneau (0 : aucune)
+    uint16_t      syncUs;
+};
+
+uint32_t exactPercentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t rank = (size_t)(p * v.size() + 0.999999);
+    if (rank == 0) rank = 1;
+    return v[std::min(v.size(), rank) - 1];
+}
+
+}  // namespace
+
+int simEndToEnd(int argc, char** argv) {
+    int touches = argc >= 1 ? std::atoi(argv[0]) : 200;
+    if (touches <= 0) touches = 200;
+    std::mt19937 rng(2022);
+    auto uni = [&](uint64_t lo, uint64_t hi) {
+        return std::uniform_int_distribution<uint64_t>(lo, hi)(rng);
+    };
+
+    // Assaut : une touche valable de A toutes les 2 a 4 s
+    std::vector<Touch> bout;
+    const uint64_t periodNs = 1000000000ull / FREQ_VALID_B;
+    uint64_t t = SYNC_WARMUP_US;
+    for (int i = 0; i < touches; i++) {
+        t += uni(2000000, 4000000);
+        Touch k;
+        k.pressUs     = t;
+        k.releaseUs   = t + uni(PRESS_MIN_US, PRESS_MAX_US);
+        k.firstEdgeNs = k.pressUs * 1000u + uni(0, 300000) + uni(0, periodNs);
+        bout.push_back(k);
+    }
+
+    Air air;
+    SimLink fencerLink{ air, false }, centralLink{ air, true };
+
+    // Tireur
+    FakeEdgeTimer timer(1000000000u);
+    EdgeTimerFeed<FakeEdgeTimer> feed(timer);
+    feed.onRisingEdge(1);            // le chronometre a deja vu un front
+    TouchDetector detector(timer.tickHz(), 0);
+    std::vector<int> seqTouch;
+    Core1Sink sink;
+    sink.seqTouch = &seqTouch;
+    TouchSender<SimLink> sender(fencerLink);
+    ClockSync clockSync;
+    LatencyProbe fencerProbe;
+
+    // Central
+    TouchReceiver<SimLink> receiver(centralLink);
+    Referee      referee;
+    OutputBuffer outputs;
+    FakeNeoPixel strip;
+    FakeBuzzer   buzzer;
+    strip.begin(22, LAMP_PIXELS);
+    buzzer.begin(21);
+    LampPanel<FakeNeoPixel, FakeBuzzer> panel(strip, buzzer);
+    LatencyProbe probe;
+    std::vector<Record> records;
+    std::vector<NeoPixelRecord> frames;
+    uint32_t framesSeen = 0;
+
+    auto applyOutputs = [&](uint64_t nowUs, uint8_t player, uint32_t& ticket) {
+        for (uint8_t i = 0; i < outputs.count; i++) {
+            const RefereeOutput& o = outputs.items[i];
+            uint32_t tk = panel.apply(o, nowUs);
+            if (o.kind == RefereeOutputKind::LIGHT && o.player == player && o.lamp != Lamp::NONE)
+                ticket = tk;
+        }
+        outputs.count = 0;
+    };
+
+    size_t   current  = 0;           // touche en cours ou a venir (coeur 1)
+    uint64_t nextEdge = bout.empty() ? ~0ull : bout[0].firstEdgeNs;
+    uint64_t next1 = 0, next0 = 0, nextC = 0;
+    uint64_t endUs = bout.empty() ? 0 : bout.back().releaseUs + 3000000;
+
+    while (true) {
+        uint64_t now = std::min(next1, std::min(next0, nextC));
+        if (now > endUs) break;
+
+        if (now == next1) {
+            // Coeur 1 : fronts de la porteuse jusqu'a maintenant, detecteur
+            while (current < bout.size() && nextEdge <= now * 1000u) {
+                feed.onRisingEdge(fencerNs(nextEdge));
+                nextEdge += periodNs;
+                if (nextEdge >= bout[current].releaseUs * 1000u) {
+                    // Fin de contact avec le relachement ; porteuse suivante
+                    if (current + 1 < bout.size()) nextEdge = bout[current + 1].firstEdgeNs;
+                    else nextEdge = ~0ull;
+                }
+            }
+            const Touch* k = current < bout.size() ? &bout[current] : nullptr;
+            bool pressed = k && now >= k->pressUs && now < k->releaseUs;
+            uint64_t edgeUs = k ? fencerUs(pressed ? k->pressUs : k->releaseUs) : 0;
+            sink.nowUs = fencerUs(now);
+            sink.touch = (int)current;
+            detector.stepFiltered(fencerUs(now), pressed, edgeUs, timer, sink);
+            if (k && now >= k->releaseUs && !detector.pressed()) {
+                current++;
+                // Premier front de la touche suivante pas encore parti
+            }
+            bool active = current < bout.size() && now + CORE1_IDLE_US >= bout[current].pressUs;
+            next1 = now + (active ? uni(CORE1_MIN_US, CORE1_MAX_US) : CORE1_IDLE_US);
+        }
+
+        if (now == next0) {
+            // Coeur 0 : file → lien (sendEvent du firmware), synchro, acquittements
+            uint64_t local = fencerUs(now);
+            fencerLink.nowUs = now;
+            FencerEvent ev;
+            while (events.pop(ev)) {
+                if (ev.type == FencerEventType::DWELL || ev.type == FencerEventType::TOUCH) {
+                    latencyMark(ev.lat, LatencyStage::UDP_TX, local, ev.tUs);
+                    TouchEvent out = toTouchEvent(ev, PLAYER_A);
+                    clockSync.stamp(out);
+                    sender.send(out, local);
+                }
+                if (ev.type == FencerEventType::DWELL)
+                    fencerProbe.add(ev.lat);
+            }
+            LinkMessage msg;
+            while (fencerLink.poll(msg)) {
+                if (msg.kind == LinkKind::ACK)
+                    sender.onAck(msg.player, msg.seq, local);
+                else if (msg.kind == LinkKind::SYNC_REPLY)
+                    clockSync.onReply(msg.sync, msg.rxUs);
+            }
+            sender.poll(local);
+            SyncExchange req;
+            if (clockSync.poll(local, PLAYER_A, req))
+                fencerLink.sendSyncRequest(req);
+            next0 = now + uni(CORE0_MIN_US, CORE0_MAX_US);
+        }
+
+        if (now == nextC) {
+            // Central : serviceLink puis loop() du firmware
+            centralLink.nowUs = now;
+            LinkMessage msg;
+            while (centralLink.poll(msg)) {
+                if (msg.kind == LinkKind::SYNC_REQUEST) {
+                    answerSync(centralLink, msg);
+                    continue;
+                }
+                if (msg.kind != LinkKind::EVENT || !receiver.onEvent(msg.ev, msg.from))
+                    continue;
+                referee.onEvent(msg.ev, msg.rxUs, outputs);
+                uint64_t decidedUs = now;
+                uint32_t ticket    = 0;
+                applyOutputs(now, msg.ev.player, ticket);
+                if (msg.ev.type != FencerEventType::DWELL)
+                    continue;
+                LatencyStamps lat = msg.ev.lat;
+                if (msg.ev.syncUs != TOUCH_SYNC_NONE) {
+                    latencyMark(lat, LatencyStage::CENTRAL_RX, msg.rxUs, msg.ev.tUs);
+                    latencyMark(lat, LatencyStage::DECISION, decidedUs, msg.ev.tUs);
+                }
+                probe.await(lat, msg.ev.tUs, ticket);
+                int touch = msg.ev.seq < seqTouch.size() ? seqTouch[msg.ev.seq] : -1;
+                records.push_back({ touch, lat, msg.ev.tUs, ticket ? now : 0, msg.ev.syncUs });
+            }
+            uint32_t none = 0;
+            referee.poll(now, outputs);
+            applyOutputs(now, 0, none);
+            panel.service(now);
+            probe.settle(panel);
+            while (framesSeen < strip.frames()) {
+                frames.push_back(strip.record(strip.kept() - (strip.frames() - framesSeen)));
+                framesSeen++;
+            }
+            nextC = now + uni(CENTRAL_MIN_US, CENTRAL_MAX_US);
+        }
+    }
+
+    // --- Verifications sur les enregistrements du central ---------------------
+    uint32_t missing = 0, disorder = 0, edgeOff = 0, lightBad = 0, unsynced = 0;
+    std::vector<bool> seen(bout.size(), false);
+    std::vector<uint32_t> stageUs[LATENCY_STAGES], segmentUs[LATENCY_STAGES], truthUs;
+    uint32_t edgeErrMax = 0;
+    for (Record& r : records) {
+        if (r.touch < 0 || (size_t)r.touch >= bout.size()) { missing++; continue; }
+        seen[r.touch] = true;
+        if (r.syncUs == TOUCH_SYNC_NONE) { unsynced++; continue; }
+
+        // Photon vrai : premiere trame partie a l'application de la lampe ou apres
+        uint64_t photonUs = 0;
+        for (const NeoPixelRecord& f : frames)
+            if (r.applyUs && f.startUs >= r.applyUs) { photonUs = f.photonUs; break; }
+        // LIGHT_ON attendu de settle() : compare aux histogrammes plus bas
+        uint64_t edgeUs = r.eventUs - r.lat.leadUs;
+        if (photonUs) {
+            latencySet(r.lat, LatencyStage::LIGHT_ON, (uint32_t)(photonUs - edgeUs));
+            truthUs.push_back((uint32_t)(photonUs - bout[r.touch].firstEdgeNs / 1000u));
+        } else if (r.applyUs) {
+            lightBad++;          // lampe jamais montree
+        }
+
+        bool complete = true;
+        for (uint8_t i = 0; i < LATENCY_STAGES; i++)
+            complete = complete && latencyHas(r.lat, (LatencyStage)i);
+        if (!complete) { missing++; continue; }
+
+        uint32_t at[LATENCY_STAGES];
+        for (uint8_t i = 0; i < LATENCY_STAGES; i++) {
+            at[i] = r.lat.atUs[i];
+            stageUs[i].push_back(at[i]);
+        }
+        using S = LatencyStage;
+        auto idx = [](S s) { return (uint8_t)s; };
+        if (at[idx(S::CLASSIFIED)] > at[idx(S::DWELL)] || at[idx(S::DWELL)] > at[idx(S::ENQUEUED)] ||
+            at[idx(S::ENQUEUED)] > at[idx(S::UDP_TX)] ||
+            at[idx(S::CENTRAL_RX)] + r.syncUs < at[idx(S::UDP_TX)] ||
+            at[idx(S::DECISION)] < at[idx(S::CENTRAL_RX)] ||
+            at[idx(S::LIGHT_ON)] < at[idx(S::DECISION)])
+            disorder++;
+        for (uint8_t i = 1; i < LATENCY_STAGES; i++)
+            segmentUs[i].push_back(at[i] >= at[i - 1] ? at[i] - at[i - 1] : 0);
+
+        // Premier front estime (horloge du central) vs vrai
+        int64_t err = (int64_t)edgeUs - (int64_t)(bout[r.touch].firstEdgeNs / 1000u);
+        uint32_t aerr = (uint32_t)(err < 0 ? -err : err);
+        if (aerr > edgeErrMax) edgeErrMax = aerr;
+        if (aerr > r.syncUs + CORE1_MAX_US + 2) edgeOff++;
+    }
+    for (bool s : seen) missing += !s;
+
+    // Histogrammes du central vs valeurs exactes ; tireur vs central
+    uint32_t histBad = 0, wireBad = 0;
+    for (uint8_t i = 0; i < LATENCY_STAGES; i++) {
+        const LatencyHistogram& h = probe.stage((LatencyStage)i);
+        if (h.count() != stageUs[i].size()) { histBad++; continue; }
+        if (stageUs[i].empty()) continue;
+        uint32_t mx = *std::max_element(stageUs[i].begin(), stageUs[i].end());
+        for (double p : { 0.5, 0.99 }) {
+            uint32_t exact = exactPercentile(stageUs[i], p);
+            uint32_t got   = h.percentile((uint16_t)(p * 1000));
+            if (got < exact || got > exact + exact / 8 + 1) histBad++;
+        }
+        if (h.max() != mx) histBad++;
+        if (i < LATENCY_FENCER_STAGES) {
+            const LatencyHistogram& f = fencerProbe.stage((LatencyStage)i);
+            if (f.count() != h.count() || f.max() != h.max() ||
+                f.percentile(500) != h.percentile(500))
+                wireBad++;
+        }
+    }
+
+    // --- Rapport ----------------------------------------------------------------
+    std::printf("Chaine complete, %d touches de A (porteuse %u Hz), air %u-%u ms, %u %% de pertes\n",
+                touches, FREQ_VALID_B, AIR_MIN_US / 1000, AIR_MAX_US / 1000,
+                AIR_LOSS_PERMILLE / 10);
+    std::printf("  datagrammes %u (perdus %u) | copies par evenement %.2f | synchro ±%u µs\n",
+                air.sent, air.lost,
+                sender.stats().queued ? (double)sender.stats().datagrams / sender.stats().queued : 0.0,
+                clockSync.uncertaintyUs(fencerUs(endUs)));
+    std::printf("\n[LATENCE] premier front GP2 -> etape, %lu dwell (ligne STATUS du central)\n",
+                (unsigned long)probe.events());
+    char line[96];
+    for (uint8_t i = 0; i < LATENCY_STAGES; i++)
+        if (formatLatencyLine(probe, (LatencyStage)i, line, sizeof line))
+            std::printf("%s", line);
+    std::printf("\nSegments (etape precedente → etape, valeurs exactes)\n");
+    for (uint8_t i = 1; i < LATENCY_STAGES; i++)
+        std::printf("  %-18s p50 %6u | p99 %6u µs\n", latencyStageText((LatencyStage)i),
+                    exactPercentile(segmentUs[i], 0.5), exactPercentile(segmentUs[i], 0.99));
+    std::printf("\nContact vrai → photon : p50 %u | p99 %u | max %u µs ; "
+                "erreur du premier front estime max %u µs\n",
+                exactPercentile(truthUs, 0.5), exactPercentile(truthUs, 0.99),
+                truthUs.empty() ? 0 : *std::max_element(truthUs.begin(), truthUs.end()),
+                edgeErrMax);
+    std::printf("  incompletes %u | desordre %u | premier front hors borne %u | "
+                "photon faux %u | non synchro %u\n",
+                missing, disorder, edgeOff, lightBad, unsynced);
+    std::printf("  histogrammes hors classe %u | etapes du tireur alterees par la trame %u\n",
+                histBad, wireBad);
+
+    bool ok = missing == 0 && disorder == 0 && edgeOff == 0 && lightBad == 0 && unsynced == 0 &&
+              histBad == 0 && wireBad == 0 && probe.waiting() == 0 &&
+              probe.events() == (uint32_t)touches;
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
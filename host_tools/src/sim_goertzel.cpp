@@ -0,0 +1,301 @@
+// =============================================================================
+// sim_goertzel.cpp — Banc de raies sur train de bits vs comptage de fronts :
+//                    porteuses seules, porteuses superposees, cout
+// =============================================================================
+//
+// 1. DISCRIMINATION : GP2 echantillonne a GOERTZEL_SAMPLE_HZ (FakeBitSampler).
+//    Chaque porteuse arrive filtree par la chaine (passe-bas du premier ordre
+//    a sa frequence : carre arrondi), a ±0.2 % de sa frequence, phase et
+//    bruit aleatoires, puis trigger de Schmitt de GP2. Cas :
+//      seule        une porteuse du plan
+//      superposees  NEUTRE + une VALID (Mode Time-Division : coque et
+//                   cuirasse vues ensemble), rapport d'amplitude 1 et 0.7
+//    Le banc rend l'energie de chaque porteuse ; ContactEstimator recoit les
+//    periodes entre les memes fronts montants, dates a la nanoseconde comme
+//    par PioEdgeTimer (detection par comptage ; "juste" : une des porteuses
+//    emises, jamais les deux).
+//
+// 2. COUT par seconde de signal : banc (mots / s × cout d'un mot) contre
+//    comptage (fronts / s × cout d'un front dans TouchDetector, porteuse la
+//    plus haute). Mesure sur l'hote, puis budget Cortex-M0+ a 133 MHz d'apres
+//    un modele en cycles (instructions Thumb de la boucle interne, multiplieur
+//    1 cycle du RP2040 ; pour un front : divisions 64 bits en bibliotheque).
+//
+// Verifie : porteuse seule → dominante juste et les autres sous
+// GOERTZEL_PRESENT_PERMILLE ; superposees a amplitudes egales → les deux
+// presentes ; NEUTRE plus faible → VALID dominante. Les chiffres de
+// comptage et de cout sont des mesures.
+//
+// USAGE : program goertzel [essais par cas, defaut 200]
+// =============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <classifier.h>
+#include <contact_estimator.h>
+#include <fencer_event.h>
+#include <goertzel_bank.h>
+#include <pio_bit_sampler.h>
+#include <pio_edge_timer.h>
+#include <touch_detector.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t SIGNAL_WORDS   = 96;      // par essai, fenetre comprise
+const double   FREQ_ERR       = 0.002;
+const double   NOISE_RMS      = 0.05;
+const double   HYSTERESIS     = 0.1;     // seuils du Schmitt : ±HYSTERESIS
+const double   CORE_HZ        = 133e6;
+
+// Modele Cortex-M0+ (cycles), cf. en-tete
+const uint32_t M0_CYCLES_PER_BYTE_BIN = 30;    // 2 LDRSH table, 2 LDRSH cos/sin,
+                                               // 4 MULS, decalages, sommes
+const uint32_t M0_CYCLES_PER_WORD_BIN = 4 * M0_CYCLES_PER_BYTE_BIN + 20;  // + fenetre
+const uint32_t M0_CYCLES_PER_EDGE     = 350;   // pollEdges (division 64 bits),
+                                               // ContactEstimator (moyenne 64 bits),
+                                               // DwellTracker, trace
+
+struct Carrier {
+    double hz;
+    double amp;
+};
+
+struct Capture {
+    std::vector<uint32_t> words;      // train de bits (PioBitSampler)
+    std::vector<uint64_t> risingNs;   // fronts montants (PioEdgeTimer)
+};
+
+struct Collect {
+    bool push(const FencerEvent&) { return true; }
+};
+
+// GP2 : somme des porteuses filtrees, bruit, trigger de Schmitt
+class BitMaker {
+public:
+    BitMaker(uint32_t sampleHz, uint32_t seed) : fs_(sampleHz), rng_(seed) {}
+
+    Capture make(const std::vector<Carrier>& carriers) {
+        std::vector<double> phase, y, alpha, hz;
+        for (const Carrier& c : carriers) {
+            double f = c.hz * (1.0 + uni(-FREQ_ERR, FREQ_ERR));
+            hz.push_back(f);
+            phase.push_back(uni(0, 1));
+            alpha.push_back(1.0 - std::exp(-2.0 * M_PI * c.hz / fs_));
+            y.push_back(0);
+        }
+        std::normal_distribution<double> noise(0.0, NOISE_RMS);
+        Capture cap;
+        uint32_t word  = 0;
+        bool     level = false;
+        double   prev  = 0;
+        // Un tour de la plus lente avant le premier mot : filtres etablis
+        for (long n = -(long)(fs_ / 200); n < (long)SIGNAL_WORDS * 32; n++) {
+            double v = 0;
+            for (size_t i = 0; i < carriers.size(); i++) {
+                double p = std::fmod(phase[i] + hz[i] * n / fs_, 1.0);
+                if (p < 0) p += 1.0;
+                double x = p < 0.5 ? 1.0 : -1.0;
+                y[i] += alpha[i] * (x - y[i]);
+                v += carriers[i].amp * y[i];
+            }
+            v += noise(rng_);
+            if (!level && v > HYSTERESIS) {
+                level = true;
+                // Front date entre deux echantillons (interpolation)
+                double t = (n - 1 + (HYSTERESIS - prev) / (v - prev)) / fs_;
+                if (n > 0) cap.risingNs.push_back((uint64_t)(t * 1e9));
+            } else if (level && v < -HYSTERESIS) {
+                level = false;
+            }
+            prev = v;
+            if (n < 0) continue;
+            if (level) word |= 1u << (n & 31);
+            if ((n & 31) == 31) {
+                cap.words.push_back(word);
+                word = 0;
+            }
+        }
+        return cap;
+    }
+
+private:
+    double uni(double lo, double hi) {
+        return std::uniform_real_distribution<double>(lo, hi)(rng_);
+    }
+
+    double       fs_;
+    std::mt19937 rng_;
+};
+
+// Decision par comptage : periodes entre fronts montants → ContactEstimator
+FreqClass countingDecision(const std::vector<uint64_t>& risingNs) {
+    ContactEstimator<DETECT_PERIODS> est(1000000000u);
+    for (size_t i = 1; i < risingNs.size(); i++) {
+        est.pushPeriod((uint32_t)(risingNs[i] - risingNs[i - 1]));
+        if (est.ready() && est.estimate().confidence >= CONTACT_MIN_CONFIDENCE)
+            return est.estimate().cls;
+    }
+    return FreqClass::NONE;
+}
+
+struct Case {
+    const char* name;
+    int         trials = 0;
+    int         ok = 0;
+    uint32_t    minWanted = 0xFFFF;     // energie min des porteuses emises
+    uint32_t    maxOther  = 0;          // energie max des autres
+    int         countRight = 0, countWrong = 0, countNone = 0;
+
+    void report() const {
+        std::printf("  %-34s banc juste %5.1f %% | emises min %4u ‰ | autres max %4u ‰ || "
+                    "comptage juste %5.1f %% fausse %5.1f %% aucune %5.1f %%\n",
+                    name, 100.0 * ok / trials, minWanted, maxOther,
+                    100.0 * countRight / trials, 100.0 * countWrong / trials,
+                    100.0 * countNone / trials);
+    }
+};
+
+// Un essai : mots → FakeBitSampler → banc ; `wanted` : rangs dans FREQ_PLAN
+void runCase(Case& c, BitMaker& maker, GoertzelBank& bank,
+             const std::vector<uint8_t>& wanted, const std::vector<double>& amps,
+             bool needAll, bool needDominant) {
+    std::vector<Carrier> carriers;
+    for (size_t i = 0; i < wanted.size(); i++)
+        carriers.push_back({ (double)FREQ_PLAN[wanted[i]].centerHz, amps[i] });
+    Capture cap = maker.make(carriers);
+
+    FakeBitSampler sampler;
+    sampler.begin(0, bank.sampleHz());
+    bank.reset();
+    for (uint32_t w : cap.words) {
+        sampler.addWord(w);
+        sampler.poll(bank);
+    }
+
+    CarrierEnergy e[FREQ_PLAN_SIZE];
+    bank.energies(e);
+    bool good = bank.ready();
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        bool emitted = false;
+        for (uint8_t w : wanted) emitted |= w == b;
+        if (emitted) {
+            c.minWanted = std::min<uint32_t>(c.minWanted, e[b].permille);
+            if (needAll && e[b].permille < GOERTZEL_PRESENT_PERMILLE) good = false;
+        } else {
+            c.maxOther = std::max<uint32_t>(c.maxOther, e[b].permille);
+            if (e[b].permille >= GOERTZEL_PRESENT_PERMILLE) good = false;
+        }
+    }
+    if (needDominant && bank.dominant() != FREQ_PLAN[wanted[0]].cls) good = false;
+    c.trials++;
+    if (good) c.ok++;
+
+    FreqClass counted = countingDecision(cap.risingNs);
+    bool known = false;
+    for (uint8_t w : wanted) known |= counted == FREQ_PLAN[w].cls;
+    if (counted == FreqClass::NONE) c.countNone++;
+    else if (known)                 c.countRight++;
+    else                            c.countWrong++;
+}
+
+template <typename F>
+double nsPer(size_t count, F&& body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / count;
+}
+
+}  // namespace
+
+int simGoertzel(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 200;
+    if (trials <= 0) trials = 200;
+
+    GoertzelBank bank;
+    std::printf("Banc de raies sur train de bits | echantillonnage %u Hz | fenetre %u mots "
+                "(%.2f ms) | %u raies :", bank.sampleHz(), bank.windowWords(),
+                bank.windowWords() * 32 * 1000.0 / bank.sampleHz(), bank.bins());
+    for (uint8_t i = 0; i < bank.bins(); i++)
+        std::printf(" %u", bank.binHz(i));
+    std::printf(" Hz\n\n1. Discrimination (%d essais par cas)\n", trials);
+
+    BitMaker maker(bank.sampleHz(), 19);
+    bool ok = true;
+
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "seule %s", FREQ_PLAN[b].label);
+        Case c = {};
+        c.name = name;
+        for (int t = 0; t < trials; t++)
+            runCase(c, maker, bank, { b }, { 1.0 }, true, true);
+        c.report();
+        ok &= c.ok == c.trials;
+    }
+
+    const double RATIOS[] = { 1.0, 0.7 };
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        if (FREQ_PLAN[b].cls == FreqClass::NEUTRE) continue;
+        uint8_t neutre = 0;
+        while (FREQ_PLAN[neutre].cls != FreqClass::NEUTRE) neutre++;
+        for (double r : RATIOS) {
+            char name[48];
+            std::snprintf(name, sizeof(name), "%s + NEUTRE x%.1f", FREQ_PLAN[b].label, r);
+            Case c = {};
+            c.name = name;
+            for (int t = 0; t < trials; t++)
+                runCase(c, maker, bank, { b, neutre }, { 1.0, r }, r >= 1.0, r < 1.0);
+            c.report();
+            ok &= c.ok == c.trials;
+        }
+    }
+
+    // --- 2. Cout --------------------------------------------------------------
+    std::printf("\n2. Cout par seconde de signal\n");
+    std::vector<uint32_t> words = maker.make({ { (double)FREQ_PLAN[0].centerHz, 1.0 } }).words;
+    const size_t WORD_REPS = 20000;
+    double nsWord = nsPer(WORD_REPS * words.size(), [&] {
+        for (size_t r = 0; r < WORD_REPS; r++)
+            for (uint32_t w : words) bank.pushWord(w);
+    });
+
+    uint32_t topHz = detail::maxCenterHz();
+    FakeEdgeTimer timer(1000000000u);
+    TouchDetector detector(timer.tickHz(), 0);
+    Collect sink;
+    const size_t EDGES = 2000000;
+    uint32_t periodTicks = 1000000000u / topHz;
+    uint64_t tUs = 0;
+    detector.stepFiltered(tUs, true, tUs, timer, sink);
+    double nsEdge = nsPer(EDGES, [&] {
+        for (size_t i = 0; i < EDGES; i += 8) {
+            for (int k = 0; k < 8; k++) timer.addPeriod(periodTicks);
+            tUs += 8 * 1000000u / topHz;
+            detector.stepFiltered(tUs, true, 0, timer, sink);
+        }
+    });
+
+    double wordsPerS = bank.sampleHz() / 32.0;
+    double bankHost  = wordsPerS * nsWord / 1e9;
+    double countHost = topHz * nsEdge / 1e9;
+    double bankM0    = wordsPerS * bank.bins() * M0_CYCLES_PER_WORD_BIN / CORE_HZ;
+    double countM0   = (double)topHz * M0_CYCLES_PER_EDGE / CORE_HZ;
+    std::printf("  hote      banc %7.1f ns/mot  x %6.0f mots/s   = %5.2f %% d'un coeur | "
+                "comptage %6.1f ns/front x %6u fronts/s = %5.2f %%\n",
+                nsWord, wordsPerS, 100 * bankHost, nsEdge, topHz, 100 * countHost);
+    std::printf("  M0+ (modele, 133 MHz) banc %u cycles/mot/raie -> %5.1f %% | "
+                "comptage %u cycles/front -> %5.1f %%\n",
+                M0_CYCLES_PER_WORD_BIN, 100 * bankM0, M0_CYCLES_PER_EDGE, 100 * countM0);
+    std::printf("  memoire banc : %zu octets\n", sizeof(GoertzelBank));
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+// =============================================================================
+// sim_lamps.cpp — Lampes et buzzer du central : trames, son, latence
+// =============================================================================
+//
+// Un assaut aleatoire (phrases toutes les 2 a 4 s, touches valables / non
+// valables de chaque tireur a ±400 ms, transport de 1 a 5 ms) passe par le
+// vrai Referee puis par LampPanel, avec FakeNeoPixel et FakeBuzzer qui
+// enregistrent trames et son avec leurs instants. La boucle du central est
+// simulee avec un tour de 20 a LOOP_MAX_US µs (Serial, lien). Une phrase sur
+// cinq ajoute une touche adverse plus ancienne qui arrive pendant la trame
+// de la premiere (decision en attente, fusion).
+//
+// Verifie, pour chaque decision de l'arbitre (LIGHT, VERDICT, extinction) :
+//   - une trame la montre (contenu = renderLamps de l'etat a son depart)
+//   - decision → premier photon <= LAMP_MAX_LATENCY_US + un tour de boucle
+//   - buzzer en marche au meme instant qu'une lampe qui s'allume, arrete
+//     BUZZER_US plus tard (a un tour de boucle pres)
+//   - lampes eteintes REFEREE_HOLD_US apres le verdict
+// Mesure : latence p50 / p99 / max, trames fusionnees, cout d'apply() sur
+// l'hote.
+//
+// USAGE : program lampsim [phrases, defaut 300]
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <buzzer.h>
+#include <lamp_panel.h>
+#include <neopixel_strip.h>
+#include <referee.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t LOOP_MIN_US = 20;
+const uint32_t LOOP_MAX_US = 500;
+const uint32_t SYNC_US     = 300;
+
+struct Arrival {
+    uint64_t   atUs;
+    TouchEvent ev;
+};
+
+struct OutputList {
+    std::vector<RefereeOutput> items;
+    bool push(const RefereeOutput& o) {
+        items.push_back(o);
+        return true;
+    }
+};
+
+TouchEvent dwellEvent(uint8_t player, FreqClass cls, uint64_t tUs, uint16_t seq) {
+    TouchEvent ev = {};
+    ev.type   = FencerEventType::DWELL;
+    ev.player = player;
+    ev.cls    = cls;
+    ev.tUs    = tUs;
+    ev.seq    = seq;
+    ev.syncUs = SYNC_US;
+    return ev;
+}
+
+std::vector<Arrival> randomBout(int phrases, std::mt19937& rng) {
+    auto uni = [&](int64_t lo, int64_t hi) {
+        return std::uniform_int_distribution<int64_t>(lo, hi)(rng);
+    };
+    std::vector<Arrival> out;
+    uint64_t t = 1000000;
+    uint16_t seq[2] = { 0, 0 };
+    for (int n = 0; n < phrases; n++) {
+        t += (uint64_t)uni(2000000, 4000000);
+        for (uint8_t player = PLAYER_A; player <= PLAYER_B; player++) {
+            if (uni(0, 99) >= 75) continue;
+            uint64_t hit = (uint64_t)((int64_t)t + (player == PLAYER_A ? 0 : uni(-400000, 400000)));
+            FreqClass own = player == PLAYER_A ? FreqClass::VALID_A : FreqClass::VALID_B;
+            FreqClass opp = player == PLAYER_A ? FreqClass::VALID_B : FreqClass::VALID_A;
+            FreqClass cls = uni(0, 9) < 8 ? opp : own;
+            uint64_t arrival = hit + (uint64_t)uni(1000, 5000);
+            out.push_back({ arrival, dwellEvent(player, cls, hit, seq[player - 1]++) });
+            // Rafale : une touche plus ancienne de l'adversaire arrive pendant
+            // la trame de la premiere (lampe allumee ou corrigee en attente)
+            if (uni(0, 99) < 20) {
+                uint8_t other = player == PLAYER_A ? PLAYER_B : PLAYER_A;
+                FreqClass oo = other == PLAYER_A ? FreqClass::VALID_B : FreqClass::VALID_A;
+                out.push_back({ arrival + (uint64_t)uni(20, 700),
+                                dwellEvent(other, oo, hit - (uint64_t)uni(1000, 50000),
+                                           seq[other - 1]++) });
+            }
+        }
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const Arrival& a, const Arrival& b) { return a.atUs < b.atUs; });
+    return out;
+}
+
+struct State {
+    Lamp a = Lamp::NONE, b = Lamp::NONE;
+};
+
+bool sameFrame(const NeoPixelRecord& r, const State& s) {
+    uint32_t grb[LAMP_PIXELS];
+    renderLamps(s.a, s.b, grb);
+    for (uint16_t i = 0; i < LAMP_PIXELS; i++)
+        if (r.grb[i] != grb[i]) return false;
+    return true;
+}
+
+uint32_t percentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5))];
+}
+
+}  // namespace
+
+int simLamps(int argc, char** argv) {
+    int phrases = argc >= 1 ? std::atoi(argv[0]) : 300;
+    if (phrases <= 0) phrases = 300;
+    std::mt19937 rng(21);
+    std::vector<Arrival> bout = randomBout(phrases, rng);
+
+    Referee      referee;
+    FakeNeoPixel strip;
+    FakeBuzzer   buzzer;
+    strip.begin(22, LAMP_PIXELS);
+    buzzer.begin(21);
+    LampPanel<FakeNeoPixel, FakeBuzzer> panel(strip, buzzer);
+
+    // Etats attendus : instant de la decision → etat des lampes apres elle
+    struct Change {
+        uint64_t tUs;
+        State    s;
+    };
+    std::vector<Change> changes(1);   // eteint au depart, rien a montrer
+    std::vector<uint32_t> latencies;
+    std::vector<double>   applyNs;
+    uint32_t shown = 1, wrongFrame = 0, late = 0, buzzerBad = 0, holdBad = 0;
+    uint32_t checkedFrames = 0;
+    uint64_t lastOnUs = 0;
+    bool     expectBuzz = false;
+    uint64_t offDueUs = 0;
+
+    auto inspectFrames = [&]() {
+        // Trames nouvelles : contenu = dernier etat decide avant leur depart,
+        // et chaque decision affichee au plus tard par la premiere trame qui
+        // part apres elle
+        while (checkedFrames < strip.frames()) {
+            const NeoPixelRecord& r = strip.record(strip.kept() - (strip.frames() - checkedFrames));
+            checkedFrames++;
+            State s;
+            for (const Change& c : changes)
+                if (c.tUs <= r.startUs) s = c.s;
+            if (!sameFrame(r, s)) wrongFrame++;
+            // Decisions montrees par cette trame : celles d'avant son depart
+            while (shown < changes.size() && changes[shown].tUs <= r.startUs) {
+                uint32_t lat = (uint32_t)(r.photonUs - changes[shown].tUs);
+                latencies.push_back(lat);
+                if (lat > LAMP_MAX_LATENCY_US + LOOP_MAX_US) late++;
+                shown++;
+            }
+        }
+    };
+
+    auto record = [&](uint64_t t) {
+        State s;
+        s.a = panel.lamp(PLAYER_A);
+        s.b = panel.lamp(PLAYER_B);
+        if (s.a != changes.back().s.a || s.b != changes.back().s.b)
+            changes.push_back({ t, s });
+    };
+
+    auto applyAll = [&](OutputList& outs, uint64_t t) {
+        for (const RefereeOutput& o : outs.items) {
+            auto t0 = std::chrono::steady_clock::now();
+            panel.apply(o, t);
+            applyNs.push_back(std::chrono::duration<double, std::nano>(
+                                  std::chrono::steady_clock::now() - t0).count());
+            if (o.kind == RefereeOutputKind::LIGHT && o.lamp != Lamp::NONE) {
+                if (!buzzer.isOn()) buzzerBad++;
+                lastOnUs   = t;
+                expectBuzz = true;
+            }
+            if (o.kind == RefereeOutputKind::VERDICT)
+                offDueUs = o.atUs + REFEREE_HOLD_US;
+            record(t);
+            inspectFrames();
+        }
+        outs.items.clear();
+    };
+
+    OutputList outs;
+    size_t   next = 0;
+    uint64_t t    = 0;
+    uint64_t endUs = bout.empty() ? 0 : bout.back().atUs + 3000000;
+    std::uniform_int_distribution<uint32_t> loop(LOOP_MIN_US, LOOP_MAX_US);
+    while (t < endUs) {
+        t += loop(rng);
+        while (next < bout.size() && bout[next].atUs <= t) {
+            referee.onEvent(bout[next].ev, bout[next].atUs, outs);
+            applyAll(outs, t);
+            next++;
+        }
+        referee.poll(t, outs);
+        applyAll(outs, t);
+        panel.service(t);
+        record(t);                   // extinction en fin d'affichage
+        inspectFrames();
+
+        if (expectBuzz && !buzzer.isOn()) {
+            uint64_t due = lastOnUs + BUZZER_US;
+            if (t < due || t > due + LOOP_MAX_US) buzzerBad++;
+            expectBuzz = false;
+        }
+        if (offDueUs && t > offDueUs + LOOP_MAX_US) {
+            if (panel.lit()) holdBad++;
+            offDueUs = 0;
+        }
+    }
+    // Dernieres trames en attente
+    for (int i = 0; i < 10; i++) {
+        t += LOOP_MAX_US;
+        panel.service(t);
+        inspectFrames();
+    }
+
+    const LampStats& st = panel.stats();
+    uint32_t unshown = (uint32_t)changes.size() - shown;
+    uint32_t decided = (uint32_t)changes.size() - 1;
+    std::sort(applyNs.begin(), applyNs.end());
+    double applyP99 = applyNs.empty() ? 0 : applyNs[(size_t)(0.99 * (applyNs.size() - 1))];
+
+    std::printf("Assaut de %d phrases : %zu arrivees, %u verdicts, %u changements de lampes\n",
+                phrases, bout.size(), referee.stats().verdicts, decided);
+    std::printf("  trames %u (fusionnees %u) de %u pixels, %u µs chacune latch compris\n",
+                st.frames, st.coalesced, LAMP_PIXELS, LAMP_FRAME_US);
+    std::printf("  decision → photon  p50 %u µs | p99 %u µs | max %u µs  "
+                "(borne %u µs + tour de boucle %u µs)\n",
+                percentile(latencies, 0.5), percentile(latencies, 0.99), st.maxLatencyUs,
+                LAMP_MAX_LATENCY_US, LOOP_MAX_US);
+    std::printf("  buzzer : %u changements d'etat, %u ecarts\n", buzzer.changes(), buzzerBad);
+    std::printf("  apply() sur l'hote : p99 %.0f ns\n", applyP99);
+    std::printf("  trames fausses %u | decisions jamais montrees %u | hors borne %u | "
+                "lampes restees allumees %u\n", wrongFrame, unshown, late, holdBad);
+
+    bool ok = wrongFrame == 0 && unshown == 0 && late == 0 && buzzerBad == 0 && holdBad == 0 &&
+              st.maxLatencyUs <= LAMP_MAX_LATENCY_US + LOOP_MAX_US && decided > 0 &&
+              buzzer.changes() > 0 && !panel.lit() && !buzzer.isOn();
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// =============================================================================
+// sim_time_division.cpp — Simulation du cycle EMIT / DETECT (Mode Time-Division)
+// =============================================================================
+//
+// Rejoue TimeDivision::onDeadline() comme le ferait l'alarme materielle :
+//   - chaque echeance est servie avec une latence d'interruption aleatoire
+//     (quelques µs, et de rares blocages jusqu'a IRQ_STALL_MAX_US comme une
+//     ecriture flash ou une rafale USB) ; une echeance deja passee est
+//     traitee aussitot, comme dans TdAlarmDriver::service()
+//   - GP16 ne lit HIGH que si le bouton est ouvert ET que la ligne C a eu le
+//     temps de monter (pull-up interne 50 kΩ, fil 10 nF, seuil VIH 2.0 V)
+//     depuis la coupure de la pull-up ou depuis l'appui
+//
+// Verifie :
+//   - duree des creneaux EMIT / DETECT et position de l'echantillon
+//   - ordre des commandes : jamais de PWM sans pull-up alimentee, jamais de
+//     pull-up coupee avec le PWM actif, jamais de lecture avec pull-up active
+//   - latence appui → FULL DETECT sur des appuis de DWELL_MIN_MS : pire cas
+//     et temps de mesure de frequence restant dans le contact
+//
+// USAGE : program tdsim [essais, defaut 20000]
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <fie_timing.h>
+#include <time_division.h>
+
+using namespace fencing;
+
+namespace {
+
+const double   PULLUP_OHM       = 50e3;
+const double   LINE_F           = 10e-9;
+const double   VIH_RATIO        = 2.0 / 3.3;
+const double   IRQ_BASE_US      = 2.0;
+const double   IRQ_TAIL_US      = 3.0;      // moyenne de la queue exponentielle
+const double   IRQ_STALL_PROB   = 0.001;
+const uint32_t IRQ_STALL_MAX_US = 400;
+
+// Temps de montee de la ligne C jusqu'a VIH
+const uint64_t RISE_US = (uint64_t)std::ceil(-PULLUP_OHM * LINE_F * std::log(1.0 - VIH_RATIO) * 1e6);
+
+struct MinMax {
+    uint64_t lo = ~0ull, hi = 0;
+    void add(uint64_t v) { lo = std::min(lo, v); hi = std::max(hi, v); }
+};
+
+struct SimIo {
+    uint64_t now = 0;
+
+    // Etat des sorties
+    bool     supply = false;
+    bool     emit   = false;
+    uint64_t supplyOffAt = 0;
+    uint64_t emitOnAt    = 0;
+    uint64_t emitUs      = 0;     // temps d'emission cumule
+
+    // Bouton physique
+    bool     open   = false;      // B↔C ouvert = presse
+    uint64_t openAt = 0;
+
+    // Mesures
+    MinMax   emitSlot, detectSlot, sampleOffset;
+    bool     slotHadFull = true;  // pas de creneau DETECT avant start()
+    int      violations  = 0;
+
+    void setSupply(bool on) {
+        if (on == supply) return;
+        if (!on && emit) violations++;             // pull-up coupee sous PWM
+        if (!on) {
+            supplyOffAt = now;
+            slotHadFull = false;
+        } else if (!slotHadFull) {
+            detectSlot.add(now - supplyOffAt);
+        }
+        supply = on;
+    }
+
+    void setEmit(bool on) {
+        if (on == emit) return;
+        if (on && !supply) violations++;           // PWM sans pull-up
+        if (on) {
+            emitOnAt = now;
+        } else {
+            emitSlot.add(now - emitOnAt);
+            emitUs += now - emitOnAt;
+        }
+        emit = on;
+    }
+
+    bool readButton() {
+        if (supply) violations++;                  // lecture ecrasee par la pull-up
+        if (!slotHadFull) sampleOffset.add(now - supplyOffAt);
+        uint64_t since = std::max(supplyOffAt, openAt);
+        return open && now - since >= RISE_US;
+    }
+};
+
+}  // namespace
+
+int simTimeDivision(int argc, char** argv) {
+    int trials = argc >= 1 ? std::atoi(argv[0]) : 20000;
+    if (trials <= 0) trials = 20000;
+
+    std::mt19937_64 rng(2024);
+    std::exponential_distribution<double> tail(1.0 / IRQ_TAIL_US);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    auto irqLatency = [&]() -> uint64_t {
+        if (uni(rng) < IRQ_STALL_PROB)
+            return (uint64_t)(uni(rng) * IRQ_STALL_MAX_US);
+        return (uint64_t)(IRQ_BASE_US + tail(rng));
+    };
+
+    const uint64_t HOLD_US = (uint64_t)DWELL_MIN_MS * 1000u;
+
+    TimeDivision td;
+    SimIo io;
+    uint64_t due = td.start(0, io);
+    uint32_t late = 0;
+
+    std::vector<uint64_t> latencies;
+    int missed = 0;
+
+    // Premier appui apres une seconde de cycle a vide
+    uint64_t nextPress = 1000000;
+    uint64_t release   = 0;
+    bool     seen      = false;
+    int      done      = 0;
+
+    while (done < trials) {
+        uint64_t t = std::max(due + irqLatency(), io.now);
+
+        // Evenements physiques du bouton avant cette echeance
+        if (!io.open && nextPress <= t) {
+            io.open   = true;
+            io.openAt = nextPress;
+            release   = nextPress + HOLD_US;
+            seen      = false;
+        }
+        if (io.open && release <= t) {
+            io.open = false;
+            if (!seen) missed++;
+            done++;
+            // Pause de 30 a 80 ms, phase aleatoire par rapport au cycle
+            nextPress = release + 30000 + (uint64_t)(uni(rng) * 50000);
+        }
+
+        io.now = t;
+        TdPhase before = td.phase();
+        due = td.onDeadline(due, t, io);
+        if (td.phase() == TdPhase::FULL_DETECT && before != TdPhase::FULL_DETECT) {
+            io.slotHadFull = true;
+            if (io.open && !seen) {
+                seen = true;
+                latencies.push_back(t - io.openAt);
+            }
+        }
+        if (due <= io.now) late++;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    uint64_t maxLat = latencies.empty() ? 0 : latencies.back();
+    uint64_t p99    = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+    double   mean   = 0;
+    for (uint64_t l : latencies) mean += l;
+    mean = latencies.empty() ? 0 : mean / latencies.size();
+
+    std::printf("Mode Time-Division : EMIT %u us / DETECT %u us, echantillon a +%u us\n",
+                TD_EMIT_US, TD_DETECT_US, TD_SETTLE_US);
+    std::printf("  montee ligne C jusqu'a VIH : %llu us (50 kOhm, 10 nF)\n\n",
+                (unsigned long long)RISE_US);
+
+    std::printf("Creneaux (reels, latence d'interruption comprise)\n");
+    std::printf("  EMIT          %6llu .. %6llu us\n",
+                (unsigned long long)io.emitSlot.lo, (unsigned long long)io.emitSlot.hi);
+    std::printf("  DETECT        %6llu .. %6llu us\n",
+                (unsigned long long)io.detectSlot.lo, (unsigned long long)io.detectSlot.hi);
+    std::printf("  echantillon   %6llu .. %6llu us apres coupure de la pull-up\n",
+                (unsigned long long)io.sampleOffset.lo, (unsigned long long)io.sampleOffset.hi);
+    std::printf("  emission      %6.2f %% du temps (appuis compris)\n",
+                100.0 * io.emitUs / io.now);
+    std::printf("  echeances deja passees : %u | violations d'ordre : %d\n\n", late, io.violations);
+
+    std::printf("Appui de %u ms → FULL DETECT (%d essais)\n", DWELL_MIN_MS, trials);
+    std::printf("  latence moy %6.0f us | p99 %6llu us | max %6llu us\n",
+                mean, (unsigned long long)p99, (unsigned long long)maxLat);
+    std::printf("  mesure restante dans le contact : min %lld us\n",
+                (long long)HOLD_US - (long long)maxLat);
+    std::printf("  appuis manques : %d\n", missed);
+
+    bool ok = io.violations == 0 && missed == 0 && maxLat < HOLD_US &&
+              io.sampleOffset.lo >= RISE_US;
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+// =============================================================================
+// sim_window.cpp — Fenetres a cadence fixe vs fenetres polled par millis()
+// =============================================================================
+//
+// 1. Erreur de frequence sous blocages de la boucle : une porteuse
+//    (plan courant, puis les memes frequences decalees de 0.037 %) est
+//    comptee de trois facons pendant que loop() bloque de temps en temps
+//    (Serial plein, 5 a 60 ms) :
+//
+//    - WindowEngine (window_sampler.h) sur un FakeEdgeCounter, lu par une
+//      "alarme" sur la grille avec une latence d'interruption simulee :
+//      gigue de 0 a 2 µs, parfois 5 a 80 µs (au-dela de WINDOW_LATE_TOL_US
+//      → recalage), rarement plus d'un pas entier ;
+//    - le motif des sketches : now - lastMeasureTime >= 50 ms dans loop(),
+//      windowFreqHz(count, elapsed) au ms pres ;
+//    - Phase 0.2 : fenetre de 15 ms et count * (1000 / 15) = count * 66.
+//
+//    Chaque fenetre publiee par le moteur doit etre a ±1 front pres, plus
+//    le retard de lecture accepte, de la vraie frequence. La boucle lit le
+//    DoubleBuffer a chacun de ses tours : resultat coherent, seq croissant.
+//
+// 2. DoubleBuffer sous deux threads : l'ecrivain publie sans jamais
+//    attendre, le lecteur verifie que chaque copie est entiere (tous les
+//    champs derives du meme numero) et que seq ne recule jamais.
+//
+// 3. Rebouclage du compteur 16 bits : FakeEdgeCounter place juste avant
+//    0xFFFF (setRaw), fenetres a cheval sur 0xFFFF → 0 ; takePulseCount()
+//    et peekPulseCount() doivent rendre le nombre exact de fronts.
+//
+// USAGE : program window [secondes simulees par frequence, defaut 20]
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include <double_buffer.h>
+#include <edge_counter.h>
+#include <freq_plan.h>
+#include <window_sampler.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t LEGACY_PERIOD_MS  = 50;     // MEASURE_PERIOD des recepteurs
+const uint32_t PHASE02_PERIOD_MS = 15;     // MEASURE_PERIOD de Phase 0.2
+const uint32_t LOOP_US           = 300;    // tour de loop() (+ 0..200 µs)
+const uint32_t STALL_PER_MILLE   = 10;     // tours bloques
+const uint32_t STALL_MIN_US      = 5000;
+const uint32_t STALL_MAX_US      = 60000;
+
+// Porteuse ideale : fronts montants dans [0, tUs]
+struct Carrier {
+    double hz;
+    double phase;
+    uint32_t edges(uint64_t tUs) const { return (uint32_t)std::floor(hz * (double)tUs * 1e-6 + phase); }
+};
+
+struct FreqStats {
+    double   hz          = 0;
+    uint32_t windows     = 0;
+    uint32_t resyncs     = 0;
+    double   errMax      = 0;
+    double   bound       = 0;
+    uint32_t appReads    = 0;
+    uint32_t appMissed   = 0;      // fenetres publiees jamais vues par la boucle
+    uint32_t appBad      = 0;
+    double   legacyErr   = 0;
+    uint32_t legacyMaxMs = 0;
+    double   phase02Err  = 0;
+};
+
+// Latence de l'interruption d'alarme (µs apres la frontiere)
+uint64_t irqLatency(std::mt19937& rng, uint32_t hopUs) {
+    uint32_t r = rng() % 4000;
+    if (r == 0)
+        return hopUs + rng() % (hopUs * 3 / 2);         // interruption masquee longtemps
+    if (r < 10)
+        return 5 + rng() % 76;
+    return rng() % 3;
+}
+
+FreqStats runCarrier(double hz, uint32_t seconds, std::mt19937& rng) {
+    FreqStats st;
+    st.hz = hz;
+    Carrier carrier = { hz, std::uniform_real_distribution<double>(0.0, 1.0)(rng) };
+
+    WindowEngine    engine;
+    FakeEdgeCounter counter;
+    counter.clear();
+
+    // ±1 front, plus un bord lu jusqu'a WINDOW_LATE_TOL_US en retard,
+    // plus l'arrondi au Hz
+    st.bound = (1.0 + hz * WINDOW_LATE_TOL_US * 1e-6) * 1e6 / engine.windowUs() + 0.5;
+
+    const uint64_t endUs = (uint64_t)seconds * 1000000u;
+    uint64_t firstUs = 1000 + rng() % engine.hopUs();
+    engine.start(firstUs);
+    uint64_t irqUs  = engine.dueUs() + irqLatency(rng, engine.hopUs());
+    uint64_t loopUs = rng() % LOOP_US;
+    uint32_t lastEdges = 0;
+
+    // Sketch : millis() et compteur lus par loop()
+    uint32_t legacyMs = 0, legacyEdges = 0;
+    uint32_t p02Ms = 0, p02Edges = 0;
+    uint32_t lastSeq = 0;
+
+    while (irqUs < endUs || loopUs < endUs) {
+        if (irqUs <= loopUs) {
+            // --- Interruption d'alarme : lecture du compteur puis de l'horloge
+            uint32_t e = carrier.edges(irqUs);
+            counter.addEdges(e - lastEdges);
+            lastEdges = e;
+            uint32_t before = engine.published();
+            engine.onHop(counter.takePulseCount(), irqUs);
+            if (engine.published() != before) {
+                WindowResult r = {};
+                engine.read(r);
+                double err = std::fabs((double)r.freqHz - hz);
+                st.errMax = std::max(st.errMax, err);
+                st.windows++;
+            }
+            irqUs = engine.dueUs() + irqLatency(rng, engine.hopUs());
+            continue;
+        }
+
+        // --- Tour de loop()
+        uint32_t nowMs = (uint32_t)(loopUs / 1000);
+        WindowResult r = {};
+        if (engine.read(r)) {
+            st.appReads++;
+            if (r.seq < lastSeq || r.freqHz != windowFreqHzUs(r.count, r.windowUs) ||
+                r.windowUs != engine.windowUs() || r.endUs > loopUs)
+                st.appBad++;
+            if (r.seq > lastSeq + 1 && lastSeq != 0)
+                st.appMissed += r.seq - lastSeq - 1;
+            lastSeq = std::max(lastSeq, r.seq);
+        }
+
+        if (legacyMs == 0 && legacyEdges == 0) {
+            legacyMs = p02Ms = nowMs;
+            legacyEdges = p02Edges = carrier.edges(loopUs);
+        }
+        if (nowMs - legacyMs >= LEGACY_PERIOD_MS) {
+            uint32_t e = carrier.edges(loopUs);
+            uint32_t elapsed = nowMs - legacyMs;
+            double f = windowFreqHz(e - legacyEdges, elapsed);
+            st.legacyErr   = std::max(st.legacyErr, std::fabs(f - hz));
+            st.legacyMaxMs = std::max(st.legacyMaxMs, elapsed);
+            legacyMs = nowMs;
+            legacyEdges = e;
+        }
+        if (nowMs - p02Ms >= PHASE02_PERIOD_MS) {
+            uint32_t e = carrier.edges(loopUs);
+            double f = (double)((e - p02Edges) * (1000 / PHASE02_PERIOD_MS));
+            st.phase02Err = std::max(st.phase02Err, std::fabs(f - hz));
+            p02Ms = nowMs;
+            p02Edges = e;
+        }
+
+        loopUs += LOOP_US + rng() % 200;
+        if (rng() % 1000 < STALL_PER_MILLE)
+            loopUs += STALL_MIN_US + rng() % (STALL_MAX_US - STALL_MIN_US);
+    }
+    st.resyncs = engine.resyncs();
+    return st;
+}
+
+// -----------------------------------------------------------------------------
+// DoubleBuffer sous deux threads
+// -----------------------------------------------------------------------------
+
+WindowResult makeResult(uint32_t n) {
+    WindowResult r;
+    r.seq      = n;
+    r.endUs    = (uint64_t)n * 0x9E3779B97F4A7C15ull;
+    r.windowUs = ~n;
+    r.count    = n * 2654435761u;
+    r.freqHz   = n ^ 0xA5A5A5A5u;
+    return r;
+}
+
+bool intact(const WindowResult& r) {
+    WindowResult ref = makeResult(r.seq);
+    return r.endUs == ref.endUs && r.windowUs == ref.windowUs && r.count == ref.count &&
+           r.freqHz == ref.freqHz;
+}
+
+bool stressBuffer(uint32_t count) {
+    static DoubleBuffer<WindowResult> buf;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint32_t n = 1; n <= count; n++) {
+            buf.publish(makeResult(n));
+            if ((n & 255) == 0)
+                std::this_thread::yield();      // hote mono-coeur
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t reads = 0, torn = 0, backwards = 0;
+    uint32_t last = 0;
+    WindowResult r;
+    for (;;) {
+        bool finished = done.load(std::memory_order_acquire);
+        if (buf.read(r)) {
+            reads++;
+            if (!intact(r)) torn++;
+            if (r.seq < last) backwards++;
+            last = std::max(last, r.seq);
+        }
+        if (finished) break;
+    }
+    writer.join();
+
+    bool ok = torn == 0 && backwards == 0 && last == count && reads > 0;
+    std::printf("  %u publications | %llu lectures | %u reprises | dechirees %llu | recul %llu → %s\n",
+                count, (unsigned long long)reads, buf.retries(), (unsigned long long)torn,
+                (unsigned long long)backwards, ok ? "OK" : "ECART");
+    return ok;
+}
+
+// Fenetres a cheval sur 0xFFFF → 0, depuis plusieurs valeurs de depart
+bool checkWrap() {
+    const uint16_t starts[] = { 0xFFFF, 0xFFF0, 0xFF00, 0x8000 };
+    const uint32_t counts[] = { 1, 15, 16, 255, 0x7FFF, 0xFFFF };
+    uint32_t cases = 0, bad = 0;
+    for (uint16_t start : starts) {
+        for (uint32_t n : counts) {
+            FakeEdgeCounter counter;
+            counter.setRaw(start);
+            counter.clear();
+            counter.addEdges(n / 2);
+            uint32_t peek = counter.peekPulseCount();
+            counter.addEdges(n - n / 2);
+            uint32_t take = counter.takePulseCount();
+            uint32_t next = counter.takePulseCount();
+            cases++;
+            if (peek != n / 2 || take != n || next != 0) {
+                if (bad++ < 3)
+                    std::printf("  /!\\ depart 0x%04X, %u fronts : peek %u take %u puis %u\n",
+                                start, n, peek, take, next);
+            }
+        }
+    }
+    bool ok = bad == 0;
+    std::printf("  %u fenetres a cheval sur 0xFFFF -> 0 | fausses %u → %s\n", cases, bad,
+                ok ? "OK" : "ECART");
+    return ok;
+}
+
+}  // namespace
+
+int simWindow(int argc, char** argv) {
+    uint32_t seconds = argc >= 1 ? (uint32_t)std::atoi(argv[0]) : 20;
+    if (seconds == 0) seconds = 20;
+
+    std::mt19937 rng(24);
+    WindowEngine ref;
+
+    std::printf("Fenetres %u us glissantes, pas %u us | retard accepte %u us | "
+                "boucle %u..%u us, %u/1000 tours bloques %u..%u ms\n\n",
+                ref.windowUs(), ref.hopUs(), WINDOW_LATE_TOL_US, LOOP_US, LOOP_US + 200,
+                STALL_PER_MILLE, STALL_MIN_US / 1000, STALL_MAX_US / 1000);
+    std::printf("  %10s | %7s %6s %8s %8s | %7s %7s | %9s %6s | %9s\n", "porteuse", "fenetres",
+                "recal", "err max", "borne", "lues", "sautees", "millis()", "fen max", "Phase 0.2");
+
+    bool ok = true;
+    double legacyWorst = 0, phase02Worst = 0;
+    for (int skew = 0; skew < 2; skew++) {
+        for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+            double hz = FREQ_PLAN[i].centerHz * (skew ? 1.00037 : 1.0);
+            FreqStats st = runCarrier(hz, seconds, rng);
+            bool good = st.errMax <= st.bound && st.windows > 0 && st.appBad == 0 &&
+                        st.appReads > 0;
+            ok = ok && good;
+            legacyWorst  = std::max(legacyWorst, st.legacyErr);
+            phase02Worst = std::max(phase02Worst, st.phase02Err);
+            std::printf("  %8.1f Hz | %8u %6u %5.1f Hz %5.1f Hz | %7u %7u | %6.1f Hz %3u ms | %6.1f Hz%s\n",
+                        st.hz, st.windows, st.resyncs, st.errMax, st.bound, st.appReads,
+                        st.appMissed, st.legacyErr, st.legacyMaxMs, st.phase02Err,
+                        good ? "" : "  ← ECART");
+        }
+    }
+    std::printf("\n  pire erreur : grille %s | millis() %.1f Hz | Phase 0.2 %.1f Hz\n",
+                ok ? "dans la borne" : "HORS BORNE", legacyWorst, phase02Worst);
+
+    std::printf("\nDoubleBuffer<WindowResult> : %zu octets, %u threads materiels\n",
+                sizeof(WindowResult), std::thread::hardware_concurrency());
+    ok = stressBuffer(2000000) && ok;
+
+    std::printf("\nCompteur 16 bits (FakeEdgeCounter) :\n");
+    ok = checkWrap() && ok;
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
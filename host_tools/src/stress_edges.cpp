@@ -0,0 +1,237 @@
+// =============================================================================
+// stress_edges.cpp — Tempetes de fronts sur GP2 : EdgeGovernor vs lecture
+//                    directe du chronometre
+// =============================================================================
+//
+// Chaque cycle, pour une porteuse du plan (FakeEdgeTimer, boucle de 50 µs
+// comme loop1) :
+//   1. appui, porteuse seule CARRIER_MS                   → DECISION attendue
+//   2. appui, parasite a STORM_RATES[] pendant STORM_MS, puis la porteuse
+//      revient (meme appui) pendant CARRIER_MS            → DECISION attendue
+//   3. appui, porteuse seule, loop1 bloque STALL_US une fois au milieu
+//      (flash, Serial)                                    → DECISION attendue
+//
+// Le meme scenario passe par TouchDetector deux fois : a travers
+// EdgeGovernor (firmware) et directement sur le chronometre. Pour chacun :
+// fronts traites par appel (max), temps d'un appel (p99, max, horloge
+// reelle de l'hote) ; pour le limiteur, ses mesures (tempetes, debit max,
+// charge).
+//
+// Verifie (limiteur) :
+//   - jamais plus de budget() fronts traites par appel, ou de
+//     GOVERNOR_STORM_HZ × retard apres un loop1 bloque ; charge <= 1000 ‰
+//   - une tempete comptee par parasite au-dela de GOVERNOR_STORM_HZ, aucune
+//     en dessous ni pour un loop1 bloque, anomalie EDGE_STORM dans l'anneau
+//     de trace
+//   - DECISION juste sur la porteuse, avant et apres chaque tempete
+//
+// USAGE : program edgestorm [cycles, defaut 24]
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <classifier.h>
+#include <edge_governor.h>
+#include <fencer_event.h>
+#include <pio_edge_timer.h>
+#include <touch_detector.h>
+#include <trace_ring.h>
+
+using namespace fencing;
+
+namespace {
+
+const uint32_t LOOP_US    = 50;
+const uint32_t CARRIER_MS = 30;
+const uint32_t STORM_MS   = 20;
+const uint32_t IDLE_MS    = 5;
+// Plusieurs fenetres du limiteur, sans depasser l'anneau PIO a la plus
+// haute porteuse
+const uint32_t STALL_US   = 5000;
+
+// 100 kHz : sous le seuil du plan par defaut, au-dessus du plan LOW
+const uint32_t STORM_RATES[] = { 100000, 1000000, 5000000, 20000000 };
+const uint32_t STORM_RATE_COUNT = sizeof(STORM_RATES) / sizeof(STORM_RATES[0]);
+
+struct Collect {
+    std::vector<FencerEvent> events;
+    bool push(const FencerEvent& ev) {
+        events.push_back(ev);
+        return true;
+    }
+};
+
+// Compte les fronts rendus par appel, quel que soit le chronometre ;
+// maxRateHz : fronts d'un appel rapportes a max(intervalle depuis l'appel
+// precedent, fenetre du limiteur)
+template <typename Timer>
+struct Counted {
+    Timer&   timer;
+    uint32_t maxPerCall = 0;
+    uint32_t maxRateHz  = 0;
+    uint64_t lastUs     = 0;
+
+    uint32_t tickHz() const { return timer.tickHz(); }
+
+    template <typename Sink>
+    uint32_t pollEdges(Sink& sink, uint64_t nowUs) {
+        uint32_t n = timer.pollEdges(sink, nowUs);
+        uint64_t spanUs = std::max<uint64_t>(nowUs - lastUs, GOVERNOR_WINDOW_US);
+        lastUs     = nowUs;
+        maxPerCall = std::max(maxPerCall, n);
+        maxRateHz  = std::max(maxRateHz, (uint32_t)((uint64_t)n * 1000000u / spanUs));
+        return n;
+    }
+};
+
+// Fronts a debit constant, phase continue d'un appel a l'autre
+struct Source {
+    FakeEdgeTimer& timer;
+    double         nextNs = 0;
+
+    void run(uint64_t untilNs, uint32_t rateHz) {
+        if (rateHz == 0) {
+            nextNs = (double)untilNs;
+            return;
+        }
+        double period = 1e9 / rateHz;
+        while (nextNs + period <= (double)untilNs) {
+            nextNs += period;
+            timer.addPeriod((uint32_t)(period + 0.5));
+        }
+    }
+};
+
+struct Result {
+    const char*           name;
+    std::vector<uint32_t> callNs;
+    uint32_t maxPerCall = 0;
+    uint32_t maxRateHz  = 0;
+    int      right = 0, wrong = 0, none = 0;
+
+    void report() {
+        std::sort(callNs.begin(), callNs.end());
+        uint32_t p99 = callNs.empty() ? 0 : callNs[callNs.size() * 99 / 100];
+        uint32_t mx  = callNs.empty() ? 0 : callNs.back();
+        std::printf("  %-10s DECISION juste %3d | fausse %3d | aucune %3d | "
+                    "fronts/appel max %4u | appel p99 %6.1f µs | max %7.1f µs\n",
+                    name, right, wrong, none, maxPerCall, p99 / 1000.0, mx / 1000.0);
+    }
+};
+
+// Un scenario complet ; Reader : FakeEdgeTimer ou EdgeGovernor<FakeEdgeTimer>
+template <typename Reader>
+void runScenario(int cycles, FakeEdgeTimer& timer, Reader& reader, Result& r) {
+    TouchDetector      detector(timer.tickHz(), 0);
+    Counted<Reader>    counted = { reader };
+    Source             src = { timer };
+    Collect            sink;
+    uint64_t           tUs = 0;
+
+    auto phase = [&](uint32_t ms, bool pressed, uint32_t rateHz, uint32_t stallUs = 0) {
+        uint64_t end = tUs + (uint64_t)ms * 1000u;
+        uint64_t stallAt = tUs + (uint64_t)ms * 500u;
+        while (tUs < end) {
+            tUs += LOOP_US;
+            if (stallUs && tUs >= stallAt) {
+                tUs += stallUs;
+                stallUs = 0;
+            }
+            src.run(tUs * 1000u, rateHz);
+            auto t0 = std::chrono::steady_clock::now();
+            detector.stepFiltered(tUs, pressed, tUs, counted, sink);
+            auto t1 = std::chrono::steady_clock::now();
+            r.callNs.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+    };
+    auto judge = [&](FreqClass truth) {
+        const FencerEvent* decision = nullptr;
+        for (const FencerEvent& ev : sink.events)
+            if (ev.type == FencerEventType::DECISION) decision = &ev;
+        if (!decision)                   r.none++;
+        else if (decision->cls == truth) r.right++;
+        else                             r.wrong++;
+        sink.events.clear();
+    };
+
+    for (int c = 0; c < cycles; c++) {
+        const CarrierBand& band = FREQ_PLAN[c % FREQ_PLAN_SIZE];
+        uint32_t storm = STORM_RATES[c % STORM_RATE_COUNT];
+
+        phase(IDLE_MS, false, 0);
+        phase(CARRIER_MS, true, band.centerHz);
+        phase(1, false, 0);
+        judge(band.cls);
+
+        phase(IDLE_MS, false, 0);
+        phase(STORM_MS, true, storm);
+        phase(CARRIER_MS, true, band.centerHz);
+        phase(1, false, 0);
+        judge(band.cls);
+
+        phase(IDLE_MS, false, 0);
+        phase(CARRIER_MS, true, band.centerHz, STALL_US);
+        phase(1, false, 0);
+        judge(band.cls);
+    }
+    r.maxPerCall = counted.maxPerCall;
+    r.maxRateHz  = counted.maxRateHz;
+}
+
+}  // namespace
+
+int stressEdges(int argc, char** argv) {
+    int cycles = argc >= 1 ? std::atoi(argv[0]) : 24;
+    if (cycles <= 0) cycles = 24;
+
+    std::printf("Tempetes de fronts sur GP2 | %d cycles | boucle %u µs | plan :", cycles, LOOP_US);
+    for (const CarrierBand& b : FREQ_PLAN)
+        std::printf(" %u", b.centerHz);
+    std::printf(" Hz\n  parasites :");
+    for (uint32_t rate : STORM_RATES)
+        std::printf(" %u", rate);
+    std::printf(" Hz | seuil de tempete %u Hz | loop1 bloque %u µs\n\n", GOVERNOR_STORM_HZ,
+                STALL_US);
+
+    // --- Lecture directe ------------------------------------------------------
+    Result direct = { "direct", {} };
+    {
+        FakeEdgeTimer timer;
+        runScenario(cycles, timer, timer, direct);
+    }
+
+    // --- A travers le limiteur ------------------------------------------------
+    Result governed = { "limiteur", {} };
+    FakeEdgeTimer timer;
+    EdgeGovernor<FakeEdgeTimer> governor(timer);
+    TraceBuffer<256> trace(TraceSource::CORE1);
+    governor.setTrace(&trace);
+    runScenario(cycles, timer, governor, governed);
+
+    direct.report();
+    governed.report();
+
+    uint32_t expectedStorms = 0;
+    for (int c = 0; c < cycles; c++)
+        if (STORM_RATES[c % STORM_RATE_COUNT] > GOVERNOR_STORM_HZ) expectedStorms++;
+
+    const GovernorStats& s = governor.stats();
+    std::printf("\n  limiteur : budget %u fronts / %u µs | tempetes %u (attendu %u) | "
+                "depassements d'anneau %u\n",
+                governor.budget(), GOVERNOR_WINDOW_US, s.storms, expectedStorms, s.overruns);
+    std::printf("             fronts transmis %u | jetes %u | debit max %u Hz | charge max %u ‰ | "
+                "anomalie de trace %s\n",
+                s.delivered, s.dropped, s.peakHz, s.loadPermille,
+                trace.anomaly() == TraceAnomaly::EDGE_STORM ? "EDGE_STORM" : "-");
+
+    bool ok = governed.maxRateHz <= GOVERNOR_STORM_HZ && s.loadPermille <= 1000 &&
+              s.storms == expectedStorms && governed.wrong == 0 && governed.none == 0 &&
+              !governor.storm() &&
+              (expectedStorms == 0 || trace.anomaly() == TraceAnomaly::EDGE_STORM);
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
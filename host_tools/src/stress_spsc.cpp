@@ -0,0 +1,152 @@
+// =============================================================================
+// stress_spsc.cpp — SpscQueue exercee par deux threads (coeur 1 / coeur 0)
+// =============================================================================
+//
+// 1. Sans perte : le producteur reessaie tant que la file est pleine, le
+//    consommateur verifie l'ordre et le contenu de chaque evenement
+//    (freqHz et value derives du numero : une case lue a moitie ecrite
+//    serait detectee). Plusieurs tailles de file, dont N = 2.
+//
+// 2. Comme le firmware : le producteur ne reessaie jamais (push() == false
+//    → evenement perdu) ; le nombre de trous vus par le consommateur doit
+//    etre exactement le nombre d'echecs de push().
+//
+// USAGE : program spsc [millions d'evenements par essai, defaut 10]
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <fencer_event.h>
+#include <spsc_queue.h>
+
+using namespace fencing;
+
+namespace {
+
+// Evenement de test : tout est derive du numero 32 bits range dans tUs
+FencerEvent makeEvent(uint32_t n) {
+    FencerEvent ev = {};
+    ev.type   = FencerEventType::TOUCH;
+    ev.seq    = (uint16_t)n;
+    ev.tUs    = n;
+    ev.freqHz = n * 2654435761u;
+    ev.value  = ~n;
+    return ev;
+}
+
+bool intact(const FencerEvent& ev) {
+    uint32_t n = (uint32_t)ev.tUs;
+    return ev.seq == (uint16_t)n && ev.freqHz == n * 2654435761u && ev.value == ~n;
+}
+
+template <uint32_t N>
+bool lossless(uint32_t count) {
+    static SpscQueue<FencerEvent, N> q;
+    uint64_t producerSpins = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (uint32_t n = 0; n < count; n++) {
+            FencerEvent ev = makeEvent(n);
+            while (!q.push(ev)) {
+                producerSpins++;
+                std::this_thread::yield();      // hote mono-coeur
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ok = true;
+    FencerEvent ev;
+    while (expected < count) {
+        if (!q.pop(ev)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (ev.tUs != expected || !intact(ev)) {
+            std::printf("  N=%-5u ERREUR : attendu %u, recu %u (%s)\n", N, expected, (uint32_t)ev.tUs,
+                        intact(ev) ? "ordre" : "contenu");
+            ok = false;
+            break;
+        }
+        expected++;
+    }
+    producer.join();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (ok)
+        std::printf("  N=%-5u %u evenements | %6.1f ns/evt | file pleine %llu fois\n",
+                    N, count, s * 1e9 / count, (unsigned long long)producerSpins);
+    return ok && q.empty();
+}
+
+template <uint32_t N>
+bool lossy(uint32_t count) {
+    static SpscQueue<FencerEvent, N> q;
+    std::atomic<bool> done{false};
+    uint64_t failed = 0;
+
+    std::thread producer([&] {
+        for (uint32_t n = 0; n < count; n++) {
+            if (!q.push(makeEvent(n)))
+                failed++;
+            if ((n & 63) == 0)
+                std::this_thread::yield();      // laisser le consommateur s'intercaler
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t gaps = 0, received = 0;
+    uint32_t expected = 0;
+    bool ok = true;
+    FencerEvent ev;
+    for (;;) {
+        if (!q.pop(ev)) {
+            if (done.load(std::memory_order_acquire) && q.empty()) break;
+            std::this_thread::yield();
+            continue;
+        }
+        if (!intact(ev) || ev.tUs < expected) {
+            ok = false;
+            break;
+        }
+        gaps += (uint32_t)ev.tUs - expected;
+        expected = (uint32_t)ev.tUs + 1;
+        received++;
+    }
+    producer.join();
+    gaps += count - expected;             // pertes apres le dernier recu
+
+    ok = ok && gaps == failed && received + failed == count;
+    std::printf("  N=%-5u recus %llu | perdus %llu | trous vus %llu → %s\n", N,
+                (unsigned long long)received, (unsigned long long)failed,
+                (unsigned long long)gaps, ok ? "OK" : "ECART");
+    return ok;
+}
+
+}  // namespace
+
+int stressSpsc(int argc, char** argv) {
+    uint32_t millions = argc >= 1 ? (uint32_t)std::atoi(argv[0]) : 10;
+    uint32_t count = millions * 1000000u;
+    if (count == 0) count = 1000000u;
+
+    std::printf("SpscQueue<FencerEvent> : %zu octets par evenement, %u threads materiels\n\n",
+                sizeof(FencerEvent), std::thread::hardware_concurrency());
+
+    std::printf("Sans perte (le producteur attend)\n");
+    bool ok = lossless<2>(count / 10);
+    ok = lossless<32>(count) && ok;
+    ok = lossless<1024>(count) && ok;
+
+    std::printf("\nAvec perte (comme le coeur 1 : jamais d'attente)\n");
+    ok = lossy<2>(count / 10) && ok;
+    ok = lossy<32>(count) && ok;
+
+    std::printf("\n%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+// =============================================================================
+// sweep_rank.cpp — Exploitation du balayage des porteuses (Phase 1.7bis)
+// =============================================================================
+//
+// sweeprank [fichier]  lit le log du recepteur (fichier ou entree standard ;
+//   les lignes qui ne sont pas du CSV de balayage sont ignorees, on peut
+//   donc passer la sortie brute du moniteur serie). Pour chaque frequence
+//   emise : plage mesuree [min, max] sur tous les balayages, pire perte.
+//   Puis, pour chaque triplet NEUTRE < VALID_A < VALID_B :
+//
+//     ecart = plus grand ecart observe a la frequence emise (sur les 3)
+//     marge = min(VALID_A - NEUTRE, VALID_B - VALID_A) - 2 * ecart
+//
+//   marge = zone morte entre deux bandes si TOLERANCE = ecart. Les plans sont
+//   classes par marge decroissante ; TOLERANCE suggeree = ecart + marge / 4.
+//   Les frequences dont la perte depasse MAX_LOSS_PERMILLE sont ecartees.
+//
+// sweepsim [R_ohm] [liste]  rejoue un balayage complet sur hote : sequence
+//   du generateur (SweepSchedule), fil de fleuret modelise par un passe-bas
+//   R / 10 nF (fronts perdus quand l'amplitude chute, gigue croissante),
+//   decoupage recepteur (SweepTracker + FakeEdgeTimer). Sortie au format du
+//   recepteur : `sweepsim | sweeprank` verifie toute la chaine.
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <pio_edge_timer.h>
+#include <sweep.h>
+
+using namespace fencing;
+
+namespace {
+
+const int32_t  MAX_LOSS_PERMILLE = 50;
+const size_t   TOP_PLANS         = 10;
+const uint32_t WINDOW_MS         = 50;      // MEASURE_PERIOD du recepteur
+
+struct Carrier {
+    uint32_t freqHz;
+    uint32_t loHz;
+    uint32_t hiHz;
+    int32_t  worstLoss;     // pour mille, valeur absolue
+    uint32_t jitterNs;
+    int      steps;
+};
+
+struct Plan {
+    uint32_t freq[3];
+    uint32_t spreadHz;      // ecart
+    int32_t  marginHz;
+    int32_t  worstLoss;
+};
+
+void merge(std::vector<Carrier>& carriers, const SweepStepResult& r) {
+    if (r.emittedHz == 0 || r.windows == 0)
+        return;
+    int32_t loss = r.lossPermille < 0 ? -r.lossPermille : r.lossPermille;
+    for (Carrier& c : carriers) {
+        if (c.freqHz != r.emittedHz) continue;
+        c.loHz      = std::min(c.loHz, r.minHz);
+        c.hiHz      = std::max(c.hiHz, r.maxHz);
+        c.worstLoss = std::max(c.worstLoss, loss);
+        c.jitterNs  = std::max(c.jitterNs, r.jitterNs);
+        c.steps++;
+        return;
+    }
+    carriers.push_back({ r.emittedHz, r.minHz, r.maxHz, loss, r.jitterNs, 1 });
+}
+
+uint32_t spreadOf(const Carrier& c) {
+    uint32_t below = c.freqHz > c.loHz ? c.freqHz - c.loHz : 0;
+    uint32_t above = c.hiHz > c.freqHz ? c.hiHz - c.freqHz : 0;
+    return std::max(below, above);
+}
+
+}  // namespace
+
+int sweepRank(int argc, char** argv) {
+    FILE* in = stdin;
+    if (argc >= 1) {
+        in = std::fopen(argv[0], "r");
+        if (!in) {
+            std::printf("impossible d'ouvrir %s\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Carrier> carriers;
+    char line[256];
+    int rows = 0;
+    while (std::fgets(line, sizeof line, in)) {
+        SweepStepResult r;
+        if (!parseSweepCsv(line, r)) continue;
+        merge(carriers, r);
+        rows++;
+    }
+    if (in != stdin)
+        std::fclose(in);
+
+    std::sort(carriers.begin(), carriers.end(),
+              [](const Carrier& a, const Carrier& b) { return a.freqHz < b.freqHz; });
+
+    std::printf("%d pas lus, %zu frequences\n\n", rows, carriers.size());
+    std::printf("  %7s %7s %7s %6s %8s %5s\n", "emis", "min", "max", "perte", "gigue", "pas");
+    std::vector<Carrier> usable;
+    for (const Carrier& c : carriers) {
+        bool ok = c.worstLoss <= MAX_LOSS_PERMILLE;
+        std::printf("  %7u %7u %7u %5d‰ %6u ns %5d%s\n", c.freqHz, c.loHz, c.hiHz,
+                    c.worstLoss, c.jitterNs, c.steps, ok ? "" : "  ecartee");
+        if (ok) usable.push_back(c);
+    }
+
+    std::vector<Plan> plans;
+    for (size_t i = 0; i < usable.size(); i++)
+        for (size_t j = i + 1; j < usable.size(); j++)
+            for (size_t k = j + 1; k < usable.size(); k++) {
+                const Carrier* c[3] = { &usable[i], &usable[j], &usable[k] };
+                Plan p = {};
+                for (int n = 0; n < 3; n++) {
+                    p.freq[n]   = c[n]->freqHz;
+                    p.spreadHz  = std::max(p.spreadHz, spreadOf(*c[n]));
+                    p.worstLoss = std::max(p.worstLoss, c[n]->worstLoss);
+                }
+                int32_t gap = (int32_t)std::min(p.freq[1] - p.freq[0], p.freq[2] - p.freq[1]);
+                p.marginHz = gap - 2 * (int32_t)p.spreadHz;
+                plans.push_back(p);
+            }
+
+    std::sort(plans.begin(), plans.end(), [](const Plan& a, const Plan& b) {
+        if (a.marginHz != b.marginHz) return a.marginHz > b.marginHz;
+        return a.worstLoss < b.worstLoss;
+    });
+
+    if (plans.empty() || plans[0].marginHz <= 0) {
+        std::printf("\nAucun plan a 3 porteuses separables\n");
+        return 1;
+    }
+
+    std::printf("\n  %-6s %-6s %-6s %-6s %7s %7s %9s\n",
+                "rang", "NEUTRE", "VAL_A", "VAL_B", "marge", "ecart", "TOLERANCE");
+    for (size_t n = 0; n < plans.size() && n < TOP_PLANS; n++) {
+        const Plan& p = plans[n];
+        if (p.marginHz <= 0) break;
+        std::printf("  %-6zu %-6u %-6u %-6u %7d %7u %9u\n", n + 1,
+                    p.freq[0], p.freq[1], p.freq[2], p.marginHz, p.spreadHz,
+                    p.spreadHz + (uint32_t)p.marginHz / 4);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Simulation d'un balayage complet
+// -----------------------------------------------------------------------------
+int sweepSim(int argc, char** argv) {
+    const double CABLE_F   = 10e-9;      // fil interne du fleuret
+    const double THRESHOLD = 0.5;        // amplitude relative du seuil GPIO
+    const double SPURIOUS  = 0.002;      // fronts parasites par front
+
+    double rOhm = argc >= 1 ? std::atof(argv[0]) : 4700.0;
+    SweepList list = defaultSweepList();
+    if (argc >= 2 && !parseSweepList(argv[1], list)) {
+        std::printf("liste invalide : %s\n", argv[1]);
+        return 1;
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    SweepSchedule schedule;
+    FakeEdgeTimer timer(1000000000u);
+    SweepTracker  tracker(timer.tickHz());
+    tracker.setList(list);
+
+    std::printf("%s\n", SWEEP_CSV_HEADER);
+    char row[128];
+
+    schedule.start(list, 0);
+    double   nextEdgeNs = 0;
+    double   lastEdgeNs = 0;
+    uint32_t count      = 0;
+    uint32_t ms         = 0;
+    bool     wasOn      = false;
+
+    // Jusqu'a la fin de la sequence, plus une fenetre de silence pour clore
+    while (schedule.running() || ms % WINDOW_MS != 0 || tracker.inStep()) {
+        schedule.update(ms);
+        bool on = schedule.phase() == SweepSchedule::Phase::STEP;
+        double endNs = (ms + 1) * 1e6;
+
+        if (on) {
+            double f = schedule.freqHz();
+            double periodNs = 1e9 / f;
+            double amp = 1.0 / std::sqrt(1.0 + std::pow(2 * M_PI * f * rOhm * CABLE_F, 2));
+            double pLoss = 1.0 / (1.0 + std::exp((amp - THRESHOLD) / 0.02));
+            double jitter = 0.002 / amp;                 // bruit rapporte a la pente
+            if (!wasOn)
+                nextEdgeNs = ms * 1e6 + uni(rng) * periodNs;
+            for (; nextEdgeNs < endNs; nextEdgeNs += periodNs) {
+                double t = nextEdgeNs + gauss(rng) * periodNs * jitter;
+                if (uni(rng) < pLoss) continue;
+                if (uni(rng) < SPURIOUS) {
+                    double s = t - uni(rng) * periodNs * 0.5;
+                    timer.addPeriod((uint32_t)(s - lastEdgeNs));
+                    lastEdgeNs = s;
+                    count++;
+                }
+                timer.addPeriod((uint32_t)(t - lastEdgeNs));
+                lastEdgeNs = t;
+                count++;
+            }
+        }
+        wasOn = on;
+        timer.poll(tracker.periods());
+
+        ms++;
+        if (ms % WINDOW_MS != 0) continue;
+        SweepTracker::Event ev = tracker.pushWindow(count, WINDOW_MS);
+        count = 0;
+        if (ev == SweepTracker::Event::STEP_BEGIN) {
+            timer.flush();
+        } else if (ev == SweepTracker::Event::STEP_END) {
+            formatSweepCsv(tracker.result(), row, sizeof row);
+            std::printf("%s\n", row);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// =============================================================================
+// adc_capture.cpp — Backend RP2040 de l'acquisition ADC (free-running + DMA)
+// =============================================================================
+
+#include "adc_capture.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+
+namespace fencing {
+
+// Aligne sur sa taille en octets : le DMA reboucle sur les RING_BITS + 1
+// bits de poids faible de l'adresse d'ecriture.
+uint16_t DmaAdcCapture::ring_[DmaAdcCapture::RING_SIZE]
+    __attribute__((aligned(DmaAdcCapture::RING_SIZE * sizeof(uint16_t))));
+
+static const uint32_t ADC_CLOCK_HZ        = 48000000;
+static const uint32_t ADC_CYCLES_PER_CONV = 96;
+
+bool DmaAdcCapture::begin(uint8_t pin, uint32_t sampleHz) {
+    if (pin < 26 || pin > 29 || sampleHz == 0)
+        return false;
+    dma_ = dma_claim_unused_channel(false);
+    if (dma_ < 0)
+        return false;
+
+    adc_init();
+    adc_gpio_init(pin);
+    adc_select_input(pin - 26);
+    // FIFO + DREQ, une conversion suffit a reveiller le DMA, bit d'erreur
+    // garde (bit 15), pas de reduction a 8 bits
+    adc_fifo_setup(true, true, 1, true, false);
+
+    // Periode = 1 + div cycles de 48 MHz ; div = 0 : dos a dos (96 cycles)
+    uint64_t div256 = 0;
+    if (sampleHz < ADC_CLOCK_HZ / ADC_CYCLES_PER_CONV) {
+        div256 = ((uint64_t)ADC_CLOCK_HZ * 256u + sampleHz / 2) / sampleHz - 256u;
+        if (div256 > 0xFFFFFF) div256 = 0xFFFFFF;
+        sampleHz_ = (uint32_t)((uint64_t)ADC_CLOCK_HZ * 256u / (div256 + 256u));
+    } else {
+        sampleHz_ = ADC_CLOCK_HZ / ADC_CYCLES_PER_CONV;
+    }
+    adc_set_clkdiv((float)div256 / 256.0f);
+
+    // DMA : FIFO ADC → buffer circulaire, sans fin pratique (2^32 transferts)
+    dma_channel_config dc = dma_channel_get_default_config(dma_);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_16);
+    channel_config_set_read_increment(&dc, false);
+    channel_config_set_write_increment(&dc, true);
+    channel_config_set_ring(&dc, true, RING_BITS + 1);
+    channel_config_set_dreq(&dc, DREQ_ADC);
+    dma_channel_configure(dma_, &dc, ring_, &adc_hw->fifo, 0xFFFFFFFFu, true);
+
+    tail_ = 0;
+    adc_fifo_drain();
+    adc_run(true);
+    return true;
+}
+
+void DmaAdcCapture::end() {
+    if (dma_ < 0)
+        return;
+    adc_run(false);
+    dma_channel_abort(dma_);
+    dma_channel_unclaim(dma_);
+    adc_fifo_drain();
+    dma_ = -1;
+}
+
+uint32_t DmaAdcCapture::headIndex() const {
+    uintptr_t w = (uintptr_t)dma_channel_hw_addr(dma_)->write_addr;
+    return (uint32_t)((w - (uintptr_t)ring_) / sizeof(uint16_t)) & (RING_SIZE - 1);
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,132 @@
+// =============================================================================
+// adc_capture.h — Acquisition continue de l'ADC sur GP26 (DMA)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   L'ADC du RP2040 tourne seul (mode free-running) a sampleHz, chaque
+//   conversion part dans sa FIFO et un canal DMA la recopie dans un buffer
+//   circulaire en RAM, comme PioEdgeTimer. Le CPU ne fait rien par
+//   echantillon pendant l'acquisition : il lit les blocs quand il veut
+//   (poll) et les passe a AmplitudeMeter.
+//
+// CADENCE :
+//   Horloge ADC 48 MHz, 96 cycles par conversion : 500 kech/s au plus.
+//   En dessous, diviseur 16.8 (periode = 1 + div cycles) ; sampleHz() rend
+//   la cadence reellement obtenue.
+//
+// BUFFER :
+//   RING_SIZE echantillons 16 bits (12 bits utiles, bit 15 = erreur de
+//   conversion), aligne sur sa taille (mode "ring" du DMA). A 500 kech/s
+//   l'anneau couvre 4 ms ; poll() a chaque tour de loop1 suffit largement.
+//
+// CABLAGE :
+//   GP26 relie a GP2 (ligne B), comme sur les recepteurs Phase 0.3 / 0.4.
+//   L'ADC ne charge pas la ligne (entree haute impedance, ~1 pF).
+//
+// DOUBLURE HOTE :
+//   FakeAdcCapture recoit des echantillons d'une trace synthetique
+//   (addSample, 12 bits) et les restitue par le meme poll().
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+// -----------------------------------------------------------------------------
+// Backend RP2040 : ADC free-running + DMA
+// -----------------------------------------------------------------------------
+class DmaAdcCapture {
+public:
+    static const uint32_t RING_BITS = 11;                 // 2048 echantillons
+    static const uint32_t RING_SIZE = 1u << RING_BITS;
+
+    // pin : 26..29 (entrees ADC 0..3). Reserve un canal DMA, demarre l'ADC.
+    bool begin(uint8_t pin, uint32_t sampleHz);
+    void end();
+
+    // Cadence reellement obtenue
+    uint32_t sampleHz() const { return sampleHz_; }
+
+    // Transfere les echantillons recus depuis le dernier appel par blocs
+    // contigus : sink.pushSamples(ptr, n), deux appels au plus (retour au
+    // debut de l'anneau). Retourne le nombre d'echantillons transferes.
+    template <typename Sink>
+    uint32_t poll(Sink& sink) {
+        uint32_t head = headIndex();
+        uint32_t n    = (head - tail_) & (RING_SIZE - 1);
+        if (head < tail_) {
+            sink.pushSamples(&ring_[tail_], RING_SIZE - tail_);
+            tail_ = 0;
+        }
+        if (head > tail_)
+            sink.pushSamples(&ring_[tail_], head - tail_);
+        tail_ = head;
+        return n;
+    }
+
+    // Ignore les echantillons en attente
+    void flush() { tail_ = headIndex(); }
+
+private:
+    uint32_t headIndex() const;
+
+    static uint16_t ring_[RING_SIZE];
+
+    uint32_t tail_     = 0;
+    uint32_t sampleHz_ = 0;
+    int      dma_      = -1;
+};
+
+// -----------------------------------------------------------------------------
+// Doublure hote : echantillons injectes a la main
+// -----------------------------------------------------------------------------
+class FakeAdcCapture {
+public:
+    static const uint32_t RING_SIZE = DmaAdcCapture::RING_SIZE;
+
+    bool begin(uint8_t, uint32_t sampleHz) {
+        sampleHz_ = sampleHz;
+        return true;
+    }
+    void end() {}
+
+    uint32_t sampleHz() const { return sampleHz_; }
+
+    // Conversion 12 bits
+    void addSample(uint16_t counts) {
+        ring_[head_] = counts;
+        head_ = (head_ + 1) & (RING_SIZE - 1);
+    }
+
+    template <typename Sink>
+    uint32_t poll(Sink& sink) {
+        uint32_t n = (head_ - tail_) & (RING_SIZE - 1);
+        if (head_ < tail_) {
+            sink.pushSamples(&ring_[tail_], RING_SIZE - tail_);
+            tail_ = 0;
+        }
+        if (head_ > tail_)
+            sink.pushSamples(&ring_[tail_], head_ - tail_);
+        tail_ = head_;
+        return n;
+    }
+
+    void flush() { tail_ = head_; }
+
+private:
+    uint32_t sampleHz_ = 0;
+    uint16_t ring_[RING_SIZE] = {};
+    uint32_t head_ = 0;
+    uint32_t tail_ = 0;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef DmaAdcCapture AdcCapture;
+#else
+typedef FakeAdcCapture AdcCapture;
+#endif
+
+}  // namespace fencing
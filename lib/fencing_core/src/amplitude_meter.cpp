@@ -0,0 +1,107 @@
+// =============================================================================
+// amplitude_meter.cpp — Statistiques par fenetre et note de contact
+// =============================================================================
+
+#include "amplitude_meter.h"
+
+namespace fencing {
+
+namespace {
+
+uint16_t toMv(uint32_t counts) {
+    return (uint16_t)((counts * ADC_FULL_SCALE_MV + ADC_MAX_COUNT / 2) / ADC_MAX_COUNT);
+}
+
+// 0 a `lo`, 1000 a `hi`, lineaire entre les deux
+uint32_t ramp(int32_t v, int32_t lo, int32_t hi) {
+    if (v <= lo) return 0;
+    if (v >= hi) return 1000;
+    return (uint32_t)((v - lo) * 1000 / (hi - lo));
+}
+
+}  // namespace
+
+uint32_t isqrt64(uint64_t v) {
+    uint64_t r   = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r  = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+uint16_t contactQuality(const AmplitudeStats& a) {
+    if (a.samples == 0 || a.p2pMv == 0)
+        return 0;
+    int32_t high   = (int32_t)a.maxMv - QUALITY_VIH_MV;
+    int32_t low    = (int32_t)QUALITY_VIL_MV - a.minMv;
+    int32_t margin = high < low ? high : low;
+    int32_t shape  = (int32_t)((2u * a.rmsMv * 1000u) / a.p2pMv);
+    return (uint16_t)(ramp(margin, 0, QUALITY_MARGIN_MV)
+                    * ramp(shape, QUALITY_SHAPE_MIN, QUALITY_SHAPE_FULL) / 1000);
+}
+
+AmplitudeMeter::AmplitudeMeter(uint32_t sampleHz, uint32_t windowUs) {
+    uint64_t n = (uint64_t)sampleHz * windowUs / 1000000u;
+    windowSamples_ = n < 2 ? 2 : n > 0xFFFF ? 0xFFFF : (uint32_t)n;
+}
+
+void AmplitudeMeter::reset() {
+    count_ = 0;
+    min_   = 0xFFFF;
+    max_   = 0;
+    sum_   = 0;
+    sumSq_ = 0;
+    fresh_ = false;
+}
+
+void AmplitudeMeter::pushSamples(const uint16_t* s, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t v = s[i] & ADC_MAX_COUNT;    // bit 15 : erreur de conversion
+        if (v < min_) min_ = v;
+        if (v > max_) max_ = v;
+        sum_   += v;
+        sumSq_ += (uint32_t)v * v;
+        if (++count_ == windowSamples_)
+            close();
+    }
+}
+
+void AmplitudeMeter::close() {
+    uint32_t n    = count_;
+    uint32_t mean = (sum_ + n / 2) / n;
+    // n · Σx² - (Σx)² = n² · variance, toujours >= 0
+    uint64_t var  = (sumSq_ * n - (uint64_t)sum_ * sum_) / ((uint64_t)n * n);
+
+    last_.minMv   = toMv(min_);
+    last_.maxMv   = toMv(max_);
+    last_.p2pMv   = toMv(max_ - min_);
+    last_.meanMv  = toMv(mean);
+    last_.rmsMv   = toMv(isqrt64(var));
+    last_.samples = (uint16_t)n;
+    windows_++;
+    fresh_ = true;
+
+    count_ = 0;
+    min_   = 0xFFFF;
+    max_   = 0;
+    sum_   = 0;
+    sumSq_ = 0;
+}
+
+bool AmplitudeMeter::takeWindow(AmplitudeStats& out) {
+    if (!fresh_)
+        return false;
+    out    = last_;
+    fresh_ = false;
+    return true;
+}
+
+}  // namespace fencing
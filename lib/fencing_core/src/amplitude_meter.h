@@ -0,0 +1,113 @@
+// =============================================================================
+// amplitude_meter.h — Amplitude de GP2 par fenetre (crete a crete, RMS)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le comptage de fronts ne voit que le niveau logique de GP2 : une fuite
+//   capacitive (couplage B↔C, Phase 1.5) qui fait juste basculer le trigger
+//   de Schmitt compte comme un vrai contact. La tension, elle, les distingue :
+//   un contact est un chemin resistif (creneau franc, de part et d'autre des
+//   seuils), une fuite passe par une capacite (pointes qui retombent vers
+//   0 V a chaque front). Les recepteurs Phase 0.3 / 0.4 lisaient deja GP26
+//   (analogRead, min / max / moyenne) sans en rien faire.
+//
+// PRINCIPE :
+//   Echantillons 12 bits de l'ADC (AdcCapture, DMA) regroupes en fenetres de
+//   windowSamples() : min, max, somme, somme des carres. A la fermeture :
+//   crete a crete, moyenne et RMS de la composante alternative, en mV
+//   (3.3 V pleine echelle). Par echantillon : deux comparaisons, une
+//   addition, une multiplication 32 bits, une addition 64 bits.
+//
+//   Fenetre : deux periodes de la plus basse porteuse du plan
+//     plan par defaut : 100 µs (50 echantillons a 500 kech/s)
+//     plan LOW        :   2 ms (160 echantillons a 80 kech/s)
+//
+// QUALITE DU CONTACT (contactQuality, pour mille) :
+//   produit de deux notes, chacune 0..1000
+//     - marge : de combien le signal depasse VIH en haut et passe sous VIL en
+//       bas (la plus petite des deux) ; pleine a QUALITY_MARGIN_MV
+//     - forme : 2 · RMS / crete a crete, 1.0 pour un creneau a 50 %, ~0.3
+//       pour des pointes exponentielles ; nulle sous QUALITY_SHAPE_MIN,
+//       pleine a partir de QUALITY_SHAPE_FULL
+//   TouchDetector::setContactQuality la fait entrer dans la decision.
+//
+// Calcul entier, sans dependance materielle : verifie sur hote contre un
+// calcul en double et sur la chaine simulee (host_tools adcsim).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "freq_plan.h"
+
+namespace fencing {
+
+const uint32_t ADC_MAX_HZ        = 500000;   // RP2040 : 96 cycles de 48 MHz
+const uint16_t ADC_MAX_COUNT     = 4095;
+const uint16_t ADC_FULL_SCALE_MV = 3300;
+
+// 32 echantillons par periode de la plus haute porteuse, plafonne a l'ADC
+constexpr uint32_t ADC_SAMPLE_HZ = 32u * detail::maxCenterHz() < ADC_MAX_HZ
+                                 ? 32u * detail::maxCenterHz() : ADC_MAX_HZ;
+
+// Deux periodes de la plus basse porteuse
+constexpr uint32_t AMPLITUDE_WINDOW_US = 2000000u / detail::minCenterHz();
+
+// Seuils de GP2 (RP2040, typ. ; ChainParams::vihV / vilV)
+const uint16_t QUALITY_VIH_MV      = 1600;
+const uint16_t QUALITY_VIL_MV      = 1300;
+const uint16_t QUALITY_MARGIN_MV   = 400;    // marge pour une note pleine
+const uint16_t QUALITY_SHAPE_MIN   = 450;    // 2·RMS/cc (pour mille) : note nulle
+const uint16_t QUALITY_SHAPE_FULL  = 650;    //                         note pleine
+
+struct AmplitudeStats {
+    uint16_t minMv;
+    uint16_t maxMv;
+    uint16_t p2pMv;         // crete a crete
+    uint16_t meanMv;
+    uint16_t rmsMv;         // RMS de la composante alternative
+    uint16_t samples;
+};
+
+// Note pour mille : 0 = pas un contact franc, 1000 = creneau net
+uint16_t contactQuality(const AmplitudeStats& a);
+
+// Racine carree entiere (plancher)
+uint32_t isqrt64(uint64_t v);
+
+class AmplitudeMeter {
+public:
+    explicit AmplitudeMeter(uint32_t sampleHz = ADC_SAMPLE_HZ,
+                            uint32_t windowUs = AMPLITUDE_WINDOW_US);
+
+    // Fenetre en cours abandonnee, aucune fenetre disponible
+    void reset();
+
+    // Echantillons 12 bits consecutifs (AdcCapture::poll)
+    void pushSamples(const uint16_t* s, uint32_t n);
+
+    // Derniere fenetre fermee depuis l'appel precedent (false : aucune)
+    bool takeWindow(AmplitudeStats& out);
+
+    const AmplitudeStats& last() const { return last_; }
+    uint32_t windows() const { return windows_; }
+    uint32_t windowSamples() const { return windowSamples_; }
+
+private:
+    void close();
+
+    uint32_t windowSamples_;
+    uint32_t count_ = 0;
+    uint16_t min_   = 0xFFFF;
+    uint16_t max_   = 0;
+    uint32_t sum_   = 0;
+    uint64_t sumSq_ = 0;
+
+    AmplitudeStats last_    = {};
+    uint32_t       windows_ = 0;
+    bool           fresh_   = false;
+};
+
+}  // namespace fencing
@@ -0,0 +1,95 @@
+// =============================================================================
+// band_plan.h — Bandes de classification choisies a l'execution
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   classifyFrequency() (classifier.h) tranche sur FREQ_PLAN, fige a la
+//   compilation : ±2 kHz (±200 Hz en plan LOW) quel que soit le materiel.
+//   Or la frequence vue par la pointe depend du fleuret, du fil de corps et
+//   de la position sur la cuirasse ; la calibration du branchement
+//   (carrier_calibration.h) mesure les vraies bandes du tireur. BandPlan
+//   porte ces bandes jusqu'aux estimateurs (ContactEstimator, DwellTracker,
+//   via TouchDetector::setPlan).
+//
+// Sans plan (pointeur nul), les estimateurs gardent la table compilee.
+// Avec un plan : recherche lineaire sur FREQ_PLAN_SIZE bandes au plus,
+// meme resultat que classifyFrequency() pour defaultBandPlan().
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "classifier.h"
+#include "freq_plan.h"
+
+namespace fencing {
+
+struct BandPlan {
+    uint8_t     count;
+    CarrierBand bands[FREQ_PLAN_SIZE];
+
+    FreqClass classify(uint32_t freqHz) const {
+        if (freqHz < FREQ_MIN_DETECT)
+            return FreqClass::NONE;
+        for (uint8_t i = 0; i < count; i++)
+            if (freqHz >= bands[i].loHz() && freqHz <= bands[i].hiHz())
+                return bands[i].cls;
+        return FreqClass::UNKNOWN;
+    }
+
+    FreqClass classifyPeriod(uint32_t periodTicks, uint32_t tickHz) const {
+        return periodTicks ? classify(tickHz / periodTicks) : FreqClass::NONE;
+    }
+
+    const CarrierBand* band(FreqClass c) const {
+        for (uint8_t i = 0; i < count; i++)
+            if (bands[i].cls == c) return &bands[i];
+        return nullptr;
+    }
+
+    uint32_t minLoHz() const {
+        uint32_t lo = 0xFFFFFFFFu;
+        for (uint8_t i = 0; i < count; i++)
+            if (bands[i].loHz() < lo) lo = bands[i].loHz();
+        return count ? lo : FREQ_MIN_DETECT;
+    }
+};
+
+constexpr BandPlan defaultBandPlan() {
+    BandPlan plan = {};
+    plan.count = FREQ_PLAN_SIZE;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        plan.bands[i] = FREQ_PLAN[i];
+    return plan;
+}
+
+// Demi-largeur minimale d'une bande (pour mille du centre) : l'estimateur
+// divise par la tolerance, et une bande de quelques Hz ne contient de toute
+// facon aucune mesure reelle
+const uint16_t BAND_MIN_TOL_PERMILLE = 5;
+
+// Memes regles que les static_assert de classifier.h : classes connues et
+// distinctes, bandes disjointes, au-dessus de FREQ_MIN_DETECT ; en plus,
+// demi-largeur d'au moins BAND_MIN_TOL_PERMILLE du centre
+inline bool bandPlanValid(const BandPlan& plan) {
+    if (plan.count > FREQ_PLAN_SIZE)
+        return false;
+    for (uint8_t i = 0; i < plan.count; i++) {
+        const CarrierBand& a = plan.bands[i];
+        if (a.cls == FreqClass::NONE || a.cls == FreqClass::UNKNOWN ||
+            a.toleranceHz >= a.centerHz || a.loHz() < FREQ_MIN_DETECT ||
+            a.toleranceHz == 0 ||
+            (uint64_t)a.toleranceHz * 1000u < (uint64_t)a.centerHz * BAND_MIN_TOL_PERMILLE)
+            return false;
+        for (uint8_t j = i + 1; j < plan.count; j++) {
+            const CarrierBand& b = plan.bands[j];
+            if (a.cls == b.cls || !(a.hiHz() < b.loHz() || b.hiHz() < a.loHz()))
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace fencing
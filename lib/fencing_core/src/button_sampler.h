@@ -0,0 +1,124 @@
+// =============================================================================
+// button_sampler.h — Echantillonnage du bouton (GP16) a cadence fixe
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Remplace readButtonDebounced() (deux millis() par tour de boucle, regle
+//   des 5 ms stables) en Mode Simple : une alarme materielle du timer lit
+//   GP16 toutes les DEBOUNCE_SAMPLE_US et alimente un IntegratorDebouncer
+//   (debounce.h). Chaque bascule de l'etat filtre est publiee dans une
+//   petite SpscQueue avec son instant antidate : la boucle ne rate pas un
+//   appui court et le dwell mesure ne contient pas le temps de filtrage.
+//
+// La latence de decision ne depend plus de la duree d'un tour de loop1 :
+// threshold echantillons apres la fin des rebonds, au plus
+// DEBOUNCE_BUDGET_US sur un contact propre.
+//
+// AlarmButtonSampler (RP2040) echantillonne sous interruption ;
+// FakeButtonSampler (hote) garde la meme grille et le meme filtre, et
+// laisse l'appelant jouer l'alarme (dueUs / service, host_tools boutsim).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "debounce.h"
+#include "hal.h"
+#include "spsc_queue.h"
+
+namespace fencing {
+
+struct ButtonEdge {
+    bool     pressed;
+    uint64_t tUs;       // premier echantillon stable (antidate)
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+class AlarmButtonSampler {
+public:
+    // Interruption sur le coeur qui appelle begin() (coeur 1 dans fencer_firmware)
+    bool begin(uint8_t pin, uint32_t sampleUs = DEBOUNCE_SAMPLE_US,
+               uint32_t budgetUs = DEBOUNCE_BUDGET_US);
+    void end();
+
+    // Bascules dans l'ordre ; false si aucune
+    bool pop(ButtonEdge& edge) { return edges_.pop(edge); }
+
+    // Bascules perdues (file pleine : boucle bloquee plus de 8 bascules)
+    uint32_t overflows() const { return overflows_; }
+    // Echeances deja passees quand l'alarme a ete reprogrammee
+    uint32_t lateCount() const { return late_; }
+
+private:
+    static void onAlarm(unsigned int alarmNum);
+    void        service();
+
+    IntegratorDebouncer      filter_;
+    SpscQueue<ButtonEdge, 8> edges_;
+    int                      alarm_    = -1;
+    uint8_t                  pin_      = 0;
+    uint32_t                 sampleUs_ = DEBOUNCE_SAMPLE_US;
+    uint32_t                 tick_     = 0;     // numero d'echantillon
+    uint64_t                 startUs_  = 0;
+    volatile uint32_t        overflows_ = 0;
+    volatile uint32_t        late_      = 0;
+};
+#endif
+
+// -----------------------------------------------------------------------------
+// Doublure hote : l'alarme, c'est l'appelant
+// -----------------------------------------------------------------------------
+class FakeButtonSampler {
+public:
+    bool begin(uint8_t pin, uint32_t sampleUs = DEBOUNCE_SAMPLE_US,
+               uint32_t budgetUs = DEBOUNCE_BUDGET_US) {
+        if (sampleUs == 0)
+            return false;
+        pin_      = pin;
+        sampleUs_ = sampleUs;
+        filter_   = IntegratorDebouncer(debounceThreshold(budgetUs, sampleUs));
+        tick_     = 0;
+        hal::pinInput(pin_, hal::Pull::UP);
+        startUs_  = hal::nowUs() + sampleUs_;
+        return true;
+    }
+    void end() {}
+
+    // Prochaine echeance de l'alarme (horloge de la carte)
+    uint64_t dueUs() const { return startUs_ + (uint64_t)tick_ * sampleUs_; }
+
+    // L'echantillon de l'echeance dueUs() : GP16 tel que hal::pinRead le voit
+    void service() {
+        if (filter_.sample(hal::pinRead(pin_), tick_)) {
+            ButtonEdge edge = { filter_.state(),
+                                startUs_ + (uint64_t)filter_.edgeTime() * sampleUs_ };
+            if (!edges_.push(edge))
+                overflows_++;
+        }
+        tick_++;
+    }
+
+    bool pop(ButtonEdge& edge) { return edges_.pop(edge); }
+
+    uint32_t overflows() const { return overflows_; }
+    uint32_t lateCount() const { return 0; }
+
+private:
+    IntegratorDebouncer      filter_;
+    SpscQueue<ButtonEdge, 8> edges_;
+    uint8_t                  pin_       = 0;
+    uint32_t                 sampleUs_  = DEBOUNCE_SAMPLE_US;
+    uint32_t                 tick_      = 0;
+    uint64_t                 startUs_   = 0;
+    uint32_t                 overflows_ = 0;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef AlarmButtonSampler ButtonSampler;
+#else
+typedef FakeButtonSampler ButtonSampler;
+#endif
+
+}  // namespace fencing
@@ -0,0 +1,82 @@
+// =============================================================================
+// button_sampler_rp2040.cpp — Echantillonnage de GP16 par alarme materielle
+// =============================================================================
+
+#include "button_sampler.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/gpio.h>
+#include <hardware/timer.h>
+
+#include "hal.h"
+
+namespace fencing {
+
+namespace {
+
+// Le callback d'alarme du SDK ne recoit que le numero d'alarme
+AlarmButtonSampler* activeSampler = nullptr;
+
+}  // namespace
+
+bool AlarmButtonSampler::begin(uint8_t pin, uint32_t sampleUs, uint32_t budgetUs) {
+    if (activeSampler || sampleUs == 0)
+        return false;
+    alarm_ = hardware_alarm_claim_unused(false);
+    if (alarm_ < 0)
+        return false;
+
+    pin_      = pin;
+    sampleUs_ = sampleUs;
+    filter_   = IntegratorDebouncer(debounceThreshold(budgetUs, sampleUs));
+    tick_     = 0;
+
+    hal::pinInput(pin_, hal::Pull::UP);
+
+    activeSampler = this;
+    hardware_alarm_set_callback((uint)alarm_, onAlarm);
+
+    startUs_ = time_us_64() + sampleUs_;
+    if (hardware_alarm_set_target((uint)alarm_, from_us_since_boot(startUs_)))
+        service();
+    return true;
+}
+
+void AlarmButtonSampler::end() {
+    if (alarm_ < 0)
+        return;
+    hardware_alarm_cancel((uint)alarm_);
+    hardware_alarm_set_callback((uint)alarm_, nullptr);
+    hardware_alarm_unclaim((uint)alarm_);
+    alarm_ = -1;
+    activeSampler = nullptr;
+}
+
+void AlarmButtonSampler::onAlarm(unsigned int) {
+    if (activeSampler)
+        activeSampler->service();
+}
+
+// Sous interruption : un echantillon par echeance. Les instants sont ceux
+// de la grille (startUs_ + tick * sampleUs_), pas ceux du traitement : la
+// latence d'interruption ne fausse pas l'antidatage.
+void AlarmButtonSampler::service() {
+    for (;;) {
+        if (filter_.sample(gpio_get(pin_), tick_)) {
+            ButtonEdge edge = { filter_.state(),
+                                startUs_ + (uint64_t)filter_.edgeTime() * sampleUs_ };
+            if (!edges_.push(edge))
+                overflows_ = overflows_ + 1;
+        }
+        tick_++;
+        uint64_t due = startUs_ + (uint64_t)tick_ * sampleUs_;
+        if (!hardware_alarm_set_target((uint)alarm_, from_us_since_boot(due)))
+            return;
+        late_ = late_ + 1;
+    }
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
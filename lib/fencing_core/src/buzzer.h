@@ -0,0 +1,84 @@
+// =============================================================================
+// buzzer.h — Buzzer piezo sur un slice PWM
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// PwmBuzzer : signal carre a BUZZER_HZ par hal::pwmStart (un slice PWM, le
+//   CPU ne fait rien pendant le son), coupe par hal::pwmStop. Sur hote, la
+//   HAL simulee garde l'etat (hal::sim::pwmActive).
+//
+// FakeBuzzer : doublure hote qui enregistre chaque mise en marche / arret
+//   avec l'instant fourni par l'appelant (BUZZER_RECORDS derniers).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "hal.h"
+
+namespace fencing {
+
+const uint32_t BUZZER_HZ      = 2700;     // resonance d'un piezo courant
+const uint8_t  BUZZER_RECORDS = 32;       // doublure hote
+
+class PwmBuzzer {
+public:
+    bool begin(uint8_t pin) {
+        pin_ = pin;
+        hal::pwmStop(pin_);
+        return true;
+    }
+
+    void on(uint64_t) {
+        if (!on_) hal::pwmStart(pin_, BUZZER_HZ);
+        on_ = true;
+    }
+    void off(uint64_t) {
+        if (on_) hal::pwmStop(pin_);
+        on_ = false;
+    }
+    bool isOn() const { return on_; }
+
+private:
+    uint8_t pin_ = 0;
+    bool    on_  = false;
+};
+
+struct BuzzerRecord {
+    uint64_t tUs;
+    bool     on;
+};
+
+class FakeBuzzer {
+public:
+    bool begin(uint8_t) { return true; }
+
+    void on(uint64_t nowUs) { set(true, nowUs); }
+    void off(uint64_t nowUs) { set(false, nowUs); }
+    bool isOn() const { return on_; }
+
+    // Changements d'etat depuis begin(), et les BUZZER_RECORDS derniers
+    // (i = 0 : le plus ancien garde)
+    uint32_t changes() const { return count_; }
+    uint32_t kept() const { return count_ < BUZZER_RECORDS ? count_ : BUZZER_RECORDS; }
+    const BuzzerRecord& record(uint32_t i) const {
+        return records_[(count_ - kept() + i) % BUZZER_RECORDS];
+    }
+
+private:
+    void set(bool on, uint64_t nowUs) {
+        if (on == on_) return;
+        on_ = on;
+        BuzzerRecord& r = records_[count_ % BUZZER_RECORDS];
+        r.tUs = nowUs;
+        r.on  = on;
+        count_++;
+    }
+
+    bool         on_    = false;
+    uint32_t     count_ = 0;
+    BuzzerRecord records_[BUZZER_RECORDS];
+};
+
+}  // namespace fencing
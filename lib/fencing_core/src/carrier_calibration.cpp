@@ -0,0 +1,326 @@
+// =============================================================================
+// carrier_calibration.cpp — Derivation des bandes, journal CAL, enregistrement
+// =============================================================================
+
+#include "carrier_calibration.h"
+
+#include <stdio.h>
+
+#include "byte_order.h"
+#include "crc16.h"
+
+namespace fencing {
+
+namespace {
+
+const uint8_t CAL_MAGIC[4] = { 'F', 'C', 'A', 'L' };
+
+const size_t OFF_MAGIC   = 0;
+const size_t OFF_VERSION = 4;
+const size_t OFF_COUNT   = 5;
+const size_t OFF_TAG     = 6;
+const size_t OFF_BANDS   = 8;
+const size_t BAND_SIZE   = 9;
+
+static_assert(OFF_BANDS == CAL_RECORD_HEADER, "en-tete de l'enregistrement");
+
+int planIndex(FreqClass cls) {
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].cls == cls) return i;
+    return -1;
+}
+
+// Tri par insertion : CAL_MAX_SAMPLES valeurs au plus, pas de <algorithm>
+// dans la bibliotheque
+void sortHz(uint32_t* v, uint16_t n) {
+    for (uint16_t i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        uint16_t j = i;
+        for (; j > 0 && v[j - 1] > x; j--) v[j] = v[j - 1];
+        v[j] = x;
+    }
+}
+
+// Bande en cours de construction : coeur mesure [coreLo, coreHi] et bornes
+struct Draft {
+    uint8_t  index;         // dans FREQ_PLAN
+    bool     calibrated;
+    uint32_t coreLo, coreHi;
+    uint32_t lo, hi;
+};
+
+}  // namespace
+
+const char* calStatusText(CalStatus s) {
+    switch (s) {
+        case CalStatus::OK:        return "OK";
+        case CalStatus::TOO_FEW:   return "TROP PEU D'APPUIS";
+        case CalStatus::UNSTABLE:  return "INSTABLE";
+        case CalStatus::OVERLAP:   return "PORTEUSES CONFONDUES";
+        case CalStatus::BELOW_MIN: return "SOUS LE SEUIL";
+        case CalStatus::EMPTY:     return "VIDE";
+    }
+    return "?";
+}
+
+// -----------------------------------------------------------------------------
+// CalibrationSet
+// -----------------------------------------------------------------------------
+
+void CalibrationSet::clear() {
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+        carriers_[i].n         = 0;
+        carriers_[i].presses   = 0;
+        carriers_[i].lastPress = 0;
+    }
+}
+
+bool CalibrationSet::add(FreqClass cls, uint32_t press, uint32_t freqHz) {
+    int i = planIndex(cls);
+    if (i < 0 || freqHz == 0)
+        return false;
+    Carrier& c = carriers_[i];
+    if (c.n >= CAL_MAX_SAMPLES)
+        return false;
+    if (c.n == 0 || press != c.lastPress) {
+        if (c.presses < 0xFF) c.presses++;
+        c.lastPress = press;
+    }
+    c.hz[c.n++] = freqHz;
+    return true;
+}
+
+uint16_t CalibrationSet::samples(FreqClass cls) const {
+    int i = planIndex(cls);
+    return i < 0 ? 0 : carriers_[i].n;
+}
+
+uint8_t CalibrationSet::presses(FreqClass cls) const {
+    int i = planIndex(cls);
+    return i < 0 ? 0 : carriers_[i].presses;
+}
+
+CalStatus CalibrationSet::derive(BandPlan& out, CalReport* report) const {
+    CalReport local;
+    CalReport& rep = report ? *report : local;
+    rep.status = CalStatus::EMPTY;
+
+    Draft   drafts[FREQ_PLAN_SIZE];
+    uint8_t n = 0;
+    uint8_t calibrated = 0;
+    CalStatus status = CalStatus::OK;
+
+    // --- Coeur de chaque porteuse calibree
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+        const Carrier& c = carriers_[i];
+        CalCarrier& r = rep.carriers[i];
+        r = CalCarrier();
+        r.cls        = FREQ_PLAN[i].cls;
+        r.status     = CalStatus::OK;
+        r.calibrated = c.n > 0;
+        r.samples    = c.n;
+        r.presses    = c.presses;
+        if (!r.calibrated)
+            continue;
+
+        uint32_t sorted[CAL_MAX_SAMPLES];
+        for (uint16_t k = 0; k < c.n; k++) sorted[k] = c.hz[k];
+        sortHz(sorted, c.n);
+        r.medianHz = sorted[c.n / 2];
+
+        // Echantillons proches du median, deja tries
+        uint16_t kept = 0;
+        for (uint16_t k = 0; k < c.n; k++) {
+            uint32_t dev = sorted[k] > r.medianHz ? sorted[k] - r.medianHz : r.medianHz - sorted[k];
+            if ((uint64_t)dev * 1000u <= (uint64_t)r.medianHz * CAL_OUTLIER_PERMILLE)
+                sorted[kept++] = sorted[k];
+        }
+        r.rejected = c.n - kept;
+        uint16_t trim = (uint16_t)((uint32_t)kept * CAL_TRIM_PERMILLE / 1000u);
+        r.loHz = sorted[trim];
+        r.hiHz = sorted[kept - 1 - trim];
+
+        if (c.n < CAL_MIN_SAMPLES || c.presses < CAL_MIN_PRESSES)
+            r.status = CalStatus::TOO_FEW;
+        else if ((uint32_t)r.rejected * 1000u > (uint32_t)c.n * CAL_MAX_REJECT_PERMILLE ||
+                 (uint64_t)(r.hiHz - r.loHz) * 1000u > (uint64_t)r.medianHz * CAL_MAX_SPREAD_PERMILLE)
+            r.status = CalStatus::UNSTABLE;
+        else if (r.loHz < FREQ_MIN_DETECT)
+            r.status = CalStatus::BELOW_MIN;
+        if (r.status != CalStatus::OK) {
+            if (status == CalStatus::OK) status = r.status;
+            continue;
+        }
+
+        uint32_t margin = (r.hiHz - r.loHz) * CAL_MARGIN_PERMILLE / 1000u;
+        uint32_t minTol = r.medianHz * CAL_MIN_TOL_PERMILLE / 1000u;
+        if (margin < minTol) margin = minTol;
+
+        Draft& d = drafts[n++];
+        d.index      = i;
+        d.calibrated = true;
+        d.coreLo     = r.loHz;
+        d.coreHi     = r.hiHz;
+        d.lo         = r.loHz - margin < FREQ_MIN_DETECT ? FREQ_MIN_DETECT : r.loHz - margin;
+        d.hi         = r.hiHz + margin;
+        calibrated++;
+    }
+    if (status != CalStatus::OK) {
+        rep.status = status;
+        return status;
+    }
+    if (calibrated == 0)
+        return CalStatus::EMPTY;
+
+    // --- Porteuses non calibrees : bande compilee, sauf si son centre
+    //     tombe dans une bande mesuree
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+        if (rep.carriers[i].calibrated)
+            continue;
+        uint32_t center = FREQ_PLAN[i].centerHz;
+        bool covered = false;
+        for (uint8_t k = 0; k < calibrated; k++)
+            if (center >= drafts[k].lo && center <= drafts[k].hi) covered = true;
+        if (covered)
+            continue;
+        Draft& d = drafts[n++];
+        d.index      = i;
+        d.calibrated = false;
+        d.coreLo     = center;
+        d.coreHi     = center;
+        d.lo         = FREQ_PLAN[i].loHz();
+        d.hi         = FREQ_PLAN[i].hiHz();
+    }
+
+    // --- Tri par coeur, puis coupe au milieu des ecarts
+    for (uint8_t i = 1; i < n; i++) {
+        Draft x = drafts[i];
+        uint8_t j = i;
+        for (; j > 0 && drafts[j - 1].coreLo > x.coreLo; j--) drafts[j] = drafts[j - 1];
+        drafts[j] = x;
+    }
+    for (uint8_t i = 0; i + 1 < n; i++) {
+        Draft& a = drafts[i];
+        Draft& b = drafts[i + 1];
+        if (a.coreHi >= b.coreLo) {
+            rep.status = CalStatus::OVERLAP;
+            return CalStatus::OVERLAP;
+        }
+        if (a.hi >= b.lo) {
+            uint32_t cut = a.coreHi + (b.coreLo - a.coreHi) / 2;
+            a.hi = cut;
+            b.lo = cut + 1;
+        }
+    }
+
+    BandPlan plan = {};
+    plan.count = n;
+    for (uint8_t i = 0; i < n; i++) {
+        const Draft& d = drafts[i];
+        CarrierBand& band = plan.bands[i];
+        band.cls         = FREQ_PLAN[d.index].cls;
+        band.centerHz    = d.lo + (d.hi - d.lo) / 2;
+        band.toleranceHz = (d.hi - d.lo) / 2;
+        band.label       = FREQ_PLAN[d.index].label;
+    }
+    if (!bandPlanValid(plan)) {
+        rep.status = CalStatus::OVERLAP;
+        return CalStatus::OVERLAP;
+    }
+
+    out = plan;
+    rep.status = CalStatus::OK;
+    return CalStatus::OK;
+}
+
+// -----------------------------------------------------------------------------
+// Journal
+// -----------------------------------------------------------------------------
+
+size_t formatCalibrationLog(FreqClass cls, uint32_t press, uint32_t freqHz, char* buf,
+                            size_t cap) {
+    int n = snprintf(buf, cap, "CAL,%u,%lu,%lu\n", (unsigned)cls, (unsigned long)press,
+                     (unsigned long)freqHz);
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+}
+
+bool parseCalibrationLog(const char* line, FreqClass& cls, uint32_t& press, uint32_t& freqHz) {
+    unsigned c;
+    unsigned long p, f;
+    if (sscanf(line, "CAL,%u,%lu,%lu", &c, &p, &f) != 3)
+        return false;
+    if (c > (unsigned)FreqClass::UNKNOWN || planIndex((FreqClass)c) < 0)
+        return false;
+    cls    = (FreqClass)c;
+    press  = (uint32_t)p;
+    freqHz = (uint32_t)f;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Enregistrement
+// -----------------------------------------------------------------------------
+
+uint16_t freqPlanTag() {
+    uint16_t crc = CRC16_INIT;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++) {
+        uint8_t b[9];
+        b[0] = (uint8_t)FREQ_PLAN[i].cls;
+        put32(b + 1, FREQ_PLAN[i].centerHz);
+        put32(b + 5, FREQ_PLAN[i].toleranceHz);
+        crc = crc16(b, sizeof b, crc);
+    }
+    return crc;
+}
+
+size_t encodeBandPlan(const BandPlan& plan, uint8_t* out, size_t cap) {
+    size_t len = OFF_BANDS + BAND_SIZE * plan.count + 2;
+    if (!bandPlanValid(plan) || cap < len)
+        return 0;
+    for (uint8_t i = 0; i < 4; i++) out[OFF_MAGIC + i] = CAL_MAGIC[i];
+    out[OFF_VERSION] = CAL_RECORD_VERSION;
+    out[OFF_COUNT]   = plan.count;
+    put16(out + OFF_TAG, freqPlanTag());
+    for (uint8_t i = 0; i < plan.count; i++) {
+        uint8_t* p = out + OFF_BANDS + BAND_SIZE * i;
+        p[0] = (uint8_t)plan.bands[i].cls;
+        put32(p + 1, plan.bands[i].centerHz);
+        put32(p + 5, plan.bands[i].toleranceHz);
+    }
+    put16(out + len - 2, crc16(out, len - 2));
+    return len;
+}
+
+bool decodeBandPlan(const uint8_t* in, size_t len, BandPlan& plan) {
+    if (len < OFF_BANDS + 2)
+        return false;
+    for (uint8_t i = 0; i < 4; i++)
+        if (in[OFF_MAGIC + i] != CAL_MAGIC[i]) return false;
+    uint8_t count = in[OFF_COUNT];
+    if (in[OFF_VERSION] != CAL_RECORD_VERSION || count > FREQ_PLAN_SIZE)
+        return false;
+    size_t size = OFF_BANDS + BAND_SIZE * count + 2;
+    if (len < size || get16(in + size - 2) != crc16(in, size - 2))
+        return false;
+    if (get16(in + OFF_TAG) != freqPlanTag())
+        return false;
+
+    BandPlan p = {};
+    p.count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* b = in + OFF_BANDS + BAND_SIZE * i;
+        int k = planIndex((FreqClass)b[0]);
+        if (k < 0)
+            return false;
+        p.bands[i].cls         = FREQ_PLAN[k].cls;
+        p.bands[i].centerHz    = get32(b + 1);
+        p.bands[i].toleranceHz = get32(b + 5);
+        p.bands[i].label       = FREQ_PLAN[k].label;
+    }
+    if (!bandPlanValid(p))
+        return false;
+    plan = p;
+    return true;
+}
+
+}  // namespace fencing
@@ -0,0 +1,294 @@
+// =============================================================================
+// carrier_calibration.h — Calibration des bandes au branchement du tireur
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   La frequence vue par la pointe depend du materiel : 16 ou 20 kHz selon
+//   la pull-down, 5 a 19 kHz selon la position sur la cuirasse, ~1.7 kHz a
+//   travers le fil du fleuret. Les bandes fixes de FREQ_PLAN (±2 kHz,
+//   ±200 Hz en plan LOW) sont trop etroites pour un materiel et se
+//   chevauchent pour un autre.
+//
+// DEROULEMENT (fencer_firmware, au branchement puis sur 'C') :
+//   etape 1 : pointe sur la cuirasse adverse  → porteuse VALID adverse
+//   etape 2 : pointe sur la coque / la piste  → NEUTRE
+//   Au moins CAL_MIN_PRESSES appuis et CAL_MIN_SAMPLES echantillons par
+//   etape, a plusieurs endroits : l'etendue mesuree couvre les positions.
+//   La porteuse du tireur lui-meme ne passe jamais par sa propre pointe :
+//   sa bande reste celle de FREQ_PLAN, rognee si besoin.
+//
+// ECHANTILLONS (CalibrationSampler, coeur 1) : pendant l'appui, les periodes
+//   de GP2 passent par un ContactEstimator aux bornes larges ; une fois un
+//   segment de contact continu etabli, une periode toutes les CAL_SAMPLE_US
+//   (si elle est a ±5 % de la moyenne du segment) devient un evenement
+//   CALIBRATION. Periodes seules et non moyennes : le dwell classe chaque
+//   periode, la bande doit couvrir leur dispersion. La porteuse est figee a
+//   l'appui : changer d'etape pendant un appui ne melange pas les bandes.
+//
+// DERIVATION (CalibrationSet::derive, coeur 0 et hote) :
+//   par porteuse calibree, les echantillons a plus de CAL_OUTLIER_PERMILLE
+//   du median sont ecartes (segments a f / 2, f / 3 quand le fleuret perd
+//   un front sur deux : le detecteur ne les classe pas non plus), puis
+//   percentiles CAL_TRIM_PERMILLE / 1 − trim des autres (coeur de la
+//   distribution), puis une marge :
+//     marge = max(etendue × CAL_MARGIN_PERMILLE, centre × CAL_MIN_TOL_PERMILLE)
+//   Refus : trop peu d'echantillons ou d'appuis (TOO_FEW), plus de
+//   CAL_MAX_REJECT_PERMILLE d'echantillons ecartes ou etendue au-dela de
+//   CAL_MAX_SPREAD_PERMILLE du median (UNSTABLE), coeur sous
+//   FREQ_MIN_DETECT (BELOW_MIN), coeurs de deux porteuses qui se recouvrent
+//   (OVERLAP). Les bandes non calibrees gardent FREQ_PLAN ; une bande par
+//   defaut dont le centre tombe dans une bande calibree est retiree. Deux
+//   bandes voisines qui se recouvrent sont coupees au milieu de l'ecart
+//   entre leurs coeurs.
+//
+// TRACE ENREGISTREE : le firmware ecrit chaque echantillon sur Serial
+//   (formatCalibrationLog) ; host_tools calib <journal> rejoue la meme
+//   derivation sur hote.
+//
+// STOCKAGE : encodeBandPlan() / decodeBandPlan(), petit-boutiste :
+//
+//   off taille champ
+//    0   4     magic      "FCAL"
+//    4   1     version    CAL_RECORD_VERSION
+//    5   1     n          bandes qui suivent (≤ FREQ_PLAN_SIZE)
+//    6   2     plan       empreinte de FREQ_PLAN (calibration d'un autre
+//                         plan compile refusee)
+//    8   9n    bandes     classe (1), centre Hz (4), demi-largeur Hz (4)
+//    8+9n 2    crc        CRC-16/CCITT-FALSE de tout ce qui precede
+//
+//   En flash : EepromPlanStore (emulation EEPROM du core arduino-pico, un
+//   secteur en fin de flash ; commit() suspend l'autre coeur le temps de
+//   l'ecriture). Sur hote : FakePlanStore.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "band_plan.h"
+#include "contact_estimator.h"
+#include "fencer_event.h"
+
+namespace fencing {
+
+const uint16_t CAL_MIN_SAMPLES          = 60;
+const uint8_t  CAL_MIN_PRESSES          = 3;
+const uint16_t CAL_MAX_SAMPLES          = 256;    // par porteuse
+const uint32_t CAL_SAMPLE_US            = 5000;   // un echantillon / 5 ms de contact
+const uint16_t CAL_TRIM_PERMILLE        = 10;     // percentiles 1 % / 99 %
+const uint16_t CAL_MARGIN_PERMILLE      = 250;    // marge = 25 % de l'etendue
+const uint16_t CAL_MIN_TOL_PERMILLE     = 20;     // marge min = 2 % du centre
+const uint16_t CAL_OUTLIER_PERMILLE     = 200;    // ecart au median → ecarte
+const uint16_t CAL_MAX_REJECT_PERMILLE  = 250;    // echantillons ecartes au plus
+const uint16_t CAL_MAX_SPREAD_PERMILLE  = 300;    // etendue max / median
+const uint16_t CAL_SAMPLE_DEV_PERMILLE  = 50;     // periode ↔ moyenne du segment
+const uint8_t  CAL_SEGMENT_PERIODS      = 4;      // contact continu avant le 1er echantillon
+
+const uint8_t  CAL_RECORD_VERSION = 1;
+const size_t   CAL_RECORD_HEADER  = 8;
+const size_t   CAL_RECORD_MAX     = CAL_RECORD_HEADER + 9 * FREQ_PLAN_SIZE + 2;
+
+enum class CalStatus : uint8_t {
+    OK        = 0,
+    TOO_FEW   = 1,    // pas assez d'echantillons ou d'appuis
+    UNSTABLE  = 2,    // etendue trop large pour une bande
+    OVERLAP   = 3,    // deux porteuses indiscernables pour ce materiel
+    BELOW_MIN = 4,    // porteuse sous FREQ_MIN_DETECT
+    EMPTY     = 5,    // aucune porteuse calibree
+};
+
+const char* calStatusText(CalStatus s);
+
+// Bilan d'une porteuse
+struct CalCarrier {
+    FreqClass cls;
+    CalStatus status;
+    bool      calibrated;   // echantillons presents
+    uint16_t  samples;
+    uint16_t  rejected;     // a plus de CAL_OUTLIER_PERMILLE du median
+    uint8_t   presses;
+    uint32_t  loHz;         // percentile bas
+    uint32_t  medianHz;
+    uint32_t  hiHz;         // percentile haut
+};
+
+struct CalReport {
+    CalStatus  status;
+    CalCarrier carriers[FREQ_PLAN_SIZE];   // dans l'ordre de FREQ_PLAN
+};
+
+// -----------------------------------------------------------------------------
+// Echantillons par porteuse et derivation (coeur 0, hote)
+// -----------------------------------------------------------------------------
+class CalibrationSet {
+public:
+    void clear();
+
+    // false : classe hors plan ou porteuse pleine
+    bool add(FreqClass cls, uint32_t press, uint32_t freqHz);
+
+    uint16_t samples(FreqClass cls) const;
+    uint8_t  presses(FreqClass cls) const;
+    bool     complete(FreqClass cls) const {
+        return samples(cls) >= CAL_MIN_SAMPLES && presses(cls) >= CAL_MIN_PRESSES;
+    }
+
+    // Plan du tireur ; `out` n'est ecrit que si le resultat est OK
+    CalStatus derive(BandPlan& out, CalReport* report = nullptr) const;
+
+private:
+    struct Carrier {
+        uint16_t n;
+        uint8_t  presses;
+        uint32_t lastPress;
+        uint32_t hz[CAL_MAX_SAMPLES];
+    };
+
+    Carrier carriers_[FREQ_PLAN_SIZE] = {};
+};
+
+// Ligne "CAL,<classe>,<appui>,<Hz>\n" (classe : valeur de FreqClass),
+// meme forme que les lignes EV / VD de referee.h ; 0 si cap trop petit
+size_t formatCalibrationLog(FreqClass cls, uint32_t press, uint32_t freqHz,
+                            char* buf, size_t cap);
+
+// Reconnait une ligne CAL dans un journal Serial ; false pour les autres
+bool parseCalibrationLog(const char* line, FreqClass& cls, uint32_t& press,
+                         uint32_t& freqHz);
+
+// Enregistrement en flash (format ci-dessus)
+size_t encodeBandPlan(const BandPlan& plan, uint8_t* out, size_t cap);
+bool   decodeBandPlan(const uint8_t* in, size_t len, BandPlan& plan);
+
+// Empreinte de FREQ_PLAN (centres et tolerances compiles)
+uint16_t freqPlanTag();
+
+// -----------------------------------------------------------------------------
+// Echantillonnage pendant l'appui (coeur 1)
+// -----------------------------------------------------------------------------
+
+// Bornes larges, de FREQ_MIN_DETECT a deux fois la plus haute porteuse :
+// l'estimateur ne sert qu'a reconnaitre un contact continu
+constexpr BandPlan CAL_WIDE_PLAN = {
+    1,
+    { { FreqClass::UNKNOWN,
+        (FREQ_MIN_DETECT + 2 * detail::maxCenterHz()) / 2,
+        (2 * detail::maxCenterHz() - FREQ_MIN_DETECT) / 2,
+        "calibration" } },
+};
+
+class CalibrationSampler {
+public:
+    explicit CalibrationSampler(uint32_t tickHz = 0) : est_(tickHz) {
+        est_.setPlan(&CAL_WIDE_PLAN);
+        tickHz_ = tickHz;
+    }
+
+    void setTickHz(uint32_t tickHz) { est_.setTickHz(tickHz); tickHz_ = tickHz; }
+
+    // Porteuse de l'etape (NONE : calibration arretee) ; prise en compte
+    // au prochain appui
+    void setTarget(FreqClass cls) { target_ = cls; }
+    FreqClass target() const { return target_; }
+
+    // Meme contrat que TouchDetector::stepFiltered ; pousse des
+    // FencerEvent CALIBRATION dans `out`
+    template <typename Timer, typename Sink>
+    void step(uint64_t nowUs, bool pressed, uint64_t edgeUs, Timer& timer, Sink& out) {
+        if (pressed && !pressed_) {
+            pressUs_  = edgeUs;
+            cls_      = target_;
+            lastUs_   = 0;
+            press_++;
+            est_.reset();
+        }
+        pressed_ = pressed;
+
+        Edges<Sink> edges = { *this, out };
+        timer.pollEdges(edges, nowUs);
+    }
+
+    bool     pressed() const { return pressed_; }
+    uint32_t pressCount() const { return press_; }
+
+private:
+    template <typename Sink>
+    struct Edges {
+        CalibrationSampler& s;
+        Sink&               out;
+
+        void pushEdge(uint64_t tUs, uint32_t ticks) {
+            if (!s.pressed_ || s.cls_ == FreqClass::NONE || tUs <= s.pressUs_ || ticks == 0)
+                return;
+            s.est_.pushPeriod(ticks);
+            if (!s.est_.ready() || (s.lastUs_ && tUs - s.lastUs_ < CAL_SAMPLE_US))
+                return;
+            uint32_t hz   = s.tickHz_ / ticks;
+            uint32_t mean = s.est_.estimate().freqHz;
+            uint32_t dev  = hz > mean ? hz - mean : mean - hz;
+            if ((uint64_t)dev * 1000u > (uint64_t)mean * CAL_SAMPLE_DEV_PERMILLE)
+                return;
+            s.lastUs_ = tUs;
+
+            FencerEvent ev = {};
+            ev.type   = FencerEventType::CALIBRATION;
+            ev.cls    = s.cls_;
+            ev.tUs    = tUs;
+            ev.freqHz = hz;
+            ev.value  = s.press_;
+            out.push(ev);
+        }
+    };
+
+    ContactEstimator<CAL_SEGMENT_PERIODS> est_;
+    uint32_t  tickHz_  = 0;
+    FreqClass target_  = FreqClass::NONE;
+    FreqClass cls_     = FreqClass::NONE;   // porteuse de l'appui en cours
+    bool      pressed_ = false;
+    uint64_t  pressUs_ = 0;
+    uint64_t  lastUs_  = 0;                 // dernier echantillon de l'appui
+    uint32_t  press_   = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Stockage du plan calibre
+// -----------------------------------------------------------------------------
+class FakePlanStore {
+public:
+    FakePlanStore() { erase(); }
+
+    bool load(BandPlan& plan) const { return decodeBandPlan(bytes_, sizeof bytes_, plan); }
+    bool save(const BandPlan& plan) {
+        uint8_t buf[CAL_RECORD_MAX];
+        size_t n = encodeBandPlan(plan, buf, sizeof buf);
+        if (n == 0) return false;
+        for (size_t i = 0; i < sizeof bytes_; i++)
+            bytes_[i] = i < n ? buf[i] : 0xFF;
+        return true;
+    }
+
+    // Flash effacee
+    void erase() {
+        for (size_t i = 0; i < sizeof bytes_; i++) bytes_[i] = 0xFF;
+    }
+    uint8_t* raw() { return bytes_; }
+
+private:
+    uint8_t bytes_[CAL_RECORD_MAX];
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+class EepromPlanStore {
+public:
+    bool load(BandPlan& plan) const;
+    bool save(const BandPlan& plan);    // efface et programme un secteur
+};
+
+typedef EepromPlanStore PlanStore;
+#else
+typedef FakePlanStore PlanStore;
+#endif
+
+}  // namespace fencing
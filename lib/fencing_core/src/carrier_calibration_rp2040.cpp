@@ -0,0 +1,54 @@
+// =============================================================================
+// carrier_calibration_rp2040.cpp — Plan calibre dans l'emulation EEPROM
+// =============================================================================
+
+#include "carrier_calibration.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <EEPROM.h>
+
+namespace fencing {
+
+namespace {
+
+// Taille minimale acceptee par EEPROM.begin() du core arduino-pico
+const size_t EEPROM_SIZE = 256;
+
+static_assert(CAL_RECORD_MAX <= EEPROM_SIZE, "enregistrement plus grand que le secteur emule");
+
+bool eepromReady = false;
+
+void eepromBegin() {
+    if (!eepromReady) {
+        EEPROM.begin(EEPROM_SIZE);
+        eepromReady = true;
+    }
+}
+
+}  // namespace
+
+bool EepromPlanStore::load(BandPlan& plan) const {
+    eepromBegin();
+    uint8_t buf[CAL_RECORD_MAX];
+    for (size_t i = 0; i < sizeof buf; i++)
+        buf[i] = EEPROM.read((int)i);
+    return decodeBandPlan(buf, sizeof buf, plan);
+}
+
+// commit() efface et reprogramme le secteur : l'autre coeur est mis en
+// attente par le core le temps de l'ecriture (quelques dizaines de ms)
+bool EepromPlanStore::save(const BandPlan& plan) {
+    uint8_t buf[CAL_RECORD_MAX];
+    size_t n = encodeBandPlan(plan, buf, sizeof buf);
+    if (n == 0)
+        return false;
+    eepromBegin();
+    for (size_t i = 0; i < sizeof buf; i++)
+        EEPROM.write((int)i, i < n ? buf[i] : 0xFF);
+    return EEPROM.commit();
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,165 @@
+// =============================================================================
+// central_node.h — Boucle du firmware central, sans Serial ni WiFi
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Le corps de loop() et de serviceLink() de central_firmware, tel quel : le
+// sketch garde le point d'acces, les broches et l'affichage (lignes LAMPE,
+// VERDICT, EV / VD, STATUS) ; host_tools boutsim instancie un CentralNode
+// sur la HAL simulee. L'assaut simule verifie ce code-ci, pas une copie.
+//
+// Un tour de loop(log) :
+//   1. t0, puis les datagrammes : requete de synchro → reponse ; touche
+//      unique (TouchReceiver) → arbitre chronometre, sorties aux lampes,
+//      puis au journal ; etapes de latence du DWELL
+//   2. echeances de l'arbitre a t0 : tout datagramme recu avant t0 est
+//      arbitre d'abord, comme au rejeu du journal
+//   3. fin d'affichage, buzzer, trame en attente d'une bande occupee
+//
+// Log : void output(const RefereeOutput& o, uint32_t ticket)
+//         sortie de l'arbitre, apres que toutes les sorties de l'appel sont
+//         passees aux lampes (ticket de LampPanel::apply) : l'affichage ne
+//         retarde pas les trames
+//       void event(const TouchEvent& ev, uint64_t rxUs)
+//         touche unique, apres sa decision et ses lampes
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "clock_sync.h"
+#include "hal.h"
+#include "lamp_panel.h"
+#include "latency_probe.h"
+#include "referee.h"
+#include "touch_link.h"
+#include "touch_wire.h"
+#include "udp_link.h"
+
+namespace fencing {
+
+template <typename Link, typename Strip, typename Buzzer>
+class CentralNode {
+public:
+    typedef LampPanel<Strip, Buzzer> Panel;
+
+    CentralNode(Link& link, Strip& strip, Buzzer& buzzer)
+        : link_(link), receiver_(link), panel_(strip, buzzer) {}
+
+    // Point d'acces leve : ecoute sur localPort
+    bool listen(uint16_t localPort) {
+        linkUp_ = link_.begin(localPort);
+        return linkUp_;
+    }
+    bool linkUp() const { return linkUp_; }
+
+    template <typename Log>
+    void loop(Log& log) {
+        uint64_t t0 = hal::nowUs();
+        if (linkUp_)
+            serviceLink(log);
+
+        uint64_t t1 = hal::nowUs();
+        referee_.poll(t0, outputs_);
+        timeReferee(t1);
+        applyOutputs(log);
+
+        panel_.service(hal::nowUs());
+        latency_.settle(panel_);
+    }
+
+    // Pire onEvent() / poll() et pics des lampes remis a zero (apres STATUS)
+    void resetPeaks() {
+        panel_.resetPeaks();
+        refereeMaxUs_ = 0;
+    }
+
+    const Referee&                referee()      const { return referee_; }
+    const TouchReceiver<Link>&    receiver()     const { return receiver_; }
+    const Panel&                  panel()        const { return panel_; }
+    const LatencyProbe&           latency()      const { return latency_; }
+    uint32_t                      refereeMaxUs() const { return refereeMaxUs_; }
+    uint32_t                      syncReplies()  const { return syncReplies_; }
+
+private:
+    // Sorties d'un appel au plus : verdict echu, correction, lampe
+    struct OutputBuffer {
+        RefereeOutput items[4];
+        uint8_t       count = 0;
+
+        bool push(const RefereeOutput& o) {
+            if (count >= sizeof items / sizeof items[0])
+                return false;
+            items[count++] = o;
+            return true;
+        }
+    };
+
+    template <typename Log>
+    void serviceLink(Log& log) {
+        LinkMessage msg;
+        while (link_.poll(msg)) {
+            if (msg.kind == LinkKind::SYNC_REQUEST) {
+                syncReplies_ += answerSync(link_, msg);
+                continue;
+            }
+            if (msg.kind != LinkKind::EVENT || !receiver_.onEvent(msg.ev, msg.from))
+                continue;
+
+            // Arbitrage et lampes d'abord, journal ensuite. L'arrivee reste
+            // msg.rxUs, instant de reception du datagramme, et refreplay ne
+            // depend pas de l'ordre des lignes EV / VD.
+            uint64_t t0 = hal::nowUs();
+            referee_.onEvent(msg.ev, msg.rxUs, outputs_);
+            timeReferee(t0);
+            uint64_t decidedUs = hal::nowUs();
+            uint32_t ticket    = applyOutputs(log, msg.ev.player);
+            log.event(msg.ev, msg.rxUs);
+            if (msg.ev.type != FencerEventType::DWELL || msg.ev.cls == FreqClass::NONE)
+                continue;           // blanche : pas de front de GP2 a dater
+            // Etapes du central : tUs doit etre sur son horloge
+            LatencyStamps lat = msg.ev.lat;
+            if (msg.ev.syncUs != TOUCH_SYNC_NONE) {
+                latencyMark(lat, LatencyStage::CENTRAL_RX, msg.rxUs, msg.ev.tUs);
+                latencyMark(lat, LatencyStage::DECISION, decidedUs, msg.ev.tUs);
+            }
+            latency_.await(lat, msg.ev.tUs, ticket);
+        }
+    }
+
+    // Lampes d'abord, journal ensuite. Rend le ticket de la derniere lampe
+    // du tireur player (0 : aucune).
+    template <typename Log>
+    uint32_t applyOutputs(Log& log, uint8_t player = 0) {
+        uint32_t tickets[sizeof outputs_.items / sizeof outputs_.items[0]];
+        uint32_t ticket = 0;
+        for (uint8_t i = 0; i < outputs_.count; i++) {
+            const RefereeOutput& o = outputs_.items[i];
+            tickets[i] = panel_.apply(o, hal::nowUs());
+            if (o.kind == RefereeOutputKind::LIGHT && o.player == player && o.lamp != Lamp::NONE)
+                ticket = tickets[i];
+        }
+        for (uint8_t i = 0; i < outputs_.count; i++)
+            log.output(outputs_.items[i], tickets[i]);
+        outputs_.count = 0;
+        return ticket;
+    }
+
+    void timeReferee(uint64_t startUs) {
+        uint32_t us = (uint32_t)(hal::nowUs() - startUs);
+        if (us > refereeMaxUs_) refereeMaxUs_ = us;
+    }
+
+    Link&               link_;
+    TouchReceiver<Link> receiver_;
+    Referee             referee_;
+    OutputBuffer        outputs_;
+    Panel               panel_;
+    LatencyProbe        latency_;
+    bool                linkUp_       = false;
+    uint32_t            refereeMaxUs_ = 0;    // pire onEvent() / poll(), depuis resetPeaks()
+    uint32_t            syncReplies_  = 0;
+};
+
+}  // namespace fencing
@@ -0,0 +1,28 @@
+// =============================================================================
+// classifier.cpp — Libelles des categories de frequence
+// =============================================================================
+
+#include "classifier.h"
+
+namespace fencing {
+
+const char* freqClassLabel(FreqClass c) {
+    if (c == FreqClass::NONE)
+        return "AUCUNE";
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].cls == c)
+            return FREQ_PLAN[i].label;
+    return "INCONNUE";
+}
+
+const char* touchResultText(FreqClass c) {
+    switch (c) {
+        case FreqClass::NONE:    return ">>> TOUCHE BLANCHE (non-valide) <<<";
+        case FreqClass::NEUTRE:  return "--- Pas de lumiere (coque/piste) ---";
+        case FreqClass::VALID_A: return "*** TOUCHE VALIDE sur tireur A ! ***";
+        case FreqClass::VALID_B: return "*** TOUCHE VALIDE sur tireur B ! ***";
+        default:                 return "??? Frequence inconnue ???";
+    }
+}
+
+}  // namespace fencing
@@ -0,0 +1,146 @@
+// =============================================================================
+// classifier.h — Classification de la frequence mesuree sur la ligne B
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Retourne une categorie (enum) au lieu d'une chaine : le chemin de mesure
+// ne manipule que des entiers, les libelles ne servent qu'a l'affichage.
+//
+//   FreqClass c = classifyFrequency(measuredFreqHz);
+//   Serial.print(freqClassLabel(c));      // "NEUTRE  (20 kHz)"
+//   Serial.print(touchResultText(c));     // "--- Pas de lumiere ... ---"
+//
+// TABLE GENEREE A LA COMPILATION :
+//   L'axe des frequences est decoupe en cases de 2^LUT_SHIFT Hz, avec la
+//   plus grande largeur qui reste inferieure ou egale au plus petit ecart
+//   entre deux bandes de FREQ_PLAN. Une case recouvre donc au plus une
+//   bande : la table donne la seule bande candidate, une comparaison a ses
+//   bornes tranche. Cout constant quel que soit le nombre de porteuses
+//   (un decalage, une lecture de table, deux comparaisons).
+//
+//   Plan 20/25/40 kHz ±2 kHz  : cases de 512 Hz, 83 octets
+//   Plan 1/1.5/2.5 kHz ±200 Hz : cases de 64 Hz, 43 octets
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "freq_plan.h"
+
+namespace fencing {
+
+namespace detail {
+
+constexpr uint8_t NO_BAND = 0xFF;
+
+constexpr bool bandsDisjoint() {
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        for (uint8_t j = i + 1; j < FREQ_PLAN_SIZE; j++)
+            if (!(FREQ_PLAN[i].hiHz() < FREQ_PLAN[j].loHz() ||
+                  FREQ_PLAN[j].hiHz() < FREQ_PLAN[i].loHz()))
+                return false;
+    return true;
+}
+
+constexpr bool bandsAboveMinDetect() {
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].toleranceHz >= FREQ_PLAN[i].centerHz ||
+            FREQ_PLAN[i].loHz() < FREQ_MIN_DETECT)
+            return false;
+    return true;
+}
+
+constexpr uint32_t maxHiHz() {
+    uint32_t hi = 0;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].hiHz() > hi) hi = FREQ_PLAN[i].hiHz();
+    return hi;
+}
+
+// Plus petit ecart entre la borne haute d'une bande et la borne basse
+// de la suivante (bandes supposees disjointes)
+constexpr uint32_t minGapHz() {
+    uint32_t gap = maxHiHz() + 1;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        for (uint8_t j = 0; j < FREQ_PLAN_SIZE; j++)
+            if (FREQ_PLAN[i].hiHz() < FREQ_PLAN[j].loHz() &&
+                FREQ_PLAN[j].loHz() - FREQ_PLAN[i].hiHz() < gap)
+                gap = FREQ_PLAN[j].loHz() - FREQ_PLAN[i].hiHz();
+    return gap;
+}
+
+constexpr uint8_t lutShift() {
+    uint8_t shift = 0;
+    while ((2u << shift) <= minGapHz() && shift < 31) shift++;
+    return shift;
+}
+
+constexpr uint8_t  LUT_SHIFT = lutShift();
+constexpr uint32_t LUT_SIZE  = (maxHiHz() >> LUT_SHIFT) + 1;
+
+struct BandLut {
+    uint8_t band[LUT_SIZE];
+};
+
+constexpr BandLut makeLut() {
+    BandLut lut = {};
+    for (uint32_t b = 0; b < LUT_SIZE; b++)
+        lut.band[b] = NO_BAND;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        for (uint32_t b = FREQ_PLAN[i].loHz() >> LUT_SHIFT;
+             b <= (FREQ_PLAN[i].hiHz() >> LUT_SHIFT); b++)
+            lut.band[b] = i;
+    return lut;
+}
+
+inline constexpr BandLut LUT = makeLut();
+
+static_assert(FREQ_PLAN_SIZE < NO_BAND, "FREQ_PLAN : trop de porteuses");
+static_assert(bandsDisjoint(),
+              "FREQ_PLAN : des bandes de tolerance se chevauchent");
+static_assert(bandsAboveMinDetect(),
+              "FREQ_PLAN : une bande descend sous FREQ_MIN_DETECT");
+
+}  // namespace detail
+
+// -----------------------------------------------------------------------------
+// Frequence (Hz) → categorie, en temps constant
+// -----------------------------------------------------------------------------
+constexpr FreqClass classifyFrequency(uint32_t freqHz) {
+    if (freqHz < FREQ_MIN_DETECT)
+        return FreqClass::NONE;
+    uint32_t bucket = freqHz >> detail::LUT_SHIFT;
+    if (bucket >= detail::LUT_SIZE)
+        return FreqClass::UNKNOWN;
+    uint8_t i = detail::LUT.band[bucket];
+    if (i == detail::NO_BAND)
+        return FreqClass::UNKNOWN;
+    const CarrierBand& band = FREQ_PLAN[i];
+    return (freqHz >= band.loHz() && freqHz <= band.hiHz()) ? band.cls
+                                                             : FreqClass::UNKNOWN;
+}
+
+// Nombre de fronts sur une fenetre de windowMs → categorie
+constexpr FreqClass classifyCount(uint32_t count, uint32_t windowMs) {
+    return windowMs ? classifyFrequency((uint32_t)((uint64_t)count * 1000u / windowMs))
+                    : FreqClass::NONE;
+}
+
+// Periode moyenne (ticks d'une horloge a tickHz) → categorie
+constexpr FreqClass classifyPeriod(uint32_t periodTicks, uint32_t tickHz) {
+    return periodTicks ? classifyFrequency(tickHz / periodTicks) : FreqClass::NONE;
+}
+
+static_assert(classifyFrequency(0) == FreqClass::NONE, "classification : 0 Hz");
+static_assert(classifyFrequency(FREQ_NEUTRE) == FreqClass::NEUTRE, "classification : NEUTRE");
+static_assert(classifyFrequency(FREQ_VALID_A) == FreqClass::VALID_A, "classification : VALID_A");
+static_assert(classifyFrequency(FREQ_VALID_B) == FreqClass::VALID_B, "classification : VALID_B");
+
+// Libelle court de la categorie ("VALID_A (25 kHz)")
+const char* freqClassLabel(FreqClass c);
+
+// Resultat de touche pour l'affichage (logique d'arbitrage simplifiee)
+const char* touchResultText(FreqClass c);
+
+}  // namespace fencing
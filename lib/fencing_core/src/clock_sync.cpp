@@ -0,0 +1,127 @@
+// =============================================================================
+// clock_sync.cpp — Filtrage des echanges et estimation offset / derive
+// =============================================================================
+
+#include "clock_sync.h"
+
+#include <math.h>
+
+namespace fencing {
+
+bool ClockSync::poll(uint64_t nowUs, uint8_t player, SyncExchange& req) {
+    if (nowUs < nextUs_)
+        return false;
+    // Demarrage rapide, puis cadence lente ; la reponse precedente, si elle
+    // arrive maintenant, sera ignoree (numero perime)
+    sent_ = sent_ < SYNC_FAST_COUNT ? sent_ + 1 : sent_;
+    nextUs_  = nowUs + (sent_ < SYNC_FAST_COUNT ? SYNC_FAST_PERIOD_US : SYNC_PERIOD_US);
+    lastUs_  = nowUs;
+    waiting_ = true;
+
+    req = {};
+    req.player = player;
+    req.seq    = ++seq_;
+    req.t1Us   = nowUs;
+    return true;
+}
+
+bool ClockSync::onReply(const SyncExchange& rep, uint64_t t4Us) {
+    if (!waiting_ || rep.seq != seq_ || rep.t1Us != lastUs_ || t4Us < rep.t1Us ||
+        rep.t3Us < rep.t2Us) {
+        ignored_++;
+        return false;
+    }
+    uint64_t round = t4Us - rep.t1Us;
+    uint64_t hold  = rep.t3Us - rep.t2Us;
+    if (hold > round || round - hold > SYNC_RTT_MAX_US) {
+        ignored_++;
+        return false;
+    }
+    waiting_ = false;
+
+    uint32_t rtt    = (uint32_t)(round - hold);
+    uint64_t mid    = rep.t1Us + round / 2;
+    int64_t  offset = ((int64_t)(rep.t2Us - rep.t1Us) + (int64_t)(rep.t3Us - t4Us)) / 2;
+    if (isStep(offset, mid, rtt)) {
+        // Nouvelle horloge du central : l'historique ne la decrit plus
+        count_ = 0;
+        next_  = 0;
+        sent_  = 1;
+        if (nextUs_ > t4Us + SYNC_FAST_PERIOD_US)
+            nextUs_ = t4Us + SYNC_FAST_PERIOD_US;
+        steps_++;
+    }
+
+    Sample& s = history_[next_];
+    s.rttUs    = rtt;
+    s.midUs    = mid;
+    s.offsetUs = offset;
+    next_ = (uint8_t)((next_ + 1) % SYNC_HISTORY);
+    if (count_ < SYNC_HISTORY) count_++;
+    accepted_++;
+
+    refit();
+    return true;
+}
+
+// Ecart a la prediction : au plus delai / 2 pour l'echantillon, plus
+// l'incertitude du modele ; bien au-dela, l'horloge du central a saute
+bool ClockSync::isStep(int64_t offsetUs, uint64_t midUs, uint32_t rttUs) const {
+    if (!synced())
+        return false;
+    int64_t predicted = (int64_t)(toCentral(midUs) - midUs);
+    uint64_t diff = offsetUs > predicted ? (uint64_t)(offsetUs - predicted)
+                                         : (uint64_t)(predicted - offsetUs);
+    uint64_t bound = (uint64_t)SYNC_STEP_FACTOR * (rttUs + uncertaintyUs(midUs)) + SYNC_STEP_MIN_US;
+    return diff > bound;
+}
+
+// Moindres carres ponderes sur tout l'historique : poids (S / (S + e))^2,
+// e = delai − delai minimal, S = SYNC_RTT_SCALE_US. Un echange retarde par
+// une retransmission (e de plusieurs ms) ne pese presque plus. Flottants :
+// une fois par echange, pas par evenement.
+void ClockSync::refit() {
+    uint32_t minRtt = ~0u;
+    const Sample* newest = &history_[0];
+    for (uint8_t i = 0; i < count_; i++) {
+        if (history_[i].rttUs < minRtt) minRtt = history_[i].rttUs;
+        if (history_[i].midUs > newest->midUs) newest = &history_[i];
+    }
+
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    uint64_t oldest = newest->midUs;
+    for (uint8_t i = 0; i < count_; i++) {
+        const Sample& s = history_[i];
+        double k = (double)SYNC_RTT_SCALE_US / (SYNC_RTT_SCALE_US + (s.rttUs - minRtt));
+        double w = k * k;
+        double x = (double)(int64_t)(s.midUs - newest->midUs);
+        double y = (double)(s.offsetUs - newest->offsetUs);
+        sw += w; sx += w * x; sy += w * y; sxx += w * x * x; sxy += w * x * y;
+        if (s.midUs < oldest) oldest = s.midUs;
+    }
+
+    refUs_     = newest->midUs;
+    bestRttUs_ = minRtt;
+    double den = sw * sxx - sx * sx;
+    double slope = (double)skewPpb_ * 1e-9;       // derive precedente par defaut
+    if (newest->midUs - oldest >= SYNC_SKEW_SPAN_US && den > 0) {
+        slope = (sw * sxy - sx * sy) / den;        // µs / µs
+        double ppb = slope * 1e9;
+        if (ppb >  SYNC_SKEW_MAX_PPB) ppb =  SYNC_SKEW_MAX_PPB;
+        if (ppb < -SYNC_SKEW_MAX_PPB) ppb = -SYNC_SKEW_MAX_PPB;
+        skewPpb_ = (int32_t)ppb;
+        slope    = ppb * 1e-9;
+    }
+    double icept = (sy - slope * sx) / sw;         // a x = 0 (dernier echange)
+    offsetUs_ = newest->offsetUs + (int64_t)llround(icept);
+}
+
+uint16_t ClockSync::uncertaintyUs(uint64_t localUs) const {
+    if (!synced())
+        return TOUCH_SYNC_NONE;
+    uint64_t age = localUs > refUs_ ? localUs - refUs_ : refUs_ - localUs;
+    uint64_t u = bestRttUs_ / 2 + age * SYNC_HOLDOVER_PPB / 1000000000u + 1;
+    return u >= TOUCH_SYNC_NONE ? (uint16_t)(TOUCH_SYNC_NONE - 1) : (uint16_t)u;
+}
+
+}  // namespace fencing
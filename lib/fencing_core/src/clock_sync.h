@@ -0,0 +1,142 @@
+// =============================================================================
+// clock_sync.h — Horloge du tireur rapportee a celle du central (offset + derive)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le verrouillage (300 ms) et la double touche comparent les instants des
+//   deux tireurs. Chaque Pico date avec son propre time_us_64() : origine
+//   inconnue (demarrages differents) et derive du quartz (±30 ppm chacun,
+//   soit jusqu'a 60 µs/s d'ecart). Ordonner a l'arrivee au central ajoute
+//   toute la gigue WiFi (quelques ms, des dizaines lors d'une retransmission).
+//
+// PRINCIPE (NTP simplifie, cote tireur) :
+//   Echange a quatre instants (trames SYNC de touch_wire.h) :
+//     t1 emission de la requete (tireur)    t2 reception (central)
+//     t3 emission de la reponse (central)   t4 reception (tireur)
+//   offset = ((t2 - t1) + (t3 - t4)) / 2    (central − tireur)
+//   delai  = (t4 - t1) - (t3 - t2)          (aller + retour sur l'air)
+//   L'erreur d'un echantillon est au plus delai / 2 (asymetrie aller /
+//   retour). Sur les SYNC_HISTORY derniers echanges (16 s), moindres carres
+//   ponderes offset(t) = a + b.t, poids (S / (S + e))^2 ou e est l'exces de
+//   delai sur le minimum et S = SYNC_RTT_SCALE_US : les echanges retardes
+//   (retransmission WiFi, veille du CYW43) ne comptent presque plus. b est
+//   la derive (ppb, offset / temps local), a l'offset au dernier echange.
+//   La conversion d'un instant local est en entiers (aucun flottant par
+//   evenement) :
+//     central = local + offset + (local − ref) . derive / 1e9
+//
+//   Cadence : SYNC_FAST_COUNT requetes a SYNC_FAST_PERIOD_US au demarrage,
+//   puis SYNC_PERIOD_US. Une reponse dont le numero n'est pas celui de la
+//   derniere requete (perdue, en retard) est ignoree.
+//
+// SAUT D'OFFSET (central redemarre, horloge repartie de zero) : un
+// echantillon dont l'offset s'ecarte de la prediction de plus de
+// SYNC_STEP_FACTOR × (son delai + incertitude courante) + SYNC_STEP_MIN_US
+// ne peut pas venir de la meme horloge. L'historique est vide, l'echantillon
+// devient le premier du nouveau et le demarrage rapide reprend. La derive
+// estimee est gardee (meme quartz cote tireur).
+//
+// INCERTITUDE : delai minimal / 2, plus SYNC_HOLDOVER_PPB du temps ecoule
+// depuis le dernier echange (derive residuelle). Transmise avec chaque
+// evenement (TouchEvent::syncUs).
+//
+// Cote central : answerSync() repond (t2 = reception, t3 = emission).
+// Simulation sur hote : host_tools syncsim.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "touch_wire.h"
+
+namespace fencing {
+
+constexpr uint32_t SYNC_PERIOD_US      = 250000;
+constexpr uint32_t SYNC_FAST_PERIOD_US = 50000;
+constexpr uint8_t  SYNC_FAST_COUNT     = 8;
+constexpr uint8_t  SYNC_HISTORY        = 64;
+constexpr uint32_t SYNC_RTT_MAX_US     = 50000;    // echange plus long : ignore
+constexpr uint32_t SYNC_RTT_SCALE_US   = 500;      // poids 1/4 a min + 500 µs
+constexpr uint32_t SYNC_SKEW_SPAN_US   = 2000000;  // duree minimale pour estimer la derive
+constexpr int32_t  SYNC_SKEW_MAX_PPB   = 200000;   // 200 ppm
+constexpr uint32_t SYNC_HOLDOVER_PPB   = 10000;    // 10 ppm de derive residuelle
+constexpr uint8_t  SYNC_STEP_FACTOR    = 4;
+constexpr uint32_t SYNC_STEP_MIN_US    = 2000;
+
+class ClockSync {
+public:
+    // Tireur, a chaque tour : true si une requete est a envoyer (req rempli)
+    bool poll(uint64_t nowUs, uint8_t player, SyncExchange& req);
+
+    // Tireur : reponse recue a t4Us (horloge locale). true si l'echantillon
+    // est accepte (numero attendu, delai plausible).
+    bool onReply(const SyncExchange& rep, uint64_t t4Us);
+
+    bool synced() const { return count_ > 0; }
+
+    // Instant local → horloge du central (identite avant synchronisation)
+    uint64_t toCentral(uint64_t localUs) const {
+        if (!synced())
+            return localUs;
+        int64_t dt = (int64_t)(localUs - refUs_);
+        return localUs + (uint64_t)(offsetUs_ + dt * skewPpb_ / 1000000000);
+    }
+
+    uint16_t uncertaintyUs(uint64_t localUs) const;
+
+    // Trame en horloge locale → horloge du central, incertitude renseignee
+    void stamp(TouchEvent& ev) const {
+        if (!synced())
+            return;
+        ev.syncUs = uncertaintyUs(ev.tUs);
+        ev.tUs    = toCentral(ev.tUs);
+    }
+
+    int64_t  offsetUs() const { return offsetUs_; }
+    int32_t  skewPpb() const { return skewPpb_; }
+    uint32_t bestRttUs() const { return bestRttUs_; }
+    uint32_t accepted() const { return accepted_; }
+    uint32_t ignored() const { return ignored_; }   // numero inattendu, delai hors borne
+    uint32_t steps() const { return steps_; }       // sauts d'offset, historique repris
+
+    void reset() { *this = ClockSync(); }
+
+private:
+    struct Sample {
+        uint64_t midUs;      // milieu de l'echange, horloge locale
+        int64_t  offsetUs;
+        uint32_t rttUs;
+    };
+
+    bool isStep(int64_t offsetUs, uint64_t midUs, uint32_t rttUs) const;
+    void refit();
+
+    Sample   history_[SYNC_HISTORY] = {};
+    uint8_t  count_     = 0;
+    uint8_t  next_      = 0;
+    uint16_t seq_       = 0;
+    bool     waiting_   = false;
+    uint8_t  sent_      = 0;
+    uint64_t nextUs_    = 0;
+    uint64_t lastUs_    = 0;         // derniere requete
+
+    uint64_t refUs_     = 0;
+    int64_t  offsetUs_  = 0;
+    int32_t  skewPpb_   = 0;
+    uint32_t bestRttUs_ = 0;
+    uint32_t accepted_  = 0;
+    uint32_t ignored_   = 0;
+    uint32_t steps_     = 0;
+};
+
+// Central : reponse a une requete recue (rxUs = t2), t3 pris par le lien
+template <typename Link, typename Message>
+bool answerSync(Link& link, const Message& msg) {
+    SyncExchange ex = msg.sync;
+    ex.t2Us = msg.rxUs;
+    return link.sendSyncReply(msg.from, ex);
+}
+
+}  // namespace fencing
@@ -0,0 +1,292 @@
+// =============================================================================
+// contact_estimator.h — Mesure reciproque limitee au contact continu
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le comptage sur fenetre (count * 1000 / elapsed) moyenne le signal sur
+//   toute la fenetre, contact ou pas : un contact etabli ou rompu au milieu
+//   donne les mesures aberrantes de la Phase 0.4 (12 kHz, 24 kHz pour 20 kHz)
+//   et une mauvaise bande. ReciprocalEstimator rejette ces melanges
+//   (stable()), mais garde la periode qui enjambe une coupure jusqu'a ce
+//   qu'elle sorte de la moyenne, et un front parasite bloque N periodes.
+//
+// PRINCIPE : les periodes sont decoupees en segments de contact continu ;
+//   seules les N dernieres periodes du segment courant sont moyennees.
+//
+//   periode > plus longue periode du plan × 1.5   → coupure (pas de signal)
+//   periode ≈ moyenne × 2                         → front manque : comptee
+//                                                   comme deux demi-periodes
+//                                                   (segment de 3 periodes
+//                                                   au moins)
+//   autre periode ≥ moyenne × 1.5                 → coupure
+//        coupure : segment abandonne, periode jetee
+//   periode courte (< moyenne − ecart max)        → mise de cote :
+//        avec la suivante ≈ moyenne               → front parasite, fusionnees
+//                                                   (segment de 3 periodes
+//                                                   au moins)
+//        sinon suivante ≈ elle                    → nouveau segment (surface
+//                                                   plus rapide)
+//        les deux (parasite a mi-periode ?)       → la troisieme tranche
+//   periode hors de moyenne ± ecart max           → nouveau segment (autre
+//                                                   surface)
+//
+// CONFIANCE (pour mille) = remplissage (periodes / N)
+//                        × dispersion (ecart max / tolerance)
+//                        × marge dans la bande (1 au centre, 0.5 au bord)
+//   0 hors des bandes du plan : il n'y a rien a decider.
+//
+// Memes ticks que ReciprocalEstimator : cycles systeme pour le timer PIO,
+// nanosecondes pour les traces synthetiques (host_tools contactsim).
+//
+// BANDES : FREQ_PLAN compile par defaut ; setPlan() pose les bandes
+// calibrees du tireur (band_plan.h). La coupure suit la plus basse bande du
+// plan mais ne se resserre jamais sous celle de FREQ_PLAN : une bande
+// NEUTRE calibree plus etroite ne doit pas couper les fronts manques des
+// porteuses plus hautes.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "band_plan.h"
+#include "classifier.h"
+#include "freq_plan.h"
+
+namespace fencing {
+
+const uint16_t CONTACT_MIN_CONFIDENCE = 250;   // seuil de decision (pour mille)
+
+struct ContactEstimate {
+    FreqClass cls;          // NONE tant que le segment est vide
+    uint32_t  freqHz;       // moyenne des N dernieres periodes du segment
+    uint16_t  confidence;   // pour mille
+    uint16_t  periods;      // longueur du segment courant (saturee)
+};
+
+namespace detail {
+
+constexpr uint32_t minLoHz() {
+    uint32_t lo = FREQ_PLAN[0].loHz();
+    for (uint8_t i = 1; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].loHz() < lo) lo = FREQ_PLAN[i].loHz();
+    return lo;
+}
+
+}  // namespace detail
+
+template <uint8_t N>
+class ContactEstimator {
+    static_assert(N >= 2, "il faut au moins 2 periodes pour juger la stabilite");
+
+public:
+    explicit ContactEstimator(uint32_t tickHz, uint16_t maxDeviationPermille = 50)
+        : maxDevPermille_(maxDeviationPermille) {
+        setTickHz(tickHz);
+    }
+
+    // Nouvel appui : segment vide (les compteurs restent)
+    void reset() {
+        restart();
+        pending_ = pendingPair_ = 0;
+    }
+
+    void setTickHz(uint32_t tickHz) {
+        tickHz_   = tickHz;
+        uint32_t lo = detail::minLoHz();
+        if (plan_ && plan_->minLoHz() < lo) lo = plan_->minLoHz();
+        maxTicks_ = (uint32_t)((uint64_t)tickHz * 3u / (2u * lo));
+    }
+
+    // Bandes calibrees (nullptr : FREQ_PLAN). Le plan doit survivre a
+    // l'estimateur ; a reposer si son contenu change.
+    void setPlan(const BandPlan* plan) {
+        plan_ = plan;
+        setTickHz(tickHz_);
+    }
+
+    // Ajoute la periode entre les deux derniers fronts montants
+    void pushPeriod(uint32_t ticks) {
+        if (ticks == 0)
+            return;
+        if (ticks > maxTicks_) {
+            gap();
+            return;
+        }
+
+        if (pendingPair_) {
+            // Paire ambigue : la troisieme periode tranche
+            uint32_t first  = pending_;
+            uint32_t second = pendingPair_;
+            pending_ = pendingPair_ = 0;
+            if (near(ticks, second)) {
+                splits_++;
+                restart();
+                append(first);
+                append(second);
+                append(ticks);
+                return;
+            }
+            if (near(ticks, mean())) {
+                glitches_++;
+                append(first + second);
+                append(ticks);
+                return;
+            }
+            splits_++;
+            restart();
+        } else if (pending_) {
+            uint32_t shortTicks = pending_;
+            bool glitch = established() && near(shortTicks + ticks, mean());
+            bool pair   = near(ticks, shortTicks);
+            if (glitch && pair) {
+                // Front parasite au milieu d'une periode, ou surface deux
+                // fois plus rapide : on attend la suivante
+                pendingPair_ = ticks;
+                return;
+            }
+            pending_ = 0;
+            if (glitch) {
+                glitches_++;
+                append(shortTicks + ticks);
+                return;
+            }
+            if (pair) {
+                // Deux periodes courtes coherentes : le segment etait faux
+                splits_++;
+                restart();
+                append(shortTicks);
+                append(ticks);
+                return;
+            }
+            splits_++;
+            restart();
+        }
+
+        if (count_ == 0) {
+            append(ticks);
+            return;
+        }
+
+        uint32_t m = mean();
+        if ((uint64_t)ticks * 2u >= (uint64_t)m * 3u) {
+            if (!established() || !near(ticks / 2, m)) {
+                gap();
+                return;
+            }
+            missed_++;
+            append(ticks / 2);
+            ticks -= ticks / 2;
+        }
+        if (!near(ticks, m)) {
+            if (ticks < m) {
+                pending_ = ticks;
+                return;
+            }
+            splits_++;
+            restart();
+        }
+        append(ticks);
+    }
+
+    // Au moins N periodes dans le segment courant
+    bool ready() const { return count_ == N; }
+
+    ContactEstimate estimate() const {
+        ContactEstimate e = {};
+        e.periods = segPeriods_;
+        if (count_ == 0)
+            return e;
+
+        e.freqHz = (uint32_t)(((uint64_t)tickHz_ * count_ + sum_ / 2) / sum_);
+        e.cls    = plan_ ? plan_->classify(e.freqHz) : classifyFrequency(e.freqHz);
+        const CarrierBand* band = plan_ ? plan_->band(e.cls) : bandOf(e.cls);
+        if (!band)
+            return e;
+
+        uint32_t m = mean();
+        uint32_t worst = 0;
+        for (uint8_t i = 0; i < count_; i++) {
+            uint32_t dev = periods_[i] > m ? periods_[i] - m : m - periods_[i];
+            if (dev > worst) worst = dev;
+        }
+        uint32_t devPermille = (uint32_t)((uint64_t)worst * 1000u / m);
+        uint32_t spread = devPermille >= maxDevPermille_
+                        ? 0 : 1000u - devPermille * 1000u / maxDevPermille_;
+
+        uint32_t off = e.freqHz > band->centerHz ? e.freqHz - band->centerHz
+                                                 : band->centerHz - e.freqHz;
+        uint32_t margin = 1000u - off * 500u / band->toleranceHz;
+        uint32_t fill   = (uint32_t)count_ * 1000u / N;
+
+        e.confidence = (uint16_t)(fill * spread / 1000u * margin / 1000u);
+        return e;
+    }
+
+    uint32_t gaps() const { return gaps_; }          // coupures
+    uint32_t missed() const { return missed_; }      // fronts manques comptes double
+    uint32_t glitches() const { return glitches_; }  // fronts parasites fusionnes
+    uint32_t splits() const { return splits_; }      // changements de surface
+
+private:
+    static const CarrierBand* bandOf(FreqClass c) {
+        for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+            if (FREQ_PLAN[i].cls == c) return &FREQ_PLAN[i];
+        return nullptr;
+    }
+
+    bool near(uint32_t ticks, uint32_t ref) const {
+        uint32_t dev = ticks > ref ? ticks - ref : ref - ticks;
+        return (uint64_t)dev * 1000u <= (uint64_t)ref * maxDevPermille_;
+    }
+
+    uint32_t mean() const { return (uint32_t)(sum_ / count_); }
+
+    // Trois periodes coherentes au moins avant de reparer : une paire courte
+    // peut venir d'un front parasite au milieu d'une periode (2f apparent),
+    // une periode seule d'un front manque juste apres la coupure (f / 2)
+    bool established() const { return count_ >= 3; }
+
+    void gap() {
+        if (count_ || pending_) gaps_++;
+        restart();
+        pending_ = pendingPair_ = 0;
+    }
+
+    void restart() {
+        count_      = 0;
+        head_       = 0;
+        sum_        = 0;
+        segPeriods_ = 0;
+    }
+
+    void append(uint32_t ticks) {
+        if (count_ == N)
+            sum_ -= periods_[head_];
+        else
+            count_++;
+        periods_[head_] = ticks;
+        sum_ += ticks;
+        head_ = (uint8_t)((head_ + 1) % N);
+        if (segPeriods_ < 0xFFFF) segPeriods_++;
+    }
+
+    const BandPlan* plan_ = nullptr;
+    uint32_t tickHz_      = 0;
+    uint32_t maxTicks_    = 0;
+    uint16_t maxDevPermille_;
+    uint32_t periods_[N]  = {};
+    uint8_t  count_       = 0;
+    uint8_t  head_        = 0;
+    uint64_t sum_         = 0;
+    uint16_t segPeriods_  = 0;
+    uint32_t pending_     = 0;   // periode courte en attente (front parasite ?)
+    uint32_t pendingPair_ = 0;   // seconde periode courte ≈ pending_ (ambigu)
+    uint32_t gaps_        = 0;
+    uint32_t missed_      = 0;
+    uint32_t glitches_    = 0;
+    uint32_t splits_      = 0;
+};
+
+}  // namespace fencing
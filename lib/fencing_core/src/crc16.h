@@ -0,0 +1,55 @@
+// =============================================================================
+// crc16.h — CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, sans reflexion)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Table de 256 entrees generee a la compilation (512 octets en flash) :
+// un octet = un decalage, un XOR et une lecture de table. Detecte toute
+// erreur de 1 a 3 bits et toute rafale de 16 bits ou moins sur les trames
+// de TouchEvent.
+//
+// Valeur de controle : crc16("123456789") = 0x29B1.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fencing {
+
+namespace detail {
+
+struct Crc16Table {
+    uint16_t v[256];
+};
+
+constexpr Crc16Table makeCrc16Table() {
+    Crc16Table t = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
+        for (int b = 0; b < 8; b++)
+            crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+        t.v[i] = crc;
+    }
+    return t;
+}
+
+inline constexpr Crc16Table CRC16_TABLE = makeCrc16Table();
+
+}  // namespace detail
+
+constexpr uint16_t CRC16_INIT = 0xFFFF;
+
+constexpr uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = CRC16_INIT) {
+    for (size_t i = 0; i < len; i++)
+        crc = (uint16_t)((crc << 8) ^ detail::CRC16_TABLE.v[(uint8_t)((crc >> 8) ^ data[i])]);
+    return crc;
+}
+
+namespace detail {
+constexpr uint8_t CRC16_CHECK_INPUT[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+}
+static_assert(crc16(detail::CRC16_CHECK_INPUT, 9) == 0x29B1, "CRC-16/CCITT-FALSE : valeur de controle");
+
+}  // namespace fencing
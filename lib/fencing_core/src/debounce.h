@@ -0,0 +1,118 @@
+// =============================================================================
+// debounce.h — Anti-rebond du bouton (GP16)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Debouncer : meme regle que readButtonDebounced() des sketches, un nouvel
+// etat n'est accepte qu'apres stableMs sans changement de la lecture brute.
+//
+//   Debouncer button(DEBOUNCE_MS);
+//   bool pressed = button.update(digitalRead(PIN_BUTTON) == HIGH, millis());
+//
+// IntegratorDebouncer : echantillonne a cadence fixe (ButtonSampler, alarme
+// materielle), entiers uniquement. Un compteur sature 0..threshold monte sur
+// un echantillon HIGH et descend sur LOW ; l'etat bascule aux bornes. Un
+// parasite isole ne coute qu'un pas, un rebond de k echantillons retarde
+// de 2k. Latence sans rebond = threshold echantillons, choisie par
+// debounceThreshold(budget, periode).
+//
+// L'instant de bascule est antidate au premier echantillon de la montee
+// (ou de la descente) qui a abouti : le dwell mesure entre deux bascules
+// ne perd pas le temps de filtrage.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+const uint32_t DEBOUNCE_MS = 5;
+
+class Debouncer {
+public:
+    explicit Debouncer(uint32_t stableMs = DEBOUNCE_MS) : stableMs_(stableMs) {}
+
+    // Lecture brute a l'instant nowMs → etat filtre
+    bool update(bool raw, uint32_t nowMs) {
+        if (raw != lastRaw_)
+            changeTimeMs_ = nowMs;
+        lastRaw_ = raw;
+
+        if (nowMs - changeTimeMs_ >= stableMs_)
+            state_ = raw;
+        return state_;
+    }
+
+    bool state() const { return state_; }
+
+private:
+    uint32_t stableMs_;
+    uint32_t changeTimeMs_ = 0;
+    bool     lastRaw_      = false;
+    bool     state_        = false;
+};
+
+// -----------------------------------------------------------------------------
+// Filtre a integrateur, echantillons a cadence fixe
+// -----------------------------------------------------------------------------
+const uint32_t DEBOUNCE_SAMPLE_US  = 250;   // 4 kHz
+const uint32_t DEBOUNCE_BUDGET_US  = 2000;  // latence max sans rebond
+
+// Nombre d'echantillons consecutifs pour basculer dans le budget de latence
+constexpr uint8_t debounceThreshold(uint32_t budgetUs, uint32_t sampleUs) {
+    return budgetUs / sampleUs < 1   ? 1
+         : budgetUs / sampleUs > 255 ? 255
+         : (uint8_t)(budgetUs / sampleUs);
+}
+
+class IntegratorDebouncer {
+public:
+    explicit IntegratorDebouncer(uint8_t threshold =
+                                     debounceThreshold(DEBOUNCE_BUDGET_US, DEBOUNCE_SAMPLE_US))
+        : threshold_(threshold ? threshold : 1) {}
+
+    // Echantillon brut a l'instant t (unite libre, µs sur le Pico).
+    // true si l'etat filtre vient de basculer ; edgeTime() donne alors
+    // l'instant antidate de la bascule.
+    bool sample(bool raw, uint32_t t) {
+        if (raw) {
+            if (count_ == 0) riseStart_ = t;
+            if (count_ < threshold_) count_++;
+        } else {
+            if (count_ == threshold_) fallStart_ = t;
+            if (count_ > 0) count_--;
+        }
+
+        if (!state_ && count_ == threshold_) {
+            state_ = true;
+            edge_  = riseStart_;
+            return true;
+        }
+        if (state_ && count_ == 0) {
+            state_ = false;
+            edge_  = fallStart_;
+            return true;
+        }
+        return false;
+    }
+
+    bool     state()     const { return state_; }
+    uint32_t edgeTime()  const { return edge_; }
+    uint8_t  threshold() const { return threshold_; }
+
+    void reset(bool state = false) {
+        state_ = state;
+        count_ = state ? threshold_ : 0;
+    }
+
+private:
+    uint8_t  threshold_;
+    uint8_t  count_     = 0;
+    bool     state_     = false;
+    uint32_t riseStart_ = 0;
+    uint32_t fallStart_ = 0;
+    uint32_t edge_      = 0;
+};
+
+}  // namespace fencing
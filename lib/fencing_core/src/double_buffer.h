@@ -0,0 +1,80 @@
+// =============================================================================
+// double_buffer.h — Derniere valeur publiee, un ecrivain / un lecteur,
+//                   sans verrou
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Une interruption (WindowSampler) publie un resultat a cadence fixe ; la
+//   boucle ne veut que le plus recent, quand elle passe. Une SpscQueue
+//   deborderait pendant un Serial bloque, un noInterrupts() autour de la
+//   copie retarderait l'echeance suivante de l'alarme.
+//
+// PRINCIPE :
+//   Deux cases et un numero de version seq_. La version s est dans la case
+//   s & 1 ; l'ecrivain remplit l'autre case puis publie s + 1 en "release".
+//   Il ne touche a la case s & 1 qu'en preparant s + 2, donc apres avoir
+//   publie s + 1.
+//
+//   Le lecteur lit seq_ (acquire), copie la case, puis relit seq_ : si elle
+//   n'a pas bouge, l'ecrivain n'a pas commence s + 2 et la copie est
+//   entiere. Sinon il recommence avec la nouvelle version. L'ecrivain
+//   n'attend jamais ; le lecteur ne recommence que si une publication tombe
+//   pendant sa copie (quelques dizaines d'octets contre une publication par
+//   pas de la grille : au plus une reprise en pratique).
+//
+//   Comme SpscQueue, seuls load() / store() et des barrieres : de simples
+//   LDR / STR entoures de DMB sur Cortex-M0+.
+//
+// Sur hote, un ecrivain et un lecteur dans deux threads (host_tools window).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace fencing {
+
+template <typename T>
+class DoubleBuffer {
+public:
+    // Ecrivain uniquement (jamais bloque)
+    void publish(const T& value) {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        // La publication precedente doit etre visible avant toute ecriture
+        // dans la case qu'elle a liberee
+        std::atomic_thread_fence(std::memory_order_release);
+        slots_[(seq + 1) & 1] = value;
+        seq_.store(seq + 1, std::memory_order_release);
+    }
+
+    // Lecteur : derniere valeur publiee ; false si rien n'a encore ete publie
+    bool read(T& out) const {
+        for (;;) {
+            uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (seq == 0)
+                return false;
+            out = slots_[seq & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq)
+                return true;
+            retries_.store(retries_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+        }
+    }
+
+    // Nombre de publications (0 : vide)
+    uint32_t version() const { return seq_.load(std::memory_order_acquire); }
+
+    // Copies recommencees par read() (diagnostic)
+    uint32_t retries() const { return retries_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t>         seq_{0};
+    mutable std::atomic<uint32_t> retries_{0};
+    T                             slots_[2];
+};
+
+}  // namespace fencing
@@ -0,0 +1,166 @@
+// =============================================================================
+// dwell_tracker.h — Dwell FIE mesure en µs, declare pendant le contact
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   phase1_5 calcule le dwell au relachement, now - buttonPressStart sur
+//   millis() : resolution de la boucle (1 ms et plus) pour une tolerance
+//   FIE de ±0.5 ms, et la touche n'est connue qu'a la fin de l'appui, des
+//   centaines de ms apres que les 15 ms sont acquises.
+//
+// PRINCIPE :
+//   Tout est date en µs (time_us_64 sur le Pico) :
+//     - GP16 : bascules antidatees de ButtonSampler (press / release)
+//     - GP2  : chaque front montant chronometre par le PIO, date par
+//              EdgeTimer::pollEdges() (pushEdge), avec la periode qui s'y
+//              termine
+//   Une periode dont la frequence est VALID_A ou VALID_B prolonge le contact
+//   valide en cours. Un trou de signal (silence ou periodes invalides) plus
+//   long que max(gapUs, 2 periodes) rompt le contact.
+//
+//   Bords du contact : la premiere periode valide commence au premier
+//   front du contact, qui suit le vrai debut de moins d'une periode ; le
+//   dernier front precede la vraie fin d'autant. Le contact est donc
+//   compte d'une demi-periode avant son premier front (jamais avant
+//   l'appui) a une demi-periode apres son dernier : sans cela il perdrait
+//   jusqu'a deux periodes (800 µs a 2.5 kHz, plan LOW).
+//
+//   update() declare le dwell des que les fronts prouvent dwellUs de
+//   contact continu : satisfiedAtUs() = debut du contact + dwellUs, la
+//   declaration arrive au plus une periode et un tour de boucle plus tard.
+//
+// RESOLUTION : ±1/2 periode sur chaque bord (±12.5 µs a 40 kHz, ±200 µs a
+// 2.5 kHz en plan LOW ; ±333 µs a 1.5 kHz), plus l'erreur de datation de
+// pollEdges() (temps depuis le poll precedent).
+//
+// Logique pure, exercee sur hote par host_tools dwell.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "band_plan.h"
+#include "classifier.h"
+#include "fie_timing.h"
+
+namespace fencing {
+
+const uint32_t DWELL_GAP_US = 250;   // trou de signal tolere dans un contact
+
+class DwellTracker {
+public:
+    explicit DwellTracker(uint32_t tickHz = 0, uint32_t dwellUs = DWELL_MIN_US,
+                          uint32_t gapUs = DWELL_GAP_US)
+        : tickHz_(tickHz), dwellUs_(dwellUs), gapUs_(gapUs) {}
+
+    void setTickHz(uint32_t tickHz) { tickHz_ = tickHz; }
+
+    // Bandes calibrees (nullptr : FREQ_PLAN), cf. band_plan.h
+    void setPlan(const BandPlan* plan) { plan_ = plan; }
+
+    // Bascules du bouton (GP16), instants antidates
+    void press(uint64_t tUs) {
+        pressed_   = true;
+        inRun_     = false;
+        satisfied_ = false;
+        pressUs_   = tUs;
+        longestUs_ = 0;
+    }
+
+    void release(uint64_t tUs) {
+        if (!pressed_) return;
+        if (inRun_) closeRun(runEndUs() < tUs ? runEndUs() : tUs);
+        pressed_ = false;
+    }
+
+    // Front montant de GP2 a tUs, fin d'une periode de `ticks`
+    // (sink de EdgeTimer::pollEdges)
+    void pushEdge(uint64_t tUs, uint32_t ticks) {
+        if (!pressed_ || tUs <= pressUs_ || tickHz_ == 0) return;
+
+        FreqClass c = plan_ ? plan_->classifyPeriod(ticks, tickHz_)
+                            : classifyPeriod(ticks, tickHz_);
+        if (c != FreqClass::VALID_A && c != FreqClass::VALID_B) return;
+
+        uint32_t periodUs = (uint32_t)((uint64_t)ticks * 1000000u / tickHz_);
+        uint64_t startUs  = tUs > periodUs ? tUs - periodUs : 0;
+        if (inRun_ && (c != cls_ || startUs > lastValidUs_ + maxGapUs()))
+            closeRun(runEndUs());
+        if (!inRun_) {
+            // Demi-periode avant le premier front du contact
+            startUs     = startUs > periodUs / 2 ? startUs - periodUs / 2 : 0;
+            inRun_      = true;
+            cls_        = c;
+            runStartUs_ = startUs > pressUs_ ? startUs : pressUs_;
+        }
+        lastValidUs_ = tUs;
+        periodUs_    = periodUs;
+    }
+
+    // A appeler apres chaque pollEdges(). true une seule fois par appui,
+    // au moment ou dwellUs de contact valide continu sont acquis.
+    bool update(uint64_t nowUs) {
+        if (inRun_ && nowUs > lastValidUs_ + maxGapUs())
+            closeRun(runEndUs());
+        if (!inRun_ || satisfied_)
+            return false;
+        // Fin supposee du contact, jamais dans le futur
+        uint64_t endUs = runEndUs() < nowUs ? runEndUs() : nowUs;
+        if (endUs < runStartUs_ + dwellUs_)
+            return false;
+        satisfied_     = true;
+        satisfiedAtUs_ = runStartUs_ + dwellUs_;
+        satisfiedCls_  = cls_;
+        contactAtUs_   = runStartUs_;
+        return true;
+    }
+
+    bool      pressed()        const { return pressed_; }
+    bool      inContact()      const { return inRun_; }
+    bool      satisfied()      const { return satisfied_; }
+    uint64_t  satisfiedAtUs()  const { return satisfiedAtUs_; }
+    uint64_t  contactStartUs() const { return contactAtUs_; }
+    FreqClass contactClass()   const { return satisfiedCls_; }
+
+    // Plus long contact valide de l'appui (en cours compris)
+    uint32_t longestContactUs() const {
+        uint64_t current = inRun_ ? runEndUs() - runStartUs_ : 0;
+        return (uint32_t)(current > longestUs_ ? current : longestUs_);
+    }
+
+private:
+    uint32_t maxGapUs() const {
+        return 2 * periodUs_ > gapUs_ ? 2 * periodUs_ : gapUs_;
+    }
+
+    // Demi-periode apres le dernier front valide
+    uint64_t runEndUs() const { return lastValidUs_ + periodUs_ / 2; }
+
+    void closeRun(uint64_t endUs) {
+        uint64_t len = endUs > runStartUs_ ? endUs - runStartUs_ : 0;
+        if (len > longestUs_) longestUs_ = len;
+        inRun_ = false;
+    }
+
+    const BandPlan* plan_ = nullptr;
+    uint32_t  tickHz_;
+    uint32_t  dwellUs_;
+    uint32_t  gapUs_;
+
+    bool      pressed_       = false;
+    bool      inRun_         = false;
+    bool      satisfied_     = false;
+    FreqClass cls_           = FreqClass::NONE;
+    FreqClass satisfiedCls_  = FreqClass::NONE;
+    uint32_t  periodUs_      = 0;
+    uint64_t  pressUs_       = 0;
+    uint64_t  runStartUs_    = 0;
+    uint64_t  lastValidUs_   = 0;
+    uint64_t  longestUs_     = 0;
+    uint64_t  satisfiedAtUs_ = 0;
+    uint64_t  contactAtUs_   = 0;
+};
+
+}  // namespace fencing
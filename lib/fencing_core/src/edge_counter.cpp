@@ -0,0 +1,48 @@
+// =============================================================================
+// edge_counter.cpp — Backend RP2040 du compteur de fronts (slice PWM)
+// =============================================================================
+
+#include "edge_counter.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/gpio.h>
+#include <hardware/pwm.h>
+
+namespace fencing {
+
+bool PwmSliceSource::begin(uint8_t pin) {
+    if (pwm_gpio_to_channel(pin) != PWM_CHAN_B)
+        return false;
+
+    slice_ = (uint8_t)pwm_gpio_to_slice_num(pin);
+
+    // Le compteur avance d'un pas par front montant sur l'entree B.
+    // Wrap au maximum : le rebouclage est gere par EdgeWindow (modulo 2^16).
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_mode(&config, PWM_DIV_B_RISING);
+    pwm_config_set_clkdiv(&config, 1.0f);
+    pwm_config_set_wrap(&config, 0xFFFF);
+    pwm_init(slice_, &config, false);
+
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+
+    pwm_set_counter(slice_, 0);
+    pwm_set_enabled(slice_, true);
+    active_ = true;
+    return true;
+}
+
+void PwmSliceSource::end() {
+    if (active_)
+        pwm_set_enabled(slice_, false);
+    active_ = false;
+}
+
+uint16_t PwmSliceSource::readRaw() const {
+    return (uint16_t)pwm_get_counter(slice_);
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,149 @@
+// =============================================================================
+// edge_counter.h — Comptage materiel des fronts montants (slice PWM RP2040)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Remplace l'ISR countPulse() (une interruption CPU par front montant) par
+//   le compteur d'un slice PWM configure en mode "B-input rising edge" : le
+//   compteur 16 bits du slice s'incremente tout seul a chaque front montant
+//   sur l'entree B. Cout CPU par front : zero. A 20 kHz l'ISR coutait
+//   20 000 interruptions/s au repos (saturation → watchdog reset, Phase 1.7).
+//
+// CONTRAINTE MATERIELLE :
+//   Seule l'entree B d'un slice (GPIO impair) peut cadencer le compteur.
+//   GP2 est le canal A du slice 1 → le comptage se fait sur GP3 (canal 1B),
+//   broche voisine sur le header (pin 4 = GP2, pin 5 = GP3). Un pont
+//   GP2 ↔ GP3 suffit ; la pull-down 10kΩ de la ligne B reste en place et
+//   GP2 est laisse en INPUT (haute impedance).
+//
+//   Ligne B (bleu) ───┬──── GP2 [pin 4] (INPUT, sans interruption)
+//                     ├──── GP3 [pin 5] (PWM 1B, compteur de fronts)
+//                   [10kΩ] pull-down
+//                     │
+//                    GND
+//
+// API (meme usage que pulseCount dans les sketches) :
+//
+//   Avant :                              Apres :
+//     noInterrupts();                      unsigned long count =
+//     unsigned long count = pulseCount;        edgeCounter.takePulseCount();
+//     pulseCount = 0;
+//     interrupts();
+//
+//   measuredFreqHz = windowFreqHz(count, elapsed);   // count * 1000 / elapsed
+//
+// Le compteur materiel n'est jamais remis a zero : takePulseCount() retourne
+// la difference depuis la lecture precedente, modulo 2^16. Il faut donc lire
+// au moins une fois toutes les 65 535 fronts (1.6 s a 40 kHz, 65 s a 1 kHz),
+// ce que toutes les fenetres de mesure (10-50 ms) respectent largement.
+//
+// DOUBLURE HOTE :
+//   FakeEdgeCounter remplace le slice PWM par un compteur 16 bits logiciel
+//   (addEdges()) pour verifier le calcul de fenetre sur Linux, y compris le
+//   rebouclage du compteur.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+// -----------------------------------------------------------------------------
+// Frequence (Hz) d'une fenetre de comptage : count * 1000 / elapsed_ms.
+// Calcul en 64 bits pour ne pas deborder sur les longues fenetres.
+// -----------------------------------------------------------------------------
+inline uint32_t windowFreqHz(uint32_t count, uint32_t elapsedMs) {
+    if (elapsedMs == 0) return 0;
+    return (uint32_t)(((uint64_t)count * 1000u) / elapsedMs);
+}
+
+// -----------------------------------------------------------------------------
+// Meme calcul sur une fenetre en µs (window_sampler.h), arrondi au Hz le plus
+// proche : 1000 fronts en 15 000 µs donnent 66 667 Hz, pas 66 000.
+// -----------------------------------------------------------------------------
+inline uint32_t windowFreqHzUs(uint32_t count, uint32_t elapsedUs) {
+    if (elapsedUs == 0) return 0;
+    return (uint32_t)(((uint64_t)count * 1000000u + elapsedUs / 2) / elapsedUs);
+}
+
+// -----------------------------------------------------------------------------
+// Calcul de fenetre sur un compteur 16 bits libre.
+// Source doit fournir : uint16_t readRaw() const;
+// -----------------------------------------------------------------------------
+template <typename Source>
+class EdgeWindow : public Source {
+public:
+    // Aligne la fenetre sur la valeur courante du compteur (debut de mesure)
+    void clear() { lastRaw_ = this->readRaw(); }
+
+    // Fronts depuis la derniere lecture, sans toucher a la fenetre
+    uint32_t peekPulseCount() const {
+        return (uint16_t)(this->readRaw() - lastRaw_);
+    }
+
+    // Fronts depuis la derniere lecture, puis debut d'une nouvelle fenetre
+    uint32_t takePulseCount() {
+        uint16_t now = this->readRaw();
+        uint16_t count = (uint16_t)(now - lastRaw_);
+        lastRaw_ = now;
+        return count;
+    }
+
+private:
+    uint16_t lastRaw_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Source materielle : compteur d'un slice PWM en mode B-input rising edge
+// -----------------------------------------------------------------------------
+class PwmSliceSource {
+public:
+    // Configure le slice de `pin` en compteur de fronts montants.
+    // Retourne false si `pin` n'est pas une entree B (GPIO impair).
+    bool begin(uint8_t pin);
+
+    // Arrete le comptage (le slice reste configure)
+    void end();
+
+    uint16_t readRaw() const;
+
+    uint8_t slice() const { return slice_; }
+
+private:
+    uint8_t slice_ = 0;
+    bool    active_ = false;
+};
+
+// -----------------------------------------------------------------------------
+// Source logicielle (doublure hote) : compteur 16 bits incremente a la main
+// -----------------------------------------------------------------------------
+class FakeSliceSource {
+public:
+    bool begin(uint8_t) { return true; }
+    void end() {}
+
+    uint16_t readRaw() const { return raw_; }
+
+    // Simule n fronts montants (rebouclage modulo 2^16 comme le materiel)
+    void addEdges(uint32_t n) { raw_ = (uint16_t)(raw_ + n); }
+
+    // Force la valeur brute (ex. juste avant le rebouclage)
+    void setRaw(uint16_t raw) { raw_ = raw; }
+
+private:
+    uint16_t raw_ = 0;
+};
+
+typedef EdgeWindow<PwmSliceSource>  PwmEdgeCounter;
+typedef EdgeWindow<FakeSliceSource> FakeEdgeCounter;
+
+// Compteur par defaut de la plateforme : slice PWM sur RP2040, doublure ailleurs
+#if defined(ARDUINO_ARCH_RP2040)
+typedef PwmEdgeCounter EdgeCounter;
+#else
+typedef FakeEdgeCounter EdgeCounter;
+#endif
+
+}  // namespace fencing
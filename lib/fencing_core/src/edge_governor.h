@@ -0,0 +1,182 @@
+// =============================================================================
+// edge_governor.h — Limiteur de debit des fronts de GP2 (tempetes)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   En Phase 1.7, 20 000 interruptions/s au repos saturaient le CPU (reset
+//   watchdog) ; le correctif etait de detacher l'interruption hors appui.
+//   Depuis, PIO + DMA chronometrent sans interruption, mais chaque periode
+//   recue passe encore par le detecteur (estimateur, dwell, trace) : un
+//   parasite a quelques MHz pendant l'appui ferait traiter un anneau PIO
+//   complet a chaque tour de loop1, et l'anneau deborderait entre deux
+//   lectures (periodes melangees).
+//
+// PRINCIPE : s'intercale entre le chronometre et TouchDetector (meme
+//   pollEdges(), meme tickHz()) et borne le travail par fenetre :
+//
+//   - comptage materiel : edgeCount() du chronometre (transferts DMA sur le
+//     Pico), zero CPU par front, lu une fois par appel
+//   - budget : au plus stormHz × windowUs fronts transmis par fenetre ;
+//     au-dela → TEMPETE : les periodes sont jetees (flush) sans etre lues,
+//     seul le compteur materiel donne le debit
+//   - debit sur la duree reelle de la fenetre : un appel en retard (loop1
+//     bloque quelques ms) allonge la fenetre au lieu d'y entasser les
+//     fronts de plusieurs fenetres, et ne passe pas pour une tempete ; il
+//     transmet au plus stormHz × retard fronts (borne par RING_SIZE)
+//   - reprise apres GOVERNOR_CALM_WINDOWS fenetres completes sous
+//     stormHz / 2 (hysteresis), premiere periode partielle ignoree
+//   - anneau depasse entre deux appels (plus de RING_SIZE fronts) : lot
+//     jete, compte dans overruns
+//
+//   Cout d'un appel en tempete : une lecture de compteur et un flush, quel
+//   que soit le debit d'entree. Hors tempete : au plus le budget par
+//   fenetre.
+//
+// MESURES (stats()) : tempetes, fronts transmis / jetes, debit max sur une
+//   fenetre (Hz) et charge = fronts transmis / budget sur la fenetre la plus
+//   chargee (pour mille). resetPeaks() a chaque STATUS.
+//
+// Timer : PioEdgeTimer / FakeEdgeTimer (edgeCount(), flush(), pollEdges()).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "classifier.h"
+#include "trace_ring.h"
+
+namespace fencing {
+
+const uint32_t GOVERNOR_WINDOW_US    = 1000;
+const uint8_t  GOVERNOR_CALM_WINDOWS = 5;
+
+// 4 fois la plus haute porteuse du plan (fronts parasites de contact
+// compris), au moins 20 kHz
+constexpr uint32_t GOVERNOR_STORM_HZ =
+    4u * detail::maxHiHz() > 20000u ? 4u * detail::maxHiHz() : 20000u;
+
+struct GovernorStats {
+    uint32_t storms;         // entrees en tempete
+    uint32_t overruns;       // anneau depasse entre deux appels
+    uint32_t delivered;      // fronts transmis au detecteur
+    uint32_t dropped;        // fronts jetes sans etre lus
+    uint32_t peakHz;         // debit max sur une fenetre complete
+    uint16_t loadPermille;   // fronts transmis / budget au prorata, fenetre la plus chargee
+};
+
+template <typename Timer>
+class EdgeGovernor {
+public:
+    explicit EdgeGovernor(Timer& timer, uint32_t stormHz = GOVERNOR_STORM_HZ,
+                          uint32_t windowUs = GOVERNOR_WINDOW_US)
+        : timer_(timer),
+          stormHz_(stormHz),
+          windowUs_(windowUs),
+          budget_((uint32_t)((uint64_t)stormHz * windowUs / 1000000u)) {}
+
+    uint32_t tickHz() const { return timer_.tickHz(); }
+
+    // Anneau du contexte qui appelle pollEdges() (coeur 1), nullptr pour aucun
+    void setTrace(TraceRing* trace) { trace_ = trace; }
+
+    // Meme contrat que Timer::pollEdges() ; rend 0 en tempete
+    template <typename Sink>
+    uint32_t pollEdges(Sink& sink, uint64_t nowUs) {
+        uint32_t total = timer_.edgeCount();
+        if (!started_) {
+            started_       = true;
+            seen_          = total;
+            windowStartUs_ = nowUs;
+        }
+        uint32_t fresh = total - seen_;
+        seen_ = total;
+
+        // Fronts arrives depuis l'appel precedent, donc dans la fenetre
+        // courante (elle commence a un appel). Fenetre echue : debit pris
+        // sur sa duree reelle ; un loop1 en retard de plusieurs fenetres ne
+        // concentre pas leurs fronts dans une seule.
+        windowEdges_ += fresh;
+        uint64_t elapsed = nowUs - windowStartUs_;
+        bool due = elapsed >= windowUs_;
+        if (!storm_ && (due ? (uint64_t)windowEdges_ * 1000000u > (uint64_t)stormHz_ * elapsed
+                            : windowEdges_ > budget_))
+            enterStorm(nowUs, windowEdges_);
+
+        uint32_t n = 0;
+        if (storm_ || fresh > Timer::RING_SIZE) {
+            if (!storm_) stats_.overruns++;
+            timer_.flush();
+            stats_.dropped += fresh;
+        } else {
+            n = timer_.pollEdges(sink, nowUs);
+            stats_.delivered += n;
+            windowDelivered_ += n;
+        }
+        if (due)
+            closeWindow(nowUs);
+        return n;
+    }
+
+    bool     storm() const { return storm_; }
+    uint32_t budget() const { return budget_; }        // fronts par fenetre
+    uint32_t rateHz() const { return rateHz_; }        // derniere fenetre complete
+    const GovernorStats& stats() const { return stats_; }
+
+    // Debut d'une periode de mesure (STATUS) : pics remis a zero
+    void resetPeaks() {
+        stats_.peakHz       = 0;
+        stats_.loadPermille = 0;
+    }
+
+private:
+    void closeWindow(uint64_t nowUs) {
+        uint64_t elapsed = nowUs - windowStartUs_;
+        rateHz_ = (uint32_t)((uint64_t)windowEdges_ * 1000000u / elapsed);
+        if (rateHz_ > stats_.peakHz)
+            stats_.peakHz = rateHz_;
+        // Budget au prorata de la duree reelle de la fenetre
+        uint64_t allowed = (uint64_t)stormHz_ * elapsed / 1000000u;
+        uint32_t load = allowed ? (uint32_t)((uint64_t)windowDelivered_ * 1000u / allowed) : 0;
+        if (load > stats_.loadPermille)
+            stats_.loadPermille = (uint16_t)(load > 0xFFFF ? 0xFFFF : load);
+
+        if (storm_) {
+            calm_ = rateHz_ * 2u < stormHz_ ? (uint8_t)(calm_ + 1) : 0;
+            if (calm_ >= GOVERNOR_CALM_WINDOWS) {
+                storm_ = false;
+                timer_.flush();
+            }
+        }
+        windowStartUs_   = nowUs;
+        windowEdges_     = 0;
+        windowDelivered_ = 0;
+    }
+
+    void enterStorm(uint64_t nowUs, uint32_t edges) {
+        storm_ = true;
+        calm_  = 0;
+        stats_.storms++;
+        if (trace_)
+            trace_->trigger(nowUs, TraceAnomaly::EDGE_STORM, traceSaturate(edges));
+    }
+
+    Timer&        timer_;
+    TraceRing*    trace_ = nullptr;
+    uint32_t      stormHz_;
+    uint32_t      windowUs_;
+    uint32_t      budget_;
+    GovernorStats stats_ = {};
+
+    bool     started_         = false;
+    bool     storm_           = false;
+    uint8_t  calm_            = 0;      // fenetres calmes consecutives en tempete
+    uint32_t seen_            = 0;      // edgeCount() au dernier appel
+    uint64_t windowStartUs_   = 0;
+    uint32_t windowEdges_     = 0;      // compteur materiel, fenetre courante
+    uint32_t windowDelivered_ = 0;
+    uint32_t rateHz_          = 0;
+};
+
+}  // namespace fencing
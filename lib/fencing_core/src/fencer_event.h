@@ -0,0 +1,49 @@
+// =============================================================================
+// fencer_event.h — Evenements du coeur de detection (coeur 1 → coeur 0)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Produits par TouchDetector sur le coeur 1, consommes par le coeur 0 qui
+// les affiche (puis les enverra au central). Taille fixe, copie par valeur
+// dans SpscQueue.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "freq_plan.h"
+#include "latency_probe.h"
+
+namespace fencing {
+
+// Valeurs figees : elles sont transmises telles quelles (touch_wire.h)
+enum class FencerEventType : uint8_t {
+    BUTTON_DOWN = 0,    // appui filtre
+    DECISION    = 1,    // frequence stable pendant l'appui (contact continu)
+    TOUCH       = 2,    // relachement : classification finale + duree d'appui
+    STATUS      = 3,    // periodique : sante de la boucle du coeur 1
+    DWELL       = 4,    // 15 ms de contact valide continu acquis (pendant l'appui) ;
+                        // classe NONE : 15 ms d'appui sans porteuse (blanche)
+    CALIBRATION = 5,    // echantillon de calibration (carrier_calibration.h),
+                        // local au tireur : jamais transmis
+};
+
+struct FencerEvent {
+    FencerEventType type;
+    FreqClass       cls;       // DECISION, TOUCH (NONE : touche blanche), DWELL ;
+                               // CALIBRATION : porteuse de l'etape
+    uint16_t        seq;       // numero d'evenement, trou = file pleine
+    uint64_t        tUs;       // instant (µs depuis le demarrage) ; DWELL :
+                               // debut du contact (blanche : de l'appui) + 15 ms
+    uint32_t        freqHz;    // DECISION, TOUCH, CALIBRATION ; STATUS : debit max
+                               // des fronts de GP2 sur une fenetre (edge_governor.h)
+    uint32_t        value;     // TOUCH : duree d'appui (us) ; STATUS : boucle
+                               // max (us) ; DWELL : retard de la declaration (us) ;
+                               // DECISION : confiance (pour mille) ;
+                               // CALIBRATION : numero d'appui
+    LatencyStamps   lat;       // DECISION, DWELL, TOUCH : premier front de GP2
+                               // → etapes (latency_probe.h)
+};
+
+}  // namespace fencing
@@ -0,0 +1,317 @@
+// =============================================================================
+// fencer_node.h — Boucles du firmware tireur, sans Serial ni WiFi
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Le corps de loop1() et de loop() de fencer_firmware, tel quel : le sketch
+// garde les broches, l'affichage, la machine de calibration (lignes Serial),
+// le vidage des traces et l'association WiFi ; host_tools boutsim instancie
+// deux FencerNode sur la HAL simulee. L'assaut simule verifie ce code-ci,
+// pas une copie.
+//
+//   Coeur 1   loop1(ButtonSampler&)        Mode Simple : bascules antidatees
+//             loop1(const TimeDivision&)   Mode Time-Division : etat du cycle
+//             mode detection / calibration et nouveau plan entre deux appuis,
+//             note d'amplitude (setAmplitude), TouchDetector ou
+//             CalibrationSampler, puits numerote → file, STATUS chaque
+//             FENCER_STATUS_PERIOD_MS, anomalie sur tour trop long
+//
+//   Coeur 0   pop()          evenement suivant : pertes comptees, DWELL /
+//                            TOUCH envoyes au central (lien associe)
+//             serviceLink()  acquittements, relances, synchro d'horloge
+//
+// Partage entre les coeurs : la file d'evenements, l'etape de calibration
+// (setCalibrationTarget) et le plan de bandes (publishPlan), ecrits par le
+// coeur 0 et lus par le coeur 1 entre deux appuis.
+//
+// Timer : PioEdgeTimer / FakeEdgeTimer ; Link : UdpLink, NoLink (firmware
+// sans -DFENCER_LINK) ou le lien simule de boutsim.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "adc_capture.h"
+#include "amplitude_meter.h"
+#include "band_plan.h"
+#include "button_sampler.h"
+#include "carrier_calibration.h"
+#include "clock_sync.h"
+#include "double_buffer.h"
+#include "edge_governor.h"
+#include "fencer_event.h"
+#include "hal.h"
+#include "latency_probe.h"
+#include "spsc_queue.h"
+#include "time_division.h"
+#include "touch_detector.h"
+#include "touch_link.h"
+#include "touch_wire.h"
+#include "trace_ring.h"
+#include "udp_link.h"
+
+namespace fencing {
+
+const uint32_t FENCER_STATUS_PERIOD_MS = 1000;   // STATUS du coeur 1
+const uint32_t FENCER_EVENT_QUEUE      = 32;     // ~30 touches d'avance pour le coeur 0
+const uint32_t FENCER_OVERRUN_US       = 1000;   // tour de loop1 anormal
+
+// Tireur sans liaison : rien ne part, rien n'arrive
+struct NoLink {
+    bool begin(uint16_t) { return false; }
+    void setPeer(const UdpPeer&) {}
+    bool sendEvent(const TouchEvent&) { return false; }
+    bool sendSyncRequest(const SyncExchange&) { return false; }
+    bool poll(LinkMessage&) { return false; }
+};
+
+template <typename Timer, typename Link>
+class FencerNode {
+public:
+    typedef SpscQueue<FencerEvent, FENCER_EVENT_QUEUE> EventQueue;
+
+    FencerNode(Timer& timer, Link& link, uint8_t player)
+        : timer_(timer), governor_(timer), link_(link), sender_(link), player_(player) {
+        sink_.node = this;
+    }
+
+    // -------------------------------------------------------------------------
+    // Coeur 1
+    // -------------------------------------------------------------------------
+
+    // Apres timer.begin() : cadence du chronometre. trace : anneau du coeur 1
+    // (detecteur, gouverneur, file), nullptr pour aucun.
+    void setup1(TraceRing* trace) {
+        trace_ = trace;
+        detector_.setTrace(trace);
+        governor_.setTrace(trace);
+        detector_.setTickHz(timer_.tickHz());
+        calibration_.setTickHz(timer_.tickHz());
+        lastStatusMs_ = hal::nowMs();
+    }
+
+    // ADC demarre (-DFENCER_ADC) : la note de contact multiplie la confiance
+    void setAmplitude(AdcCapture* adc, AmplitudeMeter* meter) {
+        adc_       = adc;
+        amplitude_ = meter;
+    }
+
+    // Mode Simple : GP16 par ButtonSampler, HIGH = bouton presse
+    void loop1(ButtonSampler& buttons) {
+        uint64_t t0 = beginLoop1();
+        ButtonEdge edge;
+        while (buttons.pop(edge)) {
+            buttonPressed_ = edge.pressed;
+            stepDetection(t0, edge.pressed, edge.tUs);
+        }
+        stepDetection(t0, buttonPressed_, t0);
+        endLoop1(t0);
+    }
+
+    // Mode Time-Division : bascule datee a ce tour, l'echantillon du cycle
+    // est au plus 10 ms avant
+    void loop1(const TimeDivision& cycle) {
+        uint64_t t0 = beginLoop1();
+        stepDetection(t0, cycle.pressed(), t0);
+        endLoop1(t0);
+    }
+
+    const TouchDetector& detector() const { return detector_; }
+
+    // -------------------------------------------------------------------------
+    // Coeur 0
+    // -------------------------------------------------------------------------
+
+    // Avant le premier envoi : anneau du coeur 0 (datagrammes, acquittements)
+    // et alea de demarrage (seq repart de 0 : le central le saura)
+    void setup(TraceRing* trace, uint32_t session) {
+        sender_.setTrace(trace);
+        sender_.setSession(session);
+    }
+
+    // Lien associe : socket ouverte, central comme destinataire
+    bool connect(uint16_t localPort, const UdpPeer& central) {
+        linkUp_ = link_.begin(localPort);
+        link_.setPeer(central);
+        return linkUp_;
+    }
+    bool linkUp() const { return linkUp_; }
+
+    // Evenement suivant de la file ; false si vide. Numerotation controlee,
+    // envoi au central avant que l'appelant n'affiche (Serial peut bloquer).
+    bool pop(FencerEvent& ev) {
+        if (!events_.pop(ev))
+            return false;
+        lostEvents_ += (uint16_t)(ev.seq - expectedSeq_);
+        expectedSeq_ = ev.seq + 1;
+        sendEvent(ev);
+        if (ev.type == FencerEventType::DWELL && ev.cls != FreqClass::NONE)
+            latency_.add(ev.lat);       // blanche : pas de front de GP2
+        return true;
+    }
+
+    void serviceLink() {
+        uint64_t now = hal::nowUs();
+        LinkMessage msg;
+        while (link_.poll(msg)) {
+            if (msg.kind == LinkKind::ACK && msg.player == player_)
+                sender_.onAck(msg.player, msg.seq, hal::nowUs());
+            else if (msg.kind == LinkKind::SYNC_REPLY && msg.sync.player == player_)
+                clockSync_.onReply(msg.sync, msg.rxUs);
+        }
+        sender_.poll(now);
+
+        SyncExchange req;
+        if (linkUp_ && clockSync_.poll(now, player_, req))
+            link_.sendSyncRequest(req);
+    }
+
+    // Etape de calibration (NONE : detection), posee par le coeur 1 au repos
+    void setCalibrationTarget(FreqClass target) {
+        calibrationTarget_.store((uint8_t)target, std::memory_order_release);
+    }
+    // Bandes du tireur : posees par le coeur 1 entre deux appuis
+    void publishPlan(const BandPlan& plan) { planBuffer_.publish(plan); }
+
+    const EventQueue&         events()     const { return events_; }
+    uint32_t                  lostEvents() const { return lostEvents_; }
+    const TouchSender<Link>&  sender()     const { return sender_; }
+    const ClockSync&          clockSync()  const { return clockSync_; }
+    const LatencyProbe&       latency()    const { return latency_; }
+
+private:
+    // Puits du detecteur : numerote les evenements et les pousse dans la file
+    struct Sink {
+        FencerNode* node;
+        uint16_t    seq = 0;
+
+        bool push(FencerEvent ev) {
+            ev.seq = seq++;
+            latencyMark(ev.lat, LatencyStage::ENQUEUED, hal::nowUs(), ev.tUs);
+            if (node->trace_)
+                node->trace_->record(ev.tUs, TraceTag::EVENT, (uint8_t)ev.type, ev.seq);
+            if (node->events_.push(ev))
+                return true;
+            if (node->trace_)
+                node->trace_->trigger(hal::nowUs(), TraceAnomaly::QUEUE_FULL, (uint8_t)ev.type);
+            return false;
+        }
+    };
+
+    uint64_t beginLoop1() {
+        uint64_t t0 = hal::nowUs();
+        updateMode();
+        updateContactQuality();
+        return t0;
+    }
+
+    void endLoop1(uint64_t t0) {
+        uint32_t now = (uint32_t)(t0 / 1000u);
+        if (now - lastStatusMs_ >= FENCER_STATUS_PERIOD_MS) {
+            lastStatusMs_ = now;
+            FencerEvent ev = {};
+            ev.type   = FencerEventType::STATUS;
+            ev.tUs    = t0;
+            ev.value  = loopMaxUs_;
+            ev.freqHz = governor_.stats().peakHz;
+            governor_.resetPeaks();
+            if (trace_)
+                trace_->record(t0, TraceTag::LOOP, 0, traceSaturate(loopMaxUs_));
+            sink_.push(ev);
+            loopMaxUs_ = 0;
+        }
+
+        uint32_t dt = (uint32_t)(hal::nowUs() - t0);
+        if (dt > loopMaxUs_)
+            loopMaxUs_ = dt;
+        if (dt > FENCER_OVERRUN_US && trace_)
+            trace_->trigger(t0, TraceAnomaly::OVERRUN, traceSaturate(dt));
+    }
+
+    // Entre deux appuis seulement : bascule detection / calibration, nouveau plan
+    void updateMode() {
+        FreqClass target = (FreqClass)calibrationTarget_.load(std::memory_order_acquire);
+        calibration_.setTarget(target);
+        if (detector_.pressed() || calibration_.pressed())
+            return;
+        calibrating_ = target != FreqClass::NONE;
+        if (!calibrating_ && planBuffer_.version() != planVersion_) {
+            planVersion_ = planBuffer_.version();
+            planBuffer_.read(activePlan_);
+            detector_.setPlan(&activePlan_);
+        }
+    }
+
+    // Avant le detecteur. Hors appui : anneau vide, note nulle (un appui ne
+    // decide pas avant sa premiere fenetre). Pendant l'appui : fenetres
+    // fermees → note du detecteur.
+    void updateContactQuality() {
+        if (!adc_)
+            return;
+        if (!detector_.pressed()) {
+            adc_->flush();
+            amplitude_->reset();
+            detector_.setContactQuality(0);
+            return;
+        }
+        adc_->poll(*amplitude_);
+        AmplitudeStats a;
+        if (amplitude_->takeWindow(a))
+            detector_.setContactQuality(contactQuality(a));
+    }
+
+    void stepDetection(uint64_t nowUs, bool pressed, uint64_t edgeUs) {
+        if (calibrating_)
+            calibration_.step(nowUs, pressed, edgeUs, governor_, sink_);
+        else
+            detector_.stepFiltered(nowUs, pressed, edgeUs, governor_, sink_);
+    }
+
+    // Seuls DWELL et TOUCH interessent l'arbitrage ; avant l'association,
+    // perdus. Avant la premiere synchro, l'horloge locale part avec
+    // syncUs = NONE. L'emission est estampillee avant la conversion d'horloge.
+    void sendEvent(FencerEvent& ev) {
+        if (!linkUp_ || (ev.type != FencerEventType::DWELL && ev.type != FencerEventType::TOUCH))
+            return;
+        latencyMark(ev.lat, LatencyStage::UDP_TX, hal::nowUs(), ev.tUs);
+        TouchEvent out = toTouchEvent(ev, player_);
+        clockSync_.stamp(out);
+        sender_.send(out, hal::nowUs());
+    }
+
+    // --- Coeur 1 ---
+    Timer&                 timer_;
+    EdgeGovernor<Timer>    governor_;          // le detecteur ne lit GP2 que par lui
+    TouchDetector          detector_{ 0, 0 };  // bouton deja filtre (sampler ou cycle)
+    CalibrationSampler     calibration_;
+    bool                   calibrating_   = false;   // le sampler lit GP2 a la place du detecteur
+    BandPlan               activePlan_    = defaultBandPlan();
+    uint32_t               planVersion_   = 0;
+    bool                   buttonPressed_ = false;   // derniere bascule lue
+    AdcCapture*            adc_           = nullptr; // sans ADC : decision sur la seule confiance
+    AmplitudeMeter*        amplitude_     = nullptr;
+    TraceRing*             trace_         = nullptr;
+    Sink                   sink_;
+    uint32_t               loopMaxUs_     = 0;
+    uint32_t               lastStatusMs_  = 0;
+
+    // --- Partage ---
+    EventQueue             events_;
+    std::atomic<uint8_t>   calibrationTarget_{ (uint8_t)FreqClass::NONE };
+    DoubleBuffer<BandPlan> planBuffer_;
+
+    // --- Coeur 0 ---
+    Link&                  link_;
+    TouchSender<Link>      sender_;
+    ClockSync              clockSync_;
+    LatencyProbe           latency_;              // DWELL : premier front → etapes du tireur
+    uint8_t                player_;
+    bool                   linkUp_      = false;
+    uint16_t               expectedSeq_ = 0;
+    uint32_t               lostEvents_  = 0;
+};
+
+}  // namespace fencing
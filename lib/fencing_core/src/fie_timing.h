@@ -0,0 +1,62 @@
+// =============================================================================
+// fie_timing.h — Temps reglementaires FIE (fleuret) : dwell et lockout
+// Projet : Escrime sans fil
+// =============================================================================
+//
+//   Temps de contact minimum (dwell)    15 ms (±0.5 ms)
+//   Temps de blocage (lockout)          300-350 ms apres la 1ere touche
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+const uint32_t DWELL_MIN_MS       = 15;
+const uint32_t DWELL_MIN_US       = DWELL_MIN_MS * 1000u;
+const uint32_t DWELL_TOLERANCE_US = 500;
+const uint32_t LOCKOUT_MS         = 300;
+
+inline bool dwellSatisfied(uint32_t dwellMs) {
+    return dwellMs >= DWELL_MIN_MS;
+}
+
+inline bool dwellSatisfiedUs(uint32_t dwellUs) {
+    return dwellUs >= DWELL_MIN_US;
+}
+
+// -----------------------------------------------------------------------------
+// Fenetre de blocage : ouverte par la premiere touche, une touche arrivant
+// avant la fermeture compte encore (double touche), apres elle est ignoree.
+// -----------------------------------------------------------------------------
+class Lockout {
+public:
+    explicit Lockout(uint32_t durationMs = LOCKOUT_MS) : durationMs_(durationMs) {}
+
+    void reset() { armed_ = false; }
+
+    // Touche a l'instant tMs : true si elle est prise en compte
+    bool accept(uint32_t tMs) {
+        if (!armed_) {
+            armed_ = true;
+            startMs_ = tMs;
+            return true;
+        }
+        return tMs - startMs_ <= durationMs_;
+    }
+
+    bool armed() const { return armed_; }
+
+    // Fenetre ouverte et expiree a l'instant tMs (resultat a afficher)
+    bool expired(uint32_t tMs) const {
+        return armed_ && tMs - startMs_ > durationMs_;
+    }
+
+private:
+    uint32_t durationMs_;
+    uint32_t startMs_ = 0;
+    bool     armed_   = false;
+};
+
+}  // namespace fencing
@@ -0,0 +1,101 @@
+// =============================================================================
+// freq_plan.h — Plan de frequences commun (generateurs + recepteurs)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Source unique des frequences porteuses et de la tolerance de classification.
+// Avant : chaque sketch avait sa copie (et les copies avaient derive, ex.
+// FREQ_NEUTRE = 1000 etiquete "20 kHz" dans pico_generator).
+//
+// PLANS DISPONIBLES (choix a la compilation, build_flags de platformio.ini) :
+//
+//   (defaut)                   20 / 25 / 40 kHz, ±2 kHz
+//                              Plan valide en Phase 0 (fil direct, fil de corps)
+//
+//   -DFENCING_FREQ_PLAN_LOW    1 / 1.5 / 2.5 kHz, ±200 Hz
+//                              Candidat Phase 1.7bis (attenuation du fil interne
+//                              du fleuret, ~10 nF), a valider experimentalement
+//
+// FREQ_PLAN[] decrit les bandes de tolerance ; classifier.h en derive a la
+// compilation une table de correspondance. Changer de plan = modifier ce
+// fichier uniquement. Des bandes qui se chevauchent sont refusees a la
+// compilation (static_assert dans classifier.h).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+// Categories de frequence detectee sur la ligne B
+enum class FreqClass : uint8_t {
+    NONE,       // pas de signal       → touche blanche
+    NEUTRE,     // coque / piste       → pas de lumiere
+    VALID_A,    // cuirasse tireur A   → touche valide sur A
+    VALID_B,    // cuirasse tireur B   → touche valide sur B
+    UNKNOWN,    // hors de toutes les bandes
+};
+
+// Bande de tolerance d'une porteuse : [centre - tolerance, centre + tolerance]
+struct CarrierBand {
+    FreqClass   cls;
+    uint32_t    centerHz;
+    uint32_t    toleranceHz;
+    const char* label;
+
+    constexpr uint32_t loHz() const { return centerHz - toleranceHz; }
+    constexpr uint32_t hiHz() const { return centerHz + toleranceHz; }
+};
+
+#if defined(FENCING_FREQ_PLAN_LOW)
+
+constexpr uint32_t FREQ_NEUTRE     = 1000;   // 1 kHz   — coque, piste
+constexpr uint32_t FREQ_VALID_A    = 1500;   // 1.5 kHz — cuirasse tireur A
+constexpr uint32_t FREQ_VALID_B    = 2500;   // 2.5 kHz — cuirasse tireur B
+constexpr uint32_t TOLERANCE       = 200;    // ±200 Hz
+constexpr uint32_t FREQ_MIN_DETECT = 300;    // en dessous : aucune frequence
+
+constexpr CarrierBand FREQ_PLAN[] = {
+    { FreqClass::NEUTRE,  FREQ_NEUTRE,  TOLERANCE, "NEUTRE  (1 kHz)"   },
+    { FreqClass::VALID_A, FREQ_VALID_A, TOLERANCE, "VALID_A (1.5 kHz)" },
+    { FreqClass::VALID_B, FREQ_VALID_B, TOLERANCE, "VALID_B (2.5 kHz)" },
+};
+
+#else
+
+constexpr uint32_t FREQ_NEUTRE     = 20000;  // 20 kHz — coque, piste
+constexpr uint32_t FREQ_VALID_A    = 25000;  // 25 kHz — cuirasse tireur A
+constexpr uint32_t FREQ_VALID_B    = 40000;  // 40 kHz — cuirasse tireur B
+constexpr uint32_t TOLERANCE       = 2000;   // ±2 kHz
+constexpr uint32_t FREQ_MIN_DETECT = 500;    // en dessous : aucune frequence
+
+constexpr CarrierBand FREQ_PLAN[] = {
+    { FreqClass::NEUTRE,  FREQ_NEUTRE,  TOLERANCE, "NEUTRE  (20 kHz)" },
+    { FreqClass::VALID_A, FREQ_VALID_A, TOLERANCE, "VALID_A (25 kHz)" },
+    { FreqClass::VALID_B, FREQ_VALID_B, TOLERANCE, "VALID_B (40 kHz)" },
+};
+
+#endif
+
+constexpr uint8_t FREQ_PLAN_SIZE = sizeof(FREQ_PLAN) / sizeof(FREQ_PLAN[0]);
+
+namespace detail {
+
+constexpr uint32_t maxCenterHz() {
+    uint32_t hi = 0;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].centerHz > hi) hi = FREQ_PLAN[i].centerHz;
+    return hi;
+}
+
+constexpr uint32_t minCenterHz() {
+    uint32_t lo = 0xFFFFFFFFu;
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (FREQ_PLAN[i].centerHz < lo) lo = FREQ_PLAN[i].centerHz;
+    return lo;
+}
+
+}  // namespace detail
+
+}  // namespace fencing
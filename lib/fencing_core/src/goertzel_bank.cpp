@@ -0,0 +1,159 @@
+// =============================================================================
+// goertzel_bank.cpp — Construction des raies et DFT glissante par octet
+// =============================================================================
+
+#include "goertzel_bank.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace fencing {
+
+namespace {
+
+const double TWO_PI = 6.283185307179586;
+
+// cos sur 256 pas d'un tour, Q14 ; sin(x) = cos(x - quart de tour)
+int16_t cosQ14[256];
+bool    cosReady = false;
+
+void buildCos() {
+    if (cosReady) return;
+    for (int i = 0; i < 256; i++)
+        cosQ14[i] = (int16_t)lround(16384.0 * cos(TWO_PI * i / 256.0));
+    cosReady = true;
+}
+
+uint32_t absDiff(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+}  // namespace
+
+GoertzelBank::GoertzelBank(uint32_t sampleHz) : sampleHz_(sampleHz) {
+    buildCos();
+    memset(bins_, 0, sizeof(bins_));
+
+    // Raies candidates : harmoniques impaires sous Nyquist, sans voisine
+    // d'une autre porteuse a moins de la tolerance
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        for (uint8_t k = 0; k < GOERTZEL_HARMONICS; k++) {
+            uint8_t  h  = (uint8_t)(2 * k + 1);
+            uint32_t hz = h * FREQ_PLAN[b].centerHz;
+            if (2 * hz >= sampleHz_)
+                continue;
+            bool collide = false;
+            for (uint8_t o = 0; o < FREQ_PLAN_SIZE && !collide; o++) {
+                if (o == b) continue;
+                uint32_t tol = FREQ_PLAN[b].toleranceHz > FREQ_PLAN[o].toleranceHz
+                             ? FREQ_PLAN[b].toleranceHz : FREQ_PLAN[o].toleranceHz;
+                for (uint8_t k2 = 0; k2 < GOERTZEL_HARMONICS; k2++)
+                    if (absDiff(hz, (2u * k2 + 1) * FREQ_PLAN[o].centerHz) < tol)
+                        collide = true;
+            }
+            if (collide)
+                continue;
+            Bin& bin = bins_[binCount_++];
+            bin.band     = b;
+            bin.harmonic = h;
+            bin.hz       = hz;
+        }
+    }
+
+    // Fenetre : resolution = 1/4 du plus petit ecart entre raies de
+    // porteuses differentes
+    uint32_t spacing = sampleHz_;
+    for (uint8_t i = 0; i < binCount_; i++)
+        for (uint8_t j = 0; j < binCount_; j++)
+            if (bins_[i].band != bins_[j].band && absDiff(bins_[i].hz, bins_[j].hz) < spacing)
+                spacing = absDiff(bins_[i].hz, bins_[j].hz);
+    uint32_t samples = (uint32_t)((uint64_t)sampleHz_ * 4u / (spacing ? spacing : 1));
+    uint32_t words   = (samples + 31) / 32;
+    windowWords_ = (uint8_t)(words < 1 ? 1 : words > GOERTZEL_MAX_WINDOW_WORDS
+                                             ? GOERTZEL_MAX_WINDOW_WORDS : words);
+
+    // Carre ±1 sur N echantillons : |X_h| = N · 2 / (π h), en Q12
+    double n = 32.0 * windowWords_ * 4096.0;
+    for (uint8_t i = 0; i < binCount_; i++) {
+        Bin& bin = bins_[i];
+        bin.ideal = (uint32_t)lround(n * 2.0 / (TWO_PI / 2.0 * bin.harmonic));
+        double delta = TWO_PI * bin.hz / sampleHz_;           // par echantillon
+        bin.step8 = (uint32_t)(uint64_t)llround(8.0 * bin.hz / sampleHz_ * 4294967296.0);
+        for (int v = 0; v < 256; v++) {
+            double re = 0, im = 0;
+            for (int s = 0; s < 8; s++) {
+                double x = (v >> s) & 1 ? 1.0 : -1.0;
+                re += x * cos(delta * s);
+                im -= x * sin(delta * s);
+            }
+            bin.table[v][0] = (int16_t)lround(re * 2048.0);
+            bin.table[v][1] = (int16_t)lround(im * 2048.0);
+        }
+    }
+}
+
+void GoertzelBank::reset() {
+    for (uint8_t i = 0; i < binCount_; i++) {
+        bins_[i].re = bins_[i].im = 0;
+        memset(bins_[i].words, 0, sizeof(bins_[i].words));
+    }
+    head_   = 0;
+    filled_ = 0;
+}
+
+void GoertzelBank::pushWord(uint32_t bits) {
+    for (uint8_t i = 0; i < binCount_; i++) {
+        Bin& bin = bins_[i];
+        int32_t  re = 0, im = 0;
+        uint32_t phase = bin.phase;
+        for (uint8_t k = 0; k < 4; k++) {
+            // e^(-jφ) · table[octet], φ = phase du premier echantillon
+            uint8_t idx = (uint8_t)((phase + (1u << 23)) >> 24);
+            int32_t c   = cosQ14[idx];
+            int32_t s   = cosQ14[(uint8_t)(idx - 64)];
+            const int16_t* t = bin.table[(bits >> (8 * k)) & 0xFF];
+            re += (c * t[0] + s * t[1]) >> 13;
+            im += (c * t[1] - s * t[0]) >> 13;
+            phase += bin.step8;
+        }
+        bin.phase = phase;
+
+        int32_t* old = bin.words[head_];
+        bin.re += re - old[0];
+        bin.im += im - old[1];
+        old[0] = re;
+        old[1] = im;
+    }
+    head_ = (uint8_t)((head_ + 1) % windowWords_);
+    if (filled_ < 0xFFFF) filled_++;
+}
+
+void GoertzelBank::energies(CarrierEnergy out[FREQ_PLAN_SIZE]) const {
+    uint64_t got[FREQ_PLAN_SIZE]   = {};
+    uint64_t ideal[FREQ_PLAN_SIZE] = {};
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        out[b].cls       = FREQ_PLAN[b].cls;
+        out[b].permille  = 0;
+        out[b].harmonics = 0;
+    }
+    for (uint8_t i = 0; i < binCount_; i++) {
+        const Bin& bin = bins_[i];
+        got[bin.band]   += (uint64_t)((int64_t)bin.re * bin.re + (int64_t)bin.im * bin.im);
+        ideal[bin.band] += (uint64_t)bin.ideal * bin.ideal;
+        out[bin.band].harmonics++;
+    }
+    for (uint8_t b = 0; b < FREQ_PLAN_SIZE; b++) {
+        if (ideal[b] == 0) continue;
+        uint64_t p = (got[b] * 1000u + ideal[b] / 2) / ideal[b];
+        out[b].permille = (uint16_t)(p > 0xFFFF ? 0xFFFF : p);
+    }
+}
+
+FreqClass GoertzelBank::dominant(uint16_t minPermille) const {
+    CarrierEnergy e[FREQ_PLAN_SIZE];
+    energies(e);
+    uint8_t best = 0;
+    for (uint8_t b = 1; b < FREQ_PLAN_SIZE; b++)
+        if (e[b].permille > e[best].permille) best = b;
+    return e[best].permille >= minPermille ? e[best].cls : FreqClass::NONE;
+}
+
+}  // namespace fencing
@@ -0,0 +1,115 @@
+// =============================================================================
+// goertzel_bank.h — Banc de raies glissant sur le train de bits de GP2
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le plan a ecarte Goertzel (signal carre, energie dans les harmoniques),
+//   et le comptage de fronts suffit tant qu'une seule porteuse atteint GP2.
+//   En Mode Time-Division, la pointe adverse voit NEUTRE (coque) et VALID
+//   (cuirasse) a la fois, plus la fuite B↔C : deux porteuses superposees
+//   donnent des fronts melanges, aucune periode n'est coherente et le
+//   comptage ne peut pas les separer. Ce detecteur optionnel rend l'energie
+//   de chaque porteuse du plan, meme melangees.
+//
+// PRINCIPE :
+//   Entree : GP2 echantillonne par PioBitSampler (1 bit = niveau, ±1), mots
+//   de 32 echantillons. Une raie par porteuse et par harmonique impaire
+//   (1, 3, 5 : un carre n'a que celles-la, en 1/h) : c'est la sortie d'un
+//   Goertzel sur la fenetre, calculee sous forme de DFT glissante.
+//
+//   Un Goertzel par bit couterait une multiplication par raie et par
+//   echantillon. Sur un train de bits, un octet (8 echantillons) n'a que 256
+//   valeurs : pour chaque raie, table[octet] = Σ x_i e^(-j·i·δ) (Q11) est
+//   calculee a la construction, et l'octet n'est plus qu'une lecture de table
+//   tournee par la phase de son premier echantillon (cos / sin Q14 sur 256
+//   pas, 4 multiplications). Les sommes par mot (phase absolue, donc
+//   coherentes) alimentent une fenetre glissante de windowWords() mots :
+//   somme courante, ajout du nouveau mot, retrait du plus ancien.
+//
+//   Raies gardees : sous Nyquist, et pas a moins de la tolerance du plan
+//   d'une raie d'une autre porteuse (plan LOW : 7.5 kHz = 5 × 1.5 = 3 × 2.5,
+//   ecartee des deux cotes). Fenetre : 4 × sampleHz / plus petit ecart entre
+//   raies de porteuses differentes (resolution = ecart / 4).
+//
+//     plan par defaut : 640 kHz, 9 raies, fenetre 16 mots (0.8 ms)
+//     plan LOW        :  40 kHz, 7 raies, fenetre 10 mots (8 ms)
+//
+// SORTIE : par porteuse, energie sur ses raies gardees rapportee a celle
+//   d'un carre plein echelle a la meme frequence (pour mille) : ~1000 pour
+//   une porteuse seule, partage quand deux porteuses se superposent.
+//
+// COUT (par mot) : 4 × raies × (2 lectures de table, 2 de cos / sin,
+//   4 multiplications) + la fenetre. Mesure sur hote et budget Cortex-M0+ :
+//   host_tools goertzel. Memoire : ~1.3 Ko par raie.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "freq_plan.h"
+
+namespace fencing {
+
+const uint8_t  GOERTZEL_HARMONICS        = 3;      // 1, 3, 5
+const uint8_t  GOERTZEL_MAX_BINS         = FREQ_PLAN_SIZE * GOERTZEL_HARMONICS;
+const uint8_t  GOERTZEL_MAX_WINDOW_WORDS = 32;
+const uint16_t GOERTZEL_PRESENT_PERMILLE = 100;    // porteuse presente
+
+// 16 echantillons par periode de la plus haute porteuse : sa 5e harmonique
+// reste sous Nyquist avec de la marge
+constexpr uint32_t GOERTZEL_SAMPLE_HZ = 16u * detail::maxCenterHz();
+
+struct CarrierEnergy {
+    FreqClass cls;
+    uint16_t  permille;     // energie / celle d'un carre plein echelle
+    uint8_t   harmonics;    // raies gardees pour cette porteuse
+};
+
+class GoertzelBank {
+public:
+    explicit GoertzelBank(uint32_t sampleHz = GOERTZEL_SAMPLE_HZ);
+
+    // Fenetre vide (debut d'appui)
+    void reset();
+
+    // 32 echantillons, bit 0 le plus ancien (PioBitSampler::poll)
+    void pushWord(uint32_t bits);
+
+    // Fenetre pleine
+    bool ready() const { return filled_ >= windowWords_; }
+
+    // Energie de chaque porteuse, dans l'ordre de FREQ_PLAN
+    void energies(CarrierEnergy out[FREQ_PLAN_SIZE]) const;
+
+    // Porteuse la plus forte si au moins minPermille, sinon NONE
+    FreqClass dominant(uint16_t minPermille = GOERTZEL_PRESENT_PERMILLE) const;
+
+    uint32_t sampleHz() const { return sampleHz_; }
+    uint8_t  windowWords() const { return windowWords_; }
+    uint8_t  bins() const { return binCount_; }
+    uint32_t binHz(uint8_t i) const { return bins_[i].hz; }
+
+private:
+    struct Bin {
+        uint8_t  band;                  // rang dans FREQ_PLAN
+        uint8_t  harmonic;              // 1, 3, 5
+        uint32_t hz;
+        uint32_t step8;                 // avance de phase par octet (2^32 = 1 tour)
+        uint32_t phase;                 // phase du prochain octet
+        int32_t  re, im;                // somme sur la fenetre (Q12)
+        uint32_t ideal;                 // |X| d'un carre plein echelle (Q12)
+        int16_t  table[256][2];         // octet → Σ x_i e^(-j·i·δ) (Q11)
+        int32_t  words[GOERTZEL_MAX_WINDOW_WORDS][2];
+    };
+
+    uint32_t sampleHz_;
+    uint8_t  windowWords_ = 1;
+    uint8_t  binCount_    = 0;
+    uint8_t  head_        = 0;
+    uint16_t filled_      = 0;
+    Bin      bins_[GOERTZEL_MAX_BINS];
+};
+
+}  // namespace fencing
@@ -0,0 +1,80 @@
+// =============================================================================
+// hal.h — Couche d'abstraction materielle (Pico W / hote)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Les briques de fencing_core n'appellent jamais Arduino ni le SDK Pico
+// directement : elles passent par ces fonctions. Deux implementations :
+//
+//   hal_rp2040.cpp   Pico W (core earlephilhower, hardware/pwm.h, ...)
+//   hal_native.cpp   hote Linux/macOS (env:native) : temps simule, broches
+//                    en memoire, pilotees par hal::sim
+//
+// Les compteurs de fronts (edge_counter.h, pio_edge_timer.h) suivent la
+// meme separation avec leurs doublures Fake*.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+namespace hal {
+
+const uint8_t PIN_COUNT = 30;   // GP0..GP29
+
+enum class Pull : uint8_t { NONE, UP, DOWN };
+
+// --- Temps ---
+uint32_t nowMs();
+uint64_t nowUs();
+
+// --- Alea de demarrage ---
+// Non nul, tire une fois : meme valeur jusqu'au prochain demarrage
+// (session des trames TouchEvent, touch_link.h)
+uint32_t bootNonce();
+
+// --- GPIO ---
+void pinInput(uint8_t pin, Pull pull);
+bool pinRead(uint8_t pin);
+void pinOutput(uint8_t pin, bool level);     // configure en sortie + niveau
+void pinWrite(uint8_t pin, bool level);
+
+// --- PWM : signal carre 50 % ---
+// Retourne la frequence reellement generee (Hz), 0 si impossible.
+uint32_t pwmStart(uint8_t pin, uint32_t freqHz);
+void     pwmStop(uint8_t pin);                // sortie forcee a LOW
+
+// Porte la sortie d'un PWM demarre sans toucher au slice : off → broche
+// reprise par le GPIO a LOW immediatement (pas d'attente de fin de periode),
+// on → sortie PWM retablie. Appelable depuis une interruption.
+void     pwmGate(uint8_t pin, bool on);
+
+#if !defined(ARDUINO)
+// -----------------------------------------------------------------------------
+// Pilotage de la simulation (hote uniquement)
+//
+// Plusieurs cartes dans le meme processus (deux tireurs et le central,
+// host_tools boutsim) : chacune a son temps et ses broches, les appels hal::
+// et sim:: portent sur la carte choisie. Carte 0 apres reset().
+// -----------------------------------------------------------------------------
+namespace sim {
+
+const uint8_t BOARD_COUNT = 4;
+
+void     reset();                             // toutes les cartes
+void     reboot();                            // carte choisie : nouvel alea de demarrage
+void     selectBoard(uint8_t board);          // ignore au-dela de BOARD_COUNT
+uint8_t  board();
+void     setTimeUs(uint64_t us);
+void     advanceUs(uint64_t us);
+void     setInput(uint8_t pin, bool level);   // niveau vu par pinRead()
+bool     output(uint8_t pin);                 // dernier niveau ecrit
+uint32_t pwmFreq(uint8_t pin);                // 0 si PWM arrete
+bool     pwmActive(uint8_t pin);              // PWM demarre et porte ouverte
+
+}  // namespace sim
+#endif
+
+}  // namespace hal
+}  // namespace fencing
@@ -0,0 +1,116 @@
+// =============================================================================
+// hal_native.cpp — HAL hote (env:native) : temps simule, broches en memoire
+// =============================================================================
+
+#include "hal.h"
+#include "pwm_planner.h"
+
+#if !defined(ARDUINO)
+
+namespace fencing {
+namespace hal {
+
+namespace {
+
+struct SimState {
+    uint64_t timeUs;
+    bool     input[PIN_COUNT];
+    bool     output[PIN_COUNT];
+    uint32_t pwmFreq[PIN_COUNT];
+    bool     pwmGated[PIN_COUNT];   // porte fermee par pwmGate(pin, false)
+    uint32_t nonce;                 // 0 : pas encore tire
+};
+
+// Une carte par Pico simule (host_tools boutsim) ; les appels hal:: portent
+// sur la carte choisie par sim::selectBoard()
+SimState boards[sim::BOARD_COUNT] = {};
+SimState* state = &boards[0];
+uint32_t  boots = 0;                // demarrages simules, tous confondus
+
+}  // namespace
+
+uint32_t nowMs() { return (uint32_t)(state->timeUs / 1000u); }
+uint64_t nowUs() { return state->timeUs; }
+
+// Deterministe (simulations rejouables) : melange du numero de demarrage
+uint32_t bootNonce() {
+    while (state->nonce == 0) {
+        uint32_t x = ++boots * 0x9E3779B9u;
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        state->nonce = x ^ (x >> 13);
+    }
+    return state->nonce;
+}
+
+void pinInput(uint8_t pin, Pull pull) {
+    if (pin >= PIN_COUNT) return;
+    state->input[pin] = (pull == Pull::UP);
+}
+
+bool pinRead(uint8_t pin) {
+    return pin < PIN_COUNT && state->input[pin];
+}
+
+void pinOutput(uint8_t pin, bool level) { pinWrite(pin, level); }
+
+void pinWrite(uint8_t pin, bool level) {
+    if (pin < PIN_COUNT) state->output[pin] = level;
+}
+
+uint32_t pwmStart(uint8_t pin, uint32_t freqHz) {
+    if (pin >= PIN_COUNT) return 0;
+    PwmPlan plan = planPwm(SYS_CLK_NOMINAL_HZ, freqHz);
+    state->pwmFreq[pin] = plan.ok ? plan.actualHz() : 0;
+    state->pwmGated[pin] = false;
+    return state->pwmFreq[pin];
+}
+
+void pwmStop(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    state->pwmFreq[pin] = 0;
+    state->output[pin] = false;
+}
+
+void pwmGate(uint8_t pin, bool on) {
+    if (pin >= PIN_COUNT) return;
+    state->pwmGated[pin] = !on;
+    if (!on) state->output[pin] = false;
+}
+
+namespace sim {
+
+void reset() {
+    for (SimState& b : boards) b = SimState();
+    state = &boards[0];
+}
+
+void reboot() { state->nonce = 0; }
+
+void selectBoard(uint8_t board) {
+    if (board < BOARD_COUNT) state = &boards[board];
+}
+
+uint8_t board() { return (uint8_t)(state - boards); }
+
+void setTimeUs(uint64_t us) { state->timeUs = us; }
+void advanceUs(uint64_t us) { state->timeUs += us; }
+
+void setInput(uint8_t pin, bool level) {
+    if (pin < PIN_COUNT) state->input[pin] = level;
+}
+
+bool output(uint8_t pin) { return pin < PIN_COUNT && state->output[pin]; }
+
+uint32_t pwmFreq(uint8_t pin) { return pin < PIN_COUNT ? state->pwmFreq[pin] : 0; }
+
+bool pwmActive(uint8_t pin) {
+    return pin < PIN_COUNT && state->pwmFreq[pin] != 0 && !state->pwmGated[pin];
+}
+
+}  // namespace sim
+
+}  // namespace hal
+}  // namespace fencing
+
+#endif  // !ARDUINO
@@ -0,0 +1,93 @@
+// =============================================================================
+// hal_rp2040.cpp — HAL Pico W (core earlephilhower)
+// =============================================================================
+
+#include "hal.h"
+#include "pwm_planner.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <Arduino.h>
+#include <hardware/clocks.h>
+#include <hardware/gpio.h>
+#include <hardware/pwm.h>
+#include <pico/rand.h>
+#include <pico/time.h>
+
+namespace fencing {
+namespace hal {
+
+uint32_t nowMs() { return millis(); }
+uint64_t nowUs() { return time_us_64(); }
+
+// pico_rand : bruit de l'oscillateur en anneau et compteurs, different a
+// chaque demarrage
+uint32_t bootNonce() {
+    static uint32_t nonce = 0;
+    while (nonce == 0)
+        nonce = get_rand_32();
+    return nonce;
+}
+
+void pinInput(uint8_t pin, Pull pull) {
+    switch (pull) {
+        case Pull::UP:   pinMode(pin, INPUT_PULLUP);   break;
+        case Pull::DOWN: pinMode(pin, INPUT_PULLDOWN); break;
+        default:         pinMode(pin, INPUT);          break;
+    }
+}
+
+bool pinRead(uint8_t pin) { return gpio_get(pin); }
+
+void pinOutput(uint8_t pin, bool level) {
+    pinMode(pin, OUTPUT);
+    gpio_put(pin, level);
+}
+
+void pinWrite(uint8_t pin, bool level) { gpio_put(pin, level); }
+
+// -----------------------------------------------------------------------------
+// PWM hardware : freq = clk_sys / (div * TOP), duty = TOP / 2
+// Diviseur 8.4 et TOP choisis par planPwm() (cf. pwm_planner.h)
+// -----------------------------------------------------------------------------
+uint32_t pwmStart(uint8_t pin, uint32_t freqHz) {
+    PwmPlan plan = planPwm(clock_get_hz(clk_sys), freqHz);
+    if (!plan.ok)
+        return 0;
+
+    uint sliceNum = pwm_gpio_to_slice_num(pin);
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, plan.divInt(), plan.divFrac());
+    pwm_config_set_wrap(&config, plan.wrap());
+    pwm_init(sliceNum, &config, false);
+
+    pwm_set_chan_level(sliceNum, pwm_gpio_to_channel(pin), plan.level());
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_set_enabled(sliceNum, true);
+
+    return plan.actualHz();
+}
+
+void pwmStop(uint8_t pin) {
+    pwm_set_enabled(pwm_gpio_to_slice_num(pin), false);
+    pinOutput(pin, false);
+}
+
+// Le slice continue de tourner : seule la fonction de la broche change.
+// Un changement de niveau PWM (pwm_set_chan_level) n'agirait qu'au wrap
+// suivant, jusqu'a une periode plus tard (1 ms a 1 kHz).
+void pwmGate(uint8_t pin, bool on) {
+    if (on) {
+        gpio_set_function(pin, GPIO_FUNC_PWM);
+    } else {
+        gpio_put(pin, false);
+        gpio_set_dir(pin, GPIO_OUT);
+        gpio_set_function(pin, GPIO_FUNC_SIO);
+    }
+}
+
+}  // namespace hal
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,186 @@
+// =============================================================================
+// lamp_panel.h — Lampes et buzzer du central (Phase 6)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Traduit les sorties de l'arbitre (referee.h) en trames NeoPixel et en
+//   son, sans jamais attendre le materiel :
+//     LIGHT    lampe du tireur mise a jour, buzzer BUZZER_US si elle s'allume
+//     VERDICT  lampes definitives, eteintes a echeance + REFEREE_HOLD_US
+//   apply() met l'etat a jour et lance la trame si la bande est libre ;
+//   sinon la trame attend service() (appele a chaque tour de loop). Deux
+//   decisions pendant une meme trame sont fusionnees : la suivante montre
+//   l'etat le plus recent.
+//
+// DISPOSITION (couleurs de l'appareil FIE) :
+//   pixels 0..7   tireur A (gauche) : rouge = valable, blanc = non valable
+//   pixels 8..15  tireur B (droite) : vert  = valable, blanc = non valable
+//   Luminosite LAMP_BRIGHTNESS / 255 (16 pixels blancs : ~0.25 A).
+//
+// LATENCE decision → premier photon : apply() date la decision ; la trame
+//   qui la montre rend son instant de photon (neopixel_strip.h). Au pire une
+//   trame est deja en cours : LAMP_MAX_LATENCY_US = 2 trames, latch compris
+//   (1.6 ms pour 16 pixels), plus l'attente du prochain service() si la
+//   bande etait occupee. Mesuree a chaque trame (stats()).
+//
+// TICKETS : apply() rend le numero de la decision ; shown(ticket) dit si une
+//   trame l'a montree, photonUs(ticket) son premier photon tant que la
+//   trame est parmi les LAMP_SHOWN_FRAMES dernieres (latency_probe.h).
+//
+// Strip  : PioNeoPixel / FakeNeoPixel
+// Buzzer : PwmBuzzer / FakeBuzzer
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "buzzer.h"
+#include "neopixel_strip.h"
+#include "referee.h"
+
+namespace fencing {
+
+const uint8_t  LAMP_PIXELS_PER_SIDE = 8;
+const uint16_t LAMP_PIXELS          = 2 * LAMP_PIXELS_PER_SIDE;
+const uint8_t  LAMP_BRIGHTNESS      = 64;
+const uint32_t LAMP_RGB_A           = 0xFF0000;   // rouge
+const uint32_t LAMP_RGB_B           = 0x00FF00;   // vert
+const uint32_t LAMP_RGB_OFF_TARGET  = 0xFFFFFF;   // blanc
+const uint32_t BUZZER_US            = 1000000;
+
+constexpr uint32_t LAMP_FRAME_US       = neoPixelFrameUs(LAMP_PIXELS);
+constexpr uint32_t LAMP_MAX_LATENCY_US = 2 * LAMP_FRAME_US;
+const uint8_t      LAMP_SHOWN_FRAMES   = 4;
+
+struct LampStats {
+    uint32_t decisions     = 0;   // apply() et extinctions
+    uint32_t frames        = 0;
+    uint32_t coalesced     = 0;   // decisions fusionnees dans une trame en attente
+    uint32_t lastLatencyUs = 0;   // decision la plus ancienne → photon
+    uint32_t maxLatencyUs  = 0;
+};
+
+// Trame de LAMP_PIXELS mots GRB pour les lampes de A et de B
+inline void renderLamps(Lamp a, Lamp b, uint32_t grb[LAMP_PIXELS]) {
+    const Lamp     lamps[2] = { a, b };
+    const uint32_t valid[2] = { LAMP_RGB_A, LAMP_RGB_B };
+    for (uint8_t side = 0; side < 2; side++) {
+        uint32_t rgb = lamps[side] == Lamp::VALID      ? valid[side]
+                     : lamps[side] == Lamp::OFF_TARGET ? LAMP_RGB_OFF_TARGET : 0;
+        uint32_t r = (rgb >> 16 & 0xFF) * LAMP_BRIGHTNESS / 255;
+        uint32_t g = (rgb >> 8 & 0xFF) * LAMP_BRIGHTNESS / 255;
+        uint32_t bl = (rgb & 0xFF) * LAMP_BRIGHTNESS / 255;
+        uint32_t w = neoPixelGrb(r << 16 | g << 8 | bl);
+        for (uint8_t i = 0; i < LAMP_PIXELS_PER_SIDE; i++)
+            grb[side * LAMP_PIXELS_PER_SIDE + i] = w;
+    }
+}
+
+template <typename Strip, typename Buzzer>
+class LampPanel {
+public:
+    LampPanel(Strip& strip, Buzzer& buzzer) : strip_(strip), buzzer_(buzzer) {}
+
+    // Sortie de l'arbitre, traitee a nowUs (horloge du central). Rend le
+    // ticket de la decision.
+    uint32_t apply(const RefereeOutput& o, uint64_t nowUs) {
+        if (o.kind == RefereeOutputKind::LIGHT) {
+            lamps_[o.player == PLAYER_B] = o.lamp;
+            if (o.lamp != Lamp::NONE) {
+                buzzer_.on(nowUs);
+                buzzerOffUs_ = nowUs + BUZZER_US;
+            }
+        } else {
+            lamps_[0] = o.lampA;
+            lamps_[1] = o.lampB;
+            offUs_    = o.atUs + REFEREE_HOLD_US;
+        }
+        changed(nowUs);
+        uint32_t ticket = stats_.decisions;
+        service(nowUs);
+        return ticket;
+    }
+
+    // Echeances (fin d'affichage, buzzer) et trame en attente ; O(pixels)
+    void service(uint64_t nowUs) {
+        if (offUs_ && nowUs >= offUs_) {
+            lamps_[0] = lamps_[1] = Lamp::NONE;
+            offUs_ = 0;
+            changed(nowUs);
+        }
+        if (buzzer_.isOn() && nowUs >= buzzerOffUs_)
+            buzzer_.off(nowUs);
+        if (!pending_ || strip_.busy(nowUs))
+            return;
+
+        uint32_t grb[LAMP_PIXELS];
+        renderLamps(lamps_[0], lamps_[1], grb);
+        uint64_t photonUs = strip_.show(grb, nowUs);
+        if (!photonUs)
+            return;
+        pending_ = false;
+        Shown& f = shown_[stats_.frames % LAMP_SHOWN_FRAMES];
+        f.lastTicket = stats_.decisions;
+        f.photonUs   = photonUs;
+        stats_.frames++;
+        stats_.lastLatencyUs = (uint32_t)(photonUs - pendingSinceUs_);
+        if (stats_.lastLatencyUs > stats_.maxLatencyUs)
+            stats_.maxLatencyUs = stats_.lastLatencyUs;
+    }
+
+    Lamp lamp(uint8_t player) const { return lamps_[player == PLAYER_B]; }
+    bool lit() const { return lamps_[0] != Lamp::NONE || lamps_[1] != Lamp::NONE; }
+    bool pending() const { return pending_; }
+
+    bool shown(uint32_t ticket) const {
+        return stats_.frames && ticket <= shown_[(stats_.frames - 1) % LAMP_SHOWN_FRAMES].lastTicket;
+    }
+
+    // Premier photon de la trame qui a montre ticket ; 0 si elle n'est pas
+    // encore partie ou plus gardee
+    uint64_t photonUs(uint32_t ticket) const {
+        uint32_t kept = stats_.frames < LAMP_SHOWN_FRAMES ? stats_.frames : LAMP_SHOWN_FRAMES;
+        for (uint32_t i = stats_.frames - kept; i < stats_.frames; i++) {
+            const Shown& f = shown_[i % LAMP_SHOWN_FRAMES];
+            if (ticket > f.lastTicket)
+                continue;
+            // La plus ancienne gardee : sa devanciere a pu montrer ticket
+            return i == 0 || i > stats_.frames - kept ? f.photonUs : 0;
+        }
+        return 0;
+    }
+
+    const LampStats& stats() const { return stats_; }
+    void resetPeaks() { stats_.maxLatencyUs = 0; }
+
+private:
+    struct Shown {
+        uint32_t lastTicket;      // derniere decision montree
+        uint64_t photonUs;
+    };
+
+    // La latence court depuis la plus ancienne decision pas encore affichee
+    void changed(uint64_t nowUs) {
+        stats_.decisions++;
+        if (pending_) {
+            stats_.coalesced++;
+            return;
+        }
+        pending_        = true;
+        pendingSinceUs_ = nowUs;
+    }
+
+    Strip&    strip_;
+    Buzzer&   buzzer_;
+    Lamp      lamps_[2]       = { Lamp::NONE, Lamp::NONE };
+    uint64_t  offUs_          = 0;     // fin d'affichage du verdict
+    uint64_t  buzzerOffUs_    = 0;
+    bool      pending_        = false;
+    uint64_t  pendingSinceUs_ = 0;
+    LampStats stats_;
+    Shown     shown_[LAMP_SHOWN_FRAMES] = {};
+};
+
+}  // namespace fencing
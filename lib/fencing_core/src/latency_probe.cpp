@@ -0,0 +1,108 @@
+// =============================================================================
+// latency_probe.cpp — Histogrammes de latence et ligne de STATUS
+// =============================================================================
+
+#include "latency_probe.h"
+
+#include <stdio.h>
+
+namespace fencing {
+
+const char* latencyStageText(LatencyStage st) {
+    switch (st) {
+        case LatencyStage::CLASSIFIED: return "classification";
+        case LatencyStage::DWELL:      return "dwell declare";
+        case LatencyStage::ENQUEUED:   return "file coeur 1";
+        case LatencyStage::UDP_TX:     return "emission UDP";
+        case LatencyStage::CENTRAL_RX: return "reception central";
+        case LatencyStage::DECISION:   return "decision arbitre";
+        case LatencyStage::LIGHT_ON:   return "lampe allumee";
+    }
+    return "?";
+}
+
+// Classe : valeur exacte sous 8, puis 8 classes par octave (les 3 bits qui
+// suivent le bit de poids fort)
+uint16_t LatencyHistogram::binOf(uint32_t us) {
+    if (us < (1u << LATENCY_SUB_BITS))
+        return (uint16_t)us;
+    uint8_t msb = 31;
+    while (!(us >> msb)) msb--;
+    uint8_t shift = msb - LATENCY_SUB_BITS;
+    return (uint16_t)(((msb - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS) +
+                      ((us >> shift) & ((1u << LATENCY_SUB_BITS) - 1)));
+}
+
+uint32_t LatencyHistogram::binHigh(uint16_t bin) {
+    if (bin < (1u << LATENCY_SUB_BITS))
+        return bin;
+    uint8_t  shift = (uint8_t)((bin >> LATENCY_SUB_BITS) - 1);
+    uint64_t low   = (uint64_t)((1u << LATENCY_SUB_BITS) + (bin & ((1u << LATENCY_SUB_BITS) - 1)))
+                     << shift;
+    return (uint32_t)(low + (1ull << shift) - 1);
+}
+
+uint32_t LatencyHistogram::percentile(uint16_t permille) const {
+    if (!count_)
+        return 0;
+    uint64_t rank = ((uint64_t)count_ * permille + 999) / 1000;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint16_t b = 0; b < LATENCY_BINS; b++) {
+        seen += counts_[b];
+        if (seen >= rank) {
+            uint32_t high = binHigh(b);
+            return high < max_ ? high : max_;
+        }
+    }
+    return max_;
+}
+
+void LatencyProbe::add(const LatencyStamps& s) {
+    events_++;
+    for (uint8_t i = 0; i < LATENCY_STAGES; i++)
+        if (latencyHas(s, (LatencyStage)i))
+            hist_[i].add(s.atUs[i]);
+}
+
+void LatencyProbe::await(const LatencyStamps& s, uint64_t eventUs, uint32_t ticket) {
+    if (!ticket) {
+        add(s);
+        return;
+    }
+    Waiting* slot = nullptr;
+    for (Waiting& w : waiting_) {
+        if (!w.ticket) { slot = &w; break; }
+        if (!slot || w.ticket < slot->ticket) slot = &w;
+    }
+    if (slot->ticket)
+        add(slot->stamps);        // plein : le plus ancien part sans sa lampe
+    slot->stamps  = s;
+    slot->eventUs = eventUs;
+    slot->ticket  = ticket;
+}
+
+uint8_t LatencyProbe::waiting() const {
+    uint8_t n = 0;
+    for (const Waiting& w : waiting_) n += w.ticket != 0;
+    return n;
+}
+
+void LatencyProbe::reset() {
+    for (LatencyHistogram& h : hist_) h.reset();
+    for (Waiting& w : waiting_) w.ticket = 0;
+    events_ = 0;
+}
+
+size_t formatLatencyLine(const LatencyProbe& p, LatencyStage st, char* buf, size_t cap) {
+    const LatencyHistogram& h = p.stage(st);
+    if (!h.count())
+        return 0;
+    int n = snprintf(buf, cap, "  %-18s n %lu | p50 %lu | p99 %lu | max %lu us\n",
+                     latencyStageText(st), (unsigned long)h.count(),
+                     (unsigned long)h.percentile(500), (unsigned long)h.percentile(990),
+                     (unsigned long)h.max());
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+}
+
+}  // namespace fencing
@@ -0,0 +1,195 @@
+// =============================================================================
+// latency_probe.h — Latence d'une touche, du premier front de GP2 a la lampe
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le plan n'avance que "2-10 ms typique" pour le WiFi ; personne ne sait
+//   combien de temps separe le premier front vu par la pointe de la lampe
+//   allumee au central, ni quelle etape coute quoi.
+//
+// ESTAMPILLES (LatencyStamps, portees par FencerEvent puis TouchEvent) :
+//   Ancre : premier front de GP2 de l'appui (date par pollEdges), gardee
+//   comme avance leadUs = tUs de l'evenement - premier front. Chaque etape
+//   est un ecart premier front → etape en µs :
+//
+//     CLASSIFIED  decision de frequence (TouchDetector, DECISION)   tireur
+//     DWELL       15 ms de contact declares (TouchDetector)         tireur
+//     ENQUEUED    poussee dans la file du coeur 1                   tireur
+//     UDP_TX      premiere copie confiee au lien (coeur 0)          tireur
+//     CENTRAL_RX  reception du datagramme                           central
+//     DECISION    retour de Referee::onEvent                        central
+//     LIGHT_ON    premier photon de la trame qui montre la lampe    central
+//
+//   Les etapes du tireur sont sur son horloge, celles du central sur la
+//   sienne : le premier front y est retrouve par tUs - leadUs, tUs etant
+//   converti par ClockSync (erreur : TouchEvent::syncUs). Sans synchro, les
+//   etapes du central ne sont pas marquees. Les etapes du tireur voyagent
+//   dans la trame (touch_wire.h, octets 26 a 45).
+//
+// HISTOGRAMMES (LatencyHistogram) : 8 classes par octave (erreur relative
+//   <= 12.5 %, borne haute de la classe rendue), de 0 a 2^32 µs, compteurs
+//   32 bits, sans tas. Un par etape dans LatencyProbe : p50 / p99 / max
+//   lus sur Serial (STATUS du tireur et du central).
+//
+// Seuls les DWELL sont agreges (c'est eux qui allument la lampe) ; DECISION
+// et TOUCH portent les memes estampilles, pour la trace.
+//
+// Verifie de bout en bout sur hote : host_tools e2e.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fencing {
+
+enum class LatencyStage : uint8_t {
+    CLASSIFIED = 0,
+    DWELL      = 1,
+    ENQUEUED   = 2,
+    UDP_TX     = 3,
+    CENTRAL_RX = 4,
+    DECISION   = 5,
+    LIGHT_ON   = 6,
+};
+
+const uint8_t  LATENCY_STAGES        = 7;
+const uint8_t  LATENCY_FENCER_STAGES = 4;            // CLASSIFIED .. UDP_TX, dans la trame
+const uint32_t LATENCY_NONE          = 0xFFFFFFFF;   // valeur absente (trame)
+const uint8_t  LATENCY_SUB_BITS      = 3;            // 8 classes par octave
+const uint16_t LATENCY_BINS          = (32 - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS;
+const uint8_t  LATENCY_WAITING       = 4;            // lampes attendues (central)
+
+struct LatencyStamps {
+    uint8_t  known;                       // bit 0 : ancre ; bit 1 + etape
+    uint32_t leadUs;                      // tUs de l'evenement - premier front
+    uint32_t atUs[LATENCY_STAGES];        // premier front → etape
+};
+
+const char* latencyStageText(LatencyStage st);
+
+inline bool latencyAnchored(const LatencyStamps& s) { return s.known & 1; }
+
+inline bool latencyHas(const LatencyStamps& s, LatencyStage st) {
+    return s.known & (2u << (uint8_t)st);
+}
+
+inline uint32_t latencyAt(const LatencyStamps& s, LatencyStage st) {
+    return latencyHas(s, st) ? s.atUs[(uint8_t)st] : LATENCY_NONE;
+}
+
+// Ecart brut (trame, copie) ; LATENCY_NONE efface l'etape
+inline void latencySet(LatencyStamps& s, LatencyStage st, uint32_t us) {
+    uint8_t bit = (uint8_t)(2u << (uint8_t)st);
+    s.known = us == LATENCY_NONE ? s.known & ~bit : s.known | bit;
+    s.atUs[(uint8_t)st] = us;
+}
+
+// Premier front a edgeUs, evenement date eventUs (meme horloge)
+inline void latencyAnchor(LatencyStamps& s, uint64_t edgeUs, uint64_t eventUs) {
+    s.known  = 0;
+    s.leadUs = 0;
+    if (eventUs < edgeUs || eventUs - edgeUs >= LATENCY_NONE)
+        return;
+    s.known  = 1;
+    s.leadUs = (uint32_t)(eventUs - edgeUs);
+}
+
+// Etape atteinte a nowUs, sur l'horloge de eventUs (tUs de l'evenement
+// porteur). Sans ancre : rien. Avant le premier front (ecart d'horloge
+// entre tireur et central) : 0.
+inline void latencyMark(LatencyStamps& s, LatencyStage st, uint64_t nowUs, uint64_t eventUs) {
+    if (!latencyAnchored(s))
+        return;
+    uint64_t edgeUs = eventUs - s.leadUs;
+    uint64_t us     = nowUs > edgeUs ? nowUs - edgeUs : 0;
+    latencySet(s, st, us >= LATENCY_NONE ? LATENCY_NONE - 1 : (uint32_t)us);
+}
+
+// -----------------------------------------------------------------------------
+// Histogramme logarithmique a classes fixes
+// -----------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    void add(uint32_t us) {
+        counts_[binOf(us)]++;
+        count_++;
+        if (us > max_) max_ = us;
+    }
+
+    void reset() {
+        for (uint32_t& c : counts_) c = 0;
+        count_ = 0;
+        max_   = 0;
+    }
+
+    uint32_t count() const { return count_; }
+    uint32_t max() const { return max_; }
+
+    // Borne haute de la classe du rang permille / 1000 (plafonnee au max
+    // exact) ; 0 si vide
+    uint32_t percentile(uint16_t permille) const;
+
+    static uint16_t binOf(uint32_t us);
+    static uint32_t binHigh(uint16_t bin);
+
+private:
+    uint32_t counts_[LATENCY_BINS] = {};
+    uint32_t count_ = 0;
+    uint32_t max_   = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Un histogramme par etape ; cote central, les evenements en attente de
+// leur lampe
+// -----------------------------------------------------------------------------
+class LatencyProbe {
+public:
+    // Chaque etape connue dans son histogramme
+    void add(const LatencyStamps& s);
+
+    // Central : evenement dont la lampe part avec la trame du ticket
+    // (LampPanel::apply) ; ticket 0 (pas de lampe) : ajoute tout de suite.
+    // Plus de LATENCY_WAITING en attente : le plus ancien est ajoute sans
+    // LIGHT_ON.
+    void await(const LatencyStamps& s, uint64_t eventUs, uint32_t ticket);
+
+    // A chaque tour de loop() du central, apres LampPanel::service()
+    template <typename Panel>
+    void settle(const Panel& panel) {
+        for (Waiting& w : waiting_) {
+            if (!w.ticket || !panel.shown(w.ticket))
+                continue;
+            uint64_t photonUs = panel.photonUs(w.ticket);
+            if (photonUs && latencyHas(w.stamps, LatencyStage::CENTRAL_RX))
+                latencyMark(w.stamps, LatencyStage::LIGHT_ON, photonUs, w.eventUs);
+            add(w.stamps);
+            w.ticket = 0;
+        }
+    }
+
+    const LatencyHistogram& stage(LatencyStage st) const { return hist_[(uint8_t)st]; }
+    uint32_t events() const { return events_; }
+    uint8_t  waiting() const;
+
+    void reset();
+
+private:
+    struct Waiting {
+        LatencyStamps stamps;
+        uint64_t      eventUs;
+        uint32_t      ticket = 0;
+    };
+
+    LatencyHistogram hist_[LATENCY_STAGES];
+    Waiting          waiting_[LATENCY_WAITING];
+    uint32_t         events_ = 0;
+};
+
+// Ligne de STATUS pour une etape : "  <etape> n <n> | p50 .. | p99 .. |
+// max .. us\n". Rend la longueur, 0 si l'etape est vide ou cap trop petit.
+size_t formatLatencyLine(const LatencyProbe& p, LatencyStage st, char* buf, size_t cap);
+
+}  // namespace fencing
@@ -0,0 +1,108 @@
+// =============================================================================
+// neopixel_strip.cpp — Backend RP2040 de la bande NeoPixel (PIO + DMA)
+// =============================================================================
+
+#include "neopixel_strip.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/pio.h>
+#include <hardware/pio_instructions.h>
+
+namespace fencing {
+
+static const uint32_t NEOPIXEL_CYCLES_PER_BIT = 10;   // T1 + T2 + T3
+
+// Programme decrit dans neopixel_strip.h (adresses relatives, relogees
+// par pio_add_program ; side-set obligatoire sur 1 bit)
+static uint16_t neoPixelInstr[4];
+
+static const pio_program_t* neoPixelProgram() {
+    static pio_program_t program = { neoPixelInstr, 4, -1 };
+    neoPixelInstr[0] = pio_encode_out(pio_x, 1)   | pio_encode_sideset(1, 0) | pio_encode_delay(2);
+    neoPixelInstr[1] = pio_encode_jmp_not_x(3)    | pio_encode_sideset(1, 1) | pio_encode_delay(1);
+    neoPixelInstr[2] = pio_encode_jmp(0)          | pio_encode_sideset(1, 1) | pio_encode_delay(4);
+    neoPixelInstr[3] = pio_encode_nop()           | pio_encode_sideset(1, 0) | pio_encode_delay(4);
+    return &program;
+}
+
+bool PioNeoPixel::begin(uint8_t pin, uint16_t pixels) {
+    PIO pio = pio0;
+    const pio_program_t* program = neoPixelProgram();
+    if (pixels == 0 || pixels > NEOPIXEL_MAX_PIXELS || !pio_can_add_program(pio, program))
+        return false;
+
+    sm_ = pio_claim_unused_sm(pio, false);
+    if (sm_ < 0)
+        return false;
+    dma_ = dma_claim_unused_channel(false);
+    if (dma_ < 0) {
+        pio_sm_unclaim(pio, sm_);
+        sm_ = -1;
+        return false;
+    }
+
+    offset_ = pio_add_program(pio, program);
+    pixels_ = pixels;
+
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm_, pin, 1, true);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset_, offset_ + 3);
+    sm_config_set_sideset(&c, 1, false, false);
+    sm_config_set_sideset_pins(&c, pin);
+    sm_config_set_out_shift(&c, false, true, 24);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    float div = (float)clock_get_hz(clk_sys) /
+                (1000000000.0f / NEOPIXEL_BIT_NS * NEOPIXEL_CYCLES_PER_BIT);
+    sm_config_set_clkdiv(&c, div);
+    pio_sm_init(pio, sm_, offset_, &c);
+
+    // DMA : buffer de la trame → FIFO TX, rearme a chaque show()
+    dma_channel_config dc = dma_channel_get_default_config(dma_);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm_, true));
+    dma_channel_configure(dma_, &dc, &pio->txf[sm_], frame_, pixels_, false);
+
+    doneUs_ = 0;
+    pio_sm_set_enabled(pio, sm_, true);
+    return true;
+}
+
+void PioNeoPixel::end() {
+    if (sm_ < 0)
+        return;
+    PIO pio = pio0;
+    dma_channel_abort(dma_);
+    dma_channel_unclaim(dma_);
+    pio_sm_set_enabled(pio, sm_, false);
+    pio_remove_program(pio, neoPixelProgram(), offset_);
+    pio_sm_unclaim(pio, sm_);
+    sm_  = -1;
+    dma_ = -1;
+}
+
+bool PioNeoPixel::busy(uint64_t nowUs) const {
+    return sm_ < 0 || dma_channel_is_busy(dma_) || nowUs < doneUs_;
+}
+
+uint64_t PioNeoPixel::show(const uint32_t* grb, uint64_t nowUs) {
+    if (busy(nowUs))
+        return 0;
+    // 24 bits utiles en poids fort : decalage vers la gauche, autopull a 24
+    for (uint16_t i = 0; i < pixels_; i++)
+        frame_[i] = grb[i] << 8;
+    dma_channel_transfer_from_buffer_now(dma_, frame_, pixels_);
+    // Duree exacte a l'horloge PIO : la FIFO se vide au rythme des bits
+    doneUs_ = nowUs + neoPixelFrameUs(pixels_);
+    return doneUs_;
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,138 @@
+// =============================================================================
+// neopixel_strip.h — Bande NeoPixel (WS2812) pilotee par PIO + DMA
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Une machine a etats PIO genere le signal WS2812 (800 kbit/s, un bit =
+//   10 cycles PIO), un canal DMA lui passe la trame depuis un buffer en RAM.
+//   show() copie la trame et lance le DMA puis rend la main : l'envoi de
+//   16 pixels (~0.4 ms) et le latch ne bloquent pas la boucle du central.
+//
+// PROGRAMME PIO (side-set 1 bit sur la broche de donnees, T1 = 2, T2 = 5,
+// T3 = 3 cycles, diviseur = clk_sys / (800 kHz × 10)) :
+//
+//   0: bitloop: out  x, 1        side 0 [T3 - 1]   ; bas, lit un bit
+//   1:          jmp  !x do_zero  side 1 [T1 - 1]   ; front montant
+//   2: do_one:  jmp  bitloop     side 1 [T2 - 1]   ; 1 : haut long
+//   3: do_zero: nop              side 0 [T2 - 1]   ; 0 : haut court
+//
+//   Mots de la FIFO : pixel GRB dans les 24 bits de poids fort, decalage
+//   vers la gauche, autopull a 24 bits.
+//
+// TEMPS : la duree d'une trame est exacte (horloge PIO) : n × 24 × 1.25 µs,
+//   plus NEOPIXEL_LATCH_US de niveau bas pour que les pixels affichent.
+//   show() rend l'instant ou la nouvelle trame est visible (premier
+//   photon) ; busy() est vrai jusque-la, une nouvelle trame attend.
+//
+// DOUBLURE HOTE :
+//   FakeNeoPixel enregistre chaque trame avec son instant de depart et de
+//   premier photon (NEOPIXEL_RECORDS dernieres trames), sur le temps fourni
+//   par l'appelant. Memes regles de busy() que la cible.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace fencing {
+
+const uint16_t NEOPIXEL_MAX_PIXELS = 64;
+const uint32_t NEOPIXEL_BIT_NS     = 1250;    // 800 kbit/s
+const uint32_t NEOPIXEL_LATCH_US   = 300;     // WS2812B recents : > 280 µs
+const uint8_t  NEOPIXEL_RECORDS    = 64;      // doublure hote
+
+// Trame de n pixels a l'ecran, latch compris (µs, arrondi au-dessus)
+constexpr uint32_t neoPixelFrameUs(uint16_t pixels) {
+    return ((uint32_t)pixels * 24u * NEOPIXEL_BIT_NS + 999u) / 1000u + NEOPIXEL_LATCH_US;
+}
+
+// Couleur 0xRRGGBB → mot GRB attendu par le WS2812
+constexpr uint32_t neoPixelGrb(uint32_t rgb) {
+    return ((rgb >> 8) & 0xFF) << 16 | ((rgb >> 16) & 0xFF) << 8 | (rgb & 0xFF);
+}
+
+// -----------------------------------------------------------------------------
+// Backend RP2040 : PIO + DMA
+// -----------------------------------------------------------------------------
+class PioNeoPixel {
+public:
+    // Reserve une SM sur pio0 et un canal DMA
+    bool begin(uint8_t pin, uint16_t pixels);
+    void end();
+
+    uint16_t pixels() const { return pixels_; }
+
+    // Trame en cours d'envoi ou latch pas encore ecoule
+    bool busy(uint64_t nowUs) const;
+
+    // Copie grb[0..pixels) (mots GRB) et lance l'envoi. Rend l'instant du
+    // premier photon, 0 si occupe (rien n'est envoye).
+    uint64_t show(const uint32_t* grb, uint64_t nowUs);
+
+private:
+    uint32_t frame_[NEOPIXEL_MAX_PIXELS];
+    uint16_t pixels_  = 0;
+    uint64_t doneUs_  = 0;      // fin du latch de la derniere trame
+    int      sm_      = -1;
+    int      dma_     = -1;
+    uint32_t offset_  = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Doublure hote : trames enregistrees avec leurs instants
+// -----------------------------------------------------------------------------
+struct NeoPixelRecord {
+    uint64_t startUs;           // depart du DMA
+    uint64_t photonUs;          // trame visible
+    uint32_t grb[NEOPIXEL_MAX_PIXELS];
+};
+
+class FakeNeoPixel {
+public:
+    bool begin(uint8_t, uint16_t pixels) {
+        pixels_ = pixels > NEOPIXEL_MAX_PIXELS ? NEOPIXEL_MAX_PIXELS : pixels;
+        return true;
+    }
+    void end() {}
+
+    uint16_t pixels() const { return pixels_; }
+
+    bool busy(uint64_t nowUs) const { return nowUs < doneUs_; }
+
+    uint64_t show(const uint32_t* grb, uint64_t nowUs) {
+        if (busy(nowUs))
+            return 0;
+        doneUs_ = nowUs + neoPixelFrameUs(pixels_);
+        NeoPixelRecord& r = records_[count_ % NEOPIXEL_RECORDS];
+        r.startUs  = nowUs;
+        r.photonUs = doneUs_;
+        memset(r.grb, 0, sizeof(r.grb));
+        memcpy(r.grb, grb, pixels_ * sizeof(uint32_t));
+        count_++;
+        return doneUs_;
+    }
+
+    // Trames envoyees depuis begin(), et les NEOPIXEL_RECORDS dernieres
+    // (i = 0 : la plus ancienne gardee)
+    uint32_t frames() const { return count_; }
+    uint32_t kept() const { return count_ < NEOPIXEL_RECORDS ? count_ : NEOPIXEL_RECORDS; }
+    const NeoPixelRecord& record(uint32_t i) const {
+        return records_[(count_ - kept() + i) % NEOPIXEL_RECORDS];
+    }
+
+private:
+    uint16_t       pixels_ = 0;
+    uint64_t       doneUs_ = 0;
+    uint32_t       count_  = 0;
+    NeoPixelRecord records_[NEOPIXEL_RECORDS];
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef PioNeoPixel NeoPixelStrip;
+#else
+typedef FakeNeoPixel NeoPixelStrip;
+#endif
+
+}  // namespace fencing
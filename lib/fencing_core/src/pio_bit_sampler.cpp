@@ -0,0 +1,99 @@
+// =============================================================================
+// pio_bit_sampler.cpp — Backend RP2040 de l'echantillonnage en bits (PIO + DMA)
+// =============================================================================
+
+#include "pio_bit_sampler.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/pio.h>
+#include <hardware/pio_instructions.h>
+
+namespace fencing {
+
+// Aligne sur sa taille en octets : le DMA reboucle sur les RING_BITS + 2
+// bits de poids faible de l'adresse d'ecriture.
+uint32_t PioBitSampler::ring_[PioBitSampler::RING_SIZE]
+    __attribute__((aligned(PioBitSampler::RING_SIZE * sizeof(uint32_t))));
+
+// Programme decrit dans pio_bit_sampler.h
+static uint16_t bitSamplerInstr[1];
+
+static const pio_program_t* bitSamplerProgram() {
+    static pio_program_t program = { bitSamplerInstr, 1, -1 };
+    bitSamplerInstr[0] = pio_encode_in(pio_pins, 1);
+    return &program;
+}
+
+bool PioBitSampler::begin(uint8_t pin, uint32_t sampleHz) {
+    PIO pio = pio0;
+    const pio_program_t* program = bitSamplerProgram();
+    if (sampleHz == 0 || !pio_can_add_program(pio, program))
+        return false;
+
+    sm_ = pio_claim_unused_sm(pio, false);
+    if (sm_ < 0)
+        return false;
+    dma_ = dma_claim_unused_channel(false);
+    if (dma_ < 0) {
+        pio_sm_unclaim(pio, sm_);
+        sm_ = -1;
+        return false;
+    }
+
+    offset_ = pio_add_program(pio, program);
+
+    // Diviseur 16.8 : une instruction (un echantillon) par pas du diviseur
+    uint32_t clk    = clock_get_hz(clk_sys);
+    uint64_t div256 = ((uint64_t)clk * 256u + sampleHz / 2) / sampleHz;
+    if (div256 < 256) div256 = 256;
+    if (div256 > 0xFFFFFF) div256 = 0xFFFFFF;
+    sampleHz_ = (uint32_t)((uint64_t)clk * 256u / div256);
+
+    pio_sm_set_consecutive_pindirs(pio, sm_, pin, 1, false);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset_, offset_);
+    sm_config_set_in_pins(&c, pin);
+    sm_config_set_in_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv_int_frac(&c, (uint16_t)(div256 >> 8), (uint8_t)(div256 & 0xFF));
+    pio_sm_init(pio, sm_, offset_, &c);
+
+    // DMA : FIFO RX → buffer circulaire, sans fin pratique (2^32 mots)
+    dma_channel_config dc = dma_channel_get_default_config(dma_);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, false);
+    channel_config_set_write_increment(&dc, true);
+    channel_config_set_ring(&dc, true, RING_BITS + 2);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm_, false));
+    dma_channel_configure(dma_, &dc, ring_, &pio->rxf[sm_], 0xFFFFFFFFu, true);
+
+    tail_ = 0;
+    pio_sm_set_enabled(pio, sm_, true);
+    return true;
+}
+
+void PioBitSampler::end() {
+    if (sm_ < 0)
+        return;
+    PIO pio = pio0;
+    pio_sm_set_enabled(pio, sm_, false);
+    dma_channel_abort(dma_);
+    dma_channel_unclaim(dma_);
+    pio_remove_program(pio, bitSamplerProgram(), offset_);
+    pio_sm_unclaim(pio, sm_);
+    sm_  = -1;
+    dma_ = -1;
+}
+
+uint32_t PioBitSampler::headIndex() const {
+    uintptr_t w = (uintptr_t)dma_channel_hw_addr(dma_)->write_addr;
+    return (uint32_t)((w - (uintptr_t)ring_) / sizeof(uint32_t)) & (RING_SIZE - 1);
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,132 @@
+// =============================================================================
+// pio_bit_sampler.h — Echantillonnage de GP2 en train de bits (PIO + DMA)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Une machine a etats PIO lit GP2 a cadence fixe (sampleHz) et empile un
+//   bit par echantillon ; tous les 32 echantillons le mot est pousse dans la
+//   FIFO RX (autopush). Un canal DMA vide la FIFO dans un buffer circulaire
+//   en RAM, comme PioEdgeTimer. Le CPU ne fait rien par echantillon : il lit
+//   les mots quand il veut (poll) et les passe au banc de raies
+//   (goertzel_bank.h).
+//
+// PROGRAMME PIO (une instruction, diviseur d'horloge = clk_sys / sampleHz) :
+//
+//   0:      in   pins, 1         ; 1 echantillon, autopush a 32 bits
+//
+//   Decalage vers la droite : le bit i du mot est l'echantillon i (ordre
+//   chronologique, bit 0 le plus ancien). Diviseur fractionnaire (1/256) :
+//   sampleHz() rend la cadence reellement obtenue.
+//
+// BUFFER :
+//   RING_SIZE mots de 32 echantillons, aligne sur sa taille (mode "ring" du
+//   DMA). A 640 kHz (plan par defaut) l'anneau couvre 12.8 ms ; poll() au
+//   moins une fois par tour de loop1 suffit largement.
+//
+// Coexiste avec PioEdgeTimer sur la meme broche (une SM chacun sur pio0, la
+// lecture des broches par le PIO ne change pas leur fonction).
+//
+// DOUBLURE HOTE :
+//   FakeBitSampler recoit des mots d'une trace synthetique (addWord) et les
+//   restitue par le meme poll().
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+// -----------------------------------------------------------------------------
+// Backend RP2040 : PIO + DMA
+// -----------------------------------------------------------------------------
+class PioBitSampler {
+public:
+    static const uint32_t RING_BITS = 8;                 // 256 mots
+    static const uint32_t RING_SIZE = 1u << RING_BITS;
+
+    // Reserve une SM sur pio0 et un canal DMA, demarre l'echantillonnage
+    bool begin(uint8_t pin, uint32_t sampleHz);
+    void end();
+
+    // Cadence reellement obtenue (diviseur arrondi au 1/256)
+    uint32_t sampleHz() const { return sampleHz_; }
+
+    // Transfere les mots recus depuis le dernier appel : sink.pushWord(bits).
+    // Retourne le nombre de mots transferes.
+    template <typename Sink>
+    uint32_t poll(Sink& sink) {
+        uint32_t n = 0;
+        uint32_t head = headIndex();
+        while (tail_ != head) {
+            sink.pushWord(ring_[tail_]);
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            n++;
+        }
+        return n;
+    }
+
+    // Ignore les mots en attente
+    void flush() { tail_ = headIndex(); }
+
+private:
+    uint32_t headIndex() const;
+
+    static uint32_t ring_[RING_SIZE];
+
+    uint32_t tail_     = 0;
+    uint32_t sampleHz_ = 0;
+    int      sm_       = -1;
+    int      dma_      = -1;
+    uint32_t offset_   = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Doublure hote : mots injectes a la main
+// -----------------------------------------------------------------------------
+class FakeBitSampler {
+public:
+    static const uint32_t RING_SIZE = PioBitSampler::RING_SIZE;
+
+    bool begin(uint8_t, uint32_t sampleHz) {
+        sampleHz_ = sampleHz;
+        return true;
+    }
+    void end() {}
+
+    uint32_t sampleHz() const { return sampleHz_; }
+
+    // 32 echantillons, bit 0 le plus ancien
+    void addWord(uint32_t bits) {
+        ring_[head_] = bits;
+        head_ = (head_ + 1) & (RING_SIZE - 1);
+    }
+
+    template <typename Sink>
+    uint32_t poll(Sink& sink) {
+        uint32_t n = 0;
+        while (tail_ != head_) {
+            sink.pushWord(ring_[tail_]);
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            n++;
+        }
+        return n;
+    }
+
+    void flush() { tail_ = head_; }
+
+private:
+    uint32_t sampleHz_ = 0;
+    uint32_t ring_[RING_SIZE] = {};
+    uint32_t head_ = 0;
+    uint32_t tail_ = 0;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef PioBitSampler BitSampler;
+#else
+typedef FakeBitSampler BitSampler;
+#endif
+
+}  // namespace fencing
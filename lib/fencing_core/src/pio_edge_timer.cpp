@@ -0,0 +1,108 @@
+// =============================================================================
+// pio_edge_timer.cpp — Backend RP2040 du chronometrage de periodes (PIO + DMA)
+// =============================================================================
+
+#include "pio_edge_timer.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/pio.h>
+#include <hardware/pio_instructions.h>
+
+namespace fencing {
+
+// Aligne sur sa taille en octets : le DMA reboucle sur les RING_BITS + 2
+// bits de poids faible de l'adresse d'ecriture.
+uint32_t PioEdgeTimer::ring_[PioEdgeTimer::RING_SIZE]
+    __attribute__((aligned(PioEdgeTimer::RING_SIZE * sizeof(uint32_t))));
+
+// Programme decrit dans pio_edge_timer.h (adresses relatives, relogees
+// par pio_add_program)
+static uint16_t edgeTimerInstr[8];
+
+static const pio_program_t* edgeTimerProgram() {
+    static pio_program_t program = { edgeTimerInstr, 8, -1 };
+    edgeTimerInstr[0] = pio_encode_mov_not(pio_x, pio_null);
+    edgeTimerInstr[1] = pio_encode_jmp_pin(3);
+    edgeTimerInstr[2] = pio_encode_jmp(4);
+    edgeTimerInstr[3] = pio_encode_jmp_x_dec(1);
+    edgeTimerInstr[4] = pio_encode_jmp_pin(6);
+    edgeTimerInstr[5] = pio_encode_jmp_x_dec(4);
+    edgeTimerInstr[6] = pio_encode_mov_not(pio_isr, pio_x);
+    edgeTimerInstr[7] = pio_encode_push(false, false);
+    return &program;
+}
+
+bool PioEdgeTimer::begin(uint8_t pin) {
+    PIO pio = pio0;
+    const pio_program_t* program = edgeTimerProgram();
+    if (!pio_can_add_program(pio, program))
+        return false;
+
+    sm_ = pio_claim_unused_sm(pio, false);
+    if (sm_ < 0)
+        return false;
+    dma_ = dma_claim_unused_channel(false);
+    if (dma_ < 0) {
+        pio_sm_unclaim(pio, sm_);
+        sm_ = -1;
+        return false;
+    }
+
+    offset_ = pio_add_program(pio, program);
+    tickHz_ = clock_get_hz(clk_sys);
+
+    // Entree seule : la fonction du GPIO et sa pull-down externe ne changent pas
+    pio_sm_set_consecutive_pindirs(pio, sm_, pin, 1, false);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset_, offset_ + 7);
+    sm_config_set_jmp_pin(&c, pin);
+    sm_config_set_in_shift(&c, false, false, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv(&c, 1.0f);
+    pio_sm_init(pio, sm_, offset_, &c);
+
+    // DMA : FIFO RX → buffer circulaire, sans fin pratique (2^32 periodes)
+    dma_channel_config dc = dma_channel_get_default_config(dma_);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, false);
+    channel_config_set_write_increment(&dc, true);
+    channel_config_set_ring(&dc, true, RING_BITS + 2);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm_, false));
+    dma_channel_configure(dma_, &dc, ring_, &pio->rxf[sm_], 0xFFFFFFFFu, true);
+
+    tail_ = 0;
+    skipFirst_ = true;
+    pio_sm_set_enabled(pio, sm_, true);
+    return true;
+}
+
+void PioEdgeTimer::end() {
+    if (sm_ < 0)
+        return;
+    PIO pio = pio0;
+    pio_sm_set_enabled(pio, sm_, false);
+    dma_channel_abort(dma_);
+    dma_channel_unclaim(dma_);
+    pio_remove_program(pio, edgeTimerProgram(), offset_);
+    pio_sm_unclaim(pio, sm_);
+    sm_  = -1;
+    dma_ = -1;
+}
+
+uint32_t PioEdgeTimer::edgeCount() const {
+    // Canal lance pour 0xFFFFFFFF transferts : chaque front en consomme un
+    return 0xFFFFFFFFu - (uint32_t)dma_channel_hw_addr(dma_)->transfer_count;
+}
+
+uint32_t PioEdgeTimer::headIndex() const {
+    uintptr_t w = (uintptr_t)dma_channel_hw_addr(dma_)->write_addr;
+    return (uint32_t)((w - (uintptr_t)ring_) / sizeof(uint32_t)) & (RING_SIZE - 1);
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,207 @@
+// =============================================================================
+// pio_edge_timer.h — Chronometrage des fronts montants par PIO + DMA
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Une machine a etats PIO chronometre chaque periode du signal sur GP2
+//   (temps entre deux fronts montants, en cycles d'horloge systeme) et la
+//   pousse dans sa FIFO RX. Un canal DMA vide la FIFO dans un buffer
+//   circulaire en RAM. Le CPU ne fait rien par front : il lit le buffer
+//   quand il veut (poll) et alimente un ReciprocalEstimator.
+//
+//   La somme cumulee des periodes donne l'horodatage de chaque front :
+//   pollEdges() date le dernier front recu a l'instant du poll et remonte
+//   les precedents periode par periode (exact au cycle entre eux ; erreur
+//   commune au plus le temps ecoule depuis le poll precedent).
+//
+// PROGRAMME PIO (x decremente toutes les 2 cycles tant que le front
+// suivant n'est pas arrive) :
+//
+//   0:      mov  x, ~null        ; x = 0xFFFFFFFF
+//   1: hi:  jmp  pin, hi_dec     ; signal haut → continuer a attendre
+//   2:      jmp  lo              ; signal bas → attendre le front montant
+//   3: hi_dec: jmp x--, hi
+//   4: lo:  jmp  pin, rise       ; front montant
+//   5:      jmp  x--, lo
+//   6: rise: mov isr, ~x         ; isr = nombre de decrements n
+//   7:      push noblock         ; (wrap → 0)
+//
+//   Periode = 2n + 6 cycles (2 cycles par iteration, 6 cycles fixes :
+//   instructions 0, 1+2 en sortie de hi, 4 en sortie de lo, 6, 7).
+//   Incertitude : ±1 cycle (synchronisation d'entree), soit 8 ns a 125 MHz.
+//
+// BUFFER :
+//   RING_SIZE mots de 32 bits, aligne sur sa taille (contrainte du mode
+//   "ring" du DMA). Il faut appeler poll() au moins une fois tous les
+//   RING_SIZE fronts (85 ms a 3 kHz), sinon les plus anciens sont ecrases.
+//
+// DOUBLURE HOTE :
+//   FakeEdgeTimer recoit les periodes d'une trace synthetique (addPeriod)
+//   et les restitue par le meme poll().
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "reciprocal_meter.h"
+
+namespace fencing {
+
+// -----------------------------------------------------------------------------
+// Backend RP2040 : PIO + DMA
+// -----------------------------------------------------------------------------
+class PioEdgeTimer {
+public:
+    static const uint32_t RING_BITS = 8;                 // 256 periodes
+    static const uint32_t RING_SIZE = 1u << RING_BITS;
+
+    // Periode en cycles a partir de la valeur poussee par le PIO
+    static uint32_t samplesToCycles(uint32_t n) { return 2u * n + 6u; }
+
+    // Reserve une SM sur pio0 et un canal DMA, demarre la mesure sur `pin`.
+    bool begin(uint8_t pin);
+    void end();
+
+    // Frequence d'horloge des periodes (clk_sys)
+    uint32_t tickHz() const { return tickHz_; }
+
+    // Fronts recus depuis begin(), modulo 2^32 : transferts du DMA, sans
+    // CPU par front (edge_governor.h)
+    uint32_t edgeCount() const;
+
+    // Transfere les periodes recues depuis le dernier appel dans `est`
+    // (ReciprocalEstimator, PeriodStats : tout type avec pushPeriod(ticks)).
+    // Retourne le nombre de periodes transferees.
+    template <typename Sink>
+    uint32_t poll(Sink& est) {
+        uint32_t n = 0;
+        uint32_t head = headIndex();
+        while (tail_ != head) {
+            uint32_t p = samplesToCycles(ring_[tail_]);
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            if (skipFirst_) {          // premiere periode : partielle
+                skipFirst_ = false;
+                continue;
+            }
+            est.pushPeriod(p);
+            n++;
+        }
+        return n;
+    }
+
+    // Comme poll(), mais chaque front est date en µs : sink.pushEdge(tUs,
+    // ticks) avec la periode qui se termine a ce front. nowUs : time_us_64()
+    // au moment de l'appel.
+    template <typename Sink>
+    uint32_t pollEdges(Sink& sink, uint64_t nowUs) {
+        uint32_t head = headIndex();
+        uint64_t pending = 0;
+        for (uint32_t i = tail_; i != head; i = (i + 1) & (RING_SIZE - 1))
+            pending += samplesToCycles(ring_[i]);
+
+        uint32_t n = 0;
+        while (tail_ != head) {
+            uint32_t p = samplesToCycles(ring_[tail_]);
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            pending -= p;
+            if (skipFirst_) {
+                skipFirst_ = false;
+                continue;
+            }
+            sink.pushEdge(nowUs - pending * 1000000u / tickHz_, p);
+            n++;
+        }
+        return n;
+    }
+
+    // Ignore les periodes en attente et celle a cheval sur l'appel
+    // (ex. au debut d'une mesure, quand le bouton vient d'etre presse)
+    void flush() {
+        tail_ = headIndex();
+        skipFirst_ = true;
+    }
+
+private:
+    uint32_t headIndex() const;
+
+    static uint32_t ring_[RING_SIZE];
+
+    uint32_t tail_      = 0;
+    uint32_t tickHz_    = 0;
+    int      sm_        = -1;
+    int      dma_       = -1;
+    uint32_t offset_    = 0;
+    bool     skipFirst_ = true;
+};
+
+// -----------------------------------------------------------------------------
+// Doublure hote : periodes injectees a la main
+// -----------------------------------------------------------------------------
+class FakeEdgeTimer {
+public:
+    static const uint32_t RING_SIZE = PioEdgeTimer::RING_SIZE;
+
+    explicit FakeEdgeTimer(uint32_t tickHz = 1000000000u) : tickHz_(tickHz) {}
+
+    bool begin(uint8_t) { return true; }
+    void end() {}
+
+    uint32_t tickHz() const { return tickHz_; }
+
+    uint32_t edgeCount() const { return edges_; }
+
+    // Simule un front montant `ticks` apres le precedent (au-dela de
+    // RING_SIZE non lus, les plus anciens sont ecrases comme par le DMA)
+    void addPeriod(uint32_t ticks) {
+        ring_[head_] = ticks;
+        head_ = (head_ + 1) & (RING_SIZE - 1);
+        edges_++;
+    }
+
+    template <typename Sink>
+    uint32_t poll(Sink& est) {
+        uint32_t n = 0;
+        while (tail_ != head_) {
+            est.pushPeriod(ring_[tail_]);
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            n++;
+        }
+        return n;
+    }
+
+    template <typename Sink>
+    uint32_t pollEdges(Sink& sink, uint64_t nowUs) {
+        uint64_t pending = 0;
+        for (uint32_t i = tail_; i != head_; i = (i + 1) & (RING_SIZE - 1))
+            pending += ring_[i];
+
+        uint32_t n = 0;
+        while (tail_ != head_) {
+            uint32_t p = ring_[tail_];
+            tail_ = (tail_ + 1) & (RING_SIZE - 1);
+            pending -= p;
+            sink.pushEdge(nowUs - pending * 1000000u / tickHz_, p);
+            n++;
+        }
+        return n;
+    }
+
+    void flush() { tail_ = head_; }
+
+private:
+    uint32_t tickHz_;
+    uint32_t ring_[RING_SIZE] = {};
+    uint32_t head_  = 0;
+    uint32_t tail_  = 0;
+    uint32_t edges_ = 0;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef PioEdgeTimer EdgeTimer;
+#else
+typedef FakeEdgeTimer EdgeTimer;
+#endif
+
+}  // namespace fencing
@@ -0,0 +1,145 @@
+// =============================================================================
+// pwm_planner.h — Choix diviseur / wrap du PWM RP2040 pour une frequence
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// PROBLEME :
+//   L'ancien setupPWM() faisait wrap = clk_sys / freq avec un diviseur de 1.
+//   Le compteur PWM est sur 16 bits (TOP <= 65 536) : a 1 kHz il faudrait
+//   TOP = 125 000 → debordement, le plan basse frequence (Phase 1.7bis) ne
+//   pouvait pas fonctionner tel quel.
+//
+// PRINCIPE :
+//   f = clk_sys / (div * TOP)     div = INT + FRAC/16 (format 8.4, 1 ≤ div < 256)
+//                                 TOP = wrap + 1      (2 ≤ TOP ≤ 65 536)
+//
+//   En seiziemes de cycle : periode = div16 * TOP, avec div16 = 16 * div.
+//   On parcourt div16 de la plus petite valeur compatible avec TOP ≤ 65 536
+//   jusqu'a 4095, TOP = arrondi(16 * clk / (div16 * f)), et on garde le couple
+//   le plus proche. Le premier couple exact trouve a le plus grand TOP (meilleure
+//   resolution du rapport cyclique) : la recherche s'arrete la.
+//
+//   Exemples a 125 MHz : 20 kHz → div 1, TOP 6250 ; 1 kHz → div 2, TOP 62 500.
+//
+// USAGE :
+//   A la compilation (plan fixe) :
+//     constexpr PwmPlan P = planPwm(SYS_CLK_NOMINAL_HZ, FREQ_NEUTRE);
+//     static_assert(P.exact(), "...");
+//   A l'execution (balayage) : planPwm(clock_get_hz(clk_sys), f) — au pire
+//   ~4000 iterations, une division par iteration. Tant que 16 * clk (plus
+//   une demi-periode) tient sur 32 bits, soit clk_sys <= ~260 MHz, la
+//   recherche se fait en uint32_t : division materielle SIO, ~1-2 ms a
+//   125 MHz sur Cortex-M0+. Au-dela, repli en uint64_t : division 64 bits
+//   logicielle a chaque iteration, compter ~10 ms. Seule la frequence
+//   obtenue, calculee une fois a la fin, reste en 64 bits.
+//
+// Rapport cyclique : niveau = TOP / 2 (50 % exact si TOP est pair).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "freq_plan.h"
+
+namespace fencing {
+
+constexpr uint32_t SYS_CLK_NOMINAL_HZ = 125000000;
+
+constexpr uint32_t PWM_DIV16_MIN = 16;       // div = 1.0
+constexpr uint32_t PWM_DIV16_MAX = 4095;     // div = 255 + 15/16
+constexpr uint32_t PWM_TOP_MIN   = 2;
+constexpr uint32_t PWM_TOP_MAX   = 65536;
+
+struct PwmPlan {
+    bool     ok;            // frequence atteignable
+    uint16_t div16;         // diviseur x 16 (format 8.4)
+    uint32_t top;           // periode en pas du compteur (wrap + 1)
+    uint32_t actualMilliHz; // frequence obtenue (mHz)
+    int32_t  errorMilliHz;  // obtenue - demandee (mHz)
+
+    constexpr uint8_t  divInt()  const { return (uint8_t)(div16 >> 4); }
+    constexpr uint8_t  divFrac() const { return (uint8_t)(div16 & 0x0F); }
+    constexpr uint16_t wrap()    const { return (uint16_t)(top - 1); }
+    constexpr uint16_t level()   const { return (uint16_t)(top / 2); }
+    constexpr uint32_t actualHz() const { return (actualMilliHz + 500) / 1000; }
+    constexpr bool     exact()   const { return ok && errorMilliHz == 0; }  // au mHz pres
+};
+
+namespace detail {
+
+// Parcours des div16 ; Word = uint32_t quand clk16 + step / 2 ne deborde pas,
+// uint64_t sinon (meme code, seule la largeur des divisions change)
+template <typename Word>
+constexpr PwmPlan searchPwm(Word clk16, uint32_t freqHz) {
+    PwmPlan best = { false, 0, 0, 0, 0 };
+
+    // Plus petit div16 tel que TOP <= PWM_TOP_MAX
+    uint64_t perFreq = (uint64_t)freqHz * PWM_TOP_MAX;
+    uint32_t div16 = (uint32_t)(((uint64_t)clk16 + perFreq - 1) / perFreq);
+    if (div16 < PWM_DIV16_MIN)
+        div16 = PWM_DIV16_MIN;
+
+    Word bestErr = ~(Word)0;
+    for (; div16 <= PWM_DIV16_MAX; div16++) {
+        Word step = (Word)div16 * freqHz;
+        Word top = (clk16 + step / 2) / step;
+        if (top < PWM_TOP_MIN)
+            break;                                   // diviseur trop grand
+        if (top > PWM_TOP_MAX)
+            continue;
+
+        // |periode obtenue - periode demandee| * f * ... : meme ordre que
+        // l'erreur de frequence, sans division (step * top <= clk16 + step / 2)
+        Word p = step * top;
+        Word err = p > clk16 ? p - clk16 : clk16 - p;
+        if (err < bestErr) {
+            bestErr    = err;
+            best.ok    = true;
+            best.div16 = (uint16_t)div16;
+            best.top   = (uint32_t)top;
+            if (err == 0)
+                break;
+        }
+    }
+    return best;
+}
+
+}  // namespace detail
+
+constexpr PwmPlan planPwm(uint32_t clkHz, uint32_t freqHz) {
+    PwmPlan best = { false, 0, 0, 0, 0 };
+    if (freqHz == 0 || clkHz == 0)
+        return best;
+
+    const uint64_t clk16 = (uint64_t)clkHz * 16u;   // seiziemes de cycle / s
+
+    // Pires cas : step = PWM_DIV16_MAX * f, numerateur clk16 + step / 2
+    const uint64_t stepMax = (uint64_t)PWM_DIV16_MAX * freqHz;
+    if (stepMax <= UINT32_MAX && clk16 + stepMax / 2 <= UINT32_MAX)
+        best = detail::searchPwm<uint32_t>((uint32_t)clk16, freqHz);
+    else
+        best = detail::searchPwm<uint64_t>(clk16, freqHz);
+
+    if (best.ok) {
+        uint64_t period16 = (uint64_t)best.div16 * best.top;
+        best.actualMilliHz = (uint32_t)((clk16 * 1000u + period16 / 2) / period16);
+        best.errorMilliHz  = (int32_t)best.actualMilliHz - (int32_t)(freqHz * 1000u);
+    }
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+// Toutes les porteuses du plan doivent etre exactes a 125 MHz
+// -----------------------------------------------------------------------------
+constexpr bool freqPlanExactAt(uint32_t clkHz) {
+    for (uint8_t i = 0; i < FREQ_PLAN_SIZE; i++)
+        if (!planPwm(clkHz, FREQ_PLAN[i].centerHz).exact())
+            return false;
+    return true;
+}
+
+static_assert(freqPlanExactAt(SYS_CLK_NOMINAL_HZ),
+              "FREQ_PLAN : une porteuse n'est pas generable exactement a 125 MHz");
+
+}  // namespace fencing
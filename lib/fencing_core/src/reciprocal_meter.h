@@ -0,0 +1,99 @@
+// =============================================================================
+// reciprocal_meter.h — Frequencemetre reciproque (mesure de periode)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Le comptage sur une fenetre de 50 ms donne, a 1 kHz, 50 fronts → ±20 Hz
+//   de quantification et une decision toutes les 50 ms seulement, alors que
+//   le dwell FIE est de 15 ms. La mesure reciproque chronometre chaque
+//   periode (temps entre deux fronts montants) et moyenne les N dernieres :
+//
+//     f = N * tickHz / somme(periodes)
+//
+//   A 125 MHz la resolution est de 8 ns par periode, soit ~0.001 % a 1 kHz :
+//   la classification est possible apres quelques periodes (N = 4 → 4 ms
+//   a 1 kHz) au lieu d'une fenetre complete.
+//
+// STABILITE :
+//   Une mesure n'est exploitable que si les N periodes sont coherentes entre
+//   elles (pas de front parasite ni de front manque a l'etablissement du
+//   contact). stable() verifie que chaque periode est a moins de
+//   maxDeviationPermille de la moyenne.
+//
+// Les periodes sont fournies en ticks (cycles d'horloge systeme pour le
+// timer PIO, nanosecondes pour les traces synthetiques sur hote).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fencing {
+
+template <uint8_t N>
+class ReciprocalEstimator {
+    static_assert(N >= 2, "il faut au moins 2 periodes pour juger la stabilite");
+
+public:
+    explicit ReciprocalEstimator(uint32_t tickHz, uint16_t maxDeviationPermille = 50)
+        : tickHz_(tickHz), maxDevPermille_(maxDeviationPermille) {}
+
+    void reset() {
+        count_ = 0;
+        head_  = 0;
+        sum_   = 0;
+    }
+
+    void setTickHz(uint32_t tickHz) { tickHz_ = tickHz; }
+
+    // Ajoute la periode entre les deux derniers fronts montants
+    void pushPeriod(uint32_t ticks) {
+        if (count_ == N)
+            sum_ -= periods_[head_];
+        else
+            count_++;
+        periods_[head_] = ticks;
+        sum_ += ticks;
+        head_ = (uint8_t)((head_ + 1) % N);
+    }
+
+    // N periodes disponibles
+    bool ready() const { return count_ == N; }
+
+    uint8_t size() const { return count_; }
+
+    // Frequence moyenne sur les periodes disponibles (0 si aucune)
+    uint32_t freqHz() const {
+        if (sum_ == 0) return 0;
+        return (uint32_t)(((uint64_t)tickHz_ * count_ + sum_ / 2) / sum_);
+    }
+
+    // Periode moyenne en ticks
+    uint32_t meanPeriod() const {
+        return count_ ? (uint32_t)(sum_ / count_) : 0;
+    }
+
+    // N periodes disponibles et toutes proches de la moyenne
+    bool stable() const {
+        if (!ready()) return false;
+        uint64_t mean = sum_ / N;
+        uint64_t maxDev = mean * maxDevPermille_ / 1000u;
+        for (uint8_t i = 0; i < N; i++) {
+            uint64_t p = periods_[i];
+            uint64_t dev = p > mean ? p - mean : mean - p;
+            if (dev > maxDev) return false;
+        }
+        return true;
+    }
+
+private:
+    uint32_t tickHz_;
+    uint16_t maxDevPermille_;
+    uint32_t periods_[N] = {};
+    uint8_t  count_ = 0;
+    uint8_t  head_  = 0;
+    uint64_t sum_   = 0;
+};
+
+}  // namespace fencing
@@ -0,0 +1,86 @@
+// =============================================================================
+// referee.cpp — Textes et journal de l'arbitrage du central
+// =============================================================================
+
+#include "referee.h"
+
+#include <stdio.h>
+
+namespace fencing {
+
+const char* lampText(Lamp lamp) {
+    switch (lamp) {
+        case Lamp::VALID:      return "VALIDE";
+        case Lamp::OFF_TARGET: return "BLANCHE";
+        default:               return "-";
+    }
+}
+
+const char* verdictText(const RefereeOutput& v) {
+    bool a = v.lampA != Lamp::NONE;
+    bool b = v.lampB != Lamp::NONE;
+    if (a && b) {
+        if (v.lampA == Lamp::VALID && v.lampB == Lamp::VALID) return "COUP DOUBLE";
+        return "DEUX LAMPES";
+    }
+    if (a) return v.lampA == Lamp::VALID ? "TOUCHE A" : "BLANCHE A";
+    if (b) return v.lampB == Lamp::VALID ? "TOUCHE B" : "BLANCHE B";
+    return "PAS DE LUMIERE";
+}
+
+size_t formatEventLog(const TouchEvent& ev, uint64_t arrivalUs, char* buf, size_t cap) {
+    int n = snprintf(buf, cap, "EV,%llu,%u,%u,%u,%u,%llu,%u,%lu,%lu\n",
+                     (unsigned long long)arrivalUs, ev.player, (unsigned)ev.type,
+                     (unsigned)ev.cls, ev.seq, (unsigned long long)ev.tUs, ev.syncUs,
+                     (unsigned long)ev.freqHz, (unsigned long)ev.value);
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+}
+
+size_t formatVerdictLog(const RefereeOutput& v, char* buf, size_t cap) {
+    int n = snprintf(buf, cap, "VD,%llu,%u,%u,%llu,%ld\n", (unsigned long long)v.atUs,
+                     (unsigned)v.lampA, (unsigned)v.lampB, (unsigned long long)v.hitUs,
+                     (long)v.gapUs);
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+}
+
+bool parseEventLog(const char* line, TouchEvent& ev, uint64_t& arrivalUs) {
+    unsigned long long arrival, t;
+    unsigned player, type, cls, seq, sync;
+    unsigned long freq, value;
+    if (sscanf(line, "EV,%llu,%u,%u,%u,%u,%llu,%u,%lu,%lu", &arrival, &player, &type, &cls,
+               &seq, &t, &sync, &freq, &value) != 9)
+        return false;
+    if ((player != PLAYER_A && player != PLAYER_B) || type > (unsigned)FencerEventType::DWELL ||
+        cls > (unsigned)FreqClass::UNKNOWN || seq > 0xFFFF || sync > 0xFFFF)
+        return false;
+    ev.type    = (FencerEventType)type;
+    ev.player  = (uint8_t)player;
+    ev.cls     = (FreqClass)cls;
+    ev.seq     = (uint16_t)seq;
+    ev.tUs     = t;
+    ev.freqHz  = (uint32_t)freq;
+    ev.value   = (uint32_t)value;
+    ev.syncUs  = (uint16_t)sync;
+    arrivalUs  = arrival;
+    return true;
+}
+
+bool parseVerdictLog(const char* line, RefereeOutput& v) {
+    unsigned long long at, first;
+    unsigned a, b;
+    long gap;
+    if (sscanf(line, "VD,%llu,%u,%u,%llu,%ld", &at, &a, &b, &first, &gap) != 5)
+        return false;
+    if (a > (unsigned)Lamp::OFF_TARGET || b > (unsigned)Lamp::OFF_TARGET)
+        return false;
+    v = RefereeOutput();
+    v.kind  = RefereeOutputKind::VERDICT;
+    v.lampA = (Lamp)a;
+    v.lampB = (Lamp)b;
+    v.hitUs = first;
+    v.gapUs = (int32_t)gap;
+    v.atUs  = at;
+    return true;
+}
+
+}  // namespace fencing
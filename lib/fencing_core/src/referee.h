@@ -0,0 +1,236 @@
+// =============================================================================
+// referee.h — Arbitrage du central : verrouillage, dwell, double touche (fleuret)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ENTREES : les evenements uniques des deux tireurs (TouchReceiver), avec
+// leur instant d'arrivee au central. Instants des touches en horloge du
+// central (clock_sync.h) ; un tireur non synchronise est date a l'arrivee.
+//
+//   DWELL classe VALID adverse     touche valide, a l'instant du dwell
+//   DWELL classe VALID du tireur   touche non valable (propre cuirasse)
+//   DWELL classe NONE              touche blanche : 15 ms d'appui sans
+//                                  porteuse, a debut d'appui + 15 ms
+//   autres (TOUCH au relachement, NEUTRE : coque / piste, UNKNOWN)  ignores
+//
+//   La touche blanche est declaree par le tireur pendant l'appui, comme le
+//   dwell : un appui tenu plus longtemps que lockoutUs + graceUs ne la rend
+//   pas tardive.
+//
+// PHRASE D'ARMES :
+//   repos ──1ere touche t0──▶ verrouillage : l'adversaire peut encore
+//   toucher jusqu'a t0 + lockoutUs ; chaque tireur ne garde que sa premiere
+//   touche (la plus ancienne, meme arrivee en retard)
+//   ──t0 + lockoutUs + graceUs──▶ VERDICT, puis touches ignorees pendant
+//   holdUs (lampes affichees), puis repos
+//
+//   graceUs couvre le transport (copies redondantes, relances) : une touche
+//   arrivee apres l'echeance de sa propre phrase est comptee "tardive".
+//   Une touche arrivee en retard mais datee avant t0 devient la premiere ;
+//   une lampe deja allumee peut alors s'eteindre (correction, comptee).
+//
+// SORTIES (Sink : bool push(const RefereeOutput&)) :
+//   LIGHT    des qu'une lampe s'allume ou change (affichage immediat)
+//   VERDICT  definitif, date de l'echeance logique (et non de l'appel)
+//
+// DETERMINISME : les sorties ne dependent que de la suite (evenement,
+// arrivee) ; onEvent() traite d'abord les echeances passees. Un journal
+// d'arrivees rejoue donne exactement les memes verdicts, quel que soit le
+// rythme des appels a poll() (host_tools refreplay).
+//
+// BORNE : etat fixe (deux touches), aucune allocation, O(1) par appel.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fie_timing.h"
+#include "touch_wire.h"
+
+namespace fencing {
+
+constexpr uint32_t LOCKOUT_US       = LOCKOUT_MS * 1000u;
+constexpr uint32_t REFEREE_GRACE_US = 50000;
+constexpr uint32_t REFEREE_HOLD_US  = 1500000;
+
+enum class Lamp : uint8_t { NONE, VALID, OFF_TARGET };
+
+enum class RefereeOutputKind : uint8_t { LIGHT, VERDICT };
+
+struct RefereeOutput {
+    RefereeOutputKind kind;
+    uint8_t  player;        // LIGHT
+    Lamp     lamp;          // LIGHT
+    Lamp     lampA;         // VERDICT
+    Lamp     lampB;         // VERDICT
+    uint64_t hitUs;         // LIGHT : instant de la touche ; VERDICT : 1ere touche
+    int32_t  gapUs;         // VERDICT : touche B − touche A (deux lampes), sinon 0
+    uint64_t atUs;          // LIGHT : arrivee ; VERDICT : echeance logique
+};
+
+struct RefereeStats {
+    uint32_t events      = 0;
+    uint32_t hits        = 0;
+    uint32_t verdicts    = 0;
+    uint32_t ignored     = 0;   // pas une touche (TOUCH, NEUTRE, ...)
+    uint32_t late        = 0;   // arrivee apres l'echeance de sa phrase
+    uint32_t locked      = 0;   // apres le verrouillage ou pendant l'affichage
+    uint32_t repeated    = 0;   // 2e touche du meme tireur dans la phrase
+    uint32_t corrections = 0;   // lampe deja allumee changee par une touche plus ancienne
+    uint32_t unsynced    = 0;   // datee a l'arrivee
+};
+
+class Referee {
+public:
+    explicit Referee(uint32_t lockoutUs = LOCKOUT_US, uint32_t graceUs = REFEREE_GRACE_US,
+                     uint32_t holdUs = REFEREE_HOLD_US)
+        : lockoutUs_(lockoutUs), graceUs_(graceUs), holdUs_(holdUs) {}
+
+    // Evenement unique recu a nowUs (horloge du central)
+    template <typename Sink>
+    void onEvent(const TouchEvent& ev, uint64_t nowUs, Sink& out) {
+        poll(nowUs, out);
+        stats_.events++;
+
+        Hit hit;
+        if (!hitFrom(ev, nowUs, hit)) {
+            stats_.ignored++;
+            return;
+        }
+        stats_.hits++;
+        uint8_t p = ev.player == PLAYER_B;
+
+        if (hit.tUs < holdUntilUs_) {
+            stats_.locked++;
+            return;
+        }
+        if (nowUs >= hit.tUs + lockoutUs_ + graceUs_) {
+            stats_.late++;
+            return;
+        }
+
+        if (!open_) {
+            open_    = true;
+            firstUs_ = hit.tUs;
+            hits_[0] = hits_[1] = Hit();
+        } else if (hit.tUs < firstUs_) {
+            // Touche plus ancienne arrivee en retard : nouvelle origine, la
+            // touche adverse peut sortir de la fenetre
+            firstUs_ = hit.tUs;
+            Hit& other = hits_[!p];
+            if (other.lamp != Lamp::NONE && other.tUs > firstUs_ + lockoutUs_) {
+                other = Hit();
+                stats_.corrections++;
+                light(!p, other, nowUs, out);
+            }
+        } else if (hit.tUs > firstUs_ + lockoutUs_) {
+            stats_.locked++;
+            return;
+        }
+
+        Hit& mine = hits_[p];
+        if (mine.lamp != Lamp::NONE) {
+            if (hit.tUs >= mine.tUs) {
+                stats_.repeated++;
+                return;
+            }
+            if (hit.lamp != mine.lamp) stats_.corrections++;
+        }
+        bool changed = mine.lamp != hit.lamp;
+        mine = hit;
+        if (changed) light(p, mine, nowUs, out);
+    }
+
+    // Echeances : VERDICT des que nowUs atteint 1ere touche + lockout + grace
+    template <typename Sink>
+    void poll(uint64_t nowUs, Sink& out) {
+        if (!open_ || nowUs < deadlineUs())
+            return;
+        RefereeOutput v = {};
+        v.kind  = RefereeOutputKind::VERDICT;
+        v.lampA = hits_[0].lamp;
+        v.lampB = hits_[1].lamp;
+        v.hitUs = firstUs_;
+        v.atUs  = deadlineUs();
+        if (v.lampA != Lamp::NONE && v.lampB != Lamp::NONE)
+            v.gapUs = (int32_t)((int64_t)hits_[1].tUs - (int64_t)hits_[0].tUs);
+        holdUntilUs_ = v.atUs + holdUs_;
+        open_ = false;
+        stats_.verdicts++;
+        out.push(v);
+    }
+
+    bool open() const { return open_; }
+    uint64_t deadlineUs() const { return firstUs_ + lockoutUs_ + graceUs_; }
+    const RefereeStats& stats() const { return stats_; }
+
+    void reset() { *this = Referee(lockoutUs_, graceUs_, holdUs_); }
+
+private:
+    struct Hit {
+        Lamp     lamp = Lamp::NONE;
+        uint64_t tUs  = 0;
+    };
+
+    // Evenement → touche (lampe et instant), false si ce n'en est pas une
+    bool hitFrom(const TouchEvent& ev, uint64_t nowUs, Hit& hit) {
+        FreqClass own = ev.player == PLAYER_A ? FreqClass::VALID_A : FreqClass::VALID_B;
+        FreqClass opp = ev.player == PLAYER_A ? FreqClass::VALID_B : FreqClass::VALID_A;
+        bool synced = ev.syncUs != TOUCH_SYNC_NONE;
+        uint64_t t = synced ? ev.tUs : nowUs;
+
+        if (ev.type != FencerEventType::DWELL)
+            return false;
+        if (ev.cls == opp)
+            hit.lamp = Lamp::VALID;
+        else if (ev.cls == own || ev.cls == FreqClass::NONE)
+            hit.lamp = Lamp::OFF_TARGET;
+        else
+            return false;
+        if (!synced) stats_.unsynced++;
+        hit.tUs = t < nowUs ? t : nowUs;            // jamais dans le futur
+        return true;
+    }
+
+    template <typename Sink>
+    void light(uint8_t p, const Hit& hit, uint64_t nowUs, Sink& out) {
+        RefereeOutput l = {};
+        l.kind   = RefereeOutputKind::LIGHT;
+        l.player = p ? PLAYER_B : PLAYER_A;
+        l.lamp   = hit.lamp;
+        l.hitUs  = hit.tUs;
+        l.atUs   = nowUs;
+        out.push(l);
+    }
+
+    uint32_t     lockoutUs_;
+    uint32_t     graceUs_;
+    uint32_t     holdUs_;
+    bool         open_        = false;
+    uint64_t     firstUs_     = 0;
+    uint64_t     holdUntilUs_ = 0;
+    Hit          hits_[2];
+    RefereeStats stats_;
+};
+
+// -----------------------------------------------------------------------------
+// Journal du central (une ligne par evenement unique / verdict), relu par
+// host_tools refreplay :
+//   EV,arrivee_us,tireur,type,classe,seq,t_us,sync_us,freq_hz,value
+//   VD,echeance_us,lampeA,lampeB,1ere_touche_us,ecart_us
+// -----------------------------------------------------------------------------
+constexpr size_t REFEREE_LOG_LINE = 112;
+
+const char* lampText(Lamp lamp);
+const char* verdictText(const RefereeOutput& v);
+
+size_t formatEventLog(const TouchEvent& ev, uint64_t arrivalUs, char* buf, size_t cap);
+size_t formatVerdictLog(const RefereeOutput& v, char* buf, size_t cap);
+
+// false si la ligne n'est pas de ce type (lignes de Serial melangees)
+bool parseEventLog(const char* line, TouchEvent& ev, uint64_t& arrivalUs);
+bool parseVerdictLog(const char* line, RefereeOutput& v);
+
+}  // namespace fencing
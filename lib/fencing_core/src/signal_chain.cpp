@@ -0,0 +1,194 @@
+// =============================================================================
+// signal_chain.cpp — Simulation de la chaine analogique (hote uniquement)
+// =============================================================================
+
+#include "signal_chain.h"
+
+#if !defined(ARDUINO)
+
+#include <cmath>
+
+#include "hal.h"
+
+namespace fencing {
+
+namespace {
+
+typedef double Mat2[2][2];
+
+void mul(const Mat2 a, const Mat2 b, Mat2 out) {
+    Mat2 r;
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            r[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j];
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            out[i][j] = r[i][j];
+}
+
+bool invert(const Mat2 a, Mat2 out) {
+    double det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    if (det == 0) return false;
+    out[0][0] =  a[1][1] / det;
+    out[0][1] = -a[0][1] / det;
+    out[1][0] = -a[1][0] / det;
+    out[1][1] =  a[0][0] / det;
+    return true;
+}
+
+// exp(a) : mise a l'echelle et elevation au carre, Taylor a l'ordre 12
+void expm(const Mat2 a, Mat2 out) {
+    double norm = std::fmax(std::fabs(a[0][0]) + std::fabs(a[0][1]),
+                            std::fabs(a[1][0]) + std::fabs(a[1][1]));
+    int squarings = norm > 0.5 ? (int)std::ceil(std::log2(norm / 0.5)) : 0;
+    double scale = std::ldexp(1.0, -squarings);
+
+    Mat2 s = { { a[0][0] * scale, a[0][1] * scale }, { a[1][0] * scale, a[1][1] * scale } };
+    Mat2 term = { { 1, 0 }, { 0, 1 } };
+    Mat2 sum  = { { 1, 0 }, { 0, 1 } };
+    for (int k = 1; k <= 12; k++) {
+        mul(term, s, term);
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++) {
+                term[i][j] /= k;
+                sum[i][j]  += term[i][j];
+            }
+    }
+    for (int q = 0; q < squarings; q++)
+        mul(sum, sum, sum);
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            out[i][j] = sum[i][j];
+}
+
+double logUniform(std::mt19937& rng, double lo, double hi) {
+    std::uniform_real_distribution<double> u(std::log(lo), std::log(hi));
+    return std::exp(u(rng));
+}
+
+double spread(std::mt19937& rng, double nominal, double fraction) {
+    std::uniform_real_distribution<double> u(1.0 - fraction, 1.0 + fraction);
+    return nominal * u(rng);
+}
+
+}  // namespace
+
+ChainParams randomChainParams(std::mt19937& rng) {
+    ChainParams p;
+    p.pullUpOhm   = spread(rng, p.pullUpOhm, 0.05);
+    p.mosfetOhm   = logUniform(rng, 2, 10);
+    p.cuirasseF   = logUniform(rng, 0.5e-9, 10e-9);
+    p.pathOhm     = logUniform(rng, 4700, 15000);
+    p.bladeF      = logUniform(rng, 5e-9, 15e-9);
+    p.pullDownOhm = spread(rng, p.pullDownOhm, 0.05);
+    p.inputF      = logUniform(rng, 5e-12, 30e-12);
+    p.vihV        = std::uniform_real_distribution<double>(1.4, 1.8)(rng);
+    p.vilV        = p.vihV - std::uniform_real_distribution<double>(0.2, 0.4)(rng);
+    p.noiseV      = logUniform(rng, 0.005, 0.05);
+    return p;
+}
+
+SignalChain::SignalChain(const ChainParams& p, ChainPath path, uint32_t seed)
+    : p_(p), path_(path), rng_(seed), noise_(0.0, p.noiseV) {
+    makeStep(false, IDLE_STEP_NS, idleStep_);
+    // Depart au repos : PWM arrete depuis longtemps
+    x_[0] = idleStep_.ss[0];
+    x_[1] = idleStep_.ss[1];
+    lastV_ = x_[1];
+    high_  = lastV_ >= p_.vihV;
+}
+
+// Equations nodales M dx/dt = G x + b, x = (ligne emettrice, B) :
+//   regime etabli ss = -G^-1 b, x(t + dt) = ss + exp(M^-1 G dt) (x - ss)
+void SignalChain::makeStep(bool on, double dtNs, Step& out) const {
+    // MOSFET passant : Thevenin de Rpu vers VBUS en parallele avec Ron
+    double rs = on ? p_.pullUpOhm * p_.mosfetOhm / (p_.pullUpOhm + p_.mosfetOhm)
+                   : p_.pullUpOhm;
+    double vs = on ? p_.vbusV * p_.mosfetOhm / (p_.pullUpOhm + p_.mosfetOhm)
+                   : p_.vbusV;
+    double gs  = 1.0 / rs;
+    double gpd = 1.0 / p_.pullDownOhm;
+
+    Mat2 m, g;
+    if (path_ == ChainPath::CONTACT) {
+        double gp = 1.0 / p_.pathOhm;
+        m[0][0] = p_.cuirasseF;  m[0][1] = 0;
+        m[1][0] = 0;             m[1][1] = p_.bladeF + p_.inputF;
+        g[0][0] = -gs - gp;      g[0][1] = gp;
+        g[1][0] = gp;            g[1][1] = -gp - gpd;
+    } else {
+        m[0][0] = p_.cuirasseF + p_.bladeF;  m[0][1] = -p_.bladeF;
+        m[1][0] = -p_.bladeF;                m[1][1] = p_.bladeF + p_.inputF;
+        g[0][0] = -gs;                       g[0][1] = 0;
+        g[1][0] = 0;                         g[1][1] = -gpd;
+    }
+    double b[2] = { vs * gs, 0 };
+
+    Mat2 gi = {}, mi = {}, a;
+    invert(g, gi);
+    out.ss[0] = -(gi[0][0] * b[0] + gi[0][1] * b[1]);
+    out.ss[1] = -(gi[1][0] * b[0] + gi[1][1] * b[1]);
+
+    invert(m, mi);
+    mul(mi, g, a);
+    double dtS = dtNs * 1e-9;
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            a[i][j] *= dtS;
+    expm(a, out.phi);
+}
+
+void SignalChain::prepare(uint32_t freqHz) {
+    if (freqHz == freqHz_)
+        return;
+    freqHz_ = freqHz;
+    sample_ = 0;
+    on_     = false;
+    if (freqHz == 0)
+        return;
+    dtNs_ = 5e8 / freqHz / SAMPLES_PER_HALF;
+    makeStep(true, dtNs_, onStep_);
+    makeStep(false, dtNs_, offStep_);
+}
+
+void SignalChain::advance(const Step& s, double dtNs, std::vector<uint64_t>& rising) {
+    double d0 = x_[0] - s.ss[0];
+    double d1 = x_[1] - s.ss[1];
+    x_[0] = s.ss[0] + s.phi[0][0] * d0 + s.phi[0][1] * d1;
+    x_[1] = s.ss[1] + s.phi[1][0] * d0 + s.phi[1][1] * d1;
+
+    double v = x_[1] + noise_(rng_);
+    if (!high_ && v >= p_.vihV) {
+        double frac = v > lastV_ ? (p_.vihV - lastV_) / (v - lastV_) : 1.0;
+        if (frac < 0) frac = 0;
+        rising.push_back((uint64_t)(tNs_ + frac * dtNs));
+        high_ = true;
+    } else if (high_ && v <= p_.vilV) {
+        high_ = false;
+    }
+    lastV_ = v;
+    tNs_  += dtNs;
+}
+
+void SignalChain::run(uint64_t untilNs, uint32_t freqHz, std::vector<uint64_t>& rising) {
+    prepare(freqHz);
+    while (tNs_ < (double)untilNs) {
+        if (freqHz_ == 0) {
+            advance(idleStep_, IDLE_STEP_NS, rising);
+            continue;
+        }
+        advance(on_ ? onStep_ : offStep_, dtNs_, rising);
+        if (++sample_ == SAMPLES_PER_HALF) {
+            sample_ = 0;
+            on_     = !on_;
+        }
+    }
+}
+
+void SignalChain::runHal(uint64_t untilNs, uint8_t pwmPin, std::vector<uint64_t>& rising) {
+    run(untilNs, hal::sim::pwmActive(pwmPin) ? hal::sim::pwmFreq(pwmPin) : 0, rising);
+}
+
+}  // namespace fencing
+
+#endif
@@ -0,0 +1,153 @@
+// =============================================================================
+// signal_chain.h — Simulation de la chaine analogique (hote uniquement)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Les resultats cles du plan (pull-up 100Ω, fil du fleuret ~10 nF,
+//   couplage B↔C, pull-down 10kΩ) viennent du banc. Ce modele reproduit la
+//   chaine generateur → MOSFET → cuirasse → fil de la lame → seuil de GP2 et
+//   rend les fronts montants dates que verrait le PIO : ils passent par
+//   FakeEdgeTimer dans le vrai code de detection (TouchDetector, estimateurs).
+//   Plans, tolerances et estimateurs s'evaluent ainsi sur des milliers de
+//   jeux de materiel tires au hasard en quelques secondes.
+//
+// MODELE (elements localises, tensions par rapport a la masse du recepteur) :
+//
+//   CONTACT : pointe adverse sur la cuirasse emettrice
+//
+//     VBUS ─[Rpu]─┬─ D (cuirasse, C_cuir) ─[R chemin]─┬─ B (GP2)
+//                 │                                   ├─ C_lame → lame
+//            2N7000 (Ron)                             ├─ R pull-down
+//                                                     └─ C_entree
+//
+//     R chemin : contact, fil de corps et retour sans masse commune, en une
+//     resistance equivalente. 10 kΩ nominal : avec 10 nF de lame, 20 kHz
+//     donne ~1 400 Hz comptes (banc Phase 1.7 : ~1 700 Hz), 1 kHz passe
+//
+//   COUPLAGE : emission sur sa propre ligne C (Phase 1.5), B ne touche rien
+//
+//     VBUS ─[Rpu]─┬─ C (ligne C, C_cuir) ─┤├ C_lame (B↔C) ─┬─ B (GP2)
+//            2N7000 (Ron)                                   ├─ R pull-down
+//                                                           └─ C_entree
+//
+//   PWM haut → MOSFET passant → ligne a ~0 V (signal inverse, meme
+//   frequence). Deux etats par topologie, lineaires par morceaux : chaque
+//   demi-periode est integree exactement (exponentielle de matrice), le seuil
+//   est cherche par interpolation entre SAMPLES_PER_HALF points.
+//
+//   GP2 : trigger de Schmitt (montee VIH, descente VIL), bruit gaussien sur
+//   la tension lue. Diodes de protection non modelisees (B reste sous VBUS).
+//
+// USAGE :
+//   SignalChain chain(params, ChainPath::CONTACT, seed);
+//   chain.run(untilNs, freqHz, edges);            // ou runHal(untilNs, pin, ...)
+//   EdgeTimerFeed<FakeEdgeTimer> feed(timer);     // periodes vers le timer
+//   for (uint64_t t : edges) feed.onRisingEdge(t);
+// =============================================================================
+
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+namespace fencing {
+
+enum class ChainPath : uint8_t { CONTACT, COUPLING };
+
+// Valeurs nominales : celles du plan (banc Phase 0 a 1.7)
+struct ChainParams {
+    double vbusV       = 5.0;      // alimentation de la pull-up
+    double pullUpOhm   = 100;      // pull-up du MOSFET d'emission
+    double mosfetOhm   = 5;        // 2N7000 passant, Vgs = 3.3 V
+    double cuirasseF   = 5e-9;     // cuirasse / ligne C vers l'environnement
+    double pathOhm     = 10000;    // contact + fil de corps + retour
+    double bladeF      = 10e-9;    // fil interne du fleuret ↔ lame
+    double pullDownOhm = 10000;    // GP2 → GND
+    double inputF      = 10e-12;   // entree GP2 + piste
+    double vihV        = 1.6;      // seuil montant (RP2040, typ.)
+    double vilV        = 1.3;      // seuil descendant
+    double noiseV      = 0.02;     // bruit rms sur la tension lue
+};
+
+// Jeu de materiel tire au hasard autour des valeurs nominales
+ChainParams randomChainParams(std::mt19937& rng);
+
+class SignalChain {
+public:
+    static const uint32_t SAMPLES_PER_HALF = 32;
+
+    SignalChain(const ChainParams& p, ChainPath path, uint32_t seed = 1);
+
+    // Avance jusqu'a untilNs avec le PWM a freqHz (0 : PWM arrete, sortie
+    // LOW, MOSFET bloque) ; ajoute les fronts montants de GP2 a `rising`.
+    // La phase du PWM est continue d'un appel a l'autre a frequence egale.
+    void run(uint64_t untilNs, uint32_t freqHz, std::vector<uint64_t>& rising);
+
+    // Meme chose, frequence lue dans la HAL simulee (hal::sim::pwmActive /
+    // pwmFreq de la broche d'emission) : le code d'emission du firmware
+    // pilote la simulation
+    void runHal(uint64_t untilNs, uint8_t pwmPin, std::vector<uint64_t>& rising);
+
+    uint64_t nowNs() const { return (uint64_t)tNs_; }
+    double   voltageB() const { return x_[1]; }      // tension de GP2 (V)
+    bool     levelB() const { return high_; }         // sortie du Schmitt
+
+private:
+    struct Step {            // x(t + dt) = ss + phi * (x(t) - ss)
+        double phi[2][2];
+        double ss[2];
+    };
+
+    static const uint32_t IDLE_STEP_NS = 1000;
+
+    void prepare(uint32_t freqHz);
+    void makeStep(bool on, double dtNs, Step& out) const;
+    void advance(const Step& s, double dtNs, std::vector<uint64_t>& rising);
+
+    ChainParams p_;
+    ChainPath   path_;
+    std::mt19937                     rng_;
+    std::normal_distribution<double> noise_;
+
+    double   x_[2]     = { 0, 0 };   // D (ou C), B
+    double   lastV_    = 0;          // derniere tension lue (bruit compris)
+    bool     high_     = false;
+    double   tNs_      = 0;
+    uint32_t sample_   = 0;          // rang dans la demi-periode courante
+    bool     on_       = false;      // PWM haut (MOSFET passant)
+    uint32_t freqHz_   = 0;
+    double   dtNs_     = 0;
+    Step     onStep_   = {};
+    Step     offStep_  = {};
+    Step     idleStep_ = {};         // PWM arrete : pas de IDLE_STEP_NS
+};
+
+// Fronts dates (ns) → periodes en ticks du chronometre (FakeEdgeTimer)
+template <typename Timer>
+class EdgeTimerFeed {
+public:
+    explicit EdgeTimerFeed(Timer& timer) : timer_(timer) {}
+
+    void onRisingEdge(uint64_t tNs) {
+        if (lastNs_ && tNs > lastNs_) {
+            uint64_t ns = tNs - lastNs_;    // borne : pas de debordement du produit
+            uint64_t ticks = ns >= 4000000000ull ? 0xFFFFFFFFu
+                                                 : ns * timer_.tickHz() / 1000000000u;
+            timer_.addPeriod(ticks > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)ticks);
+        }
+        lastNs_ = tNs;
+    }
+
+private:
+    Timer&   timer_;
+    uint64_t lastNs_ = 0;
+};
+
+}  // namespace fencing
+
+#endif
@@ -0,0 +1,82 @@
+// =============================================================================
+// spsc_queue.h — File sans verrou, un producteur / un consommateur
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Passage des evenements du coeur 1 (detection, boucle bornee) au coeur 0
+//   (Serial USB, puis WiFi) sans jamais bloquer le producteur : push()
+//   retourne false si la file est pleine, l'evenement est perdu (le numero
+//   de sequence des evenements rend la perte visible cote consommateur).
+//
+// PRINCIPE :
+//   head_ n'est ecrit que par le producteur, tail_ que par le consommateur.
+//   Les indices tournent librement sur 32 bits (N puissance de 2 divise 2^32,
+//   le rebouclage est donc transparent) ; la case est index & (N - 1).
+//   Ecriture de la case puis publication de head_ en "release", lecture de
+//   head_ en "acquire" puis de la case : le consommateur ne voit jamais une
+//   case a moitie ecrite.
+//
+//   Seuls load() et store() sont utilises : sur Cortex-M0+ (pas de LDREX /
+//   STREX) ce sont de simples LDR / STR entoures de DMB, sans verrou ni
+//   appel de bibliotheque. Le RP2040 n'a pas de cache de donnees : les deux
+//   coeurs voient la meme SRAM.
+//
+// POURQUOI PAS LA FIFO INTER-COEURS (SIO) :
+//   8 mots seulement, et le core earlephilhower s'en sert deja pour
+//   suspendre l'autre coeur pendant les ecritures en flash.
+//
+// Sur hote, la meme file est exercee par deux threads (host_tools spsc).
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace fencing {
+
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N doit etre une puissance de 2");
+
+public:
+    static constexpr uint32_t capacity() { return N; }
+
+    // Producteur uniquement
+    bool push(const T& value) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail == N)
+            return false;
+        slots_[head & (N - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur uniquement
+    bool pop(T& value) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail)
+            return false;
+        value = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Instantane (exact seulement depuis l'un des deux cotes)
+    uint32_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    T slots_[N];
+};
+
+}  // namespace fencing
@@ -0,0 +1,282 @@
+// =============================================================================
+// sweep.cpp — Balayage des porteuses : liste, sequence, decoupage des pas, CSV
+// =============================================================================
+
+#include "sweep.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "edge_counter.h"
+
+namespace fencing {
+
+SweepList defaultSweepList() {
+    SweepList list = {};
+    for (uint32_t f = 1000; f <= 3000; f += 250)
+        list.freqHz[list.size++] = f;
+    return list;
+}
+
+bool parseSweepList(const char* text, SweepList& out) {
+    SweepList list = {};
+    const char* p = text;
+    while (*p) {
+        if (*p == ',' || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+            continue;
+        }
+        if (*p < '0' || *p > '9')
+            return false;
+        char* end;
+        unsigned long f = strtoul(p, &end, 10);
+        if (f < SWEEP_FREQ_MIN || f > SWEEP_FREQ_MAX || list.size == SWEEP_MAX_STEPS)
+            return false;
+        list.freqHz[list.size++] = (uint32_t)f;
+        p = end;
+    }
+    if (list.size == 0)
+        return false;
+    out = list;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SweepSchedule
+// -----------------------------------------------------------------------------
+void SweepSchedule::start(const SweepList& list, uint32_t nowMs) {
+    list_  = list;
+    step_  = 0;
+    phase_ = list_.size ? Phase::START : Phase::IDLE;
+    phaseStartMs_ = nowMs;
+}
+
+bool SweepSchedule::update(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - phaseStartMs_;
+    switch (phase_) {
+        case Phase::START:
+            if (elapsed < SWEEP_START_MS) return false;
+            phase_ = Phase::STEP;
+            break;
+        case Phase::STEP:
+            if (elapsed < SWEEP_STEP_MS) return false;
+            if (step_ + 1 >= list_.size) {
+                phase_ = Phase::IDLE;
+                return true;
+            }
+            phase_ = Phase::GAP;
+            break;
+        case Phase::GAP:
+            if (elapsed < SWEEP_GAP_MS) return false;
+            step_++;
+            phase_ = Phase::STEP;
+            break;
+        default:
+            return false;
+    }
+    phaseStartMs_ = nowMs;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// PeriodStats
+// -----------------------------------------------------------------------------
+uint32_t PeriodStats::stdDevTicks() const {
+    if (count_ < 2)
+        return 0;
+    // Une fois par pas : le flottant (logiciel sur M0+) ne coute rien ici
+    double mean = (double)sum_ / count_;
+    double var  = (double)sumSq_ / count_ - mean * mean;
+    return var > 0 ? (uint32_t)(sqrt(var) + 0.5) : 0;
+}
+
+// -----------------------------------------------------------------------------
+// CSV
+// -----------------------------------------------------------------------------
+const char SWEEP_CSV_HEADER[] =
+    "pas,emis_hz,mesure_hz,min_hz,max_hz,ratio_pm,gigue_ns,perte_pm,aberrantes,fenetres";
+
+int formatSweepCsv(const SweepStepResult& r, char* buf, size_t len) {
+    return snprintf(buf, len, "%u,%lu,%lu,%lu,%lu,%u,%lu,%ld,%lu,%u",
+                    (unsigned)r.step, (unsigned long)r.emittedHz,
+                    (unsigned long)r.meanHz, (unsigned long)r.minHz,
+                    (unsigned long)r.maxHz, (unsigned)r.ratioPermille,
+                    (unsigned long)r.jitterNs, (long)r.lossPermille,
+                    (unsigned long)r.outliers, (unsigned)r.windows);
+}
+
+bool parseSweepCsv(const char* line, SweepStepResult& out) {
+    const int FIELDS = 10;
+    long v[FIELDS];
+    const char* p = line;
+    for (int i = 0; i < FIELDS; i++) {
+        bool negOk = (i == 7);                  // perte_pm
+        if (!((*p >= '0' && *p <= '9') || (negOk && *p == '-')))
+            return false;
+        char* end;
+        v[i] = strtol(p, &end, 10);
+        p = end;
+        if (i < FIELDS - 1) {
+            if (*p != ',') return false;
+            p++;
+        }
+    }
+    while (*p == ' ' || *p == '\r' || *p == '\n')
+        p++;
+    if (*p != '\0')
+        return false;
+
+    out.step          = (uint8_t)v[0];
+    out.emittedHz     = (uint32_t)v[1];
+    out.meanHz        = (uint32_t)v[2];
+    out.minHz         = (uint32_t)v[3];
+    out.maxHz         = (uint32_t)v[4];
+    out.ratioPermille = (uint16_t)v[5];
+    out.jitterNs      = (uint32_t)v[6];
+    out.lossPermille  = (int32_t)v[7];
+    out.outliers      = (uint32_t)v[8];
+    out.windows       = (uint16_t)v[9];
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SweepTracker
+// -----------------------------------------------------------------------------
+void SweepTracker::reset() {
+    clockMs_    = 0;
+    inStep_     = false;
+    synced_     = false;
+    syncArmed_  = false;
+    nextStep_   = 0;
+    silenceMs_  = 0;
+    hasPending_ = false;
+}
+
+SweepTracker::Event SweepTracker::pushWindow(uint32_t count, uint32_t elapsedMs) {
+    uint32_t f = windowFreqHz(count, elapsedMs);
+    uint32_t startMs = clockMs_;
+    clockMs_ += elapsedMs;
+
+    if (f < SWEEP_SILENCE_HZ) {
+        silenceMs_ += elapsedMs;
+        if (silenceMs_ >= SWEEP_SYNC_MS)
+            syncArmed_ = true;
+        if (!inStep_)
+            return Event::NONE;
+        if (silenceMs_ < SWEEP_GAP_MS / 2) {   // trou ou debut du silence ?
+            heldCount_ += count;
+            heldMs_    += elapsedMs;
+            heldWindows_++;
+            return Event::NONE;
+        }
+        finishStep();                   // fenetre en attente = derniere, ignoree
+        return Event::STEP_END;
+    }
+
+    silenceMs_ = 0;
+    if (!inStep_) {
+        // Index du pas d'apres son instant de debut : le pas k commence a
+        // k * cadence (± une fenetre), un fragment apres un trou tombe dans
+        // [k * cadence, k * cadence + SWEEP_STEP_MS[
+        const uint32_t cadence = SWEEP_STEP_MS + SWEEP_GAP_MS;
+        uint32_t n = synced_ ? (startMs - step0Ms_ + SWEEP_GAP_MS) / cadence : 0;
+
+        // Un long trou dans un pas tres attenue ressemble au silence initial :
+        // on ne se resynchronise qu'une fois le balayage en cours termine
+        if (syncArmed_ && (!synced_ || n >= list_.size)) {
+            synced_   = true;
+            step0Ms_  = startMs;
+            n         = 0;
+        }
+        syncArmed_ = false;
+        if (synced_)
+            nextStep_ = n > 255 ? 255 : (uint8_t)n;
+        beginStep(f);                   // premiere fenetre partielle, ignoree
+        return Event::STEP_BEGIN;
+    }
+    if (hasPending_)
+        commitWindow(pendCount_, pendMs_);
+    commitHeld();                       // c'etait un trou : fronts perdus
+    hasPending_ = true;
+    pendCount_  = count;
+    pendMs_     = elapsedMs;
+    return Event::NONE;
+}
+
+void SweepTracker::beginStep(uint32_t firstFreqHz) {
+    result_      = SweepStepResult();
+    result_.step = nextStep_;
+    emittedHz_   = nextStep_ < list_.size ? list_.freqHz[nextStep_] : 0;
+    if (nextStep_ < 255)
+        nextStep_++;
+
+    // Hors liste : la premiere fenetre sert de reference pour la gigue
+    uint32_t ref = emittedHz_ ? emittedHz_ : firstFreqHz;
+    periods_.reset((tickHz_ + ref / 2) / ref);
+
+    inStep_      = true;
+    hasPending_  = false;
+    heldCount_   = 0;
+    heldMs_      = 0;
+    heldWindows_ = 0;
+    edges_       = 0;
+    durationMs_  = 0;
+    minHz_       = 0xFFFFFFFFu;
+    maxHz_       = 0;
+    windows_     = 0;
+}
+
+void SweepTracker::commitHeld() {
+    if (heldWindows_ == 0)
+        return;
+    // Trou au milieu du pas : frequence moyenne du trou prise dans le min
+    uint32_t f = windowFreqHz(heldCount_, heldMs_);
+    if (f < minHz_) minHz_ = f;
+    edges_      += heldCount_;
+    durationMs_ += heldMs_;
+    windows_    += heldWindows_;
+    heldCount_   = 0;
+    heldMs_      = 0;
+    heldWindows_ = 0;
+}
+
+void SweepTracker::commitWindow(uint32_t count, uint32_t elapsedMs) {
+    uint32_t f = windowFreqHz(count, elapsedMs);
+    if (f < minHz_) minHz_ = f;
+    if (f > maxHz_) maxHz_ = f;
+    edges_      += count;
+    durationMs_ += elapsedMs;
+    windows_++;
+}
+
+void SweepTracker::finishStep() {
+    inStep_      = false;
+    hasPending_  = false;
+    heldCount_   = 0;
+    heldMs_      = 0;
+    heldWindows_ = 0;
+
+    SweepStepResult& r = result_;
+    r.emittedHz = emittedHz_;
+    r.windows   = windows_;
+    r.outliers  = periods_.outliers();
+    r.jitterNs  = (uint32_t)((uint64_t)periods_.stdDevTicks() * 1000000000u / tickHz_);
+    if (windows_ == 0)
+        return;
+
+    r.meanHz = windowFreqHz(edges_, durationMs_);
+    r.minHz  = minHz_;
+    r.maxHz  = maxHz_;
+    if (emittedHz_ == 0)
+        return;
+
+    r.ratioPermille = (uint16_t)(((uint64_t)edges_ * 1000000u / durationMs_ + emittedHz_ / 2)
+                                 / emittedHz_);
+    // Fronts attendus x 1000 = emis * duree (ms)
+    int64_t expectedMilli = (int64_t)emittedHz_ * durationMs_;
+    int64_t countedMilli  = (int64_t)edges_ * 1000;
+    r.lossPermille = (int32_t)((expectedMilli - countedMilli) * 1000 / expectedMilli);
+}
+
+}  // namespace fencing
@@ -0,0 +1,214 @@
+// =============================================================================
+// sweep.h — Balayage automatique des porteuses (Phase 1.7bis)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// BUT :
+//   Choisir 3 porteuses dans 1-3 kHz qui traversent le fil interne du fleuret
+//   (~10 nF). Au lieu de modifier les constantes et de reflasher pour chaque
+//   frequence, le generateur enchaine une liste de frequences et le recepteur
+//   ecrit une ligne CSV par pas. L'outil hote `sweeprank` classe ensuite les
+//   plans candidats.
+//
+// PROTOCOLE (aucun lien entre les deux Pico a part le signal) :
+//
+//   silence SWEEP_START_MS | f0 SWEEP_STEP_MS | silence SWEEP_GAP_MS | f1 ...
+//
+//   Le recepteur decoupe les pas sur les silences. Un long silence
+//   (>= SWEEP_SYNC_MS) arme la synchro : la reprise suivante est le pas 0 et
+//   l'index des pas suivants se deduit de leur instant de debut (cadence
+//   SWEEP_STEP_MS + SWEEP_GAP_MS), si bien qu'une porteuse entierement
+//   perdue dans le fleuret ne decale pas les autres. Un trou plus court que
+//   SWEEP_GAP_MS / 2 au milieu d'un pas compte comme fronts perdus.
+//   Pour relancer un balayage avant la fin du precedent, remettre le
+//   recepteur a zero (commande `b` deux fois).
+//   Les deux cartes doivent avoir la meme liste (commande `l`). La premiere
+//   et la derniere fenetre de chaque pas (partielles) sont ignorees.
+//
+// MESURES PAR PAS (recepteur) :
+//   - frequence moyenne, min et max des fenetres de comptage
+//   - ratio mesure / emis (pour mille)
+//   - gigue : ecart type des periodes chronometrees par le PIO (ns) ;
+//     les periodes a plus de ±50 % de la periode emise sont comptees a part
+//   - perte : fronts manquants / fronts attendus (pour mille, negatif si
+//     fronts parasites)
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fencing {
+
+constexpr uint8_t  SWEEP_MAX_STEPS = 16;
+constexpr uint32_t SWEEP_STEP_MS   = 2000;   // emission par pas
+constexpr uint32_t SWEEP_GAP_MS    = 200;    // silence entre deux pas
+constexpr uint32_t SWEEP_START_MS  = 1000;   // silence initial (synchro)
+constexpr uint32_t SWEEP_SYNC_MS   = 750;    // silence qui remet l'index a 0
+constexpr uint32_t SWEEP_SILENCE_HZ = 100;   // en dessous : pas de signal
+constexpr uint32_t SWEEP_FREQ_MIN  = 200;
+constexpr uint32_t SWEEP_FREQ_MAX  = 50000;
+
+static_assert(SWEEP_GAP_MS < SWEEP_SYNC_MS && SWEEP_SYNC_MS < SWEEP_START_MS,
+              "le silence entre pas ne doit pas etre pris pour une synchro");
+
+struct SweepList {
+    uint32_t freqHz[SWEEP_MAX_STEPS];
+    uint8_t  size;
+};
+
+// 1000 a 3000 Hz par pas de 250 Hz
+SweepList defaultSweepList();
+
+// "1000,1500 2500" → liste. false si vide, plus de SWEEP_MAX_STEPS valeurs,
+// caractere inattendu ou frequence hors [SWEEP_FREQ_MIN, SWEEP_FREQ_MAX] ;
+// `out` n'est alors pas modifie.
+bool parseSweepList(const char* text, SweepList& out);
+
+// -----------------------------------------------------------------------------
+// Generateur : sequence silence / pas
+// -----------------------------------------------------------------------------
+class SweepSchedule {
+public:
+    enum class Phase : uint8_t { IDLE, START, STEP, GAP };
+
+    void start(const SweepList& list, uint32_t nowMs);
+    void stop() { phase_ = Phase::IDLE; }
+
+    // true si la phase vient de changer : l'appelant allume le PWM a freqHz()
+    // en phase STEP, l'eteint sinon. Retour a IDLE apres le dernier pas.
+    bool update(uint32_t nowMs);
+
+    Phase    phase()   const { return phase_; }
+    bool     running() const { return phase_ != Phase::IDLE; }
+    uint8_t  step()    const { return step_; }
+    uint8_t  size()    const { return list_.size; }
+    uint32_t freqHz()  const { return list_.freqHz[step_]; }
+
+private:
+    SweepList list_  = {};
+    Phase     phase_ = Phase::IDLE;
+    uint8_t   step_  = 0;
+    uint32_t  phaseStartMs_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Recepteur : statistiques des periodes d'un pas
+// -----------------------------------------------------------------------------
+class PeriodStats {
+public:
+    // Periode attendue en ticks : reference de la gigue et des aberrantes
+    void reset(uint32_t expectedTicks) {
+        expected_ = expectedTicks;
+        count_    = 0;
+        outliers_ = 0;
+        sum_      = 0;
+        sumSq_    = 0;
+    }
+
+    // Meme interface que ReciprocalEstimator : alimente par EdgeTimer::poll()
+    void pushPeriod(uint32_t ticks) {
+        int64_t d = (int64_t)ticks - (int64_t)expected_;
+        if (expected_ == 0 || d > (int64_t)(expected_ / 2) || -d > (int64_t)(expected_ / 2)) {
+            outliers_++;
+            return;
+        }
+        count_++;
+        sum_   += d;
+        sumSq_ += (uint64_t)(d * d);
+    }
+
+    uint32_t count()    const { return count_; }
+    uint32_t outliers() const { return outliers_; }
+
+    // Ecart type des periodes retenues, en ticks
+    uint32_t stdDevTicks() const;
+
+private:
+    uint32_t expected_ = 0;
+    uint32_t count_    = 0;
+    uint32_t outliers_ = 0;
+    int64_t  sum_      = 0;     // ecarts a la periode attendue
+    uint64_t sumSq_    = 0;
+};
+
+struct SweepStepResult {
+    uint8_t  step;
+    uint32_t emittedHz;       // 0 si le pas depasse la liste
+    uint32_t meanHz;
+    uint32_t minHz;
+    uint32_t maxHz;
+    uint16_t ratioPermille;   // mesure / emis
+    uint32_t jitterNs;
+    int32_t  lossPermille;    // > 0 : fronts perdus, < 0 : fronts parasites
+    uint32_t outliers;        // periodes hors ±50 %
+    uint16_t windows;
+};
+
+extern const char SWEEP_CSV_HEADER[];
+
+// Ligne CSV sans fin de ligne ; retourne la longueur (snprintf)
+int formatSweepCsv(const SweepStepResult& r, char* buf, size_t len);
+
+// Relit une ligne produite par formatSweepCsv (false pour toute autre ligne
+// du moniteur serie : en-tete, messages, ligne tronquee)
+bool parseSweepCsv(const char* line, SweepStepResult& out);
+
+class SweepTracker {
+public:
+    enum class Event : uint8_t { NONE, STEP_BEGIN, STEP_END };
+
+    explicit SweepTracker(uint32_t tickHz) : tickHz_(tickHz) {}
+
+    void setList(const SweepList& list) { list_ = list; }
+    void setTickHz(uint32_t tickHz) { tickHz_ = tickHz; }
+    void reset();
+
+    // Fenetre de comptage terminee (count fronts en elapsedMs).
+    // STEP_BEGIN : l'appelant vide son EdgeTimer (flush) — les periodes du
+    // pas vont dans periods(). STEP_END : result() contient le pas termine.
+    Event pushWindow(uint32_t count, uint32_t elapsedMs);
+
+    PeriodStats&           periods()      { return periods_; }
+    const SweepStepResult& result() const { return result_; }
+
+    bool inStep() const { return inStep_; }
+
+private:
+    void beginStep(uint32_t firstFreqHz);
+    void commitWindow(uint32_t count, uint32_t elapsedMs);
+    void commitHeld();
+    void finishStep();
+
+    SweepList       list_     = {};
+    uint32_t        tickHz_;
+    PeriodStats     periods_;
+    SweepStepResult result_   = {};
+
+    uint32_t clockMs_   = 0;        // somme des fenetres recues
+    bool     inStep_    = false;
+    bool     synced_    = false;    // debut du pas 0 connu
+    bool     syncArmed_ = false;    // long silence vu, pas 0 a venir
+    uint32_t step0Ms_   = 0;
+    uint8_t  nextStep_  = 0;
+    uint32_t silenceMs_ = 0;
+
+    // Pas en cours. La fenetre precedente reste en attente (ignoree si c'est
+    // la derniere) ; les fenetres silencieuses aussi, tant qu'on ne sait pas
+    // si c'est la fin du pas ou un trou.
+    uint32_t emittedHz_  = 0;
+    bool     hasPending_ = false;
+    uint32_t pendCount_  = 0;
+    uint32_t pendMs_     = 0;
+    uint32_t heldCount_  = 0;
+    uint32_t heldMs_     = 0;
+    uint16_t heldWindows_ = 0;
+    uint32_t edges_      = 0;
+    uint32_t durationMs_ = 0;
+    uint32_t minHz_      = 0;
+    uint32_t maxHz_      = 0;
+    uint16_t windows_    = 0;
+};
+
+}  // namespace fencing
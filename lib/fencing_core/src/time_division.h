@@ -0,0 +1,236 @@
+// =============================================================================
+// time_division.h — Mode Time-Division sur la ligne C (coque)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// CYCLE (cf. PROJECT_PLAN.md, "Mode Time-Division") :
+//
+//   EMIT   9 ms : GP15 = HIGH (pull-up alimentee), GP17 = PWM Freq_NEUTRE
+//   DETECT 1 ms : GP17 coupe puis GP15 = LOW ; GP16 echantillonne a
+//                 TD_SETTLE_US apres la coupure de GP15
+//   bouton vu presse → FULL DETECT des cet echantillon : GP15 / GP17 restent
+//                 LOW, GP16 echantillonne toutes les TD_FULL_SAMPLE_US ;
+//                 TD_RELEASE_SAMPLES echantillons relaches → EMIT
+//
+// TEMPS DE STABILISATION :
+//   GP15 coupe, la ligne C ne tient plus qu'a la pull-up interne de GP16
+//   (~50 kΩ). Avec ~10 nF de fil de fleuret, tau ≈ 500 µs : il faut ~1.4 tau
+//   (700 µs) pour passer VIH = 2.0 V depuis 0 V. Bouton ferme, la pull-down
+//   10 kΩ de GP2 ramene la ligne a LOW beaucoup plus vite.
+//
+// LATENCE BOUTON :
+//   Pire cas : appui juste apres un echantillon → vu au DETECT suivant,
+//   TD_EMIT_US + TD_DETECT_US plus tard (10 ms), plus la latence de
+//   l'interruption. Il reste ~5 ms de mesure de frequence dans un contact
+//   de 15 ms (dwell FIE), GP2 etant propre des l'entree en FULL DETECT.
+//
+// CADENCEMENT :
+//   TimeDivision ne fait que la logique : chaque echeance calcule la
+//   suivante a partir de l'echeance theorique precedente (pas de l'instant
+//   reel), donc la latence d'interruption ne s'accumule pas. Seule exception,
+//   l'echantillon : il est place TD_SETTLE_US apres la coupure REELLE de la
+//   pull-up, sinon une interruption retardee au debut du creneau raccourcit
+//   la stabilisation et le bouton est lu LOW a tort. Le pilote
+//   TdAlarmDriver (RP2040) appelle onDeadline() depuis une alarme materielle
+//   du timer 1 µs ; sur hote, host_tools tdsim l'appelle depuis une
+//   simulation a evenements discrets, et FakeTdDriver (meme interface que
+//   le pilote, echeances jouees par l'appelant) sert a host_tools boutsim.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "hal.h"
+#include "trace_ring.h"
+
+namespace fencing {
+
+constexpr uint32_t TD_EMIT_US         = 9000;
+constexpr uint32_t TD_DETECT_US       = 1000;
+constexpr uint32_t TD_SETTLE_US       = 700;
+constexpr uint32_t TD_FULL_SAMPLE_US  = 1000;
+constexpr uint8_t  TD_RELEASE_SAMPLES = 5;      // 5 ms relache avant de reemettre
+
+static_assert(TD_SETTLE_US < TD_DETECT_US, "l'echantillon doit tomber dans le creneau DETECT");
+
+enum class TdPhase : uint8_t { IDLE, EMIT, DETECT, FULL_DETECT };
+
+class TimeDivision {
+public:
+    // Io : void setSupply(bool)  GP15 (pull-up de la coque alimentee)
+    //      void setEmit(bool)    GP17 (porte du PWM Freq_NEUTRE)
+    //      bool readButton()     GP16 (HIGH = bouton presse)
+    // Retourne l'echeance suivante (µs absolues).
+    template <typename Io>
+    uint64_t start(uint64_t nowUs, Io& io) {
+        pressed_ = false;
+        return enterEmit(nowUs, io);
+    }
+
+    template <typename Io>
+    void stop(Io& io) {
+        io.setEmit(false);
+        io.setSupply(false);
+        phase_   = TdPhase::IDLE;
+        pressed_ = false;
+    }
+
+    // dueUs : echeance programmee, nowUs : instant reel du traitement
+    template <typename Io>
+    uint64_t onDeadline(uint64_t dueUs, uint64_t nowUs, Io& io) {
+        switch (next_) {
+            case Step::DETECT:
+                io.setEmit(false);              // MOSFET B bloque avant de couper la pull-up
+                io.setSupply(false);
+                phase_  = TdPhase::DETECT;
+                slotUs_ = dueUs;
+                next_   = Step::SAMPLE;
+                return nowUs + TD_SETTLE_US;    // depuis la coupure reelle
+
+            case Step::SAMPLE:
+                samples_++;
+                if (io.readButton()) {
+                    phase_   = TdPhase::FULL_DETECT;
+                    pressed_ = true;
+                    released_ = 0;
+                    next_    = Step::FULL_SAMPLE;
+                    return dueUs + TD_FULL_SAMPLE_US;
+                }
+                next_ = Step::EMIT;
+                return slotUs_ + TD_DETECT_US;
+
+            case Step::EMIT:
+                return enterEmit(dueUs, io);
+
+            case Step::FULL_SAMPLE:
+                samples_++;
+                if (io.readButton()) {
+                    released_ = 0;
+                } else if (++released_ >= TD_RELEASE_SAMPLES) {
+                    pressed_ = false;
+                    return enterEmit(dueUs, io);
+                }
+                return dueUs + TD_FULL_SAMPLE_US;
+        }
+        return dueUs + TD_EMIT_US;
+    }
+
+    TdPhase  phase()   const { return phase_; }
+    // Bouton vu presse par le dernier echantillon (filtre au relachement)
+    bool     pressed() const { return pressed_; }
+    uint32_t samples() const { return samples_; }
+
+private:
+    enum class Step : uint8_t { DETECT, SAMPLE, EMIT, FULL_SAMPLE };
+
+    template <typename Io>
+    uint64_t enterEmit(uint64_t dueUs, Io& io) {
+        io.setSupply(true);                     // pull-up alimentee avant d'emettre
+        io.setEmit(true);
+        phase_ = TdPhase::EMIT;
+        next_  = Step::DETECT;
+        return dueUs + TD_EMIT_US;
+    }
+
+    // Ecrits sous interruption, lus par la boucle du meme coeur
+    volatile TdPhase  phase_    = TdPhase::IDLE;
+    volatile bool     pressed_  = false;
+    volatile uint32_t samples_  = 0;
+
+    Step     next_     = Step::EMIT;
+    uint64_t slotUs_   = 0;
+    uint8_t  released_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Pilote RP2040 : alarme materielle du timer, interruption sur le coeur qui
+// appelle begin() (coeur 1 dans fencer_firmware)
+// -----------------------------------------------------------------------------
+#if defined(ARDUINO_ARCH_RP2040)
+class TdAlarmDriver {
+public:
+    // pwmStart(pinEmit, emitFreqHz) puis cycle EMIT / DETECT
+    bool begin(uint8_t pinSupply, uint8_t pinEmit, uint8_t pinButton, uint32_t emitFreqHz);
+    void end();
+
+    const TimeDivision& state() const { return td_; }
+
+    // Echeances deja passees quand l'alarme a ete reprogrammee
+    uint32_t lateCount() const { return late_; }
+
+    // Changements de phase traces sous interruption : anneau reserve a
+    // l'interruption (un seul ecrivain), a poser avant begin()
+    void setTrace(TraceRing* trace) { trace_ = trace; }
+
+private:
+    static void onAlarm(unsigned int alarmNum);
+    void        service();
+
+    TimeDivision      td_;
+    int               alarm_ = -1;
+    uint64_t          due_   = 0;
+    volatile uint32_t late_  = 0;
+    TraceRing*        trace_ = nullptr;
+    uint8_t           pinSupply_ = 0;
+    uint8_t           pinEmit_   = 0;
+    uint8_t           pinButton_ = 0;
+};
+#endif
+
+// -----------------------------------------------------------------------------
+// Doublure hote : broches par la HAL, l'alarme, c'est l'appelant
+// -----------------------------------------------------------------------------
+class FakeTdDriver {
+public:
+    bool begin(uint8_t pinSupply, uint8_t pinEmit, uint8_t pinButton, uint32_t emitFreqHz) {
+        io_ = { pinSupply, pinEmit, pinButton };
+        hal::pinOutput(pinSupply, false);
+        hal::pinInput(pinButton, hal::Pull::UP);
+        hal::pwmStart(pinEmit, emitFreqHz);
+        due_ = td_.start(hal::nowUs(), io_);
+        return true;
+    }
+    void end() {
+        td_.stop(io_);
+        hal::pwmStop(io_.emit);
+    }
+
+    const TimeDivision& state() const { return td_; }
+    uint32_t lateCount() const { return 0; }
+    void setTrace(TraceRing* trace) { trace_ = trace; }
+
+    // Prochaine echeance (horloge de la carte)
+    uint64_t dueUs() const { return due_; }
+
+    // L'echeance dueUs(), traitee a hal::nowUs()
+    void service() {
+        TdPhase  before = td_.phase();
+        uint64_t now    = hal::nowUs();
+        due_ = td_.onDeadline(due_, now, io_);
+        if (trace_ && td_.phase() != before)
+            trace_->record(now, TraceTag::TD_PHASE, (uint8_t)td_.phase());
+    }
+
+private:
+    struct HalIo {
+        uint8_t supply, emit, button;
+
+        void setSupply(bool on) { hal::pinWrite(supply, on); }
+        void setEmit(bool on)   { hal::pwmGate(emit, on); }
+        bool readButton()       { return hal::pinRead(button); }
+    };
+
+    TimeDivision td_;
+    HalIo        io_    = {};
+    uint64_t     due_   = 0;
+    TraceRing*   trace_ = nullptr;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+typedef TdAlarmDriver TdDriver;
+#else
+typedef FakeTdDriver TdDriver;
+#endif
+
+}  // namespace fencing
@@ -0,0 +1,94 @@
+// =============================================================================
+// time_division_rp2040.cpp — Cadencement du Mode Time-Division par alarme
+// =============================================================================
+
+#include "time_division.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/gpio.h>
+#include <hardware/timer.h>
+
+#include "hal.h"
+
+namespace fencing {
+
+namespace {
+
+// Le callback d'alarme du SDK ne recoit que le numero d'alarme
+TdAlarmDriver* activeDriver = nullptr;
+
+struct GpioIo {
+    uint8_t supply, emit, button;
+
+    void setSupply(bool on) { gpio_put(supply, on); }
+    void setEmit(bool on)   { hal::pwmGate(emit, on); }
+    bool readButton()       { return gpio_get(button); }
+};
+
+}  // namespace
+
+bool TdAlarmDriver::begin(uint8_t pinSupply, uint8_t pinEmit, uint8_t pinButton,
+                          uint32_t emitFreqHz) {
+    if (activeDriver)
+        return false;
+    alarm_ = hardware_alarm_claim_unused(false);
+    if (alarm_ < 0)
+        return false;
+
+    pinSupply_ = pinSupply;
+    pinEmit_   = pinEmit;
+    pinButton_ = pinButton;
+
+    hal::pinOutput(pinSupply_, false);
+    hal::pinInput(pinButton_, hal::Pull::UP);
+    hal::pwmStart(pinEmit_, emitFreqHz);
+
+    activeDriver = this;
+    hardware_alarm_set_callback((uint)alarm_, onAlarm);
+
+    GpioIo io = { pinSupply_, pinEmit_, pinButton_ };
+    due_ = td_.start(time_us_64(), io);
+    if (hardware_alarm_set_target((uint)alarm_, from_us_since_boot(due_)))
+        service();
+    return true;
+}
+
+void TdAlarmDriver::end() {
+    if (alarm_ < 0)
+        return;
+    hardware_alarm_cancel((uint)alarm_);
+    hardware_alarm_set_callback((uint)alarm_, nullptr);
+    hardware_alarm_unclaim((uint)alarm_);
+    alarm_ = -1;
+    activeDriver = nullptr;
+
+    GpioIo io = { pinSupply_, pinEmit_, pinButton_ };
+    td_.stop(io);
+    hal::pwmStop(pinEmit_);
+}
+
+void TdAlarmDriver::onAlarm(unsigned int) {
+    if (activeDriver)
+        activeDriver->service();
+}
+
+// Sous interruption : traite l'echeance, programme la suivante. Si elle est
+// deja passee (interruption retardee), on la traite tout de suite.
+void TdAlarmDriver::service() {
+    GpioIo io = { pinSupply_, pinEmit_, pinButton_ };
+    for (;;) {
+        TdPhase  before = td_.phase();
+        uint64_t now    = time_us_64();
+        due_ = td_.onDeadline(due_, now, io);
+        if (trace_ && td_.phase() != before)
+            trace_->record(now, TraceTag::TD_PHASE, (uint8_t)td_.phase());
+        if (!hardware_alarm_set_target((uint)alarm_, from_us_since_boot(due_)))
+            return;
+        late_ = late_ + 1;
+    }
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
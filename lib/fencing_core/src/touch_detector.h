@@ -0,0 +1,233 @@
+// =============================================================================
+// touch_detector.h — Machine a etats bouton / frequence d'un tireur
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Tout le chemin de detection de la boucle de phase1_5, sans Serial ni
+//   millis() : l'appelant fournit l'instant, la lecture brute du bouton et
+//   le chronometre de periodes (EdgeTimer), et recupere des FencerEvent
+//   dans un puits (SpscQueue sur le Pico, vecteur sur hote).
+//
+//   repos ──appui filtre──▶ BUTTON_DOWN
+//   appui ──N periodes de contact continu, classe dans une bande et
+//           confiance >= CONTACT_MIN_CONFIDENCE──▶ DECISION (une fois par
+//           appui ; value = confiance pour mille, contact_estimator.h)
+//   appui ──15 ms de contact valide continu──▶ DWELL (DwellTracker, des
+//                          que c'est acquis, sans attendre le relachement)
+//   appui ──15 ms sans decision ni contact valide en cours──▶ DWELL classe
+//                          NONE (touche blanche, datee appui + 15 ms ; une
+//                          fois par appui, jamais apres un DWELL valide)
+//   appui ──relachement──▶ TOUCH (classe decidee, NONE si aucune mesure
+//                          stable = touche blanche ; duree d'appui en µs)
+//
+// Le chronometre est lu a chaque appel, appuye ou non : ses fronts sont
+// dates (pollEdges) et ceux d'avant l'appui ignores, donc rien a vider a
+// l'appui et pas de periode perdue entre la bascule antidatee et le poll.
+//
+// TRACE (optionnelle, setTrace) : bascules filtrees du bouton, changements
+// de classe des periodes de GP2 (les mesures aberrantes a l'etablissement et
+// a la rupture du contact), anomalie si une periode hors bandes arrive
+// pendant l'appui. Sans trace : un test de pointeur par front.
+//
+// LATENCE : chaque evenement de l'appui porte ses estampilles (premier front
+// de GP2 de l'appui, classification, dwell declare ; latency_probe.h), les
+// etapes suivantes sont marquees en aval.
+//
+// QUALITE (optionnelle, setContactQuality) : note d'amplitude de GP2 pour
+// mille (amplitude_meter.h). Connue, elle multiplie la confiance avant le
+// seuil : une fuite capacitive qui fait basculer GP2 sans creneau franc ne
+// decide pas. Le dwell (niveau logique seul) n'est pas touche.
+//
+// BANDES (optionnelles, setPlan) : plan calibre au branchement du tireur
+// (carrier_calibration.h) pour l'estimateur, le dwell et la trace ; sans
+// plan, FREQ_PLAN compile.
+//
+// BORNE : un appel de step() lit au plus un buffer PIO (RING_SIZE periodes)
+// et pousse au plus quatre evenements, sans allocation ni attente.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "classifier.h"
+#include "debounce.h"
+#include "dwell_tracker.h"
+#include "contact_estimator.h"
+#include "fencer_event.h"
+#include "trace_ring.h"
+
+namespace fencing {
+
+const uint8_t  DETECT_PERIODS          = 4;        // periodes de contact continu pour decider
+const uint16_t CONTACT_QUALITY_UNKNOWN = 0xFFFF;   // pas de mesure d'amplitude
+
+class TouchDetector {
+public:
+    // debounceMs = 0 quand la lecture est deja filtree (Mode Time-Division)
+    explicit TouchDetector(uint32_t tickHz = 0, uint32_t debounceMs = DEBOUNCE_MS)
+        : button_(debounceMs), est_(tickHz), dwell_(tickHz), tickHz_(tickHz) {}
+
+    void setTickHz(uint32_t tickHz) {
+        est_.setTickHz(tickHz);
+        dwell_.setTickHz(tickHz);
+        tickHz_ = tickHz;
+    }
+
+    // Bandes calibrees (nullptr : FREQ_PLAN). Hors appui ; a reposer si
+    // le contenu du plan change.
+    void setPlan(const BandPlan* plan) {
+        plan_ = plan;
+        est_.setPlan(plan);
+        dwell_.setPlan(plan);
+    }
+
+    // Anneau du contexte qui appelle step() (coeur 1), nullptr pour aucun
+    void setTrace(TraceRing* trace) { trace_ = trace; }
+
+    // Derniere note d'amplitude (0..1000), CONTACT_QUALITY_UNKNOWN pour
+    // decider sur la seule confiance
+    void setContactQuality(uint16_t permille) { quality_ = permille; }
+    uint16_t contactQuality() const { return quality_; }
+
+    // Timer : PioEdgeTimer / FakeEdgeTimer
+    // Sink  : tout type avec bool push(const FencerEvent&)
+    template <typename Timer, typename Sink>
+    void step(uint32_t nowMs, bool rawPressed, Timer& timer, Sink& out) {
+        uint64_t nowUs = (uint64_t)nowMs * 1000u;
+        stepFiltered(nowUs, button_.update(rawPressed, nowMs), nowUs, timer, out);
+    }
+
+    // Bouton deja filtre (ButtonSampler, Mode Time-Division). edgeUs :
+    // instant de la derniere bascule, antidate par le filtre ; sert de
+    // debut d'appui (BUTTON_DOWN) et de fin (TOUCH).
+    template <typename Timer, typename Sink>
+    void stepFiltered(uint64_t nowUs, bool pressed, uint64_t edgeUs, Timer& timer, Sink& out) {
+        if (pressed && !pressed_) {
+            pressUs_ = edgeUs;
+            decided_ = false;
+            cls_     = FreqClass::NONE;
+            freqHz_  = 0;
+            firstEdgeUs_  = 0;
+            classifiedUs_ = 0;
+            dwellUs_      = 0;
+            blank_        = false;
+            est_.reset();
+            dwell_.press(edgeUs);
+            if (trace_) trace_->record(edgeUs, TraceTag::BUTTON, 1);
+            out.push(event(FencerEventType::BUTTON_DOWN, edgeUs, 0));
+        }
+        pressed_ = pressed;
+
+        Edges edges = { *this };
+        timer.pollEdges(edges, nowUs);
+
+        if (pressed && !decided_ && est_.ready()) {
+            ContactEstimate e = est_.estimate();
+            uint32_t confidence = e.confidence;
+            if (quality_ != CONTACT_QUALITY_UNKNOWN)
+                confidence = confidence * quality_ / 1000u;
+            if (confidence >= CONTACT_MIN_CONFIDENCE) {
+                decided_ = true;
+                freqHz_  = e.freqHz;
+                cls_     = e.cls;
+                classifiedUs_ = nowUs;
+                out.push(event(FencerEventType::DECISION, nowUs, confidence));
+            }
+        }
+
+        if (pressed && dwell_.update(nowUs)) {
+            dwellUs_ = nowUs;
+            FencerEvent ev = event(FencerEventType::DWELL, dwell_.satisfiedAtUs(),
+                                   (uint32_t)(nowUs - dwell_.satisfiedAtUs()));
+            ev.cls = dwell_.contactClass();
+            out.push(ev);
+        }
+
+        // Touche blanche : cls_ reste NONE tant que rien n'est decide
+        if (pressed && !blank_ && !decided_ && !dwell_.satisfied() && !dwell_.inContact() &&
+            nowUs >= pressUs_ + DWELL_MIN_US) {
+            blank_ = true;
+            uint64_t tUs = pressUs_ + DWELL_MIN_US;
+            out.push(event(FencerEventType::DWELL, tUs, (uint32_t)(nowUs - tUs)));
+        }
+
+        if (!pressed && dwell_.pressed()) {
+            dwell_.release(edgeUs);
+            if (trace_) trace_->record(edgeUs, TraceTag::BUTTON, 0);
+            out.push(event(FencerEventType::TOUCH, edgeUs, (uint32_t)(edgeUs - pressUs_)));
+        }
+    }
+
+    bool pressed() const { return pressed_; }
+    bool decided() const { return decided_; }
+    const DwellTracker& dwell() const { return dwell_; }
+    const ContactEstimator<DETECT_PERIODS>& estimator() const { return est_; }
+
+private:
+    // Fronts dates : periodes de l'appui vers l'estimateur de contact (jusqu'a
+    // la decision), tous vers le suivi du dwell
+    struct Edges {
+        TouchDetector& d;
+
+        void pushEdge(uint64_t tUs, uint32_t ticks) {
+            if (d.pressed_ && !d.firstEdgeUs_ && tUs > d.pressUs_)
+                d.firstEdgeUs_ = tUs;
+            if (d.pressed_ && !d.decided_ && tUs > d.pressUs_)
+                d.est_.pushPeriod(ticks);
+            d.dwell_.pushEdge(tUs, ticks);
+            if (d.trace_)
+                d.tracePeriod(tUs, ticks);
+        }
+    };
+
+    void tracePeriod(uint64_t tUs, uint32_t ticks) {
+        uint32_t  hz = ticks ? tickHz_ / ticks : 0;
+        FreqClass c  = plan_ ? plan_->classify(hz) : classifyFrequency(hz);
+        if (c == traceCls_)
+            return;
+        traceCls_ = c;
+        trace_->record(tUs, TraceTag::PERIOD, (uint8_t)c, traceSaturate(hz));
+        if (c == FreqClass::UNKNOWN && pressed_)
+            trace_->trigger(tUs, TraceAnomaly::ABERRANT, traceSaturate(hz));
+    }
+
+    FencerEvent event(FencerEventType type, uint64_t tUs, uint32_t value) const {
+        FencerEvent ev = {};
+        ev.type   = type;
+        ev.cls    = cls_;
+        ev.tUs    = tUs;
+        ev.freqHz = freqHz_;
+        ev.value  = value;
+        if (firstEdgeUs_) {
+            latencyAnchor(ev.lat, firstEdgeUs_, tUs);
+            if (classifiedUs_) latencyMark(ev.lat, LatencyStage::CLASSIFIED, classifiedUs_, tUs);
+            if (dwellUs_)      latencyMark(ev.lat, LatencyStage::DWELL, dwellUs_, tUs);
+        }
+        return ev;
+    }
+
+    Debouncer button_;
+    ContactEstimator<DETECT_PERIODS> est_;
+    DwellTracker dwell_;
+    uint32_t     tickHz_;
+    const BandPlan* plan_  = nullptr;
+    TraceRing*   trace_    = nullptr;
+    uint16_t     quality_  = CONTACT_QUALITY_UNKNOWN;
+    FreqClass    traceCls_ = FreqClass::NONE;   // classe de la derniere periode tracee
+
+    bool      pressed_ = false;
+    bool      decided_ = false;
+    uint64_t  pressUs_ = 0;
+    bool      blank_   = false;     // touche blanche declaree pour cet appui
+    FreqClass cls_     = FreqClass::NONE;
+    uint32_t  freqHz_  = 0;
+
+    // Estampilles de l'appui (0 : pas encore)
+    uint64_t  firstEdgeUs_  = 0;
+    uint64_t  classifiedUs_ = 0;
+    uint64_t  dwellUs_      = 0;
+};
+
+}  // namespace fencing
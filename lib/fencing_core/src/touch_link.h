@@ -0,0 +1,219 @@
+// =============================================================================
+// touch_link.h — Envoi redondant et acquitte des evenements tireur → central
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// UDP sur WiFi perd des datagrammes par rafales (collisions, balayage du
+// CYW43, interferences 2.4 GHz) ; attendre un timeout pour retransmettre
+// coute des dizaines de ms, alors que la fenetre de double touche FIE est
+// de 40 a 50 ms. D'ou :
+//
+//   EMETTEUR (TouchSender, tireur)
+//     - LINK_COPIES copies espacees de LINK_SPACING_US, la premiere tout de
+//       suite : une rafale de pertes plus courte que l'espacement ne coute
+//       rien en latence
+//     - tant qu'aucun acquittement n'est arrive, une copie de plus toutes
+//       les LINK_RETRY_US, jusqu'a LINK_DEADLINE_US (au-dela, la touche est
+//       hors delai pour le central : on abandonne)
+//     - au plus LINK_PENDING evenements en vol, tableau fixe, sans tas
+//
+//   RECEPTEUR (TouchReceiver, central)
+//     - acquitte CHAQUE copie recue (l'acquittement peut lui-meme se perdre)
+//     - deduplication par (tireur, seq) : fenetre glissante de 64 numeros
+//       par tireur
+//     - redemarrage du tireur (seq repart de 0) : la trame porte la session
+//       tiree a son demarrage (hal::bootNonce) ; session differente → la
+//       fenetre repart de ce numero, meme s'il tombe dans les 64 derniers.
+//       Un emetteur sans setSession() envoie toujours TOUCH_SESSION_NONE :
+//       seul un numero tres en arriere (> 64) est alors pris pour un
+//       redemarrage. Un acquittement de l'ancienne session
+//       ne peut pas acquitter la nouvelle : le tireur met plusieurs
+//       secondes a se reassocier, bien plus que LINK_DEADLINE_US.
+//
+// Link : UdpLink (udp_link.h) ou tout type offrant sendEvent / sendAck.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "touch_wire.h"
+#include "trace_ring.h"
+#include "udp_link.h"
+
+namespace fencing {
+
+constexpr uint8_t  LINK_COPIES      = 3;
+constexpr uint32_t LINK_SPACING_US  = 2000;
+constexpr uint32_t LINK_RETRY_US    = 8000;
+constexpr uint32_t LINK_DEADLINE_US = 100000;
+constexpr uint8_t  LINK_PENDING     = 8;
+
+constexpr uint16_t LINK_PORT_CENTRAL = 4210;
+constexpr uint16_t LINK_PORT_FENCER  = 4211;
+
+// Point d'acces du central (redefinissables par build_flags)
+#ifndef LINK_SSID
+#define LINK_SSID "escrime-central"
+#endif
+#ifndef LINK_PASS
+#define LINK_PASS "escrime-central"
+#endif
+
+struct LinkStats {
+    uint32_t queued    = 0;   // evenements confies a l'emetteur
+    uint32_t datagrams = 0;   // copies envoyees (premiere comprise)
+    uint32_t acked     = 0;
+    uint32_t expired   = 0;   // abandonnes sans acquittement
+    uint32_t overflow  = 0;   // refuses, LINK_PENDING en vol
+    uint32_t ackMaxUs  = 0;   // pire delai envoi → acquittement
+};
+
+template <typename Link>
+class TouchSender {
+public:
+    explicit TouchSender(Link& link) : link_(link) {}
+
+    // Session de ce demarrage, recopiee dans chaque trame (hal::bootNonce())
+    void setSession(uint32_t session) { session_ = session; }
+    uint32_t session() const { return session_; }
+
+    // Premiere copie envoyee tout de suite. false si la file est pleine.
+    bool send(const TouchEvent& ev, uint64_t nowUs) {
+        Pending* slot = nullptr;
+        for (Pending& p : pending_)
+            if (!p.used) { slot = &p; break; }
+        if (!slot) {
+            stats_.overflow++;
+            return false;
+        }
+        slot->used   = true;
+        slot->ev     = ev;
+        slot->sentUs = nowUs;
+        slot->ev.session = session_;
+        slot->copies = 0;
+        stats_.queued++;
+        transmit(*slot, nowUs);
+        return true;
+    }
+
+    // A appeler a chaque tour de loop() : copies et relances dues, abandons
+    void poll(uint64_t nowUs) {
+        for (Pending& p : pending_) {
+            if (!p.used || nowUs < p.nextUs)
+                continue;
+            if (nowUs - p.sentUs >= LINK_DEADLINE_US) {
+                p.used = false;
+                stats_.expired++;
+                continue;
+            }
+            transmit(p, nowUs);
+        }
+    }
+
+    void onAck(uint8_t player, uint16_t seq, uint64_t nowUs) {
+        for (Pending& p : pending_) {
+            if (!p.used || p.ev.player != player || p.ev.seq != seq)
+                continue;
+            p.used = false;
+            stats_.acked++;
+            if (trace_) trace_->record(nowUs, TraceTag::ACK, 0, seq);
+            uint64_t rtt = nowUs - p.sentUs;
+            if (rtt > stats_.ackMaxUs) stats_.ackMaxUs = (uint32_t)rtt;
+        }
+    }
+
+    uint8_t inFlight() const {
+        uint8_t n = 0;
+        for (const Pending& p : pending_) n += p.used;
+        return n;
+    }
+
+    const LinkStats& stats() const { return stats_; }
+
+    // Trace des datagrammes et acquittements (anneau du coeur 0)
+    void setTrace(TraceRing* trace) { trace_ = trace; }
+
+private:
+    struct Pending {
+        bool       used = false;
+        uint8_t    copies;
+        TouchEvent ev;
+        uint64_t   sentUs;
+        uint64_t   nextUs;
+    };
+
+    void transmit(Pending& p, uint64_t nowUs) {
+        link_.sendEvent(p.ev);
+        stats_.datagrams++;
+        p.copies++;
+        if (trace_) trace_->record(nowUs, TraceTag::PACKET, p.copies, p.ev.seq);
+        p.nextUs = nowUs + (p.copies < LINK_COPIES ? LINK_SPACING_US : LINK_RETRY_US);
+    }
+
+    Link&      link_;
+    Pending    pending_[LINK_PENDING];
+    LinkStats  stats_;
+    TraceRing* trace_   = nullptr;
+    uint32_t   session_ = TOUCH_SESSION_NONE;
+};
+
+template <typename Link>
+class TouchReceiver {
+public:
+    explicit TouchReceiver(Link& link) : link_(link) {}
+
+    // Acquitte, puis true si l'evenement n'a jamais ete vu (a traiter)
+    bool onEvent(const TouchEvent& ev, const UdpPeer& from) {
+        link_.sendAck(from, ev.player, ev.seq);
+        if (ev.player != PLAYER_A && ev.player != PLAYER_B)
+            return false;
+        if (!window_[ev.player - 1].accept(ev.seq, ev.session)) {
+            duplicates_++;
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t duplicates() const { return duplicates_; }
+    uint32_t restarts() const { return window_[0].restarts + window_[1].restarts; }
+
+private:
+    // Bit i de seen : numero last - i deja recu
+    struct Window {
+        bool     started  = false;
+        uint16_t last     = 0;
+        uint64_t seen     = 0;
+        uint32_t session  = TOUCH_SESSION_NONE;
+        uint32_t restarts = 0;      // nouvelles sessions apres la premiere
+
+        bool accept(uint16_t seq, uint32_t from) {
+            int16_t ahead = (int16_t)(seq - last);
+            bool reboot = from != session;
+            if (!started || reboot || ahead < -63) {
+                if (started && reboot) restarts++;
+                started = true;     // premier evenement ou tireur redemarre
+                last    = seq;
+                seen    = 1;
+                session = from;
+                return true;
+            }
+            if (ahead > 0) {
+                seen  = ahead >= 64 ? 1 : (seen << ahead) | 1;
+                last  = seq;
+                return true;
+            }
+            uint64_t bit = 1ull << -ahead;
+            if (seen & bit)
+                return false;
+            seen |= bit;
+            return true;
+        }
+    };
+
+    Link&    link_;
+    Window   window_[2];
+    uint32_t duplicates_ = 0;
+};
+
+}  // namespace fencing
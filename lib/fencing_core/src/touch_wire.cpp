@@ -0,0 +1,228 @@
+// =============================================================================
+// touch_wire.cpp — Codage / decodage des trames TouchEvent
+// =============================================================================
+
+#include "touch_wire.h"
+
+#include "byte_order.h"
+#include "crc16.h"
+
+namespace fencing {
+
+namespace {
+
+const size_t OFF_MAGIC   = 0;
+const size_t OFF_VERSION = 1;
+const size_t OFF_LENGTH  = 2;
+const size_t OFF_TYPE    = 3;
+const size_t OFF_PLAYER  = 4;
+const size_t OFF_CLASS   = 5;
+const size_t OFF_SEQ     = 6;
+const size_t OFF_TIME    = 8;
+const size_t OFF_FREQ    = 16;
+const size_t OFF_VALUE   = 20;
+const size_t OFF_SYNC    = 24;
+const size_t OFF_LEAD    = 26;
+const size_t OFF_STAGES  = 30;      // LATENCY_FENCER_STAGES × 4 octets
+const size_t OFF_SESSION = 46;
+const size_t OFF_CRC     = 50;
+
+static_assert(OFF_CRC + 2 == TOUCH_WIRE_SIZE, "trame v1 : 52 octets");
+static_assert(OFF_STAGES + 4 * LATENCY_FENCER_STAGES == OFF_SESSION, "etapes du tireur");
+
+// Acquittement
+const size_t ACK_OFF_PLAYER = 3;
+const size_t ACK_OFF_SEQ    = 4;
+const size_t ACK_OFF_CRC    = 6;
+
+static_assert(ACK_OFF_CRC + 2 == TOUCH_ACK_SIZE, "acquittement v1 : 8 octets");
+
+// Synchronisation
+const size_t SYNC_OFF_PLAYER = 3;
+const size_t SYNC_OFF_SEQ    = 4;
+const size_t SYNC_OFF_T1     = 6;
+const size_t SYNC_OFF_T2     = 14;
+const size_t SYNC_OFF_T3     = 22;
+
+static_assert(SYNC_OFF_T2 + 2 == SYNC_REQUEST_SIZE, "requete de synchro : 16 octets");
+static_assert(SYNC_OFF_T3 + 8 + 2 == SYNC_REPLY_SIZE, "reponse de synchro : 32 octets");
+
+// Magic, version, longueur (exactement size) et CRC
+WireStatus checkFrame(const uint8_t* buf, size_t len, uint8_t magic, size_t size) {
+    if (!buf || len < OFF_LENGTH + 1)
+        return WireStatus::TOO_SHORT;
+    if (buf[OFF_MAGIC] != magic)
+        return WireStatus::BAD_MAGIC;
+    if (buf[OFF_VERSION] != TOUCH_WIRE_VERSION)
+        return WireStatus::BAD_VERSION;
+    if (buf[OFF_LENGTH] != size)
+        return WireStatus::BAD_LENGTH;
+    if (len < size)
+        return WireStatus::TOO_SHORT;
+    if (len > size)
+        return WireStatus::BAD_LENGTH;
+    if (get16(buf + size - 2) != crc16(buf, size - 2))
+        return WireStatus::BAD_CRC;
+    return WireStatus::OK;
+}
+
+bool validPlayer(uint8_t player) {
+    return player == PLAYER_A || player == PLAYER_B;
+}
+
+}  // namespace
+
+const char* wireStatusText(WireStatus s) {
+    switch (s) {
+        case WireStatus::OK:          return "OK";
+        case WireStatus::TOO_SHORT:   return "trame courte";
+        case WireStatus::BAD_MAGIC:   return "magic";
+        case WireStatus::BAD_VERSION: return "version";
+        case WireStatus::BAD_CRC:     return "CRC";
+        case WireStatus::BAD_FIELD:   return "champ hors plage";
+        case WireStatus::BAD_LENGTH:  return "longueur";
+    }
+    return "?";
+}
+
+size_t encodeTouchEvent(const TouchEvent& ev, uint8_t* buf, size_t cap) {
+    if (!buf || cap < TOUCH_WIRE_SIZE)
+        return 0;
+    buf[OFF_MAGIC]   = TOUCH_WIRE_MAGIC;
+    buf[OFF_VERSION] = TOUCH_WIRE_VERSION;
+    buf[OFF_LENGTH]  = (uint8_t)TOUCH_WIRE_SIZE;
+    buf[OFF_TYPE]    = (uint8_t)ev.type;
+    buf[OFF_PLAYER]  = ev.player;
+    buf[OFF_CLASS]   = (uint8_t)ev.cls;
+    put16(buf + OFF_SEQ, ev.seq);
+    put64(buf + OFF_TIME, ev.tUs);
+    put32(buf + OFF_FREQ, ev.freqHz);
+    put32(buf + OFF_VALUE, ev.value);
+    put16(buf + OFF_SYNC, ev.syncUs);
+    bool anchored = latencyAnchored(ev.lat);
+    put32(buf + OFF_LEAD, anchored ? ev.lat.leadUs : LATENCY_NONE);
+    for (uint8_t i = 0; i < LATENCY_FENCER_STAGES; i++)
+        put32(buf + OFF_STAGES + 4 * i, anchored ? latencyAt(ev.lat, (LatencyStage)i) : LATENCY_NONE);
+    put32(buf + OFF_SESSION, ev.session);
+    put16(buf + OFF_CRC, crc16(buf, OFF_CRC));
+    return TOUCH_WIRE_SIZE;
+}
+
+WireStatus decodeTouchEvent(const uint8_t* buf, size_t len, TouchEvent& out) {
+    WireStatus st = checkFrame(buf, len, TOUCH_WIRE_MAGIC, TOUCH_WIRE_SIZE);
+    if (st != WireStatus::OK)
+        return st;
+
+    uint8_t type   = buf[OFF_TYPE];
+    uint8_t player = buf[OFF_PLAYER];
+    uint8_t cls    = buf[OFF_CLASS];
+    if (type > (uint8_t)FencerEventType::DWELL || cls > (uint8_t)FreqClass::UNKNOWN ||
+        !validPlayer(player))
+        return WireStatus::BAD_FIELD;
+
+    out.type   = (FencerEventType)type;
+    out.player = player;
+    out.cls    = (FreqClass)cls;
+    out.seq    = get16(buf + OFF_SEQ);
+    out.tUs    = get64(buf + OFF_TIME);
+    out.freqHz = get32(buf + OFF_FREQ);
+    out.value  = get32(buf + OFF_VALUE);
+    out.syncUs = get16(buf + OFF_SYNC);
+    out.lat    = {};
+    if (get32(buf + OFF_LEAD) != LATENCY_NONE) {
+        out.lat.known  = 1;
+        out.lat.leadUs = get32(buf + OFF_LEAD);
+        for (uint8_t i = 0; i < LATENCY_FENCER_STAGES; i++)
+            latencySet(out.lat, (LatencyStage)i, get32(buf + OFF_STAGES + 4 * i));
+    }
+    out.session = get32(buf + OFF_SESSION);
+    return WireStatus::OK;
+}
+
+size_t encodeTouchAck(uint8_t player, uint16_t seq, uint8_t* buf, size_t cap) {
+    if (!buf || cap < TOUCH_ACK_SIZE)
+        return 0;
+    buf[OFF_MAGIC]      = TOUCH_ACK_MAGIC;
+    buf[OFF_VERSION]    = TOUCH_WIRE_VERSION;
+    buf[OFF_LENGTH]     = (uint8_t)TOUCH_ACK_SIZE;
+    buf[ACK_OFF_PLAYER] = player;
+    put16(buf + ACK_OFF_SEQ, seq);
+    put16(buf + ACK_OFF_CRC, crc16(buf, ACK_OFF_CRC));
+    return TOUCH_ACK_SIZE;
+}
+
+WireStatus decodeTouchAck(const uint8_t* buf, size_t len, uint8_t& player, uint16_t& seq) {
+    WireStatus st = checkFrame(buf, len, TOUCH_ACK_MAGIC, TOUCH_ACK_SIZE);
+    if (st != WireStatus::OK)
+        return st;
+    if (!validPlayer(buf[ACK_OFF_PLAYER]))
+        return WireStatus::BAD_FIELD;
+    player = buf[ACK_OFF_PLAYER];
+    seq    = get16(buf + ACK_OFF_SEQ);
+    return WireStatus::OK;
+}
+
+namespace {
+
+void putSyncHeader(const SyncExchange& ex, uint8_t magic, size_t size, uint8_t* buf) {
+    buf[OFF_MAGIC]       = magic;
+    buf[OFF_VERSION]     = TOUCH_WIRE_VERSION;
+    buf[OFF_LENGTH]      = (uint8_t)size;
+    buf[SYNC_OFF_PLAYER] = ex.player;
+    put16(buf + SYNC_OFF_SEQ, ex.seq);
+    put64(buf + SYNC_OFF_T1, ex.t1Us);
+}
+
+WireStatus getSyncHeader(const uint8_t* buf, size_t len, uint8_t magic, size_t size,
+                         SyncExchange& out) {
+    WireStatus st = checkFrame(buf, len, magic, size);
+    if (st != WireStatus::OK)
+        return st;
+    if (!validPlayer(buf[SYNC_OFF_PLAYER]))
+        return WireStatus::BAD_FIELD;
+    out.player = buf[SYNC_OFF_PLAYER];
+    out.seq    = get16(buf + SYNC_OFF_SEQ);
+    out.t1Us   = get64(buf + SYNC_OFF_T1);
+    return WireStatus::OK;
+}
+
+}  // namespace
+
+size_t encodeSyncRequest(const SyncExchange& ex, uint8_t* buf, size_t cap) {
+    if (!buf || cap < SYNC_REQUEST_SIZE)
+        return 0;
+    putSyncHeader(ex, SYNC_REQUEST_MAGIC, SYNC_REQUEST_SIZE, buf);
+    put16(buf + SYNC_OFF_T2, crc16(buf, SYNC_OFF_T2));
+    return SYNC_REQUEST_SIZE;
+}
+
+WireStatus decodeSyncRequest(const uint8_t* buf, size_t len, SyncExchange& out) {
+    SyncExchange ex = {};
+    WireStatus st = getSyncHeader(buf, len, SYNC_REQUEST_MAGIC, SYNC_REQUEST_SIZE, ex);
+    if (st == WireStatus::OK)
+        out = ex;
+    return st;
+}
+
+size_t encodeSyncReply(const SyncExchange& ex, uint8_t* buf, size_t cap) {
+    if (!buf || cap < SYNC_REPLY_SIZE)
+        return 0;
+    putSyncHeader(ex, SYNC_REPLY_MAGIC, SYNC_REPLY_SIZE, buf);
+    put64(buf + SYNC_OFF_T2, ex.t2Us);
+    put64(buf + SYNC_OFF_T3, ex.t3Us);
+    put16(buf + SYNC_REPLY_SIZE - 2, crc16(buf, SYNC_REPLY_SIZE - 2));
+    return SYNC_REPLY_SIZE;
+}
+
+WireStatus decodeSyncReply(const uint8_t* buf, size_t len, SyncExchange& out) {
+    SyncExchange ex = {};
+    WireStatus st = getSyncHeader(buf, len, SYNC_REPLY_MAGIC, SYNC_REPLY_SIZE, ex);
+    if (st != WireStatus::OK)
+        return st;
+    ex.t2Us = get64(buf + SYNC_OFF_T2);
+    ex.t3Us = get64(buf + SYNC_OFF_T3);
+    out = ex;
+    return WireStatus::OK;
+}
+
+}  // namespace fencing
@@ -0,0 +1,185 @@
+// =============================================================================
+// touch_wire.h — Format de trame des evenements tireur → central (UDP)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Remplace le "struct TouchEvent (a affiner)" de PROJECT_PLAN.md, dont la
+// disposition en memoire dependait du compilateur (alignement, ordre des
+// octets) et qui n'avait ni numero de sequence ni controle d'integrite.
+//
+// TRAME v1 : 52 octets, petit-boutiste, sans bourrage
+//
+//   off taille champ
+//    0   1     magic      0xF5
+//    1   1     version    TOUCH_WIRE_VERSION
+//    2   1     longueur   octets de la trame, CRC compris
+//    3   1     type       FencerEventType
+//    4   1     tireur     1 = A, 2 = B
+//    5   1     classe     FreqClass
+//    6   2     seq        numero d'evenement du tireur (rebouclage 16 bits)
+//    8   8     tUs        horloge du central si syncUs != TOUCH_SYNC_NONE,
+//                         sinon horloge locale du tireur (µs)
+//   16   4     freqHz
+//   20   4     value      selon le type (cf. fencer_event.h)
+//   24   2     syncUs     incertitude de tUs (µs, clock_sync.h) ;
+//                         TOUCH_SYNC_NONE : tUs en horloge du tireur
+//   26   4     leadUs     tUs - premier front de GP2, horloge du tireur
+//                         (latency_probe.h) ; LATENCY_NONE : pas d'estampille
+//   30   4     classe     premier front → classification (µs)
+//   34   4     dwell      premier front → dwell declare
+//   38   4     file       premier front → file du coeur 1
+//   42   4     emission   premier front → premiere copie UDP
+//                         (LATENCY_NONE : etape pas atteinte)
+//   46   4     session    alea tire au demarrage du tireur, non nul : seq
+//                         repart de 0 a chaque demarrage, le central remet
+//                         sa fenetre de doublons a zero quand la session
+//                         change (TOUCH_SESSION_NONE : emetteur sans session)
+//   50   2     crc        CRC-16/CCITT-FALSE des octets 0 .. 49
+//
+// ACQUITTEMENT (central → tireur), 8 octets :
+//
+//    0   1     magic      0xFA
+//    1   1     version    TOUCH_WIRE_VERSION
+//    2   1     longueur   8
+//    3   1     tireur
+//    4   2     seq        numero de l'evenement acquitte
+//    6   2     crc
+//
+// SYNCHRONISATION D'HORLOGE (clock_sync.h), echange a quatre instants :
+//
+//   requete (tireur → central), 16 octets     reponse (central → tireur), 32
+//    0   1     magic      0xFC                 0xFD
+//    1   1     version
+//    2   1     longueur   16                   32
+//    3   1     tireur
+//    4   2     seq        numero de la requete (recopie dans la reponse)
+//    6   8     t1         emission de la requete, horloge du tireur (recopie)
+//   14   8     t2                              reception, horloge du central
+//   22   8     t3                              emission de la reponse, central
+//   14 / 30    crc
+//
+// VERSIONS : une seule disposition par version et par type de trame. La
+// longueur annoncee et celle du datagramme doivent valoir exactement la
+// taille de la trame, sinon BAD_LENGTH (ou TOO_SHORT si le datagramme est
+// coupe) : un bit errone dans l'octet de longueur ne deplace jamais le CRC.
+// Tout changement de disposition change la version ; une version
+// differente est refusee.
+//
+// ZERO COPIE : encode / decode lisent et ecrivent directement dans le
+// buffer fourni (payload d'un pbuf lwIP, buffer statique), octet par octet :
+// aucun tas, aucune contrainte d'alignement, meme code sur le Cortex-M0+
+// (qui ne tolere pas les acces non alignes) et sur hote.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fencer_event.h"
+#include "freq_plan.h"
+
+namespace fencing {
+
+constexpr uint8_t TOUCH_WIRE_MAGIC   = 0xF5;
+constexpr uint8_t TOUCH_ACK_MAGIC    = 0xFA;
+constexpr uint8_t SYNC_REQUEST_MAGIC = 0xFC;
+constexpr uint8_t SYNC_REPLY_MAGIC   = 0xFD;
+constexpr uint8_t TOUCH_WIRE_VERSION = 1;
+constexpr size_t  TOUCH_WIRE_SIZE    = 52;
+constexpr size_t  TOUCH_ACK_SIZE     = 8;
+constexpr size_t  SYNC_REQUEST_SIZE  = 16;
+constexpr size_t  SYNC_REPLY_SIZE    = 32;
+constexpr size_t  WIRE_FRAME_MAX     = TOUCH_WIRE_SIZE;
+constexpr uint16_t TOUCH_SYNC_NONE   = 0xFFFF;  // tUs en horloge locale
+constexpr uint32_t TOUCH_SESSION_NONE = 0;      // TouchSender sans setSession()
+constexpr uint8_t PLAYER_A           = 1;
+constexpr uint8_t PLAYER_B           = 2;
+
+// Valeurs transmises : toute renumerotation casse le format
+static_assert((uint8_t)FencerEventType::DWELL == 4, "FencerEventType : valeurs figees");
+static_assert((uint8_t)FreqClass::UNKNOWN == 4, "FreqClass : valeurs figees");
+static_assert(WIRE_FRAME_MAX >= SYNC_REPLY_SIZE, "WIRE_FRAME_MAX : plus longue trame");
+
+struct TouchEvent {
+    FencerEventType type;
+    uint8_t         player;
+    FreqClass       cls;
+    uint16_t        seq;
+    uint64_t        tUs;
+    uint32_t        freqHz;
+    uint32_t        value;
+    uint16_t        syncUs;
+    LatencyStamps   lat;       // etapes du tireur ; le central ajoute les siennes
+    uint32_t        session;   // demarrage du tireur (TouchSender::setSession)
+};
+
+// Requete : t1 seul. Reponse : t1 recopie, t2 et t3 du central.
+struct SyncExchange {
+    uint8_t  player;
+    uint16_t seq;
+    uint64_t t1Us;
+    uint64_t t2Us;
+    uint64_t t3Us;
+};
+
+enum class WireStatus : uint8_t {
+    OK,
+    TOO_SHORT,      // moins d'octets que la trame
+    BAD_MAGIC,
+    BAD_VERSION,
+    BAD_CRC,
+    BAD_FIELD,      // type, tireur ou classe hors plage
+    BAD_LENGTH,     // longueur annoncee fausse, ou octets en trop
+};
+
+const char* wireStatusText(WireStatus s);
+
+// Ecrit la trame dans buf. Retourne TOUCH_WIRE_SIZE, ou 0 si cap est trop petit.
+size_t encodeTouchEvent(const TouchEvent& ev, uint8_t* buf, size_t cap);
+
+// Lit une trame de len octets. out n'est modifie que si le resultat est OK.
+WireStatus decodeTouchEvent(const uint8_t* buf, size_t len, TouchEvent& out);
+
+// Acquittement : memes regles (longueur exacte, version, CRC)
+size_t     encodeTouchAck(uint8_t player, uint16_t seq, uint8_t* buf, size_t cap);
+WireStatus decodeTouchAck(const uint8_t* buf, size_t len, uint8_t& player, uint16_t& seq);
+
+// Synchronisation : memes regles
+size_t     encodeSyncRequest(const SyncExchange& ex, uint8_t* buf, size_t cap);
+WireStatus decodeSyncRequest(const uint8_t* buf, size_t len, SyncExchange& out);
+size_t     encodeSyncReply(const SyncExchange& ex, uint8_t* buf, size_t cap);
+WireStatus decodeSyncReply(const uint8_t* buf, size_t len, SyncExchange& out);
+
+// pbuf lwIP (ou tout type avec payload, len, tot_len) : la trame doit tenir
+// dans le premier maillon (pbuf_alloc(PBUF_TRANSPORT, TOUCH_WIRE_SIZE, PBUF_RAM))
+template <typename Pbuf>
+size_t encodeTouchEvent(const TouchEvent& ev, Pbuf* p) {
+    return p ? encodeTouchEvent(ev, (uint8_t*)p->payload, p->len) : 0;
+}
+
+template <typename Pbuf>
+WireStatus decodeTouchEvent(const Pbuf* p, TouchEvent& out) {
+    if (!p || p->len != p->tot_len)
+        return WireStatus::TOO_SHORT;     // trame coupee entre deux maillons
+    return decodeTouchEvent((const uint8_t*)p->payload, p->len, out);
+}
+
+// Evenement du coeur 1 → trame, en horloge locale (ClockSync::stamp pour
+// passer a celle du central)
+inline TouchEvent toTouchEvent(const FencerEvent& ev, uint8_t player) {
+    TouchEvent t = {};
+    t.type   = ev.type;
+    t.player = player;
+    t.cls    = ev.cls;
+    t.seq    = ev.seq;
+    t.tUs    = ev.tUs;
+    t.freqHz = ev.freqHz;
+    t.value  = ev.value;
+    t.syncUs = TOUCH_SYNC_NONE;
+    t.lat    = ev.lat;
+    t.session = TOUCH_SESSION_NONE;
+    return t;
+}
+
+}  // namespace fencing
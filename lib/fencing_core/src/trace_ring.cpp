@@ -0,0 +1,92 @@
+// =============================================================================
+// trace_ring.cpp — Vidage binaire des anneaux de trace
+// =============================================================================
+
+#include "trace_ring.h"
+
+#include "byte_order.h"
+#include "crc16.h"
+
+namespace fencing {
+
+namespace {
+
+const uint8_t TRACE_MAGIC[4] = { 'F', 'T', 'R', 'C' };
+
+const size_t OFF_VERSION = 4;
+const size_t OFF_SOURCE  = 5;
+const size_t OFF_REASON  = 6;
+const size_t OFF_ANOMALY = 7;
+const size_t OFF_COUNT   = 8;
+const size_t OFF_WRITTEN = 12;
+const size_t OFF_NOW     = 16;
+
+static_assert(OFF_NOW + 8 == TRACE_DUMP_HEADER, "en-tete de vidage : 24 octets");
+
+}  // namespace
+
+uint64_t traceWord(const uint8_t* p) {
+    return get64(p);
+}
+
+size_t encodeTraceDump(const TraceDumpHeader& h, const uint64_t* records, uint8_t* buf,
+                       size_t cap) {
+    size_t size = traceDumpSize(h.count);
+    if (cap < size)
+        return 0;
+    for (size_t i = 0; i < 4; i++)
+        buf[i] = TRACE_MAGIC[i];
+    buf[OFF_VERSION] = TRACE_DUMP_VERSION;
+    buf[OFF_SOURCE]  = (uint8_t)h.source;
+    buf[OFF_REASON]  = h.reason;
+    buf[OFF_ANOMALY] = (uint8_t)h.anomaly;
+    put16(buf + OFF_COUNT, h.count);
+    put16(buf + OFF_COUNT + 2, 0);
+    put32(buf + OFF_WRITTEN, h.written);
+    put64(buf + OFF_NOW, h.nowUs);
+    uint8_t* p = buf + TRACE_DUMP_HEADER;
+    for (uint16_t i = 0; i < h.count; i++, p += 8)
+        put64(p, records[i]);
+    put16(p, crc16(buf, size - 2));
+    return size;
+}
+
+size_t decodeTraceDump(const uint8_t* buf, size_t len, TraceDumpHeader& h,
+                       const uint8_t*& records) {
+    if (len < traceDumpSize(0))
+        return 0;
+    for (size_t i = 0; i < 4; i++)
+        if (buf[i] != TRACE_MAGIC[i])
+            return 0;
+    if (buf[OFF_VERSION] != TRACE_DUMP_VERSION)
+        return 0;
+    uint16_t count = get16(buf + OFF_COUNT);
+    size_t size = traceDumpSize(count);
+    if (len < size || crc16(buf, size - 2) != get16(buf + size - 2))
+        return 0;
+
+    h.source  = (TraceSource)buf[OFF_SOURCE];
+    h.reason  = buf[OFF_REASON];
+    h.anomaly = (TraceAnomaly)buf[OFF_ANOMALY];
+    h.count   = count;
+    h.written = get32(buf + OFF_WRITTEN);
+    h.nowUs   = traceWord(buf + OFF_NOW);
+    records   = buf + TRACE_DUMP_HEADER;
+    return size;
+}
+
+const char* traceTagText(TraceTag tag) {
+    switch (tag) {
+        case TraceTag::BUTTON:   return "BUTTON";
+        case TraceTag::PERIOD:   return "PERIOD";
+        case TraceTag::EVENT:    return "EVENT";
+        case TraceTag::TD_PHASE: return "TD_PHASE";
+        case TraceTag::PACKET:   return "PACKET";
+        case TraceTag::ACK:      return "ACK";
+        case TraceTag::LOOP:     return "LOOP";
+        case TraceTag::ANOMALY:  return "ANOMALY";
+        default:                 return "NONE";
+    }
+}
+
+}  // namespace fencing
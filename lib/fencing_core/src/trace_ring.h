@@ -0,0 +1,213 @@
+// =============================================================================
+// trace_ring.h — Trace binaire permanente des transitions (fronts, classes,
+//                evenements, datagrammes), videe sur USB a la demande
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// POURQUOI :
+//   Un Serial.print toutes les 200 a 500 ms ne montre pas les mesures
+//   aberrantes (12 kHz, 24 kHz) a l'etablissement et a la rupture du
+//   contact : elles durent quelques periodes. La trace les garde toutes,
+//   en RAM, pour un cout fixe sur le chemin critique.
+//
+// ENREGISTREMENT : 8 octets, un seul mot de 64 bits ecrit dans la case,
+//   puis publication de l'indice (comme SpscQueue) :
+//
+//     bits  0..31  tUs   instant (32 bits bas des µs, rebouclage 71 min)
+//          32..39  tag   TraceTag
+//          40..47  a     selon le tag
+//          48..63  b     selon le tag
+//
+// UN ANNEAU PAR CONTEXTE D'ECRITURE (coeur 1, coeur 0, interruption du
+//   Mode Time-Division) : un seul ecrivain par anneau, sans verrou ni
+//   masquage d'interruption. L'ecrivain ne lit jamais l'indice du lecteur :
+//   les plus anciens enregistrements sont ecrases.
+//
+// LECTURE (coeur 0) : snapshot() copie les derniers enregistrements pendant
+//   que l'ecrivain continue, puis relit l'indice et ecarte ceux qu'il a pu
+//   reecrire pendant la copie (dont celui en cours d'ecriture).
+//
+// DECLENCHEMENT : trigger() enregistre une ANOMALY et leve un drapeau que le
+//   coeur 0 consulte ; il vide les anneaux un peu plus tard (contexte apres
+//   l'anomalie compris).
+//
+// VIDAGE (encodeTraceDump), petit-boutiste, un bloc par anneau :
+//
+//   off taille champ
+//    0   4     magic      "FTRC"
+//    4   1     version    TRACE_DUMP_VERSION
+//    5   1     source     TraceSource
+//    6   1     raison     0 commande, 1 anomalie
+//    7   1     anomalie   TraceAnomaly (raison 1)
+//    8   2     n          enregistrements qui suivent
+//   10   2     0
+//   12   4     ecrits     total ecrits depuis le demarrage (rebouclage)
+//   16   8     nowUs      instant du vidage (µs, 64 bits : deroule tUs)
+//   24   8n    enregistrements, du plus ancien au plus recent
+//   24+8n 2    crc        CRC-16/CCITT-FALSE de tout ce qui precede
+//
+// Decodage sur hote (CSV, VCD) : host_tools tracedump.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace fencing {
+
+enum class TraceTag : uint8_t {
+    NONE     = 0,
+    BUTTON   = 1,   // bascule filtree de GP16 (antidatee) : a = 1 appui, 0 relachement
+    PERIOD   = 2,   // changement de classe des periodes de GP2 : a = FreqClass, b = Hz
+    EVENT    = 3,   // FencerEvent emis : a = type, b = seq
+    TD_PHASE = 4,   // Mode Time-Division : a = TdPhase
+    PACKET   = 5,   // datagramme d'evenement : a = copie (1 = premiere), b = seq
+    ACK      = 6,   // acquittement recu : b = seq
+    LOOP     = 7,   // boucle du coeur 1 (STATUS) : b = duree max (µs, saturee)
+    ANOMALY  = 8,   // a = TraceAnomaly, b = valeur
+};
+
+enum class TraceSource : uint8_t { CORE1 = 0, CORE0 = 1, TD_IRQ = 2 };
+
+enum class TraceAnomaly : uint8_t {
+    NONE       = 0,
+    ABERRANT   = 1,   // periode hors bandes pendant l'appui : b = Hz
+    QUEUE_FULL = 2,   // evenement perdu, file du coeur 1 pleine : b = type
+    OVERRUN    = 3,   // tour de boucle du coeur 1 trop long : b = µs
+    EDGE_STORM = 4,   // debit de fronts de GP2 hors budget (edge_governor.h) : b = fronts
+};
+
+struct TraceRecord {
+    uint32_t tUs;
+    TraceTag tag;
+    uint8_t  a;
+    uint16_t b;
+};
+
+constexpr uint64_t packTrace(uint32_t tUs, TraceTag tag, uint8_t a, uint16_t b) {
+    return (uint64_t)tUs | ((uint64_t)tag << 32) | ((uint64_t)a << 40) | ((uint64_t)b << 48);
+}
+
+constexpr TraceRecord unpackTrace(uint64_t w) {
+    return { (uint32_t)w, (TraceTag)(uint8_t)(w >> 32), (uint8_t)(w >> 40), (uint16_t)(w >> 48) };
+}
+
+constexpr uint8_t TRACE_DUMP_VERSION = 1;
+constexpr size_t  TRACE_DUMP_HEADER  = 24;
+
+constexpr size_t traceDumpSize(uint32_t records) {
+    return TRACE_DUMP_HEADER + 8u * records + 2u;
+}
+
+inline uint16_t traceSaturate(uint32_t v) {
+    return v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+}
+
+// Anneau sur une memoire fournie (TraceBuffer<N>) : les producteurs ne
+// voient qu'un TraceRing*, quelle que soit la taille
+class TraceRing {
+public:
+    TraceRing(uint64_t* slots, uint32_t size, TraceSource source)
+        : slots_(slots), mask_(size - 1), source_(source) {}
+
+    // Ecrivain uniquement
+    void record(uint64_t tUs, TraceTag tag, uint8_t a = 0, uint16_t b = 0) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        slots_[head & mask_] = packTrace((uint32_t)tUs, tag, a, b);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Ecrivain : enregistre l'anomalie ; la premiere non servie est retenue
+    void trigger(uint64_t tUs, TraceAnomaly code, uint16_t value) {
+        record(tUs, TraceTag::ANOMALY, (uint8_t)code, value);
+        if (anomaly_.load(std::memory_order_relaxed) == 0)
+            anomaly_.store((uint8_t)code, std::memory_order_release);
+    }
+
+    // Lecteur : derniers enregistrements (au plus cap), du plus ancien au
+    // plus recent ; written = total ecrits a la copie
+    uint32_t snapshot(uint64_t* out, uint32_t cap, uint32_t& written) const {
+        uint32_t head  = head_.load(std::memory_order_acquire);
+        uint32_t size  = mask_ + 1;
+        uint32_t n     = head < size ? head : size;
+        if (n > cap) n = cap;
+        uint32_t first = head - n;
+        for (uint32_t i = 0; i < n; i++)
+            out[i] = slots_[(first + i) & mask_];
+
+        // Reecrits pendant la copie : indices < head2 + 1 − size (le +1
+        // couvre l'ecriture en cours, pas encore publiee)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t head2 = head_.load(std::memory_order_relaxed);
+        uint32_t safe  = head2 + 1 - size;
+        uint32_t drop  = (int32_t)(safe - first) > 0 ? safe - first : 0;
+        if (drop > n) drop = n;
+        for (uint32_t i = drop; i < n; i++)
+            out[i - drop] = out[i];
+        written = head;
+        return n - drop;
+    }
+
+    TraceAnomaly anomaly() const {
+        return (TraceAnomaly)anomaly_.load(std::memory_order_acquire);
+    }
+    void clearAnomaly() { anomaly_.store(0, std::memory_order_relaxed); }
+
+    TraceSource source() const { return source_; }
+    uint32_t capacity() const { return mask_ + 1; }
+    uint32_t written() const { return head_.load(std::memory_order_relaxed); }
+
+private:
+    uint64_t*             slots_;
+    uint32_t              mask_;
+    TraceSource           source_;
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint8_t>  anomaly_{0};
+};
+
+template <uint32_t N>
+class TraceBuffer : public TraceRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N doit etre une puissance de 2");
+
+public:
+    explicit TraceBuffer(TraceSource source) : TraceRing(storage_, N, source) {}
+
+private:
+    uint64_t storage_[N] = {};
+};
+
+// -----------------------------------------------------------------------------
+// Vidage
+// -----------------------------------------------------------------------------
+struct TraceDumpHeader {
+    TraceSource  source;
+    uint8_t      reason;     // 0 commande, 1 anomalie
+    TraceAnomaly anomaly;
+    uint16_t     count;
+    uint32_t     written;
+    uint64_t     nowUs;
+};
+
+// Ecrit header + records dans buf ; 0 si cap < traceDumpSize(count)
+size_t encodeTraceDump(const TraceDumpHeader& h, const uint64_t* records, uint8_t* buf,
+                       size_t cap);
+
+// Bloc complet au debut de buf (CRC verifie) : en-tete, enregistrements
+// (pointeur dans buf, 8 octets chacun, traceWord() pour les lire) et
+// taille consommee. 0 si pas de bloc valide a cet endroit.
+size_t decodeTraceDump(const uint8_t* buf, size_t len, TraceDumpHeader& h,
+                       const uint8_t*& records);
+
+uint64_t traceWord(const uint8_t* p);
+
+// Instant complet d'un enregistrement, deroule d'apres l'instant du vidage
+inline uint64_t traceTimeUs(uint32_t tUs, uint64_t dumpNowUs) {
+    return dumpNowUs - (uint32_t)((uint32_t)dumpNowUs - tUs);
+}
+
+const char* traceTagText(TraceTag tag);
+
+}  // namespace fencing
@@ -0,0 +1,189 @@
+// =============================================================================
+// udp_link.h — Datagrammes UDP tireur ↔ central (trames touch_wire.h)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// Deux backends, meme interface :
+//
+//   LwipUdpLink   Pico W : API "raw" de lwIP (udp_new / udp_sendto /
+//                 udp_recv), pas la classe WiFiUDP d'Arduino. La trame est
+//                 codee directement dans le pbuf envoye ; en reception, le
+//                 callback lwIP decode le pbuf en place et pousse le message
+//                 dans une SpscQueue videe par loop() (rien d'autre ne
+//                 s'execute dans le contexte lwIP).
+//
+//   PosixUdpLink  hote : socket UDP non bloquante sur 127.0.0.1, avec un
+//                 injecteur de pertes (independantes + rafales) et de
+//                 latence (fixe + gigue) sur les envois, pour mesurer la
+//                 livraison sans radio (host_tools udpbench).
+//
+// Le protocole (copies redondantes, acquittements, deduplication) est dans
+// touch_link.h, la synchronisation d'horloge dans clock_sync.h ; ils ne
+// dependent que de cette interface. Les instants de synchro sont pris dans
+// le backend, au plus pres du reseau : rxUs a la reception, t3 de la
+// reponse juste avant le codage.
+// =============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "spsc_queue.h"
+#include "touch_wire.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <lwip/udp.h>
+#endif
+
+namespace fencing {
+
+// Adresse IPv4 telle que rangee par lwIP et par sockaddr_in (ordre reseau
+// en memoire : sur ces cibles petit-boutistes, a dans l'octet de poids faible)
+constexpr uint32_t ipv4(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+}
+
+struct UdpPeer {
+    uint32_t ip;
+    uint16_t port;
+};
+
+enum class LinkKind : uint8_t { EVENT, ACK, SYNC_REQUEST, SYNC_REPLY };
+
+struct LinkMessage {
+    LinkKind     kind;
+    TouchEvent   ev;        // EVENT
+    uint8_t      player;    // ACK
+    uint16_t     seq;       // ACK
+    SyncExchange sync;      // SYNC_*
+    uint64_t     rxUs;      // reception, horloge locale (au plus pres du reseau)
+    UdpPeer      from;
+};
+
+// Trame recue → message, d'apres le magic. kind, ev / player / seq / sync
+// remplis ; rxUs et from sont a la charge du backend.
+inline bool decodeLinkFrame(const uint8_t* buf, size_t len, LinkMessage& msg) {
+    if (len < 1)
+        return false;
+    switch (buf[0]) {
+        case TOUCH_WIRE_MAGIC:
+            msg.kind = LinkKind::EVENT;
+            return decodeTouchEvent(buf, len, msg.ev) == WireStatus::OK;
+        case TOUCH_ACK_MAGIC:
+            msg.kind = LinkKind::ACK;
+            return decodeTouchAck(buf, len, msg.player, msg.seq) == WireStatus::OK;
+        case SYNC_REQUEST_MAGIC:
+            msg.kind = LinkKind::SYNC_REQUEST;
+            return decodeSyncRequest(buf, len, msg.sync) == WireStatus::OK;
+        case SYNC_REPLY_MAGIC:
+            msg.kind = LinkKind::SYNC_REPLY;
+            return decodeSyncReply(buf, len, msg.sync) == WireStatus::OK;
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Backend Pico W : lwIP raw
+// -----------------------------------------------------------------------------
+#if defined(ARDUINO_ARCH_RP2040)
+class LwipUdpLink {
+public:
+    // Apres l'association WiFi. Ecoute sur localPort (toutes interfaces).
+    bool begin(uint16_t localPort);
+    void end();
+
+    void setPeer(const UdpPeer& peer) { peer_ = peer; }
+
+    bool sendEvent(const TouchEvent& ev);
+    bool sendAck(const UdpPeer& to, uint8_t player, uint16_t seq);
+    bool sendSyncRequest(const SyncExchange& ex);
+    bool sendSyncReply(const UdpPeer& to, SyncExchange ex);   // t3 rempli ici
+
+    // Message recu ; false si aucun
+    bool poll(LinkMessage& msg) { return rx_.pop(msg); }
+
+    uint32_t rejected() const { return rejected_; }   // trames invalides
+    uint32_t overflows() const { return overflows_; } // file de reception pleine
+
+private:
+    static void onRecv(void* arg, udp_pcb* pcb, pbuf* p, const ip_addr_t* addr, u16_t port);
+
+    udp_pcb*                  pcb_  = nullptr;
+    UdpPeer                   peer_ = {};
+    SpscQueue<LinkMessage, 16> rx_;
+    volatile uint32_t         rejected_  = 0;
+    volatile uint32_t         overflows_ = 0;
+};
+
+typedef LwipUdpLink UdpLink;
+#endif
+
+// -----------------------------------------------------------------------------
+// Backend hote : socket POSIX + injecteur de pertes / latence
+// -----------------------------------------------------------------------------
+#if !defined(ARDUINO)
+struct LinkImpairment {
+    uint16_t lossPermille  = 0;   // perte d'un datagramme isole
+    uint16_t burstPermille = 0;   // apres une perte, proba que la suivante le soit aussi
+    uint32_t delayUs       = 0;   // latence ajoutee a chaque envoi
+    uint32_t jitterUs      = 0;   // + uniforme [0, jitterUs]
+};
+
+class PosixUdpLink {
+public:
+    static const uint32_t DELAY_SLOTS = 256;
+
+    ~PosixUdpLink() { end(); }
+
+    // 127.0.0.1:localPort (0 = port choisi par le systeme, cf. localPort())
+    bool begin(uint16_t localPort);
+    void end();
+
+    void setPeer(const UdpPeer& peer) { peer_ = peer; }
+    void setImpairment(const LinkImpairment& imp, uint32_t seed);
+
+    bool sendEvent(const TouchEvent& ev);
+    bool sendAck(const UdpPeer& to, uint8_t player, uint16_t seq);
+    bool sendSyncRequest(const SyncExchange& ex);
+    bool sendSyncReply(const UdpPeer& to, SyncExchange ex);   // t3 rempli ici
+
+    // Libere les envois retardes arrives a echeance, puis lit un datagramme
+    bool poll(LinkMessage& msg);
+
+    uint16_t localPort() const { return port_; }
+    uint32_t rejected()  const { return rejected_; }
+    uint32_t injectedLosses() const { return losses_; }
+    uint32_t datagrams() const { return sent_; }
+
+    // Horloge des echeances (steady_clock, µs)
+    static uint64_t clockUs();
+
+private:
+    bool transmit(const uint8_t* data, size_t len, const UdpPeer& to);
+    void flushDelayed(uint64_t nowUs);
+
+    struct Delayed {
+        uint64_t dueUs;
+        UdpPeer  to;
+        uint8_t  len;
+        uint8_t  data[WIRE_FRAME_MAX];
+    };
+
+    int            fd_   = -1;
+    uint16_t       port_ = 0;
+    UdpPeer        peer_ = {};
+    LinkImpairment imp_  = {};
+    uint64_t       rng_  = 1;
+    bool           lostLast_ = false;
+    Delayed        delayed_[DELAY_SLOTS];
+    uint32_t       delayedCount_ = 0;
+    uint32_t       rejected_ = 0;
+    uint32_t       losses_   = 0;
+    uint32_t       sent_     = 0;
+};
+
+typedef PosixUdpLink UdpLink;
+#endif
+
+}  // namespace fencing
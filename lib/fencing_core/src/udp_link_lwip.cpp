@@ -0,0 +1,117 @@
+// =============================================================================
+// udp_link_lwip.cpp — Liaison UDP du Pico W par l'API raw de lwIP
+// =============================================================================
+//
+// Le core arduino-pico enveloppe les appels lwIP (lwip_wrap) d'un verrou du
+// contexte asynchrone du CYW43 : sendEvent() / sendAck() peuvent etre appeles
+// depuis loop(). onRecv() s'execute dans ce contexte (interruption basse
+// priorite du coeur 0) : il decode et pousse dans rx_, loop() est le seul
+// consommateur.
+// =============================================================================
+
+#include "udp_link.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <lwip/ip_addr.h>
+#include <lwip/pbuf.h>
+
+#include "hal.h"
+
+namespace fencing {
+
+namespace {
+
+// Un seul pbuf PBUF_RAM (payload contigu, en-tetes reserves devant) : la
+// trame est codee directement dedans, sans buffer intermediaire
+template <typename Encode>
+bool sendFrame(udp_pcb* pcb, const UdpPeer& to, size_t size, Encode encode) {
+    if (!pcb || !to.ip)
+        return false;
+    pbuf* p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)size, PBUF_RAM);
+    if (!p)
+        return false;
+    bool ok = encode((uint8_t*)p->payload, (size_t)p->len) == size;
+    if (ok) {
+        ip_addr_t addr;
+        ip_addr_set_ip4_u32(&addr, to.ip);
+        ok = udp_sendto(pcb, p, &addr, to.port) == ERR_OK;
+    }
+    pbuf_free(p);
+    return ok;
+}
+
+}  // namespace
+
+bool LwipUdpLink::begin(uint16_t localPort) {
+    if (pcb_)
+        return false;
+    pcb_ = udp_new();
+    if (!pcb_)
+        return false;
+    if (udp_bind(pcb_, IP_ADDR_ANY, localPort) != ERR_OK) {
+        udp_remove(pcb_);
+        pcb_ = nullptr;
+        return false;
+    }
+    udp_recv(pcb_, onRecv, this);
+    return true;
+}
+
+void LwipUdpLink::end() {
+    if (!pcb_)
+        return;
+    udp_remove(pcb_);
+    pcb_ = nullptr;
+}
+
+bool LwipUdpLink::sendEvent(const TouchEvent& ev) {
+    return sendFrame(pcb_, peer_, TOUCH_WIRE_SIZE, [&](uint8_t* buf, size_t cap) {
+        return encodeTouchEvent(ev, buf, cap);
+    });
+}
+
+bool LwipUdpLink::sendAck(const UdpPeer& to, uint8_t player, uint16_t seq) {
+    return sendFrame(pcb_, to, TOUCH_ACK_SIZE, [&](uint8_t* buf, size_t cap) {
+        return encodeTouchAck(player, seq, buf, cap);
+    });
+}
+
+bool LwipUdpLink::sendSyncRequest(const SyncExchange& ex) {
+    return sendFrame(pcb_, peer_, SYNC_REQUEST_SIZE, [&](uint8_t* buf, size_t cap) {
+        return encodeSyncRequest(ex, buf, cap);
+    });
+}
+
+// t3 pris apres l'allocation du pbuf, juste avant le codage
+bool LwipUdpLink::sendSyncReply(const UdpPeer& to, SyncExchange ex) {
+    return sendFrame(pcb_, to, SYNC_REPLY_SIZE, [&](uint8_t* buf, size_t cap) {
+        ex.t3Us = hal::nowUs();
+        return encodeSyncReply(ex, buf, cap);
+    });
+}
+
+// Contexte lwIP : decodage en place dans le pbuf recu, puis liberation
+void LwipUdpLink::onRecv(void* arg, udp_pcb*, pbuf* p, const ip_addr_t* addr, u16_t port) {
+    LwipUdpLink* self = (LwipUdpLink*)arg;
+    if (!p)
+        return;
+
+    LinkMessage msg;
+    msg.rxUs      = hal::nowUs();
+    msg.from.ip   = ip4_addr_get_u32(ip_2_ip4(addr));
+    msg.from.port = port;
+
+    // Trame coupee entre deux maillons : refusee (cf. decodeTouchEvent(Pbuf))
+    bool ok = p->len == p->tot_len && decodeLinkFrame((const uint8_t*)p->payload, p->len, msg);
+    pbuf_free(p);
+
+    if (!ok)
+        self->rejected_ = self->rejected_ + 1;
+    else if (!self->rx_.push(msg))
+        self->overflows_ = self->overflows_ + 1;
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
@@ -0,0 +1,178 @@
+// =============================================================================
+// udp_link_posix.cpp — Liaison UDP sur hote (localhost) avec pertes simulees
+// =============================================================================
+
+#include "udp_link.h"
+
+#if !defined(ARDUINO)
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace fencing {
+
+namespace {
+
+// xorshift64* : reproductible a graine egale, independant de la libc
+uint32_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (uint32_t)((state * 2685821657736338717ull) >> 32);
+}
+
+}  // namespace
+
+uint64_t PosixUdpLink::clockUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool PosixUdpLink::begin(uint16_t localPort) {
+    end();
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+        return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(localPort);
+    addr.sin_addr.s_addr = ipv4(127, 0, 0, 1);
+    socklen_t size = sizeof addr;
+    if (::bind(fd_, (const sockaddr*)&addr, sizeof addr) != 0 ||
+        ::getsockname(fd_, (sockaddr*)&addr, &size) != 0 ||
+        ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        end();
+        return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    return true;
+}
+
+void PosixUdpLink::end() {
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+    port_ = 0;
+    delayedCount_ = 0;
+}
+
+void PosixUdpLink::setImpairment(const LinkImpairment& imp, uint32_t seed) {
+    imp_      = imp;
+    rng_      = 0x9E3779B97F4A7C15ull ^ seed;
+    lostLast_ = false;
+    losses_   = 0;
+}
+
+// Perte (Gilbert simplifie : apres une perte, burstPermille remplace
+// lossPermille), puis envoi immediat ou mise en attente jusqu'a l'echeance
+bool PosixUdpLink::transmit(const uint8_t* data, size_t len, const UdpPeer& to) {
+    if (fd_ < 0 || len > WIRE_FRAME_MAX)
+        return false;
+    sent_++;
+
+    uint16_t lossPermille = lostLast_ ? imp_.burstPermille : imp_.lossPermille;
+    lostLast_ = lossPermille && nextRandom(rng_) % 1000u < lossPermille;
+    if (lostLast_) {
+        losses_++;
+        return true;            // perdu en route : l'emetteur n'en sait rien
+    }
+
+    uint32_t delay = imp_.delayUs;
+    if (imp_.jitterUs)
+        delay += nextRandom(rng_) % (imp_.jitterUs + 1);
+
+    if (delay == 0) {
+        sockaddr_in addr = {};
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(to.port);
+        addr.sin_addr.s_addr = to.ip;
+        return ::sendto(fd_, data, len, 0, (const sockaddr*)&addr, sizeof addr) == (ssize_t)len;
+    }
+
+    if (delayedCount_ == DELAY_SLOTS)
+        return false;
+    Delayed& d = delayed_[delayedCount_++];
+    d.dueUs = clockUs() + delay;
+    d.to    = to;
+    d.len   = (uint8_t)len;
+    std::memcpy(d.data, data, len);
+    return true;
+}
+
+// La gigue peut reordonner les datagrammes, comme sur l'air
+void PosixUdpLink::flushDelayed(uint64_t nowUs) {
+    uint32_t i = 0;
+    while (i < delayedCount_) {
+        Delayed& d = delayed_[i];
+        if (d.dueUs > nowUs) {
+            i++;
+            continue;
+        }
+        sockaddr_in addr = {};
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(d.to.port);
+        addr.sin_addr.s_addr = d.to.ip;
+        ::sendto(fd_, d.data, d.len, 0, (const sockaddr*)&addr, sizeof addr);
+        d = delayed_[--delayedCount_];
+    }
+}
+
+bool PosixUdpLink::sendEvent(const TouchEvent& ev) {
+    uint8_t frame[TOUCH_WIRE_SIZE];
+    size_t len = encodeTouchEvent(ev, frame, sizeof frame);
+    return len && transmit(frame, len, peer_);
+}
+
+bool PosixUdpLink::sendAck(const UdpPeer& to, uint8_t player, uint16_t seq) {
+    uint8_t frame[TOUCH_ACK_SIZE];
+    size_t len = encodeTouchAck(player, seq, frame, sizeof frame);
+    return len && transmit(frame, len, to);
+}
+
+bool PosixUdpLink::sendSyncRequest(const SyncExchange& ex) {
+    uint8_t frame[SYNC_REQUEST_SIZE];
+    size_t len = encodeSyncRequest(ex, frame, sizeof frame);
+    return len && transmit(frame, len, peer_);
+}
+
+bool PosixUdpLink::sendSyncReply(const UdpPeer& to, SyncExchange ex) {
+    uint8_t frame[SYNC_REPLY_SIZE];
+    ex.t3Us = clockUs();
+    size_t len = encodeSyncReply(ex, frame, sizeof frame);
+    return len && transmit(frame, len, to);
+}
+
+bool PosixUdpLink::poll(LinkMessage& msg) {
+    if (fd_ < 0)
+        return false;
+    if (delayedCount_)
+        flushDelayed(clockUs());
+
+    // Une trame plus longue (version compatible) doit rester lisible
+    uint8_t buf[64];
+    for (;;) {
+        sockaddr_in addr = {};
+        socklen_t size = sizeof addr;
+        ssize_t n = ::recvfrom(fd_, buf, sizeof buf, 0, (sockaddr*)&addr, &size);
+        if (n < 0)
+            return false;
+
+        msg.rxUs      = clockUs();
+        msg.from.ip   = addr.sin_addr.s_addr;
+        msg.from.port = ntohs(addr.sin_port);
+        if (decodeLinkFrame(buf, (size_t)n, msg))
+            return true;
+        rejected_++;
+    }
+}
+
+}  // namespace fencing
+
+#endif  // !ARDUINO
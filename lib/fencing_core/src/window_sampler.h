@@ -0,0 +1,188 @@
+// =============================================================================
+// window_sampler.h — Fenetres de comptage a cadence fixe (alarme materielle)
+// Projet : Escrime sans fil
+// =============================================================================
+//
+// ROLE :
+//   Remplace le motif des sketches
+//
+//     if (now - lastMeasureTime >= MEASURE_PERIOD) {
+//         count = edgeCounter.takePulseCount();
+//         measuredFreqHz = windowFreqHz(count, now - lastMeasureTime);
+//
+//   dont la fenetre suit la duree du tour de loop() : 50 ms demandees,
+//   51..80 ms mesurees quand Serial bloque, et un elapsed au ms pres (2 %
+//   d'erreur sur 50 ms). Ici une alarme materielle lit le compteur de
+//   fronts (edge_counter.h) sur une grille exacte startUs + k * hopUs ; la
+//   frequence est calculee sur la duree de la grille, en µs, arrondie.
+//
+// FENETRES GLISSANTES :
+//   La fenetre couvre les `hops` derniers pas : 50 ms recalculees toutes
+//   les 10 ms par defaut (WINDOW_HOP_US, WINDOW_HOPS). hops = 1 donne des
+//   fenetres jointives.
+//
+// PUBLICATION :
+//   Chaque fenetre complete est publiee dans un DoubleBuffer
+//   (double_buffer.h) : la boucle lit la plus recente quand elle passe,
+//   sans masquer les interruptions ; seq dit combien en ont ete manquees.
+//
+// ECHEANCES EN RETARD :
+//   Le pilote date chaque lecture. Une lecture plus de WINDOW_LATE_TOL_US
+//   apres sa frontiere (interruption masquee, echeance deja passee a la
+//   reprogrammation) ne tombe plus sur la grille : le moteur l'ecarte, se
+//   recale sur la frontiere suivante, reprend une lecture de reference et
+//   remplit a nouveau la fenetre avant de publier. Aucune fenetre publiee
+//   n'a donc de bord faux de plus de WINDOW_LATE_TOL_US.
+//
+// WindowEngine est la logique pure (grille, somme glissante, publication),
+// exercee sur hote avec un FakeEdgeCounter et des retards simules
+// (host_tools window) ; WindowSampler est le pilote RP2040.
+// =============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#include "double_buffer.h"
+#include "edge_counter.h"
+
+namespace fencing {
+
+const uint32_t WINDOW_HOP_US      = 10000;   // pas de la grille
+const uint8_t  WINDOW_HOPS        = 5;       // fenetre = 5 pas = 50 ms
+const uint8_t  WINDOW_MAX_HOPS    = 16;
+const uint32_t WINDOW_LATE_TOL_US = 20;      // retard de lecture accepte
+
+struct WindowResult {
+    uint32_t seq;        // numero de fenetre publiee (1, 2, ...)
+    uint64_t endUs;      // frontiere de fin (instant de grille)
+    uint32_t windowUs;   // duree exacte : hops * hopUs
+    uint32_t count;      // fronts dans la fenetre
+    uint32_t freqHz;     // windowFreqHzUs(count, windowUs)
+};
+
+class WindowEngine {
+public:
+    WindowEngine(uint32_t hopUs = WINDOW_HOP_US, uint8_t hops = WINDOW_HOPS,
+                 uint32_t lateTolUs = WINDOW_LATE_TOL_US) {
+        configure(hopUs, hops, lateTolUs);
+    }
+
+    // Avant start() (le DoubleBuffer n'est pas copiable)
+    void configure(uint32_t hopUs, uint8_t hops, uint32_t lateTolUs = WINDOW_LATE_TOL_US) {
+        hopUs_     = hopUs ? hopUs : 1;
+        hops_      = hops == 0 ? 1 : hops > WINDOW_MAX_HOPS ? WINDOW_MAX_HOPS : hops;
+        lateTolUs_ = lateTolUs;
+    }
+
+    // Premiere frontiere ; la lecture a cet instant sert de reference
+    void start(uint64_t firstUs) {
+        startUs_ = firstUs;
+        tick_    = 0;
+        restart();
+    }
+
+    // Prochaine frontiere a lire (cible de l'alarme)
+    uint64_t dueUs() const { return startUs_ + tick_ * hopUs_; }
+
+    // Sous interruption : fronts depuis la lecture precedente, lus a readUs
+    void onHop(uint32_t count, uint64_t readUs) {
+        uint64_t due  = dueUs();
+        uint64_t late = readUs > due ? readUs - due : 0;
+        if (late > lateTolUs_) {
+            // Hors grille : reference perdue, recalage sur la frontiere
+            // suivante (les pas sautes sont comptes dans resyncs)
+            tick_ += 1 + late / hopUs_;
+            restart();
+            resyncs_++;
+            return;
+        }
+        tick_++;
+        if (!primed_) {
+            primed_ = true;             // lecture de reference
+            return;
+        }
+
+        sum_ += count;
+        if (filled_ == hops_)
+            sum_ -= ring_[head_];
+        else
+            filled_++;
+        ring_[head_] = count;
+        head_ = (uint8_t)((head_ + 1) % hops_);
+        if (filled_ < hops_)
+            return;
+
+        WindowResult r;
+        r.seq      = ++published_;
+        r.endUs    = due;
+        r.windowUs = windowUs();
+        r.count    = sum_;
+        r.freqHz   = windowFreqHzUs(sum_, r.windowUs);
+        out_.publish(r);
+    }
+
+    // Boucle : derniere fenetre publiee ; false avant la premiere
+    bool read(WindowResult& out) const { return out_.read(out); }
+
+    uint32_t hopUs() const    { return hopUs_; }
+    uint8_t  hops() const     { return hops_; }
+    uint32_t windowUs() const { return hopUs_ * hops_; }
+    uint32_t published() const { return published_; }
+    uint32_t resyncs() const  { return resyncs_; }
+    const DoubleBuffer<WindowResult>& buffer() const { return out_; }
+
+private:
+    void restart() {
+        primed_ = false;
+        filled_ = 0;
+        head_   = 0;
+        sum_    = 0;
+    }
+
+    uint32_t hopUs_     = WINDOW_HOP_US;
+    uint8_t  hops_      = WINDOW_HOPS;
+    uint32_t lateTolUs_ = WINDOW_LATE_TOL_US;
+    uint64_t startUs_   = 0;
+    uint64_t tick_      = 0;
+    bool     primed_    = false;
+    uint8_t  filled_    = 0;
+    uint8_t  head_      = 0;
+    uint32_t sum_       = 0;
+    uint32_t ring_[WINDOW_MAX_HOPS] = {};
+    uint32_t published_ = 0;
+    uint32_t resyncs_   = 0;
+    DoubleBuffer<WindowResult> out_;
+};
+
+// -----------------------------------------------------------------------------
+// Pilote RP2040 : alarme materielle du timer + compteur de fronts d'un slice
+// PWM, interruption sur le coeur qui appelle begin()
+// -----------------------------------------------------------------------------
+#if defined(ARDUINO_ARCH_RP2040)
+class WindowSampler {
+public:
+    // pin : entree B d'un slice PWM (GPIO impair, cf. edge_counter.h)
+    bool begin(uint8_t pin, uint32_t hopUs = WINDOW_HOP_US, uint8_t hops = WINDOW_HOPS);
+    void end();
+
+    // Derniere fenetre publiee (boucle) ; false avant la premiere
+    bool read(WindowResult& out) const { return engine_.read(out); }
+
+    const WindowEngine& engine() const { return engine_; }
+
+    // Echeances deja passees quand l'alarme a ete reprogrammee
+    uint32_t lateCount() const { return late_; }
+
+private:
+    static void onAlarm(unsigned int alarmNum);
+    void        service();
+
+    WindowEngine      engine_;
+    PwmEdgeCounter    counter_;
+    int               alarm_ = -1;
+    volatile uint32_t late_  = 0;
+};
+#endif
+
+}  // namespace fencing
@@ -0,0 +1,76 @@
+// =============================================================================
+// window_sampler_rp2040.cpp — Fenetres de comptage cadencees par alarme
+// =============================================================================
+
+#include "window_sampler.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/timer.h>
+
+namespace fencing {
+
+namespace {
+
+// Le callback d'alarme du SDK ne recoit que le numero d'alarme
+WindowSampler* activeWindowSampler = nullptr;
+
+}  // namespace
+
+bool WindowSampler::begin(uint8_t pin, uint32_t hopUs, uint8_t hops) {
+    if (activeWindowSampler || hopUs == 0)
+        return false;
+    if (!counter_.begin(pin))
+        return false;
+    alarm_ = hardware_alarm_claim_unused(false);
+    if (alarm_ < 0) {
+        counter_.end();
+        return false;
+    }
+
+    engine_.configure(hopUs, hops);
+
+    activeWindowSampler = this;
+    hardware_alarm_set_callback((uint)alarm_, onAlarm);
+
+    engine_.start(time_us_64() + hopUs);
+    if (hardware_alarm_set_target((uint)alarm_, from_us_since_boot(engine_.dueUs())))
+        service();
+    return true;
+}
+
+void WindowSampler::end() {
+    if (alarm_ < 0)
+        return;
+    hardware_alarm_cancel((uint)alarm_);
+    hardware_alarm_set_callback((uint)alarm_, nullptr);
+    hardware_alarm_unclaim((uint)alarm_);
+    alarm_ = -1;
+    counter_.end();
+    activeWindowSampler = nullptr;
+}
+
+void WindowSampler::onAlarm(unsigned int) {
+    if (activeWindowSampler)
+        activeWindowSampler->service();
+}
+
+// Sous interruption : une lecture du compteur par frontiere. Le compteur
+// est lu avant l'horloge : readUs majore l'instant de lecture, un retard
+// n'est jamais sous-estime.
+void WindowSampler::service() {
+    for (;;) {
+        uint32_t count  = counter_.takePulseCount();
+        uint64_t readUs = time_us_64();
+        engine_.onHop(count, readUs);
+        if (!hardware_alarm_set_target((uint)alarm_, from_us_since_boot(engine_.dueUs())))
+            return;
+        // Frontiere deja passee : la lecture immediate sera en retard et
+        // le moteur se recalera sur la suivante
+        late_ = late_ + 1;
+    }
+}
+
+}  // namespace fencing
+
+#endif  // ARDUINO_ARCH_RP2040
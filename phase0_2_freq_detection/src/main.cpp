@@ -132,16 +132,20 @@ void loop() {
   }
   
   // Mesure toutes les MEASURE_PERIOD ms (rapide, 15ms)
-  if (millis() - lastMeasureTime >= MEASURE_PERIOD) {
+  unsigned long now = millis();
+  if (now - lastMeasureTime >= MEASURE_PERIOD) {
     noInterrupts();
     unsigned long count = pulseCount;
     pulseCount = 0;
     interrupts();
     
-    // Convertir en Hz
-    lastFreqHz = count * (1000 / MEASURE_PERIOD);
+    // Convertir en Hz sur la duree reelle de la fenetre, arrondi :
+    // count * (1000 / 15) multipliait par 66 au lieu de 66.67, et la
+    // fenetre s'allonge quand Serial bloque
+    unsigned long elapsed = now - lastMeasureTime;
+    lastFreqHz = (count * 1000UL + elapsed / 2) / elapsed;
     
-    lastMeasureTime = millis();
+    lastMeasureTime = now;
   }
   
   // Affichage toutes les DISPLAY_PERIOD ms (lent, 500ms)
@@ -1,4 +1,9 @@
 #include <Arduino.h>
+#include <classifier.h>
+#include <freq_plan.h>
+#include <window_sampler.h>
+
+using namespace fencing;
 
 // ============================================================
 // Phase 0.3 — Détection sans GND commun
@@ -12,37 +17,37 @@
 //
 // CÂBLAGE :
 //   - UN SEUL fil obligatoire  : Pin 9 (Mega) → GPIO 2 (Pico)
+//   - GPIO 2 ↔ GPIO 3 (pont, pins 4-5) — comptage matériel sur PWM 1B
 //   - Fil optionnel (ADC)      : Pin 9 (Mega) → GPIO 26 / ADC0 (Pico)
 //   - PAS de fil GND entre les deux cartes
 //   - Mega  : alimenté par adaptateur secteur
 //   - Pico  : alimenté par USB sur PC (Serial Monitor)
 //
 // MÉTHODE DE DÉTECTION :
-//   Comptage d'impulsions par interruption sur front montant.
-//   La fréquence est calculée sur une fenêtre de 50 ms.
+//   Comptage des fronts montants par le slice PWM 1 (entrée B, GPIO 3) :
+//   aucune interruption par front, même à 40 kHz.
+//   Une alarme lit le compteur toutes les 10 ms (window_sampler.h) :
+//   fenêtres jointives de 10 ms exactes, même quand Serial bloque loop().
 //   Affichage toutes les 500 ms avec classification et lecture ADC.
 // ============================================================
 
 // --- Pins ---
-const int PIN_INTERRUPT = 2;   // GPIO 2 — entrée signal (interruption)
+const int PIN_INTERRUPT = 2;   // GPIO 2 — entrée signal (haute impédance)
+const int PIN_COUNTER   = 3;   // GPIO 3 — compteur de fronts (slice PWM 1, entrée B)
 const int PIN_ADC       = 26;  // GPIO 26 / ADC0 — lecture analogique optionnelle
 
-// --- Fréquences cibles (Hz) ---
-// Fréquences exactes du Mega (prescaler 8, OCR entier)
-const unsigned int FREQ_NEUTRE  = 20000;  // 20 kHz exact
-const unsigned int FREQ_VALID_A = 25000;  // 25 kHz exact
-const unsigned int FREQ_VALID_B = 40000;  // 40 kHz exact
-const unsigned int TOLERANCE    = 2000;   // ±2 kHz
+// --- Fréquences cibles (Hz) et tolérance : freq_plan.h ---
+// (plan par défaut 20/25/40 kHz, exact sur le Mega : prescaler 8, OCR entier)
 
 // --- Périodes de mesure et d'affichage ---
-const unsigned int MEASURE_PERIOD  = 10;   // ms — fenêtre de comptage
-const unsigned int DISPLAY_PERIOD  = 500;  // ms — rafraîchissement Serial
+const uint32_t     MEASURE_PERIOD_US = 10000;  // µs — fenêtre de comptage
+const unsigned int DISPLAY_PERIOD    = 500;    // ms — rafraîchissement Serial
 
-// --- Variables partagées avec l'ISR ---
-volatile unsigned long pulseCount = 0;  // compteur d'impulsions (ISR)
+// --- Fenêtres de comptage : slice PWM lu par une alarme, fenêtres jointives
+//     (un pas par fenêtre, cf. window_sampler.h) ---
+WindowSampler windowSampler;
 
 // --- Variables de mesure ---
-unsigned long lastMeasureTime  = 0;
 unsigned long lastDisplayTime  = 0;
 unsigned long measuredFreqHz   = 0;  // fréquence calculée sur la dernière fenêtre
 
@@ -52,28 +57,6 @@ unsigned int adcMax   = 0;
 unsigned long adcSum  = 0;
 unsigned int adcCount = 0;
 
-// ============================================================
-// ISR — Comptage des fronts montants
-// ============================================================
-void countPulse() {
-    pulseCount++;
-}
-
-// ============================================================
-// Classification de la fréquence mesurée
-// ============================================================
-const char* classifyFrequency(unsigned long freq) {
-    if (freq < 100)
-        return "AUCUNE";
-    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
-        return "NEUTRE  (20 kHz)";
-    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
-        return "VALID_A (25 kHz)";
-    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
-        return "VALID_B (40 kHz)";
-    return "INCONNUE";
-}
-
 // ============================================================
 // Setup
 // ============================================================
@@ -88,10 +71,10 @@ void setup() {
     // Résolution ADC 12 bits (0–4095) au lieu des 10 bits par défaut
     analogReadResolution(12);
 
-    // Entrée interruption — PAS de pull-up ni pull-down
-    // On veut observer le signal brut sans biaiser le test
-    pinMode(PIN_INTERRUPT, INPUT_PULLDOWN);
-    attachInterrupt(digitalPinToInterrupt(PIN_INTERRUPT), countPulse, RISING);
+    // GPIO 2 en entrée simple — PAS de pull-up ni pull-down, on veut
+    // observer le signal brut sans biaiser le test. Le comptage se fait
+    // sur GPIO 3 (slice PWM), ponté à GPIO 2.
+    pinMode(PIN_INTERRUPT, INPUT);
 
     // --- Header d'information ---
     Serial.println();
@@ -100,16 +83,17 @@ void setup() {
     Serial.println("  Recepteur : Raspberry Pi Pico W");
     Serial.println("============================================================");
     Serial.println("  CABLAGE ATTENDU :");
-    Serial.println("    [OBLIGATOIRE] Pin 9 (Mega) -> GPIO 2  (Pico) — interruption");
+    Serial.println("    [OBLIGATOIRE] Pin 9 (Mega) -> GPIO 2  (Pico) — signal");
+    Serial.println("    [OBLIGATOIRE] Pont GPIO 2 <-> GPIO 3 (Pico) — compteur PWM 1B");
     Serial.println("    [OPTIONNEL]   Pin 9 (Mega) -> GPIO 26 (Pico) — lecture ADC");
     Serial.println("    Pas de fil GND entre les deux cartes.");
-    Serial.println("  METHODE : comptage d'impulsions par interruption (RISING)");
-    Serial.println("  Fenetre de mesure : 50 ms | Affichage : 500 ms");
+    Serial.println("  METHODE : comptage materiel des fronts montants (slice PWM)");
+    Serial.println("  Fenetre de mesure : 10 ms | Affichage : 500 ms");
     Serial.println("============================================================");
     Serial.println();
 
-    lastMeasureTime = millis();
     lastDisplayTime = millis();
+    windowSampler.begin(PIN_COUNTER, MEASURE_PERIOD_US, 1);
 }
 
 // ============================================================
@@ -128,21 +112,11 @@ void loop() {
     adcCount++;
 
     // ----------------------------------------------------------
-    // 2. Calcul de la fréquence toutes les MEASURE_PERIOD ms
+    // 2. Dernière fenêtre de 10 ms publiée par l'alarme
     // ----------------------------------------------------------
-    if (now - lastMeasureTime >= MEASURE_PERIOD) {
-        // Lire et remettre à zéro le compteur de manière atomique
-        noInterrupts();
-        unsigned long count = pulseCount;
-        pulseCount = 0;
-        interrupts();
-
-        unsigned long elapsed = now - lastMeasureTime;
-        lastMeasureTime = now;
-
-        // Fréquence = impulsions / durée_en_secondes
-        measuredFreqHz = (count * 1000UL) / elapsed;
-    }
+    WindowResult window;
+    if (windowSampler.read(window))
+        measuredFreqHz = window.freqHz;
 
     // ----------------------------------------------------------
     // 3. Affichage toutes les DISPLAY_PERIOD ms
@@ -156,7 +130,7 @@ void loop() {
         Serial.print("Freq: ");
         Serial.print(measuredFreqHz);
         Serial.print(" Hz | ");
-        Serial.print(classifyFrequency(measuredFreqHz));
+        Serial.print(freqClassLabel(classifyFrequency(measuredFreqHz)));
         Serial.print(" | ADC: min=");
         Serial.print(adcMin);
         Serial.print(" max=");
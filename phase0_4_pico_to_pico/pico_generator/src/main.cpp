@@ -18,27 +18,42 @@
 //
 // COMMANDES SÉRIE (optionnel, si FTDI branché) :
 //   t → bascule signal ON/OFF
-//   1 → 20 kHz (NEUTRE)
-//   2 → 25 kHz (VALID_A)
-//   3 → 40 kHz (VALID_B)
+//   1 → FREQ_NEUTRE  (20 kHz, plan par défaut — cf. freq_plan.h)
+//   2 → FREQ_VALID_A (25 kHz)
+//   3 → FREQ_VALID_B (40 kHz)
+//   s → lance un balayage de la liste (Phase 1.7bis, cf. sweep.h)
+//   x → arrete le balayage
+//   l 1000,1500,2500 ⏎ → remplace la liste (défaut : 1000 à 3000 Hz / 250 Hz)
+//
+// BALAYAGE : silence 1 s, puis chaque fréquence 2 s séparée de 200 ms de
+//   silence. Le récepteur (même liste) écrit une ligne CSV par pas.
 // =============================================================================
 
 #include <Arduino.h>
-#include <hardware/pwm.h>
-#include <hardware/clocks.h>
+#include <classifier.h>
+#include <freq_plan.h>
+#include <hal.h>
+#include <sweep.h>
+
+using namespace fencing;
 
 // --- Broche de sortie du signal ---
-const uint PIN_SIGNAL_OUT = 15;
+const int PIN_SIGNAL_OUT = 15;
 
-// --- Fréquences disponibles ---
-const unsigned int FREQ_NEUTRE  = 1000;  // 20 kHz — exact
-const unsigned int FREQ_VALID_A = 25000;  // 25 kHz — exact
-const unsigned int FREQ_VALID_B = 40000;  // 40 kHz — exact
+// --- Fréquences disponibles : freq_plan.h (FREQ_NEUTRE, FREQ_VALID_A/B) ---
 
 // --- État courant ---
 bool          signalActif  = true;
 unsigned int  freqActuelle = FREQ_NEUTRE;
-uint          sliceNum     = 0;
+
+// --- Balayage ---
+SweepList     listeBalayage = defaultSweepList();
+SweepSchedule balayage;
+
+// --- Ligne de commande en cours de saisie (commande l) ---
+char          ligne[96];
+unsigned int  ligneLen   = 0;
+bool          saisieLigne = false;
 
 // --- Timing ---
 unsigned long dernierClignotement = 0;
@@ -46,50 +61,23 @@ bool          etatLed             = false;
 unsigned long dernierAffichage    = 0;
 
 // ---------------------------------------------------------------------------
-// Configure le PWM hardware pour une fréquence exacte (signal carré 50%)
-// RP2040 clock = 125 MHz
-// freq = 125000000 / (diviser * wrap)
-// Pour un signal carré : duty = wrap / 2
-// ---------------------------------------------------------------------------
-void configurerPWM(unsigned int freq) {
-  // Calcul du wrap pour cette fréquence (diviser = 1)
-  // wrap = clock_freq / freq
-  uint32_t clock_freq = clock_get_hz(clk_sys);  // 125 MHz
-  uint32_t wrap = clock_freq / freq;
-
-  // Configurer le slice PWM
-  sliceNum = pwm_gpio_to_slice_num(PIN_SIGNAL_OUT);
-
-  pwm_config config = pwm_get_default_config();
-  pwm_config_set_clkdiv(&config, 1.0f);       // pas de division, pleine vitesse
-  pwm_config_set_wrap(&config, wrap - 1);      // période
-  pwm_init(sliceNum, &config, false);          // ne pas démarrer encore
-
-  // Duty cycle 50% → signal carré
-  pwm_set_chan_level(sliceNum, pwm_gpio_to_channel(PIN_SIGNAL_OUT), wrap / 2);
-}
-
+// PWM hardware (signal carré 50%) : hal::pwmStart / hal::pwmStop
 // ---------------------------------------------------------------------------
 void demarrerPWM() {
-  pwm_set_enabled(sliceNum, true);
+  hal::pwmStart(PIN_SIGNAL_OUT, freqActuelle);
 }
 
 void arreterPWM() {
-  pwm_set_enabled(sliceNum, false);
-  gpio_put(PIN_SIGNAL_OUT, 0);  // forcer le pin à LOW
+  hal::pwmStop(PIN_SIGNAL_OUT);  // forcer le pin à LOW
 }
 
 // ---------------------------------------------------------------------------
 const char* nomFreq(unsigned int freq) {
-  if (freq == FREQ_NEUTRE)  return "NEUTRE  (20 kHz)";
-  if (freq == FREQ_VALID_A) return "VALID_A (25 kHz)";
-  if (freq == FREQ_VALID_B) return "VALID_B (40 kHz)";
-  return "INCONNUE";
+  return freqClassLabel(classifyFrequency(freq));
 }
 
 // ---------------------------------------------------------------------------
 void activerSignal() {
-  configurerPWM(freqActuelle);
   demarrerPWM();
   digitalWrite(LED_BUILTIN, HIGH);
   signalActif = true;
@@ -106,13 +94,81 @@ void desactiverSignal() {
 void changerFrequence(unsigned int nouvelleFreq) {
   freqActuelle = nouvelleFreq;
   if (signalActif) {
-    configurerPWM(freqActuelle);
     demarrerPWM();
   }
   Serial.print("[FREQ] ");
   Serial.println(nomFreq(freqActuelle));
 }
 
+// ---------------------------------------------------------------------------
+// Balayage (Phase 1.7bis)
+// ---------------------------------------------------------------------------
+void afficherListe() {
+  Serial.print("[LISTE]");
+  for (uint8_t i = 0; i < listeBalayage.size; i++) {
+    Serial.print(i == 0 ? " " : ",");
+    Serial.print(listeBalayage.freqHz[i]);
+  }
+  Serial.println();
+}
+
+void lancerBalayage() {
+  arreterPWM();
+  signalActif = false;
+  balayage.start(listeBalayage, millis());
+  Serial.print("[BALAYAGE] debut, ");
+  Serial.print(listeBalayage.size);
+  Serial.println(" pas");
+}
+
+void arreterBalayage() {
+  balayage.stop();
+  desactiverSignal();
+  Serial.println("[BALAYAGE] arrete");
+}
+
+// Appelée à chaque loop() : allume / coupe le PWM aux changements de phase
+void suivreBalayage() {
+  if (!balayage.update(millis()))
+    return;
+
+  if (balayage.phase() == SweepSchedule::Phase::STEP) {
+    freqActuelle = balayage.freqHz();
+    unsigned int reelle = hal::pwmStart(PIN_SIGNAL_OUT, freqActuelle);
+    signalActif = true;
+    digitalWrite(LED_BUILTIN, HIGH);
+    Serial.print("[PAS ");
+    Serial.print(balayage.step() + 1);
+    Serial.print("/");
+    Serial.print(balayage.size());
+    Serial.print("] ");
+    Serial.print(freqActuelle);
+    Serial.print(" Hz (PWM ");
+    Serial.print(reelle);
+    Serial.println(" Hz)");
+  } else {
+    arreterPWM();
+    signalActif = false;
+    if (!balayage.running())
+      Serial.println("[BALAYAGE] termine");
+  }
+}
+
+void traiterLigne() {
+  ligne[ligneLen] = '\0';
+  if (parseSweepList(ligne, listeBalayage)) {
+    afficherListe();
+  } else {
+    Serial.print("[LISTE] invalide (");
+    Serial.print(SWEEP_FREQ_MIN);
+    Serial.print("-");
+    Serial.print(SWEEP_FREQ_MAX);
+    Serial.print(" Hz, max ");
+    Serial.print(SWEEP_MAX_STEPS);
+    Serial.println(" valeurs)");
+  }
+}
+
 // ---------------------------------------------------------------------------
 // SETUP
 // ---------------------------------------------------------------------------
@@ -120,11 +176,9 @@ void setup() {
   Serial.begin(115200);
   delay(3000);
 
-  // Configurer GPIO 15 comme sortie PWM
-  gpio_set_function(PIN_SIGNAL_OUT, GPIO_FUNC_PWM);
   pinMode(LED_BUILTIN, OUTPUT);
 
-  // Démarrage du signal à 20 kHz
+  // Démarrage du signal à FREQ_NEUTRE (GPIO 15 en sortie PWM)
   activerSignal();
 
   Serial.println("=========================================");
@@ -135,10 +189,12 @@ void setup() {
   Serial.println("  Alimentation  : adaptateur secteur");
   Serial.println("  GND commun    : NON");
   Serial.println("-----------------------------------------");
-  Serial.println("  t -> ON/OFF | 1=20k | 2=25k | 3=40k");
+  Serial.println("  t -> ON/OFF | 1=NEUTRE | 2=VALID_A | 3=VALID_B");
+  Serial.println("  s -> balayage | x -> stop | l f1,f2,... -> liste");
   Serial.println("=========================================");
   Serial.print("  Etat initial : ");
   Serial.println(nomFreq(freqActuelle));
+  afficherListe();
   Serial.println();
 
   dernierAffichage = millis();
@@ -149,9 +205,20 @@ void setup() {
 // ---------------------------------------------------------------------------
 void loop() {
 
-  // --- Commandes série ---
-  if (Serial.available() > 0) {
+  // --- Commandes série : un caractère, sauf "l ..." lue jusqu'à la fin de ligne ---
+  while (Serial.available() > 0) {
     char cmd = Serial.read();
+    if (saisieLigne) {
+      if (cmd == '\n' || cmd == '\r') {
+        saisieLigne = false;
+        traiterLigne();
+      } else if (ligneLen < sizeof(ligne) - 1) {
+        ligne[ligneLen++] = cmd;
+      }
+      continue;
+    }
+    if (balayage.running() && cmd != 'x')
+      continue;                          // pas d'autre commande pendant un balayage
     switch (cmd) {
       case 't':
         signalActif ? desactiverSignal() : activerSignal();
@@ -159,9 +226,21 @@ void loop() {
       case '1': changerFrequence(FREQ_NEUTRE);  break;
       case '2': changerFrequence(FREQ_VALID_A); break;
       case '3': changerFrequence(FREQ_VALID_B); break;
+      case 's': lancerBalayage();  break;
+      case 'x': arreterBalayage(); break;
+      case 'l':
+        saisieLigne = true;
+        ligneLen    = 0;
+        break;
     }
   }
 
+  // --- Balayage en cours ---
+  if (balayage.running()) {
+    suivreBalayage();
+    return;                              // LED et statut gérés par le balayage
+  }
+
   // --- LED : allumée si signal actif, clignote sinon ---
   if (!signalActif) {
     unsigned long now = millis();
@@ -1,4 +1,11 @@
 #include <Arduino.h>
+#include <classifier.h>
+#include <edge_counter.h>
+#include <freq_plan.h>
+#include <pio_edge_timer.h>
+#include <sweep.h>
+
+using namespace fencing;
 
 // =============================================================================
 // Phase 0.4 — Pico to Pico : RÉCEPTEUR
@@ -6,30 +13,45 @@
 //
 // Câblage attendu :
 //   GPIO 15 (Pico générateur) → GPIO 2  (Pico récepteur) — signal carré
+//   GPIO 2 ↔ GPIO 3 (pont, pins 4-5) — comptage matériel sur PWM 1B
 //   GPIO 15 (Pico générateur) → GPIO 26 (Pico récepteur) — optionnel, lecture ADC
 //   PAS de fil GND entre les deux Pico
 //
+// Mode balayage (Phase 1.7bis) — commandes série :
+//   b → active / désactive le mode balayage (une ligne CSV par pas,
+//       à lancer avant la commande s du générateur)
+//   l 1000,1500,2500 ⏎ → liste des fréquences, identique au générateur
+//   Exploitation : program sweeprank log.txt (host_tools)
+//
 // Alimentation :
 //   Pico générateur : adaptateur secteur via multiprise
 //   Pico récepteur  : USB sur Mac (Serial Monitor disponible)
 // =============================================================================
 
 // --- Broches ---
-const int PIN_INTERRUPT = 2;   // GPIO 2 : entrée signal carré (interruption)
+const int PIN_INTERRUPT = 2;   // GPIO 2 : entrée signal carré (haute impédance)
+const int PIN_COUNTER   = 3;   // GPIO 3 : compteur de fronts (slice PWM 1, entrée B)
 const int PIN_ADC       = 26;  // GPIO 26 : lecture ADC optionnelle (info bonus)
 
-// --- Fréquences de référence (Hz) ---
-const unsigned int FREQ_NEUTRE  = 20000;
-const unsigned int FREQ_VALID_A = 25000;
-const unsigned int FREQ_VALID_B = 40000;
-const unsigned int TOLERANCE    = 2000;  // ±2 kHz autour de chaque fréquence cible
+// --- Fréquences de référence (Hz) et tolérance : freq_plan.h ---
 
 // --- Périodes de mesure et d'affichage (ms) ---
 const unsigned int MEASURE_PERIOD  = 50;   // calcul fréquence toutes les 50 ms
 const unsigned int DISPLAY_PERIOD  = 500;  // affichage toutes les 500 ms
 
-// --- Variables partagées avec l'ISR ---
-volatile unsigned long pulseCount = 0;  // compteur d'impulsions (incrémenté par ISR)
+// --- Compteur matériel de fronts montants (remplace l'ISR countPulse) ---
+EdgeCounter edgeCounter;
+
+// --- Mode balayage : chronométrage PIO des périodes sur GPIO 2 (gigue) ---
+EdgeTimer     edgeTimer;
+SweepList     sweepList = defaultSweepList();
+SweepTracker  sweepTracker(0);
+bool          sweepMode = false;
+
+// --- Ligne de commande en cours de saisie (commande l) ---
+char          cmdLine[96];
+unsigned int  cmdLineLen  = 0;
+bool          cmdLineMode = false;
 
 // --- Variables de timing ---
 unsigned long lastMeasureTime = 0;
@@ -44,24 +66,6 @@ unsigned int  adcMax   = 0;
 unsigned long adcSum   = 0;
 unsigned int  adcCount = 0;
 
-// --- ISR : compte chaque front montant ---
-void countPulse() {
-    pulseCount++;
-}
-
-// --- Classifie la fréquence mesurée ---
-const char* classifyFrequency(unsigned long freq) {
-    if (freq < 100)
-        return "AUCUNE";
-    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
-        return "NEUTRE  (20 kHz)";
-    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
-        return "VALID_A (25 kHz)";
-    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
-        return "VALID_B (40 kHz)";
-    return "INCONNUE";
-}
-
 // =============================================================================
 void setup() {
     Serial.begin(115200);
@@ -74,26 +78,96 @@ void setup() {
     // Résolution ADC 12 bits (0–4095)
     analogReadResolution(12);
 
-    // GPIO 2 en entrée, interruption sur front montant
+    // GPIO 2 en entrée simple, le comptage se fait sur GPIO 3 (slice PWM)
     pinMode(PIN_INTERRUPT, INPUT);
-    attachInterrupt(digitalPinToInterrupt(PIN_INTERRUPT), countPulse, RISING);
+    edgeCounter.begin(PIN_COUNTER);
+    edgeTimer.begin(PIN_INTERRUPT);
+    sweepTracker.setTickHz(edgeTimer.tickHz());
+    sweepTracker.setList(sweepList);
 
     // En-tête dans le Serial Monitor
     Serial.println("==============================================");
     Serial.println("  Phase 0.4 — Pico to Pico | RECEPTEUR");
     Serial.println("  Signal : GPIO 15 (gen) -> GPIO 2 (rec)");
+    Serial.println("  Compteur : GPIO 3 (PWM 1B, pont GPIO 2-3)");
     Serial.println("  ADC    : GPIO 15 (gen) -> GPIO 26 (rec) [optionnel]");
     Serial.println("  Pas de GND commun entre les deux Pico");
+    Serial.println("  b -> mode balayage | l f1,f2,... -> liste");
     Serial.println("==============================================");
 
     lastMeasureTime = millis();
     lastDisplayTime = millis();
+    edgeCounter.clear();
+}
+
+// =============================================================================
+void printSweepList() {
+    Serial.print("# liste");
+    for (uint8_t i = 0; i < sweepList.size; i++) {
+        Serial.print(i == 0 ? " " : ",");
+        Serial.print(sweepList.freqHz[i]);
+    }
+    Serial.println();
+}
+
+void handleSerial() {
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (cmdLineMode) {
+            if (c == '\n' || c == '\r') {
+                cmdLineMode = false;
+                cmdLine[cmdLineLen] = '\0';
+                if (parseSweepList(cmdLine, sweepList)) {
+                    sweepTracker.setList(sweepList);
+                    printSweepList();
+                } else {
+                    Serial.println("# liste invalide");
+                }
+            } else if (cmdLineLen < sizeof(cmdLine) - 1) {
+                cmdLine[cmdLineLen++] = c;
+            }
+            continue;
+        }
+        if (c == 'l') {
+            cmdLineMode = true;
+            cmdLineLen  = 0;
+        } else if (c == 'b') {
+            sweepMode = !sweepMode;
+            sweepTracker.reset();
+            edgeTimer.flush();
+            if (sweepMode) {
+                printSweepList();
+                Serial.println(SWEEP_CSV_HEADER);
+            } else {
+                Serial.println("# fin du mode balayage");
+            }
+        }
+    }
+}
+
+// Une fenêtre de comptage en mode balayage : CSV à la fin de chaque pas
+void sweepWindow(unsigned long count, unsigned long elapsed) {
+    edgeTimer.poll(sweepTracker.periods());
+    SweepTracker::Event ev = sweepTracker.pushWindow(count, elapsed);
+    if (ev == SweepTracker::Event::STEP_BEGIN) {
+        edgeTimer.flush();
+    } else if (ev == SweepTracker::Event::STEP_END) {
+        char row[96];
+        formatSweepCsv(sweepTracker.result(), row, sizeof(row));
+        Serial.println(row);
+    }
 }
 
 // =============================================================================
 void loop() {
     unsigned long now = millis();
 
+    handleSerial();
+
+    // Mode balayage : vider le buffer PIO souvent (256 périodes = 85 ms à 3 kHz)
+    if (sweepMode)
+        edgeTimer.poll(sweepTracker.periods());
+
     // ------------------------------------------------------------------
     // 1. Lecture ADC en continu (info bonus, non bloquant)
     // ------------------------------------------------------------------
@@ -107,19 +181,29 @@ void loop() {
     // 2. Calcul de la fréquence toutes les MEASURE_PERIOD ms
     // ------------------------------------------------------------------
     if (now - lastMeasureTime >= MEASURE_PERIOD) {
-        // Lecture atomique du compteur d'impulsions
-        noInterrupts();
-        unsigned long count = pulseCount;
-        pulseCount = 0;
-        interrupts();
+        // Fronts comptés par le slice PWM depuis la dernière fenêtre
+        unsigned long count = edgeCounter.takePulseCount();
 
         // Fréquence = impulsions / durée réelle (en secondes)
         unsigned long elapsed = now - lastMeasureTime;
-        measuredFreqHz = (count * 1000UL) / elapsed;
+        measuredFreqHz = windowFreqHz(count, elapsed);
+
+        if (sweepMode)
+            sweepWindow(count, elapsed);
 
         lastMeasureTime = now;
     }
 
+    // En mode balayage, seules les lignes CSV sont affichées
+    if (sweepMode) {
+        adcMin   = 4095;
+        adcMax   = 0;
+        adcSum   = 0;
+        adcCount = 0;
+        lastDisplayTime = now;
+        return;
+    }
+
     // ------------------------------------------------------------------
     // 3. Affichage compact toutes les DISPLAY_PERIOD ms
     // ------------------------------------------------------------------
@@ -131,7 +215,7 @@ void loop() {
         Serial.print("Freq: ");
         Serial.print(measuredFreqHz);
         Serial.print(" Hz | ");
-        Serial.print(classifyFrequency(measuredFreqHz));
+        Serial.print(freqClassLabel(classifyFrequency(measuredFreqHz)));
         Serial.print(" | ADC: min=");
         Serial.print(adcMin);
         Serial.print(" max=");
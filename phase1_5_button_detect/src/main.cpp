@@ -10,6 +10,9 @@
 //      via filtre RC (10kΩ + 100nF) sur GP16 → digitalRead
 //   3. Quand le bouton est pressé, mesure la fréquence sur GP2 (ligne B)
 //      et classifie la touche (valide / neutre / blanche)
+//   4. En parallèle, un PIO chronomètre chaque période sur GP2 : la
+//      décision est affichée dès que RECIPROCAL_PERIODS périodes stables
+//      sont reçues (quelques ms), sans attendre la fin de la fenêtre
 //
 // CÂBLAGE :
 //
@@ -36,7 +39,8 @@
 //                     │              │
 //                     │           GP16 [pin 21] (bouton, digitalRead)
 //                     │
-//                     ├──── GP2 (détection freq, interruption)
+//                     ├──── GP2 (entrée, haute impédance)
+//                     ├──── GP3 (pont avec GP2, compteur de fronts PWM 1B)
 //                     │
 //                   [10kΩ] pull-down
 //                     │
@@ -57,52 +61,69 @@
 // =============================================================================
 
 #include <Arduino.h>
-#include <hardware/pwm.h>
-#include <hardware/clocks.h>
+#include <classifier.h>
+#include <debounce.h>
+#include <edge_counter.h>
+#include <fie_timing.h>
+#include <freq_plan.h>
+#include <hal.h>
+#include <pio_edge_timer.h>
+#include <reciprocal_meter.h>
+
+using namespace fencing;
 
 // =============================================================================
 // CONFIGURATION DES PINS
 // =============================================================================
 
-const uint PIN_PWM_NEUTRE = 14;   // GP14 : sortie PWM → MOSFET → ligne C (coque)
-const int  PIN_FREQ_IN    = 2;    // GP2  : entrée interruption (ligne B, détection freq)
+const int  PIN_PWM_NEUTRE = 14;   // GP14 : sortie PWM → MOSFET → ligne C (coque)
+const int  PIN_FREQ_IN    = 2;    // GP2  : entrée ligne B (haute impédance)
+const int  PIN_FREQ_COUNT = 3;    // GP3  : compteur de fronts (slice PWM 1, entrée B, ponté à GP2)
 const int  PIN_BUTTON     = 16;   // GP16 : entrée digitalRead (ligne B via filtre RC)
 
+// Fréquences de référence et tolérance : freq_plan.h (fencing_core)
+
 // =============================================================================
-// FRÉQUENCES DE RÉFÉRENCE (Hz)
+// PARAMÈTRES DE MESURE
 // =============================================================================
 
-const unsigned int FREQ_NEUTRE  = 20000;  // 20 kHz — coque, piste
-const unsigned int FREQ_VALID_A = 25000;  // 25 kHz — cuirasse tireur A
-const unsigned int FREQ_VALID_B = 40000;  // 40 kHz — cuirasse tireur B
-const unsigned int TOLERANCE    = 2000;   // ±2 kHz
+const uint32_t     MEASURE_WINDOW_US  = 50000; // fenêtre de comptage (µs)
+const unsigned int DISPLAY_PERIOD_MS  = 200;   // affichage série (ms)
+const uint8_t      RECIPROCAL_PERIODS = 4;     // périodes pour la mesure réciproque
 
 // =============================================================================
-// PARAMÈTRES DE MESURE
+// COMPTEUR MATÉRIEL DE FRONTS (remplace l'ISR countPulse)
 // =============================================================================
+//
+// Fenêtres pilotées par loop(), pas par WindowSampler : elles s'ouvrent à
+// l'appui (clear()) et la dernière se ferme au relâchement. Au repos, GP2
+// reçoit le 20 kHz de la coque par B↔C fermé ; une fenêtre de la grille de
+// l'alarme (50 ms glissantes) mélangerait ce signal de repos à celui de la
+// pointe pour tout appui de moins de 50 ms. Les bords sont datés en µs
+// (micros(), lu juste après le compteur) : un tour de loop() lent allonge
+// la fenêtre mais ne fausse pas la fréquence.
 
-const unsigned int MEASURE_WINDOW_MS = 50;    // fenêtre de comptage (ms)
-const unsigned int DISPLAY_PERIOD_MS = 200;   // affichage série (ms)
-const unsigned int DEBOUNCE_MS       = 5;     // anti-rebond bouton (ms)
+EdgeCounter edgeCounter;
 
 // =============================================================================
-// VARIABLES PARTAGÉES AVEC L'ISR
+// CHRONOMÈTRE PIO DES PÉRIODES (mesure réciproque, décision rapide)
 // =============================================================================
 
-volatile unsigned long pulseCount = 0;
+EdgeTimer edgeTimer;
+ReciprocalEstimator<RECIPROCAL_PERIODS> reciprocal(0);
+bool quickDecisionDone = false;
 
 // =============================================================================
 // VARIABLES D'ÉTAT
 // =============================================================================
 
 // Bouton
-bool     buttonPressed      = false;   // état courant du bouton
-bool     lastButtonState    = false;   // état précédent (pour détection de front)
-unsigned long buttonChangeTime = 0;    // timestamp du dernier changement (debounce)
+bool      buttonPressed = false;       // état courant du bouton
+Debouncer buttonDebouncer(DEBOUNCE_MS);
 
 // Mesure de fréquence
 unsigned long measuredFreqHz   = 0;
-unsigned long lastMeasureTime  = 0;
+uint32_t      lastMeasureUs    = 0;      // bord de la fenêtre en cours (micros())
 bool          measuring        = false;  // true = on est en train de compter
 
 // Dwell time (durée d'appui du bouton)
@@ -115,73 +136,6 @@ unsigned long lastDisplayTime  = 0;
 // Statistiques de touche
 unsigned long touchCount       = 0;
 
-// =============================================================================
-// ISR — compte chaque front montant sur GP2
-// =============================================================================
-
-void countPulse() {
-    pulseCount++;
-}
-
-// =============================================================================
-// Classification de la fréquence mesurée
-// =============================================================================
-
-const char* classifyFrequency(unsigned long freq) {
-    if (freq < 500)
-        return "AUCUNE (blanche)";
-    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
-        return "NEUTRE  (20 kHz)";
-    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
-        return "VALID_A (25 kHz)";
-    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
-        return "VALID_B (40 kHz)";
-    return "INCONNUE";
-}
-
-// =============================================================================
-// Résultat de la touche (logique d'arbitrage simplifiée)
-// =============================================================================
-
-const char* touchResult(unsigned long freq) {
-    if (freq < 500)
-        return ">>> TOUCHE BLANCHE (non-valide) <<<";
-    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
-        return "--- Pas de lumiere (coque/piste) ---";
-    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
-        return "*** TOUCHE VALIDE sur tireur A ! ***";
-    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
-        return "*** TOUCHE VALIDE sur tireur B ! ***";
-    return "??? Frequence inconnue ???";
-}
-
-// =============================================================================
-// Configuration du PWM hardware (signal carré exact)
-// =============================================================================
-
-uint pwmSliceNeutre = 0;
-
-void setupPWM(uint pin, unsigned int freq) {
-    gpio_set_function(pin, GPIO_FUNC_PWM);
-
-    uint sliceNum = pwm_gpio_to_slice_num(pin);
-    uint32_t clock_freq = clock_get_hz(clk_sys);  // 125 MHz
-    uint32_t wrap = clock_freq / freq;
-
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 1.0f);
-    pwm_config_set_wrap(&config, wrap - 1);
-    pwm_init(sliceNum, &config, false);
-
-    // Duty cycle 50% → signal carré
-    pwm_set_chan_level(sliceNum, pwm_gpio_to_channel(pin), wrap / 2);
-
-    // Démarrer le PWM
-    pwm_set_enabled(sliceNum, true);
-
-    pwmSliceNeutre = sliceNum;
-}
-
 // =============================================================================
 // Lecture du bouton avec anti-rebond
 // =============================================================================
@@ -189,17 +143,8 @@ void setupPWM(uint pin, unsigned int freq) {
 bool readButtonDebounced() {
     // GP16 : HIGH = bouton au repos (B↔C fermé, signal 20 kHz filtré)
     //         LOW = bouton pressé (B↔C ouvert, condensateur déchargé)
-    bool rawState = !digitalRead(PIN_BUTTON);  // inversé : LOW = pressé → true
-
-    if (rawState != lastButtonState) {
-        buttonChangeTime = millis();
-    }
-    lastButtonState = rawState;
-
-    if ((millis() - buttonChangeTime) >= DEBOUNCE_MS) {
-        return rawState;
-    }
-    return buttonPressed;  // pas encore stabilisé, garder l'état précédent
+    bool rawState = !hal::pinRead(PIN_BUTTON);  // inversé : LOW = pressé → true
+    return buttonDebouncer.update(rawState, millis());
 }
 
 // =============================================================================
@@ -215,11 +160,13 @@ void setup() {
     digitalWrite(LED_BUILTIN, HIGH);
 
     // --- Génération Freq_NEUTRE sur GP14 (via MOSFET → ligne C) ---
-    setupPWM(PIN_PWM_NEUTRE, FREQ_NEUTRE);
+    hal::pwmStart(PIN_PWM_NEUTRE, FREQ_NEUTRE);
 
-    // --- Détection fréquence sur GP2 (interruption RISING) ---
+    // --- Détection fréquence : GP2 en entrée, comptage matériel sur GP3 ---
     pinMode(PIN_FREQ_IN, INPUT);
-    attachInterrupt(digitalPinToInterrupt(PIN_FREQ_IN), countPulse, RISING);
+    edgeCounter.begin(PIN_FREQ_COUNT);
+    edgeTimer.begin(PIN_FREQ_IN);
+    reciprocal.setTickHz(edgeTimer.tickHz());
 
     // --- Détection bouton sur GP16 (filtre RC, digitalRead) ---
     pinMode(PIN_BUTTON, INPUT);  // pas de pull-up/pull-down interne, le RC s'en charge
@@ -229,7 +176,7 @@ void setup() {
     Serial.println("  Phase 1.5 — Detection bouton + classification");
     Serial.println("=====================================================");
     Serial.println("  GP14 : PWM 20 kHz → MOSFET → ligne C (coque)");
-    Serial.println("  GP2  : detection frequence (interruption RISING)");
+    Serial.println("  GP3  : detection frequence (compteur PWM, pont GP2)");
     Serial.println("  GP16 : detection bouton (filtre RC, digitalRead)");
     Serial.println("-----------------------------------------------------");
     Serial.println("  Bouton au repos : GP16 = HIGH (signal 20 kHz filtre)");
@@ -239,7 +186,6 @@ void setup() {
     Serial.println("=====================================================");
     Serial.println();
 
-    lastMeasureTime = millis();
     lastDisplayTime = millis();
 }
 
@@ -263,11 +209,12 @@ void loop() {
         buttonPressStart = now;
         measuring = true;
 
-        // Reset du compteur pour une mesure propre
-        noInterrupts();
-        pulseCount = 0;
-        interrupts();
-        lastMeasureTime = now;
+        // Début d'une nouvelle fenêtre pour une mesure propre
+        edgeCounter.clear();
+        lastMeasureUs = (uint32_t)micros();
+        edgeTimer.flush();
+        reciprocal.reset();
+        quickDecisionDone = false;
 
         Serial.println("[BOUTON] Presse ! Mesure en cours...");
     }
@@ -280,15 +227,11 @@ void loop() {
         dwellTimeMs = now - buttonPressStart;
         measuring = false;
 
-        // Dernière mesure
-        noInterrupts();
-        unsigned long count = pulseCount;
-        pulseCount = 0;
-        interrupts();
-
-        unsigned long elapsed = now - lastMeasureTime;
+        // Dernière mesure, de la fenêtre en cours jusqu'au relâchement
+        unsigned long count   = edgeCounter.takePulseCount();
+        uint32_t      elapsed = (uint32_t)micros() - lastMeasureUs;
         if (elapsed > 0) {
-            measuredFreqHz = (count * 1000UL) / elapsed;
+            measuredFreqHz = windowFreqHzUs(count, elapsed);
         }
 
         // Afficher le résultat de la touche
@@ -299,16 +242,16 @@ void loop() {
         Serial.print("]  Freq: ");
         Serial.print(measuredFreqHz);
         Serial.print(" Hz | ");
-        Serial.print(classifyFrequency(measuredFreqHz));
+        Serial.print(freqClassLabel(classifyFrequency(measuredFreqHz)));
         Serial.print(" | Dwell: ");
         Serial.print(dwellTimeMs);
         Serial.println(" ms");
 
         Serial.print("  Resultat: ");
-        Serial.println(touchResult(measuredFreqHz));
+        Serial.println(touchResultText(classifyFrequency(measuredFreqHz)));
 
         // Vérification dwell time FIE (15 ms minimum)
-        if (dwellTimeMs < 15) {
+        if (!dwellSatisfied(dwellTimeMs)) {
             Serial.println("  /!\\ Dwell time < 15 ms (insuffisant pour la FIE)");
         }
         Serial.println("-----------------------------------------------------");
@@ -318,15 +261,29 @@ void loop() {
     // -----------------------------------------------------------------
     // 4. Pendant que le bouton est pressé : mesure continue
     // -----------------------------------------------------------------
-    if (measuring && (now - lastMeasureTime >= MEASURE_WINDOW_MS)) {
-        noInterrupts();
-        unsigned long count = pulseCount;
-        pulseCount = 0;
-        interrupts();
-
-        unsigned long elapsed = now - lastMeasureTime;
-        measuredFreqHz = (count * 1000UL) / elapsed;
-        lastMeasureTime = now;
+    if (measuring && ((uint32_t)micros() - lastMeasureUs >= MEASURE_WINDOW_US)) {
+        unsigned long count  = edgeCounter.takePulseCount();
+        uint32_t      nowUs  = (uint32_t)micros();
+
+        measuredFreqHz = windowFreqHzUs(count, nowUs - lastMeasureUs);
+        lastMeasureUs  = nowUs;
+    }
+
+    // -----------------------------------------------------------------
+    // 4bis. Mesure réciproque : décision dès N périodes stables
+    // -----------------------------------------------------------------
+    if (measuring) {
+        edgeTimer.poll(reciprocal);
+        if (!quickDecisionDone && reciprocal.stable()) {
+            quickDecisionDone = true;
+            unsigned long quickFreq = reciprocal.freqHz();
+            Serial.print("[DECISION] t+");
+            Serial.print(now - buttonPressStart);
+            Serial.print(" ms | Freq: ");
+            Serial.print(quickFreq);
+            Serial.print(" Hz | ");
+            Serial.println(touchResultText(classifyFrequency(quickFreq)));
+        }
     }
 
     // -----------------------------------------------------------------
@@ -345,7 +302,7 @@ void loop() {
             Serial.print("[MESURE] Freq: ");
             Serial.print(measuredFreqHz);
             Serial.print(" Hz | ");
-            Serial.print(classifyFrequency(measuredFreqHz));
+            Serial.print(freqClassLabel(classifyFrequency(measuredFreqHz)));
             Serial.print(" | Dwell: ");
             Serial.print(now - buttonPressStart);
             Serial.println(" ms");
@@ -13,70 +13,48 @@
 //
 // CABLAGE : tout reste branche comme c'est.
 //   GP16 avec 10kOhm serie → on s'en sert pas, on le lit meme pas.
-//   GP2 + 10kOhm pull-down → detection frequence (interrupt RISING)
+//   GP2 + 10kOhm pull-down → ligne B (entree haute impedance)
+//   GP3 ponte a GP2 → detection frequence (compteur de fronts PWM 1B,
+//   fenetres cadencees par alarme : window_sampler.h)
 //
 // =============================================================================
 
 #include <Arduino.h>
+#include <classifier.h>
+#include <freq_plan.h>
+#include <window_sampler.h>
 
-// =============================================================================
-// PINS
-// =============================================================================
-
-const int PIN_FREQ_IN  = 2;
-const int PIN_BUTTON   = 16;
-const int PIN_PWM_A    = 14;
-const int PIN_MOSFET_C = 15;
-const int PIN_PWM_C    = 17;
+using namespace fencing;
 
 // =============================================================================
-// FREQUENCES
+// PINS
 // =============================================================================
 
-const unsigned int FREQ_NEUTRE  = 20000;
-const unsigned int FREQ_VALID_A = 25000;
-const unsigned int FREQ_VALID_B = 40000;
-const unsigned int TOLERANCE    = 2000;
+const int PIN_FREQ_IN    = 2;
+const int PIN_FREQ_COUNT = 3;   // slice PWM 1, entree B (ponte a GP2)
+const int PIN_BUTTON     = 16;
+const int PIN_PWM_A      = 14;
+const int PIN_MOSFET_C   = 15;
+const int PIN_PWM_C      = 17;
 
 // =============================================================================
 // PARAMETRES
 // =============================================================================
 
-const unsigned int MEASURE_PERIOD_MS = 50;
 const unsigned int DISPLAY_PERIOD_MS = 500;
 
 // =============================================================================
-// ISR — identique Phase 0.4
+// FENETRES DE COMPTAGE — slice PWM lu par une alarme toutes les 10 ms,
+// fenetre glissante de 50 ms (cf. window_sampler.h)
 // =============================================================================
 
-volatile unsigned long pulseCount = 0;
-
-void countPulse() {
-    pulseCount++;
-}
-
-// =============================================================================
-// CLASSIFICATION
-// =============================================================================
-
-const char* classifyFrequency(unsigned long freq) {
-    if (freq < 100)
-        return "AUCUNE";
-    if (freq >= FREQ_NEUTRE  - TOLERANCE && freq <= FREQ_NEUTRE  + TOLERANCE)
-        return "NEUTRE  (20 kHz)";
-    if (freq >= FREQ_VALID_A - TOLERANCE && freq <= FREQ_VALID_A + TOLERANCE)
-        return "VALID_A (25 kHz)";
-    if (freq >= FREQ_VALID_B - TOLERANCE && freq <= FREQ_VALID_B + TOLERANCE)
-        return "VALID_B (40 kHz)";
-    return "INCONNUE";
-}
+WindowSampler windowSampler;
 
 // =============================================================================
 // VARIABLES
 // =============================================================================
 
 unsigned long measuredFreqHz   = 0;
-unsigned long lastMeasureTime  = 0;
 unsigned long lastDisplayTime  = 0;
 
 // =============================================================================
@@ -90,9 +68,8 @@ void setup() {
     pinMode(LED_BUILTIN, OUTPUT);
     digitalWrite(LED_BUILTIN, HIGH);
 
-    // GP2 : interruption RISING (comme Phase 0.4)
+    // GP2 : entree simple, comptage materiel sur GP3 (pont GP2-GP3)
     pinMode(PIN_FREQ_IN, INPUT);
-    attachInterrupt(digitalPinToInterrupt(PIN_FREQ_IN), countPulse, RISING);
 
     // GP16 : on le met en INPUT simple (pas de pull-up, on le touche pas)
     pinMode(PIN_BUTTON, INPUT);
@@ -108,7 +85,7 @@ void setup() {
     Serial.println();
     Serial.println("=====================================================");
     Serial.println("  Phase 1.7 — TEST DIAGNOSTIC");
-    Serial.println("  GP2 interrupt RISING en permanence (comme Phase 0.4)");
+    Serial.println("  GP3 compteur de fronts PWM en permanence (pont GP2)");
     Serial.println("  GP16 ignore, pas de logique bouton");
     Serial.println("  Tout le circuit reste branche");
     Serial.println("=====================================================");
@@ -118,8 +95,8 @@ void setup() {
     Serial.println("=====================================================");
     Serial.println();
 
-    lastMeasureTime = millis();
     lastDisplayTime = millis();
+    windowSampler.begin(PIN_FREQ_COUNT);
 }
 
 // =============================================================================
@@ -129,18 +106,10 @@ void setup() {
 void loop() {
     unsigned long now = millis();
 
-    // Mesure toutes les 50 ms
-    if (now - lastMeasureTime >= MEASURE_PERIOD_MS) {
-        noInterrupts();
-        unsigned long count = pulseCount;
-        pulseCount = 0;
-        interrupts();
-
-        unsigned long elapsed = now - lastMeasureTime;
-        lastMeasureTime = now;
-
-        measuredFreqHz = (count * 1000UL) / elapsed;
-    }
+    // Derniere fenetre de 50 ms publiee par l'alarme (Serial peut bloquer)
+    WindowResult window;
+    if (windowSampler.read(window))
+        measuredFreqHz = window.freqHz;
 
     // Affichage toutes les 500 ms
     if (now - lastDisplayTime >= DISPLAY_PERIOD_MS) {
@@ -149,7 +118,7 @@ void loop() {
         Serial.print("Freq: ");
         Serial.print(measuredFreqHz);
         Serial.print(" Hz | ");
-        Serial.print(classifyFrequency(measuredFreqHz));
+        Serial.print(freqClassLabel(classifyFrequency(measuredFreqHz)));
         Serial.print(" | GP16=");
         Serial.println(digitalRead(PIN_BUTTON) ? "HIGH" : "LOW");
     }